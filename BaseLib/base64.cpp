@@ -3,39 +3,556 @@
 // found in the LICENSE file.
 
 #include "base64.h"
-#include "third_party/modp_b64/modp_b64.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <immintrin.h>
+#endif
+
+#include "cpu.h"
 
 namespace base {
 
-	std::string Base64Encode(span<const uint8_t> input) {
-		std::string output;
-		output.resize(modp_b64_encode_len(input.size()));  // makes room for null byte
+	namespace {
+
+		constexpr char kPaddingChar = '=';
+
+		// Marks the bytes that are not symbols of an alphabet.
+		constexpr uint8_t kInvalid = 0x80;
+
+		struct Alphabet {
+			// The 64 symbols, in value order.
+			const char* symbols;
+			// The value of every byte, or kInvalid.
+			std::array<uint8_t, 256> values;
+		};
+
+		constexpr std::array<uint8_t, 256> MakeValues(const char* symbols) {
+			std::array<uint8_t, 256> values = {};
+			for (auto& value : values)
+				value = kInvalid;
+			for (uint8_t i = 0; i < 64; ++i)
+				values[static_cast<uint8_t>(symbols[i])] = i;
+			return values;
+		}
+
+		constexpr char kStandardSymbols[] =
+			"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		constexpr char kUrlSafeSymbols[] =
+			"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+		constexpr Alphabet kStandardAlphabet = {
+			kStandardSymbols, MakeValues(kStandardSymbols) };
+		constexpr Alphabet kUrlSafeAlphabet = {
+			kUrlSafeSymbols, MakeValues(kUrlSafeSymbols) };
+
+		const Alphabet& GetAlphabet(internal::Base64Alphabet alphabet) {
+			return alphabet == internal::Base64Alphabet::kUrlSafe ?
+				kUrlSafeAlphabet : kStandardAlphabet;
+		}
+
+		// Encoders. Each encodes the |size| bytes at |input|, a multiple of 3,
+		// into size / 3 * 4 symbols at |output|. The vector variants turn 12 or
+		// 24 bytes into 16 or 32 symbols per step, and hand the tail to the next
+		// narrower variant.
+		using EncodeFunction = void (*)(const uint8_t* input,
+			size_t size,
+			char* output,
+			const Alphabet& alphabet);
+
+		void EncodeScalar(const uint8_t* input,
+			size_t size,
+			char* output,
+			const Alphabet& alphabet) {
+			const char* const symbols = alphabet.symbols;
+			for (const uint8_t* const end = input + size; input != end; input += 3) {
+				const uint32_t group =
+					(input[0] << 16) | (input[1] << 8) | input[2];
+				*output++ = symbols[group >> 18];
+				*output++ = symbols[(group >> 12) & 0x3f];
+				*output++ = symbols[(group >> 6) & 0x3f];
+				*output++ = symbols[group & 0x3f];
+			}
+		}
+
+		// Decoders. Each decodes whole 4-symbol groups from the |size| symbols at
+		// |input|, a multiple of 4, into 3 bytes per group at |output|, and
+		// returns the number of symbols decoded. That is less than |size| when a
+		// byte outside the alphabet was found; the vector variants stop at the
+		// start of the 16 or 32 symbols holding it.
+		using DecodeFunction = size_t (*)(const char* input,
+			size_t size,
+			uint8_t* output,
+			const Alphabet& alphabet);
+
+		size_t DecodeScalar(const char* input,
+			size_t size,
+			uint8_t* output,
+			const Alphabet& alphabet) {
+			const uint8_t* const values = alphabet.values.data();
+			size_t decoded = 0;
+			for (; decoded < size; decoded += 4) {
+				const auto* group = reinterpret_cast<const uint8_t*>(input + decoded);
+				const uint32_t a = values[group[0]];
+				const uint32_t b = values[group[1]];
+				const uint32_t c = values[group[2]];
+				const uint32_t d = values[group[3]];
+				if ((a | b | c | d) & kInvalid)
+					break;
+				const uint32_t bits = (a << 18) | (b << 12) | (c << 6) | d;
+				*output++ = static_cast<uint8_t>(bits >> 16);
+				*output++ = static_cast<uint8_t>(bits >> 8);
+				*output++ = static_cast<uint8_t>(bits);
+			}
+			return decoded;
+		}
+
+#if defined(ARCH_CPU_X86_FAMILY)
+		// The 6-bit groups of 12 bytes, as the low bits of 16 bytes. Each 32-bit
+		// lane receives bytes 1, 0, 2, 1 of its 3-byte group so that both
+		// multiplies shift every 6-bit field into a byte of its own.
+		__m128i SplitGroups(__m128i input) {
+			const __m128i shuffled = _mm_shuffle_epi8(input,
+				_mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+			const __m128i high = _mm_mulhi_epu16(
+				_mm_and_si128(shuffled, _mm_set1_epi32(0x0fc0fc00)),
+				_mm_set1_epi32(0x04000040));
+			const __m128i low = _mm_mullo_epi16(
+				_mm_and_si128(shuffled, _mm_set1_epi32(0x003f03f0)),
+				_mm_set1_epi32(0x01000010));
+			return _mm_or_si128(high, low);
+		}
+
+		// Maps 16 values to symbols. Values run in four ranges with one offset
+		// each, A-Z, a-z, 0-9 and the last two symbols, so a saturating
+		// subtract sorts them into 14 classes whose offsets a shuffle looks up.
+		__m128i ValuesToSymbols(__m128i values, __m128i offsets) {
+			__m128i classes = _mm_subs_epu8(values, _mm_set1_epi8(51));
+			const __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), values);
+			classes = _mm_or_si128(classes, _mm_and_si128(upper, _mm_set1_epi8(13)));
+			return _mm_add_epi8(values, _mm_shuffle_epi8(offsets, classes));
+		}
+
+		// The offsets ValuesToSymbols() adds to each class of values.
+		__m128i SymbolOffsets(const Alphabet& alphabet) {
+			return _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52,
+				'0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+				static_cast<char>(alphabet.symbols[62] - 62),
+				static_cast<char>(alphabet.symbols[63] - 63), 'A', 0, 0);
+		}
+
+		void EncodeSSSE3(const uint8_t* input,
+			size_t size,
+			char* output,
+			const Alphabet& alphabet) {
+			const __m128i offsets = SymbolOffsets(alphabet);
+			const uint8_t* const end = input + size;
+			// Each load reads 16 bytes to encode 12.
+			for (; end - input >= 16; input += 12, output += 16) {
+				const __m128i bytes =
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(output),
+					ValuesToSymbols(SplitGroups(bytes), offsets));
+			}
+			EncodeScalar(input, end - input, output, alphabet);
+		}
+
+		// Returns the values of 16 symbols, and sets |*valid| to the bytes that
+		// are symbols of the alphabet. The letters and digits are found with one
+		// compare per range each, by moving the range to the bottom of the
+		// signed bytes.
+		__m128i SymbolsToValues(__m128i symbols,
+			const Alphabet& alphabet,
+			__m128i* valid) {
+			const auto in_range = [symbols](char first, char last) {
+				const __m128i shifted =
+					_mm_add_epi8(symbols, _mm_set1_epi8(static_cast<char>(0x80 - first)));
+				return _mm_cmpgt_epi8(
+					_mm_set1_epi8(static_cast<char>(-128 + (last - first) + 1)), shifted);
+			};
+			const __m128i upper = in_range('A', 'Z');
+			const __m128i lower = in_range('a', 'z');
+			const __m128i digit = in_range('0', '9');
+			const __m128i symbol62 =
+				_mm_cmpeq_epi8(symbols, _mm_set1_epi8(alphabet.symbols[62]));
+			const __m128i symbol63 =
+				_mm_cmpeq_epi8(symbols, _mm_set1_epi8(alphabet.symbols[63]));
+			*valid = _mm_or_si128(_mm_or_si128(upper, lower),
+				_mm_or_si128(digit, _mm_or_si128(symbol62, symbol63)));
+			__m128i offsets = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+			offsets = _mm_or_si128(offsets,
+				_mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+			offsets = _mm_or_si128(offsets,
+				_mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+			offsets = _mm_or_si128(offsets, _mm_and_si128(symbol62,
+				_mm_set1_epi8(static_cast<char>(62 - alphabet.symbols[62]))));
+			offsets = _mm_or_si128(offsets, _mm_and_si128(symbol63,
+				_mm_set1_epi8(static_cast<char>(63 - alphabet.symbols[63]))));
+			return _mm_add_epi8(symbols, offsets);
+		}
+
+		// Packs the 6-bit values of each 4-symbol group into 24 bits, stored big
+		// endian in the low 3 bytes of its 32-bit lane.
+		__m128i PackGroups(__m128i values) {
+			const __m128i pairs =
+				_mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+			const __m128i groups = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+			return _mm_shuffle_epi8(groups, _mm_setr_epi8(
+				2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+		}
+
+		size_t DecodeSSSE3(const char* input,
+			size_t size,
+			uint8_t* output,
+			const Alphabet& alphabet) {
+			size_t decoded = 0;
+			for (; size - decoded >= 16; decoded += 16, output += 12) {
+				const __m128i symbols = _mm_loadu_si128(
+					reinterpret_cast<const __m128i*>(input + decoded));
+				__m128i valid;
+				const __m128i values = SymbolsToValues(symbols, alphabet, &valid);
+				if (_mm_movemask_epi8(valid) != 0xffff)
+					return decoded;
+				const __m128i bytes = PackGroups(values);
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(output), bytes);
+				const auto last = static_cast<uint32_t>(
+					_mm_cvtsi128_si32(_mm_srli_si128(bytes, 8)));
+				memcpy(output + 8, &last, sizeof(last));
+			}
+			return decoded +
+				DecodeScalar(input + decoded, size - decoded, output, alphabet);
+		}
+
+		// The AVX2 variants run the SSSE3 steps on both 128-bit lanes.
+		__m256i SplitGroups(__m256i input) {
+			const __m256i shuffled = _mm256_shuffle_epi8(input, _mm256_setr_epi8(
+				1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+				1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+			const __m256i high = _mm256_mulhi_epu16(
+				_mm256_and_si256(shuffled, _mm256_set1_epi32(0x0fc0fc00)),
+				_mm256_set1_epi32(0x04000040));
+			const __m256i low = _mm256_mullo_epi16(
+				_mm256_and_si256(shuffled, _mm256_set1_epi32(0x003f03f0)),
+				_mm256_set1_epi32(0x01000010));
+			return _mm256_or_si256(high, low);
+		}
+
+		__m256i ValuesToSymbols(__m256i values, __m256i offsets) {
+			__m256i classes = _mm256_subs_epu8(values, _mm256_set1_epi8(51));
+			const __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), values);
+			classes = _mm256_or_si256(classes,
+				_mm256_and_si256(upper, _mm256_set1_epi8(13)));
+			return _mm256_add_epi8(values, _mm256_shuffle_epi8(offsets, classes));
+		}
+
+		void EncodeAVX2(const uint8_t* input,
+			size_t size,
+			char* output,
+			const Alphabet& alphabet) {
+			const __m256i offsets =
+				_mm256_broadcastsi128_si256(SymbolOffsets(alphabet));
+			const uint8_t* const end = input + size;
+			// Each lane loads 16 bytes to encode 12, so 28 bytes must be left.
+			for (; end - input >= 28; input += 24, output += 32) {
+				const __m256i bytes = _mm256_inserti128_si256(
+					_mm256_castsi128_si256(
+						_mm_loadu_si128(reinterpret_cast<const __m128i*>(input))),
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 12)), 1);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(output),
+					ValuesToSymbols(SplitGroups(bytes), offsets));
+			}
+			EncodeSSSE3(input, end - input, output, alphabet);
+		}
+
+		__m256i SymbolsToValues(__m256i symbols,
+			const Alphabet& alphabet,
+			__m256i* valid) {
+			const auto in_range = [symbols](char first, char last) {
+				const __m256i shifted = _mm256_add_epi8(symbols,
+					_mm256_set1_epi8(static_cast<char>(0x80 - first)));
+				return _mm256_cmpgt_epi8(
+					_mm256_set1_epi8(static_cast<char>(-128 + (last - first) + 1)),
+					shifted);
+			};
+			const __m256i upper = in_range('A', 'Z');
+			const __m256i lower = in_range('a', 'z');
+			const __m256i digit = in_range('0', '9');
+			const __m256i symbol62 =
+				_mm256_cmpeq_epi8(symbols, _mm256_set1_epi8(alphabet.symbols[62]));
+			const __m256i symbol63 =
+				_mm256_cmpeq_epi8(symbols, _mm256_set1_epi8(alphabet.symbols[63]));
+			*valid = _mm256_or_si256(_mm256_or_si256(upper, lower),
+				_mm256_or_si256(digit, _mm256_or_si256(symbol62, symbol63)));
+			__m256i offsets = _mm256_and_si256(upper, _mm256_set1_epi8(-'A'));
+			offsets = _mm256_or_si256(offsets,
+				_mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a')));
+			offsets = _mm256_or_si256(offsets,
+				_mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')));
+			offsets = _mm256_or_si256(offsets, _mm256_and_si256(symbol62,
+				_mm256_set1_epi8(static_cast<char>(62 - alphabet.symbols[62]))));
+			offsets = _mm256_or_si256(offsets, _mm256_and_si256(symbol63,
+				_mm256_set1_epi8(static_cast<char>(63 - alphabet.symbols[63]))));
+			return _mm256_add_epi8(symbols, offsets);
+		}
+
+		// Also moves the 12 bytes of the high lane down next to those of the low
+		// lane.
+		__m256i PackGroups(__m256i values) {
+			const __m256i pairs =
+				_mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+			const __m256i groups =
+				_mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+			const __m256i lanes = _mm256_shuffle_epi8(groups, _mm256_setr_epi8(
+				2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+				2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+			return _mm256_permutevar8x32_epi32(lanes,
+				_mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+		}
+
+		size_t DecodeAVX2(const char* input,
+			size_t size,
+			uint8_t* output,
+			const Alphabet& alphabet) {
+			size_t decoded = 0;
+			for (; size - decoded >= 32; decoded += 32, output += 24) {
+				const __m256i symbols = _mm256_loadu_si256(
+					reinterpret_cast<const __m256i*>(input + decoded));
+				__m256i valid;
+				const __m256i values = SymbolsToValues(symbols, alphabet, &valid);
+				if (_mm256_movemask_epi8(valid) != -1)
+					return decoded;
+				const __m256i bytes = PackGroups(values);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(output),
+					_mm256_castsi256_si128(bytes));
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(output + 16),
+					_mm256_extracti128_si256(bytes, 1));
+			}
+			return decoded +
+				DecodeSSSE3(input + decoded, size - decoded, output, alphabet);
+		}
+#endif  // defined(ARCH_CPU_X86_FAMILY)
+
+		// Pick the widest encoder and decoder the processor supports. Done once
+		// per process.
+		EncodeFunction GetEncodeFunction() {
+			static const EncodeFunction encode = [] {
+#if defined(ARCH_CPU_X86_FAMILY)
+				const CPU cpu;
+				if (cpu.has_avx2())
+					return &EncodeAVX2;
+				if (cpu.has_ssse3())
+					return &EncodeSSSE3;
+#endif
+				return &EncodeScalar;
+			}();
+			return encode;
+		}
+
+		DecodeFunction GetDecodeFunction() {
+			static const DecodeFunction decode = [] {
+#if defined(ARCH_CPU_X86_FAMILY)
+				const CPU cpu;
+				if (cpu.has_avx2())
+					return &DecodeAVX2;
+				if (cpu.has_ssse3())
+					return &DecodeSSSE3;
+#endif
+				return &DecodeScalar;
+			}();
+			return decode;
+		}
 
-		// modp_b64_encode_len() returns at least 1, so output[0] is safe to use.
-		const auto output_size = modp_b64_encode(
-			&(output[0]), reinterpret_cast<const char*>(input.data()), input.size());
+		// Drops up to two padding characters from the end of |input|.
+		std::string_view RemovePadding(std::string_view input) {
+			for (int i = 0; i < 2 && !input.empty() && input.back() == kPaddingChar; ++i)
+				input.remove_suffix(1);
+			return input;
+		}
 
-		output.resize(output_size);
+	}  // namespace
+
+	namespace internal {
+
+		void Base64EncodeAppend(span<const uint8_t> input,
+			Base64Alphabet alphabet,
+			bool pad,
+			std::string* output) {
+			const Alphabet& symbols = GetAlphabet(alphabet);
+			const size_t remainder = input.size() % 3;
+			const size_t whole = input.size() - remainder;
+			const size_t old_size = output->size();
+			size_t tail_size = 0;
+			if (remainder)
+				tail_size = pad ? 4 : remainder + 1;
+			output->resize(old_size + whole / 3 * 4 + tail_size);
+			char* out = &(*output)[old_size];
+			GetEncodeFunction()(input.data(), whole, out, symbols);
+			if (!remainder)
+				return;
+
+			out += whole / 3 * 4;
+			const uint32_t first = input[whole];
+			const uint32_t second = remainder == 2 ? input[whole + 1] : 0;
+			out[0] = symbols.symbols[first >> 2];
+			out[1] = symbols.symbols[((first & 0x03) << 4) | (second >> 4)];
+			if (remainder == 2)
+				out[2] = symbols.symbols[(second & 0x0f) << 2];
+			else if (pad)
+				out[2] = kPaddingChar;
+			if (pad)
+				out[3] = kPaddingChar;
+		}
+
+		bool Base64DecodeAppend(std::string_view input,
+			Base64Alphabet alphabet,
+			std::string* output) {
+			const size_t remainder = input.size() % 4;
+			if (remainder == 1)
+				return false;
+			const Alphabet& symbols = GetAlphabet(alphabet);
+			const size_t whole = input.size() - remainder;
+			const size_t old_size = output->size();
+			output->resize(old_size + whole / 4 * 3 + (remainder ? remainder - 1 : 0));
+			auto* out = reinterpret_cast<uint8_t*>(&(*output)[old_size]);
+			if (GetDecodeFunction()(input.data(), whole, out, symbols) != whole) {
+				output->resize(old_size);
+				return false;
+			}
+			if (!remainder)
+				return true;
+
+			// The last 2 or 3 symbols hold 1 or 2 bytes; their spare low bits are
+			// not checked.
+			out += whole / 4 * 3;
+			const auto* tail = reinterpret_cast<const uint8_t*>(input.data() + whole);
+			const uint32_t a = symbols.values[tail[0]];
+			const uint32_t b = symbols.values[tail[1]];
+			const uint32_t c = remainder == 3 ? symbols.values[tail[2]] : 0;
+			if ((a | b | c) & kInvalid) {
+				output->resize(old_size);
+				return false;
+			}
+			out[0] = static_cast<uint8_t>((a << 2) | (b >> 4));
+			if (remainder == 3)
+				out[1] = static_cast<uint8_t>((b << 4) | (c >> 2));
+			return true;
+		}
+
+	}  // namespace internal
+
+	std::string Base64Encode(span<const uint8_t> input) {
+		std::string output;
+		internal::Base64EncodeAppend(input, internal::Base64Alphabet::kStandard,
+			true, &output);
 		return output;
 	}
 
-	void Base64Encode(std::string_view& input, std::string* output) {
+	void Base64Encode(const std::string_view& input, std::string* output) {
 		*output = Base64Encode(as_bytes(make_span(input)));
 	}
 
 	bool Base64Decode(const std::string_view& input, std::string* output) {
+		if (input.size() % 4)
+			return false;
+
 		std::string temp;
-		temp.resize(modp_b64_decode_len(input.size()));
+		if (!internal::Base64DecodeAppend(RemovePadding(input),
+			internal::Base64Alphabet::kStandard, &temp)) {
+			return false;
+		}
+		output->swap(temp);
+		return true;
+	}
 
-		// does not null terminate result since result is binary data!
-		const auto input_size = input.size();
-		const auto output_size = modp_b64_decode(&(temp[0]), input.data(), input_size);
-		if (output_size == MODP_B64_ERROR)
+	Base64Encoder::Base64Encoder() = default;
+
+	Base64Encoder::~Base64Encoder() = default;
+
+	void Base64Encoder::Update(span<const uint8_t> input, std::string* output) {
+		if (pending_size_) {
+			const size_t size = std::min(3 - pending_size_, input.size());
+			memcpy(pending_ + pending_size_, input.data(), size);
+			pending_size_ += size;
+			input = input.subspan(size);
+			if (pending_size_ < 3)
+				return;
+			internal::Base64EncodeAppend(make_span(pending_),
+				internal::Base64Alphabet::kStandard, true, output);
+			pending_size_ = 0;
+		}
+
+		const size_t whole = input.size() / 3 * 3;
+		internal::Base64EncodeAppend(input.first(whole),
+			internal::Base64Alphabet::kStandard, true, output);
+		pending_size_ = input.size() - whole;
+		memcpy(pending_, input.data() + whole, pending_size_);
+	}
+
+	void Base64Encoder::Finish(std::string* output) {
+		internal::Base64EncodeAppend(make_span(pending_, pending_size_),
+			internal::Base64Alphabet::kStandard, true, output);
+		pending_size_ = 0;
+	}
+
+	Base64Decoder::Base64Decoder() = default;
+
+	Base64Decoder::~Base64Decoder() = default;
+
+	bool Base64Decoder::Update(std::string_view input, std::string* output) {
+		if (failed_)
 			return false;
 
-		temp.resize(output_size);
-		output->swap(temp);
+		// Padding is only valid in the last group, so a group that holds some
+		// is kept until Finish(), and anything after it is an error.
+		if (pending_size_) {
+			const size_t size = std::min(4 - pending_size_, input.size());
+			memcpy(pending_ + pending_size_, input.data(), size);
+			pending_size_ += size;
+			input.remove_prefix(size);
+			if (pending_size_ < 4)
+				return true;
+			const std::string_view group(pending_, 4);
+			if (group.find(kPaddingChar) != std::string_view::npos)
+				return input.empty() || Fail();
+			if (!internal::Base64DecodeAppend(group,
+				internal::Base64Alphabet::kStandard, output)) {
+				return Fail();
+			}
+			pending_size_ = 0;
+		}
+
+		size_t whole = input.size() / 4 * 4;
+		const size_t padding = input.substr(0, whole).find(kPaddingChar);
+		if (padding != std::string_view::npos)
+			whole = padding / 4 * 4;
+		if (!internal::Base64DecodeAppend(input.substr(0, whole),
+			internal::Base64Alphabet::kStandard, output)) {
+			return Fail();
+		}
+		input.remove_prefix(whole);
+		if (input.size() > 4)
+			return Fail();
+		memcpy(pending_, input.data(), input.size());
+		pending_size_ = input.size();
 		return true;
 	}
 
+	bool Base64Decoder::Finish(std::string* output) {
+		const bool valid = !failed_ && (!pending_size_ || (pending_size_ == 4 &&
+			internal::Base64DecodeAppend(
+				RemovePadding(std::string_view(pending_, pending_size_)),
+				internal::Base64Alphabet::kStandard, output)));
+		pending_size_ = 0;
+		failed_ = false;
+		return valid;
+	}
+
+	bool Base64Decoder::Fail() {
+		failed_ = true;
+		return false;
+	}
+
 }  // namespace base
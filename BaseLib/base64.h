@@ -4,11 +4,12 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 
 #include "base_export.h"
 #include "containers/span.h"
-#include <string>
 
 namespace base {
 
@@ -23,4 +24,99 @@ namespace base {
 	// be done in-place.
 	BASE_EXPORT bool Base64Decode(const std::string_view& input, std::string* output);
 
+	// Base64Encoder encodes a stream of bytes a chunk at a time, so that a large
+	// blob can be encoded while it is read, without holding all of it in memory.
+	// The concatenated output is the same as Base64Encode() on the concatenated
+	// input:
+	//
+	//   base::Base64Encoder encoder;
+	//   std::string encoded;
+	//   char buffer[64 * 1024];
+	//   int bytes_read;
+	//   while ((bytes_read = file.ReadAtCurrentPos(buffer, sizeof(buffer))) > 0) {
+	//     encoder.Update(as_bytes(make_span(buffer, bytes_read)), &encoded);
+	//     out_file.WriteAtCurrentPos(encoded.data(), encoded.size());
+	//     encoded.clear();
+	//   }
+	//   encoder.Finish(&encoded);
+	//   out_file.WriteAtCurrentPos(encoded.data(), encoded.size());
+	class BASE_EXPORT Base64Encoder {
+	public:
+		Base64Encoder();
+		~Base64Encoder();
+
+		Base64Encoder(const Base64Encoder&) = delete;
+		Base64Encoder& operator=(const Base64Encoder&) = delete;
+
+		// Appends the encoding of |input| to |*output|, except for the last one
+		// or two bytes when they do not make up a whole 3-byte group; those wait
+		// for the next call.
+		void Update(span<const uint8_t> input, std::string* output);
+
+		// Appends the encoding of the bytes still waiting, with padding, and
+		// makes the encoder ready for a new stream.
+		void Finish(std::string* output);
+
+	private:
+		uint8_t pending_[3];
+		size_t pending_size_ = 0;
+	};
+
+	// Base64Decoder is the streaming counterpart of Base64Decode(). It accepts
+	// exactly the inputs Base64Decode() accepts, however they are split into
+	// chunks. Unlike Base64Decode(), it appends to the output as it goes, so a
+	// failure can leave some of the decoded bytes in |*output|.
+	class BASE_EXPORT Base64Decoder {
+	public:
+		Base64Decoder();
+		~Base64Decoder();
+
+		Base64Decoder(const Base64Decoder&) = delete;
+		Base64Decoder& operator=(const Base64Decoder&) = delete;
+
+		// Appends the bytes decoded from |input| to |*output|. Up to three
+		// characters, or a final group ending in padding, are held back until
+		// the next call. Returns false as soon as the input so far cannot start
+		// a valid encoding, and from then on until Finish().
+		bool Update(std::string_view input, std::string* output);
+
+		// Decodes the characters held back. Returns true if the whole input was
+		// valid, and makes the decoder ready for a new stream.
+		bool Finish(std::string* output);
+
+	private:
+		bool Fail();
+
+		char pending_[4];
+		size_t pending_size_ = 0;
+		bool failed_ = false;
+	};
+
+	namespace internal {
+
+		enum class Base64Alphabet {
+			// A-Z, a-z, 0-9, '+' and '/', RFC 4648 section 4.
+			kStandard,
+			// A-Z, a-z, 0-9, '-' and '_', RFC 4648 section 5.
+			kUrlSafe,
+		};
+
+		// Appends the encoding of |input| to |*output|, which must not overlap
+		// it. Without |pad|, a final partial group is not followed by '='.
+		BASE_EXPORT void Base64EncodeAppend(span<const uint8_t> input,
+			Base64Alphabet alphabet,
+			bool pad,
+			std::string* output);
+
+		// Appends the decoding of |input| to |*output|, which must not overlap
+		// it. |input| must have no padding: any character outside |alphabet|,
+		// '=' included, or a size of 1 modulo 4, is an error. On error, returns
+		// false and leaves |*output| as it was. As with Base64Decode(), unused
+		// bits in the last character are ignored.
+		BASE_EXPORT bool Base64DecodeAppend(std::string_view input,
+			Base64Alphabet alphabet,
+			std::string* output);
+
+	}  // namespace internal
+
 }  // namespace base
@@ -7,48 +7,23 @@
 #include <stddef.h>
 
 #include "base64.h"
-#include "macros.h"
-#include "numerics/safe_math.h"
-#include "strings/string_util.h"
-#include "third_party/modp_b64/modp_b64.h"
 
 namespace base {
 
 	const char kPaddingChar = '=';
 
-	// Base64url maps {+, /} to {-, _} in order for the encoded content to be safe
-	// to use in a URL. These characters will be translated by this implementation.
-	const char kBase64Chars[] = "+/";
-	const char kBase64UrlSafeChars[] = "-_";
-
 	void Base64UrlEncode(const std::string_view& input, Base64UrlEncodePolicy policy, std::string* output) {
-		Base64Encode(input, output);
-
-		ReplaceChars(*output, "+", "-", output);
-		ReplaceChars(*output, "/", "_", output);
-
-		switch (policy) {
-		case Base64UrlEncodePolicy::INCLUDE_PADDING:
-			// The padding included in |*output| will not be amended.
-			break;
-		case Base64UrlEncodePolicy::OMIT_PADDING:
-			// The padding included in |*output| will be removed.
-			const size_t last_non_padding_pos = output->find_last_not_of(kPaddingChar);
-			if (last_non_padding_pos != std::string::npos)
-				output->resize(last_non_padding_pos + 1);
-
-			break;
-		}
+		// Encoded straight into the base64url alphabet. |input| may alias
+		// |*output|, so the result goes through a temporary.
+		std::string encoded;
+		internal::Base64EncodeAppend(as_bytes(make_span(input)),
+			internal::Base64Alphabet::kUrlSafe,
+			policy == Base64UrlEncodePolicy::INCLUDE_PADDING, &encoded);
+		output->swap(encoded);
 	}
 
 	bool Base64UrlDecode(const std::string_view& input, Base64UrlDecodePolicy policy, std::string* output) {
-		// Characters outside of the base64url alphabet are disallowed, which includes
-		// the {+, /} characters found in the conventional base64 alphabet.
-		if (input.find_first_of(kBase64Chars) != std::string::npos)
-			return false;
-
 		const size_t required_padding_characters = input.size() % 4;
-		const bool needs_replacement = input.find_first_of(kBase64UrlSafeChars) != std::string::npos;
 
 		switch (policy) {
 		case Base64UrlDecodePolicy::REQUIRE_PADDING:
@@ -57,7 +32,7 @@ namespace base {
 				return false;
 			break;
 		case Base64UrlDecodePolicy::IGNORE_PADDING:
-			// Missing padding will be silently appended.
+			// Missing padding is treated as if it had been appended.
 			break;
 		case Base64UrlDecodePolicy::DISALLOW_PADDING:
 			// Fail if padding characters are included in |input|.
@@ -66,31 +41,27 @@ namespace base {
 			break;
 		}
 
-		// If the string either needs replacement of URL-safe characters to normal
-		// base64 ones, or additional padding, a copy of |input| needs to be made in
-		// order to make these adjustments without side effects.
-		if (required_padding_characters > 0 || needs_replacement) {
-			std::string base64_input;
-
-			CheckedNumeric<size_t> base64_input_size = input.size();
-			if (required_padding_characters > 0)
-				base64_input_size += 4 - required_padding_characters;
-
-			base64_input.reserve(base64_input_size.ValueOrDie());
-			base64_input.append(input.data(), input.size());
-			//input.AppendToString(&base64_input);
-
-			// Substitute the base64url URL-safe characters to their base64 equivalents.
-			ReplaceChars(base64_input, "-", "+", &base64_input);
-			ReplaceChars(base64_input, "_", "/", &base64_input);
-
-			// Append the necessary padding characters.
-			base64_input.resize(base64_input_size.ValueOrDie(), '=');
-
-			return Base64Decode(base64_input, output);
+		// Behave as Base64Decode() on |input| padded to a multiple of 4, which
+		// drops at most two trailing padding characters, without making that
+		// copy. The base64url alphabet excludes the {+, /} characters found in
+		// the conventional one.
+		const size_t missing_padding =
+			required_padding_characters ? 4 - required_padding_characters : 0;
+		if (missing_padding > 2)
+			return false;
+		std::string_view unpadded = input;
+		for (size_t i = missing_padding; i < 2 && !unpadded.empty() &&
+			unpadded.back() == kPaddingChar; ++i) {
+			unpadded.remove_suffix(1);
 		}
 
-		return Base64Decode(input, output);
+		std::string decoded;
+		if (!internal::Base64DecodeAppend(unpadded,
+			internal::Base64Alphabet::kUrlSafe, &decoded)) {
+			return false;
+		}
+		output->swap(decoded);
+		return true;
 	}
 
 }  // namespace base
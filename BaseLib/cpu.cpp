@@ -78,6 +78,7 @@ namespace base {
 		has_avx_(false),
 		has_avx2_(false),
 		has_aesni_(false),
+		has_sha_(false),
 		has_non_stop_time_stamp_counter_(false),
 		is_running_in_vm_(false),
 		cpu_vendor_("unknown") {
@@ -168,6 +169,7 @@ namespace base {
 				(xgetbv(0) & 6) == 6 /* XSAVE enabled by kernel */;
 			has_aesni_ = (cpu_info[2] & 0x02000000) != 0;
 			has_avx2_ = has_avx_ && (cpu_info7[1] & 0x00000020) != 0;
+			has_sha_ = (cpu_info7[1] & 0x20000000) != 0;
 		}
 
 		// Get the brand string of the cpu.
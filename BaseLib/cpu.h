@@ -62,6 +62,8 @@ namespace base {
 		bool has_avx() const { return has_avx_; }
 		bool has_avx2() const { return has_avx2_; }
 		bool has_aesni() const { return has_aesni_; }
+		// The SHA-1 and SHA-256 instructions (SHA-NI).
+		bool has_sha() const { return has_sha_; }
 		bool has_non_stop_time_stamp_counter() const {
 			return has_non_stop_time_stamp_counter_;
 		}
@@ -92,6 +94,7 @@ namespace base {
 		bool has_avx_;
 		bool has_avx2_;
 		bool has_aesni_;
+		bool has_sha_;
 		bool has_non_stop_time_stamp_counter_;
 		bool is_running_in_vm_;
 		std::string cpu_vendor_;
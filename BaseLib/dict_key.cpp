@@ -0,0 +1,100 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "dict_key.h"
+
+#include <utility>
+
+#include "trace_event/memory_usage_estimator.h"
+
+namespace base {
+
+	// DictKey::Rep ////////////////////////////////////////////////////////////////
+
+	DictKey::Rep::Rep(std::string str) : str(std::move(str)) {}
+
+	void DictKey::Rep::AddRef() const {
+		ref_count.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void DictKey::Rep::Release() const {
+		if (ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			delete this;
+	}
+
+	// DictKey /////////////////////////////////////////////////////////////////////
+
+	DictKey::DictKey(std::string_view key) : str_(key) {}
+
+	DictKey::DictKey(const std::string& key) : str_(key) {}
+
+	DictKey::DictKey(const char* key) : str_(key) {}
+
+	DictKey::DictKey(scoped_refptr<const Rep> rep) : rep_(std::move(rep)) {}
+
+	size_t DictKey::EstimateMemoryUsage() const {
+		if (!rep_)
+			return trace_event::EstimateMemoryUsage(str_);
+		// Like std::shared_ptr, rather overestimate than return 0.
+		const int ref_count = rep_->ref_count.load(std::memory_order_relaxed);
+		return (sizeof(Rep) + trace_event::EstimateMemoryUsage(rep_->str) +
+			ref_count - 1) / ref_count;
+	}
+
+	// A lookup with the characters of a key, such as an interned key or one
+	// taken from another dictionary sharing it, is decided by the sizes.
+	// static
+	bool DictKey::Equals(const DictKey& key, std::string_view str) {
+		const std::string& own = key.str();
+		if (own.size() != str.size())
+			return false;
+		return own.data() == str.data() || std::string_view(own) == str;
+	}
+
+	// static
+	bool DictKey::Less(const DictKey& key, std::string_view str) {
+		const std::string& own = key.str();
+		if (own.data() == str.data())
+			return own.size() < str.size();
+		return std::string_view(own) < str;
+	}
+
+	// static
+	bool DictKey::Less(std::string_view str, const DictKey& key) {
+		const std::string& own = key.str();
+		if (str.data() == own.data())
+			return str.size() < own.size();
+		return str < std::string_view(own);
+	}
+
+	// DictKeyTable ////////////////////////////////////////////////////////////////
+
+	DictKeyTable::DictKeyTable() = default;
+
+	DictKeyTable::~DictKeyTable() = default;
+
+	DictKey DictKeyTable::Intern(std::string_view key) {
+		const auto found = keys_.find(key);
+		if (found != keys_.end())
+			return found->second;
+		return Intern(std::string(key));
+	}
+
+	DictKey DictKeyTable::Intern(std::string&& key) {
+		const auto found = keys_.find(key);
+		if (found != keys_.end())
+			return found->second;
+		if (key.empty())
+			return DictKey();
+		DictKey interned(
+			scoped_refptr<const DictKey::Rep>(new DictKey::Rep(std::move(key))));
+		keys_.emplace(interned.str(), interned);
+		return interned;
+	}
+
+	DictKey DictKeyTable::Intern(const char* key) {
+		return Intern(std::string_view(key));
+	}
+
+}  // namespace base
@@ -0,0 +1,170 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+#include "base_export.h"
+#include "macros.h"
+#include "memory/ref_counted.h"
+#include "memory/scoped_refptr.h"
+
+namespace base {
+
+	namespace internal {
+
+		template <typename T>
+		using EnableIfStringLike =
+			std::enable_if_t<std::is_convertible_v<const T&, std::string_view>>;
+
+	}  // namespace internal
+
+	// The key of a dictionary Value. A DictKey holds its characters in a
+	// std::string, like the keys of a std::map, unless it comes from a
+	// DictKeyTable. Keys interned by the same table share a single allocation
+	// held by reference, so the many dictionaries of an array of records store
+	// each of their keys once, and copying such a key only takes a reference.
+	//
+	// DictKey converts implicitly from and to strings, so a DictStorage is
+	// indexed and filled with strings as before, and it compares with strings
+	// in both directions without constructing a DictKey. Interned keys known
+	// to share storage compare equal without looking at their characters.
+	class BASE_EXPORT DictKey {
+	public:
+		DictKey() = default;
+		DictKey(std::string_view key);
+		DictKey(const std::string& key);
+		// Inline, like the destructor, as a parser makes one of these for every
+		// dictionary member.
+		DictKey(std::string&& key) : str_(std::move(key)) {}
+		DictKey(const char* key);
+		DictKey(const DictKey& other) = default;
+		DictKey(DictKey&& other) noexcept = default;
+		DictKey& operator=(const DictKey& other) = default;
+		DictKey& operator=(DictKey&& other) noexcept = default;
+		~DictKey() = default;
+
+		[[nodiscard]] const std::string& str() const {
+			return rep_ ? rep_->str : str_;
+		}
+		operator const std::string&() const { return str(); }
+
+		[[nodiscard]] size_t size() const { return str().size(); }
+		[[nodiscard]] bool empty() const { return str().empty(); }
+
+		// Returns true if both keys were interned and refer to the same
+		// characters, which implies that they are equal.
+		[[nodiscard]] bool SharesStorageWith(const DictKey& other) const {
+			return rep_ && rep_ == other.rep_;
+		}
+
+		// The key's share of its storage.
+		[[nodiscard]] size_t EstimateMemoryUsage() const;
+
+		// The comparisons are hidden friends, so that strings compared with one
+		// another never convert to DictKey. Those with std::string,
+		// std::string_view and const char* are templates, so that they are
+		// preferred to converting the string to a DictKey.
+		friend bool operator==(const DictKey& lhs, const DictKey& rhs) {
+			return lhs.SharesStorageWith(rhs) || lhs.str() == rhs.str();
+		}
+		friend bool operator!=(const DictKey& lhs, const DictKey& rhs) {
+			return !(lhs == rhs);
+		}
+		friend bool operator<(const DictKey& lhs, const DictKey& rhs) {
+			return !lhs.SharesStorageWith(rhs) && lhs.str() < rhs.str();
+		}
+		template <typename T, typename = internal::EnableIfStringLike<T>>
+		friend bool operator==(const DictKey& lhs, const T& rhs) {
+			return Equals(lhs, rhs);
+		}
+		template <typename T, typename = internal::EnableIfStringLike<T>>
+		friend bool operator==(const T& lhs, const DictKey& rhs) {
+			return Equals(rhs, lhs);
+		}
+		template <typename T, typename = internal::EnableIfStringLike<T>>
+		friend bool operator!=(const DictKey& lhs, const T& rhs) {
+			return !Equals(lhs, rhs);
+		}
+		template <typename T, typename = internal::EnableIfStringLike<T>>
+		friend bool operator!=(const T& lhs, const DictKey& rhs) {
+			return !Equals(rhs, lhs);
+		}
+		template <typename T, typename = internal::EnableIfStringLike<T>>
+		friend bool operator<(const DictKey& lhs, const T& rhs) {
+			return Less(lhs, rhs);
+		}
+		template <typename T, typename = internal::EnableIfStringLike<T>>
+		friend bool operator<(const T& lhs, const DictKey& rhs) {
+			return Less(lhs, rhs);
+		}
+
+	private:
+		friend class DictKeyTable;
+
+		// A RefCountedThreadSafe would do, but the estimate above needs the
+		// count.
+		class Rep {
+		public:
+			explicit Rep(std::string str);
+
+			void AddRef() const;
+			void Release() const;
+
+			const std::string str;
+			mutable std::atomic_int ref_count{ 0 };
+		};
+
+		static bool Equals(const DictKey& key, std::string_view str);
+		static bool Less(const DictKey& key, std::string_view str);
+		static bool Less(std::string_view str, const DictKey& key);
+
+		// Used by DictKeyTable to share |rep|.
+		explicit DictKey(scoped_refptr<const Rep> rep);
+
+		// The characters of a key that was not interned.
+		std::string str_;
+		// The shared characters of an interned key.
+		scoped_refptr<const Rep> rep_;
+	};
+
+	// Hands out a shared DictKey for each distinct string. Use one table for
+	// all dictionaries expected to have the same keys, such as the records of
+	// a JSON document parsed with JSON_INTERN_KEYS, or Values built with
+	// Value::SetKey(DictKey, Value). Keys hold their own references, so they
+	// remain valid after the table is gone; the table keeps every key it
+	// interned alive until then.
+	//
+	// The table is ref-counted so that a parser and the code building Values
+	// around its output can share it, but it is not thread-safe: it must be
+	// used on one sequence at a time.
+	class BASE_EXPORT DictKeyTable : public RefCounted<DictKeyTable> {
+	public:
+		DictKeyTable();
+
+		// Returns the key equal to |key|, adding it to the table if needed.
+		DictKey Intern(std::string_view key);
+		DictKey Intern(std::string&& key);
+		// This overload is necessary to avoid ambiguity for const char* arguments.
+		DictKey Intern(const char* key);
+
+		// Number of distinct keys interned.
+		[[nodiscard]] size_t size() const { return keys_.size(); }
+
+	private:
+		friend class RefCounted<DictKeyTable>;
+		~DictKeyTable();
+
+		// Views into the keys themselves.
+		std::unordered_map<std::string_view, DictKey> keys_;
+
+		DISALLOW_COPY_AND_ASSIGN(DictKeyTable);
+	};
+
+}  // namespace base
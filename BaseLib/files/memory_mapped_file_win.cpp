@@ -6,6 +6,7 @@
 
 #include <cstdint>
 
+#include <algorithm>
 #include <limits>
 
 #include "files/file_path.h"
@@ -126,6 +127,26 @@ namespace base {
 		return true;
 	}
 
+	void MemoryMappedFile::Prefetch(size_t offset, size_t size) const {
+		DCHECK(IsValid());
+		DCHECK_LE(offset, length_);
+		size = std::min(size, length_ - offset);
+		// PrefetchVirtualMemory() fails when asked to read zero bytes.
+		if (!size)
+			return;
+
+		// ::PrefetchVirtualMemory() is only available on Windows 8 and above.
+		static const auto prefetch_virtual_memory =
+			reinterpret_cast<decltype(&::PrefetchVirtualMemory)>(GetProcAddress(
+				::GetModuleHandleA("kernel32.dll"), "PrefetchVirtualMemory"));
+		if (!prefetch_virtual_memory)
+			return;
+
+		::_WIN32_MEMORY_RANGE_ENTRY address_range = { data_ + offset, size };
+		(*prefetch_virtual_memory)(::GetCurrentProcess(),
+			/*NumberOfEntries=*/1, &address_range, /*Flags=*/0);
+	}
+
 	void MemoryMappedFile::CloseHandles() {
 		if (data_)
 			::UnmapViewOfFile(data_);
@@ -22,7 +22,17 @@
  */
 
 #include "hash/md5.h"
+
+#include <algorithm>
+#include <utility>
+
 #include "../third_party/boringssl/md5.h"
+#include "cpu.h"
+#include "files/file.h"
+#include "files/memory_mapped_file.h"
+#include "hash/simd_lanes_internal.h"
+#include "logging.h"
+#include "threading/scoped_blocking_call.h"
 
 namespace {
 
@@ -293,4 +303,170 @@ namespace base {
 		return MD5DigestToBase16(digest);
 	}
 
+	namespace {
+
+		// MD5SumFile() hashes a chunk of the mapping while the next one is
+		// prefetched.
+		constexpr size_t kFileChunkSize = 4 * 1024 * 1024;
+
+		constexpr uint32_t kInitialState[4] = {
+			0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+
+		// The constants added in each of the 64 steps, as in MD5Transform().
+		constexpr uint32_t kStepConstants[64] = {
+			0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee,
+			0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+			0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
+			0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+			0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa,
+			0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+			0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed,
+			0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+			0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c,
+			0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+			0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05,
+			0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+			0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039,
+			0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+			0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1,
+			0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391,
+		};
+
+		// The rotations of the steps, which repeat every 4 steps within each
+		// round of 16.
+		constexpr int kStepRotations[4][4] = {
+			{ 7, 12, 17, 22 }, { 5, 9, 14, 20 }, { 4, 11, 16, 23 }, { 6, 10, 15, 21 } };
+
+		// Multi-buffer functions. Each hashes every input into the digest at the
+		// same index.
+		using SumManyFunction = void (*)(span<const std::string_view> inputs,
+			span<MD5Digest> digests);
+
+		void SumManyOneByOne(span<const std::string_view> inputs,
+			span<MD5Digest> digests) {
+			for (size_t i = 0; i < inputs.size(); ++i)
+				MD5Sum(inputs[i].data(), inputs[i].size(), &digests[i]);
+		}
+
+#if defined(ARCH_CPU_X86_FAMILY)
+		// Step |kStep| of MD5Transform() in every lane. The roles of the four
+		// registers in |abcd| rotate by one each step.
+		template <typename V, int kStep>
+		void LanesStep(V(&abcd)[4], const V(&words)[16]) {
+			using L = internal::HashLanes<V>;
+			constexpr int kRound = kStep / 16;
+			constexpr int kIndex = kStep % 16;
+			constexpr int kWord = kRound == 0 ? kIndex :
+				kRound == 1 ? (5 * kIndex + 1) % 16 :
+				kRound == 2 ? (3 * kIndex + 5) % 16 : 7 * kIndex % 16;
+			V& w = abcd[(64 - kStep) % 4];
+			const V x = abcd[(65 - kStep) % 4];
+			const V y = abcd[(66 - kStep) % 4];
+			const V z = abcd[(67 - kStep) % 4];
+			V f;
+			if constexpr (kRound == 0)
+				f = L::Xor(z, L::And(x, L::Xor(y, z)));
+			else if constexpr (kRound == 1)
+				f = L::Xor(y, L::And(z, L::Xor(x, y)));
+			else if constexpr (kRound == 2)
+				f = L::Xor(L::Xor(x, y), z);
+			else
+				f = L::Xor(y, L::Or(x, L::Xor(z, L::Set1(0xffffffff))));
+			w = L::Add(L::Add(w, f),
+				L::Add(words[kWord], L::Set1(kStepConstants[kStep])));
+			w = L::Add(L::template RotateLeft<kStepRotations[kRound][kIndex % 4]>(w),
+				x);
+		}
+
+		template <typename V, int... kSteps>
+		void LanesSteps(V(&abcd)[4],
+			const V(&words)[16],
+			std::integer_sequence<int, kSteps...>) {
+			(LanesStep<V, kSteps>(abcd, words), ...);
+		}
+
+		// Adds one block of each lane's message to |state|, which holds the
+		// four state words of every lane.
+		template <typename V>
+		void TransformInLanes(uint32_t state[4][internal::HashLanes<V>::kCount],
+			const uint8_t* const blocks[internal::HashLanes<V>::kCount]) {
+			using L = internal::HashLanes<V>;
+			V words[16];
+			for (size_t group = 0; group < 4; ++group) {
+				L::template LoadWords<internal::HashByteOrder::kLittleEndian>(
+					blocks, group, words + 4 * group);
+			}
+			V abcd[4];
+			for (size_t i = 0; i < 4; ++i)
+				abcd[i] = L::Load(state[i]);
+			LanesSteps(abcd, words, std::make_integer_sequence<int, 64>());
+			for (size_t i = 0; i < 4; ++i)
+				L::Store(state[i], L::Add(L::Load(state[i]), abcd[i]));
+		}
+
+		template <typename V>
+		void SumManyInLanes(span<const std::string_view> inputs,
+			span<MD5Digest> digests) {
+			internal::HashManyInLanes<V, 4, internal::HashByteOrder::kLittleEndian>(
+				inputs, digests, kInitialState, &TransformInLanes<V>);
+		}
+#endif  // defined(ARCH_CPU_X86_FAMILY)
+
+		// Picks the widest lanes the processor supports. Done once per process.
+		SumManyFunction GetSumManyFunction() {
+			static const SumManyFunction sum_many = [] {
+#if defined(ARCH_CPU_X86_FAMILY)
+				const CPU cpu;
+				if (cpu.has_avx2())
+					return &SumManyInLanes<__m256i>;
+				if (cpu.has_sse2())
+					return &SumManyInLanes<__m128i>;
+#endif
+				return &SumManyOneByOne;
+			}();
+			return sum_many;
+		}
+
+	}  // namespace
+
+	bool MD5SumFile(const FilePath& path, MD5Digest* digest) {
+		ScopedBlockingCall scoped_blocking_call(FROM_HERE, BlockingType::MAY_BLOCK);
+
+		File file(path,
+			File::FLAG_OPEN | File::FLAG_READ | File::FLAG_SEQUENTIAL_SCAN);
+		if (!file.IsValid())
+			return false;
+		const int64_t file_length = file.GetLength();
+		if (file_length < 0)
+			return false;
+		// MemoryMappedFile::Initialize() fails on an empty file.
+		if (file_length == 0) {
+			MD5Sum("", 0, digest);
+			return true;
+		}
+		MemoryMappedFile mapped_file;
+		if (!mapped_file.Initialize(std::move(file)))
+			return false;
+
+		const auto* data = reinterpret_cast<const char*>(mapped_file.data());
+		const size_t length = mapped_file.length();
+		MD5Context context;
+		MD5Init(&context);
+		mapped_file.Prefetch(0, kFileChunkSize);
+		for (size_t offset = 0; offset < length; offset += kFileChunkSize) {
+			const size_t chunk_size = std::min(kFileChunkSize, length - offset);
+			if (chunk_size < length - offset)
+				mapped_file.Prefetch(offset + chunk_size, kFileChunkSize);
+			MD5Update(&context, std::string_view(data + offset, chunk_size));
+		}
+		MD5Final(digest, &context);
+		return true;
+	}
+
+	void MD5SumMany(span<const std::string_view> inputs,
+		span<MD5Digest> digests) {
+		CHECK_EQ(inputs.size(), digests.size());
+		GetSumManyFunction()(inputs, digests);
+	}
+
 }  // namespace base
@@ -4,9 +4,12 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 
 #include "base_export.h"
+#include "containers/span.h"
 
 // MD5 stands for Message Digest algorithm 5.
 // MD5 is a robust hash function, designed for cyptography, but often used
@@ -30,8 +33,14 @@
 //   MD5Final(&digest, &ctx);
 //
 // You can call MD5DigestToBase16() to generate a string of the digest.
+//
+// MD5SumFile() hashes a file, and MD5SumMany() hashes a batch of independent
+// buffers at once.
 
 namespace base {
+
+	class FilePath;
+
 	// MD5_CBLOCK is the block size of MD5.
 	#define MD5_CBLOCK 64
 	// MD5_DIGEST_LENGTH is the length of an MD5 digest.
@@ -76,5 +85,18 @@ namespace base {
 	// Returns the MD5 (in hexadecimal) of a string.
 	BASE_EXPORT std::string MD5String(const std::string_view& str);
 
+	// Computes the MD5 sum of the file at |path| into |digest|. The file is
+	// read through a memory mapping, opened for sequential access, and each
+	// chunk is paged in ahead while the one before it is hashed. Returns false
+	// if the file cannot be opened or mapped.
+	BASE_EXPORT bool MD5SumFile(const FilePath& path, MD5Digest* digest);
+
+	// Computes the MD5 sum of each of |inputs| into the matching entry of
+	// |digests|, which must have the same size. The inputs are hashed side by
+	// side in the lanes of vector registers, several times faster than one by
+	// one when there are many small ones, such as cache entries to validate.
+	BASE_EXPORT void MD5SumMany(span<const std::string_view> inputs,
+		span<MD5Digest> digests);
+
 }  // namespace base
 
@@ -4,186 +4,370 @@
 
 #include "hash/sha1.h"
 
-#include <cstdint>
+#include <algorithm>
 #include <cstring>
+#include <utility>
 
-#include "sys_byteorder.h"
+#include "cpu.h"
+#include "hash/simd_lanes_internal.h"
+#include "logging.h"
 
 namespace base {
 
-	// Implementation of SHA-1. Only handles data in byte-sized blocks,
-	// which simplifies the code a fair bit.
+	// Implementation of SHA-1. Messages are whole bytes, never a bit count
+	// that is not a multiple of 8. Whole 64-byte blocks are hashed straight
+	// from the input, with the SHA instructions or SSSE3 if available.
 
 	// Identifier names follow notation in FIPS PUB 180-3, where you'll
 	// also find a description of the algorithm:
 	// http://csrc.nist.gov/publications/fips/fips180-3/fips180-3_final.pdf
 
-	// Usage example:
-	//
-	// SecureHashAlgorithm sha;
-	// while(there is data to hash)
-	//   sha.Update(moredata, size of data);
-	// sha.Final();
-	// memcpy(somewhere, sha.Digest(), 20);
-	//
-	// to reuse the instance of sha, call sha.Init();
+	namespace {
 
-	class SecureHashAlgorithm {
-	public:
-		SecureHashAlgorithm() { Init(); }
+		constexpr size_t kBlockSize = internal::kHashBlockSize;
 
-		static const int kDigestSizeBytes;
+		constexpr uint32_t kInitialState[5] = {
+			0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
 
-		void Init();
-		void Update(const void* data, size_t nbytes);
-		void Final();
+		// K(t), which changes every 20 rounds.
+		constexpr uint32_t kK[4] = {
+			0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xca62c1d6 };
 
-		// 20 bytes of message digest.
-		[[nodiscard]] const unsigned char* Digest() const {
-			return reinterpret_cast<const unsigned char*>(H);
+		inline uint32_t S(uint32_t n, uint32_t X) {
+			return (X << n) | (X >> (32 - n));
 		}
 
-	private:
-		void Pad();
-		void Process();
+		inline uint32_t LoadBigEndian(const uint8_t* p) {
+			return (static_cast<uint32_t>(p[0]) << 24) |
+				(static_cast<uint32_t>(p[1]) << 16) |
+				(static_cast<uint32_t>(p[2]) << 8) | p[3];
+		}
 
-		uint32_t A, B, C, D, E;
+		void StoreDigest(const uint32_t state[5], SHA1Digest* digest) {
+			for (size_t i = 0; i < 5; ++i) {
+				(*digest)[4 * i] = static_cast<uint8_t>(state[i] >> 24);
+				(*digest)[4 * i + 1] = static_cast<uint8_t>(state[i] >> 16);
+				(*digest)[4 * i + 2] = static_cast<uint8_t>(state[i] >> 8);
+				(*digest)[4 * i + 3] = static_cast<uint8_t>(state[i]);
+			}
+		}
 
-		uint32_t H[5];
+		// Block functions. Each adds the |count| blocks at |blocks| to
+		// |state|, the hash values H0 to H4.
+		using ProcessBlocksFunction = void (*)(uint32_t state[5],
+			const uint8_t* blocks,
+			size_t count);
+
+		// The 80 rounds of a block, given W(t) + K(t) for each of them.
+		void Rounds(uint32_t state[5], const uint32_t wk[80]) {
+			uint32_t A = state[0];
+			uint32_t B = state[1];
+			uint32_t C = state[2];
+			uint32_t D = state[3];
+			uint32_t E = state[4];
+			const auto round = [&](uint32_t f, uint32_t wk) {
+				const uint32_t TEMP = S(5, A) + f + E + wk;
+				E = D;
+				D = C;
+				C = S(30, B);
+				B = A;
+				A = TEMP;
+			};
+			size_t t = 0;
+			for (; t < 20; ++t)
+				round(D ^ (B & (C ^ D)), wk[t]);
+			for (; t < 40; ++t)
+				round(B ^ C ^ D, wk[t]);
+			for (; t < 60; ++t)
+				round((B & C) | (D & (B | C)), wk[t]);
+			for (; t < 80; ++t)
+				round(B ^ C ^ D, wk[t]);
+			state[0] += A;
+			state[1] += B;
+			state[2] += C;
+			state[3] += D;
+			state[4] += E;
+		}
 
-		union {
+		void ProcessBlocksScalar(uint32_t state[5],
+			const uint8_t* blocks,
+			size_t count) {
 			uint32_t W[80];
-			uint8_t M[64];
-		};
-
-		uint32_t cursor;
-		uint64_t l;
-	};
-
-	static inline uint32_t f(uint32_t t, uint32_t B, uint32_t C, uint32_t D) {
-		if (t < 20)
-			return (B & C) | ((~B) & D);
-		if (t < 40)
-			return B ^ C ^ D;
-		if (t < 60)
-			return (B & C) | (B & D) | (C & D);
-		return B ^ C ^ D;
-	}
-
-	static inline uint32_t S(uint32_t n, uint32_t X) {
-		return (X << n) | (X >> (32 - n));
-	}
+			uint32_t wk[80];
+			for (; count; --count, blocks += kBlockSize) {
+				for (size_t t = 0; t < 16; ++t)
+					W[t] = LoadBigEndian(blocks + 4 * t);
+				for (size_t t = 16; t < 80; ++t)
+					W[t] = S(1, W[t - 3] ^ W[t - 8] ^ W[t - 14] ^ W[t - 16]);
+				for (size_t t = 0; t < 80; ++t)
+					wk[t] = W[t] + kK[t / 20];
+				Rounds(state, wk);
+			}
+		}
 
-	static inline uint32_t K(uint32_t t) {
-		if (t < 20)
-			return 0x5a827999;
-		if (t < 40)
-			return 0x6ed9eba1;
-		if (t < 60)
-			return 0x8f1bbcdc;
-		return 0xca62c1d6;
-	}
+#if defined(ARCH_CPU_X86_FAMILY)
+		// Computes the message schedule four words at a time, then runs the
+		// scalar rounds.
+		void ProcessBlocksSSSE3(uint32_t state[5],
+			const uint8_t* blocks,
+			size_t count) {
+			const __m128i byte_swap =
+				_mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+			const auto rotate_left_1 = [](__m128i x) {
+				return _mm_or_si128(_mm_slli_epi32(x, 1), _mm_srli_epi32(x, 31));
+			};
+			alignas(16) uint32_t wk[80];
+			for (; count; --count, blocks += kBlockSize) {
+				// The last 16 words of the schedule, W(t - 16) first.
+				__m128i W[4];
+				for (size_t i = 0; i < 4; ++i) {
+					W[i] = _mm_shuffle_epi8(_mm_loadu_si128(
+						reinterpret_cast<const __m128i*>(blocks + 16 * i)), byte_swap);
+					_mm_store_si128(reinterpret_cast<__m128i*>(wk + 4 * i),
+						_mm_add_epi32(W[i], _mm_set1_epi32(kK[0])));
+				}
+				for (size_t t = 16; t < 80; t += 4) {
+					const __m128i w16 = W[(t / 4) % 4];
+					const __m128i w12 = W[(t / 4 + 1) % 4];
+					const __m128i w8 = W[(t / 4 + 2) % 4];
+					const __m128i w4 = W[(t / 4 + 3) % 4];
+					// W(t + 3) depends on W(t), so it is first computed with 0 in
+					// its place and then corrected: S^1 distributes over xor.
+					__m128i x = _mm_xor_si128(
+						_mm_xor_si128(w16, _mm_alignr_epi8(w12, w16, 8)),
+						_mm_xor_si128(w8, _mm_srli_si128(w4, 4)));
+					x = rotate_left_1(x);
+					x = _mm_xor_si128(x, rotate_left_1(_mm_slli_si128(x, 12)));
+					W[(t / 4) % 4] = x;
+					_mm_store_si128(reinterpret_cast<__m128i*>(wk + t),
+						_mm_add_epi32(x, _mm_set1_epi32(kK[t / 20])));
+				}
+				Rounds(state, wk);
+			}
+		}
 
-	const int SecureHashAlgorithm::kDigestSizeBytes = 20;
-
-	void SecureHashAlgorithm::Init() {
-		A = 0;
-		B = 0;
-		C = 0;
-		D = 0;
-		E = 0;
-		cursor = 0;
-		l = 0;
-		H[0] = 0x67452301;
-		H[1] = 0xefcdab89;
-		H[2] = 0x98badcfe;
-		H[3] = 0x10325476;
-		H[4] = 0xc3d2e1f0;
-	}
+		// Rounds 4 * kGroup to 4 * kGroup + 3 with the SHA instructions. ABCD
+		// share a register, and E is folded into the message words, alternating
+		// between |e[0]| and |e[1]|. |messages| holds the next 16 words of the
+		// schedule, which the instructions extend 4 at a time.
+		template <int kGroup>
+		void ShaRounds(__m128i& abcd, __m128i(&e)[2], __m128i(&messages)[4]) {
+			const __m128i message = messages[kGroup % 4];
+			__m128i& e_current = e[kGroup % 2];
+			if constexpr (kGroup == 0)
+				e_current = _mm_add_epi32(e_current, message);
+			else
+				e_current = _mm_sha1nexte_epu32(e_current, message);
+			e[(kGroup + 1) % 2] = abcd;
+			if constexpr (kGroup >= 3 && kGroup <= 18) {
+				messages[(kGroup + 1) % 4] =
+					_mm_sha1msg2_epu32(messages[(kGroup + 1) % 4], message);
+			}
+			abcd = _mm_sha1rnds4_epu32(abcd, e_current, kGroup / 5);
+			if constexpr (kGroup >= 1 && kGroup <= 16) {
+				messages[(kGroup + 3) % 4] =
+					_mm_sha1msg1_epu32(messages[(kGroup + 3) % 4], message);
+			}
+			if constexpr (kGroup >= 2 && kGroup <= 17) {
+				messages[(kGroup + 2) % 4] =
+					_mm_xor_si128(messages[(kGroup + 2) % 4], message);
+			}
+		}
 
-	void SecureHashAlgorithm::Final() {
-		Pad();
-		Process();
+		template <int... kGroups>
+		void ShaBlockRounds(__m128i& abcd,
+			__m128i(&e)[2],
+			__m128i(&messages)[4],
+			std::integer_sequence<int, kGroups...>) {
+			(ShaRounds<kGroups>(abcd, e, messages), ...);
+		}
 
-		for (auto& t : H)
-			t = ByteSwap(t);
-	}
+		void ProcessBlocksSha(uint32_t state[5],
+			const uint8_t* blocks,
+			size_t count) {
+			const __m128i byte_swap = _mm_setr_epi8(
+				15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+			__m128i abcd = _mm_shuffle_epi32(
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0x1b);
+			__m128i e0 = _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0);
+			for (; count; --count, blocks += kBlockSize) {
+				const __m128i saved_abcd = abcd;
+				const __m128i saved_e = e0;
+				__m128i messages[4];
+				for (size_t i = 0; i < 4; ++i) {
+					messages[i] = _mm_shuffle_epi8(_mm_loadu_si128(
+						reinterpret_cast<const __m128i*>(blocks + 16 * i)), byte_swap);
+				}
+				__m128i e[2] = { e0, _mm_setzero_si128() };
+				ShaBlockRounds(abcd, e, messages,
+					std::make_integer_sequence<int, 20>());
+				e0 = _mm_sha1nexte_epu32(e[0], saved_e);
+				abcd = _mm_add_epi32(abcd, saved_abcd);
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(state),
+				_mm_shuffle_epi32(abcd, 0x1b));
+			state[4] = static_cast<uint32_t>(_mm_extract_epi32(e0, 3));
+		}
 
-	void SecureHashAlgorithm::Update(const void* data, size_t nbytes) {
-		const uint8_t* d = reinterpret_cast<const uint8_t*>(data);
-		while (nbytes--) {
-			M[cursor++] = *d++;
-			if (cursor >= 64)
-				Process();
-			l += 8;
+		// The SHA instructions only have legacy SSE encodings, which run many
+		// times slower while earlier AVX code has left the upper halves of the
+		// registers dirty. Clearing them takes an AVX instruction itself.
+		void ProcessBlocksShaAVX(uint32_t state[5],
+			const uint8_t* blocks,
+			size_t count) {
+			_mm256_zeroupper();
+			ProcessBlocksSha(state, blocks, count);
 		}
-	}
 
-	void SecureHashAlgorithm::Pad() {
-		M[cursor++] = 0x80;
+		// Adds one block of each lane's message to |state|, which holds H0 to
+		// H4 of every lane.
+		template <typename V>
+		void ProcessBlockInLanes(uint32_t state[5][internal::HashLanes<V>::kCount],
+			const uint8_t* const blocks[internal::HashLanes<V>::kCount]) {
+			using L = internal::HashLanes<V>;
+			V W[16];
+			for (size_t group = 0; group < 4; ++group) {
+				L::template LoadWords<internal::HashByteOrder::kBigEndian>(
+					blocks, group, W + 4 * group);
+			}
+
+			V A = L::Load(state[0]);
+			V B = L::Load(state[1]);
+			V C = L::Load(state[2]);
+			V D = L::Load(state[3]);
+			V E = L::Load(state[4]);
+			const auto round = [&](size_t t, V f, V k) {
+				if (t >= 16) {
+					W[t % 16] = L::template RotateLeft<1>(L::Xor(
+						L::Xor(W[(t - 3) % 16], W[(t - 8) % 16]),
+						L::Xor(W[(t - 14) % 16], W[t % 16])));
+				}
+				const V TEMP = L::Add(L::Add(L::template RotateLeft<5>(A), f),
+					L::Add(L::Add(E, W[t % 16]), k));
+				E = D;
+				D = C;
+				C = L::template RotateLeft<30>(B);
+				B = A;
+				A = TEMP;
+			};
+			size_t t = 0;
+			for (const V k = L::Set1(kK[0]); t < 20; ++t)
+				round(t, L::Xor(D, L::And(B, L::Xor(C, D))), k);
+			for (const V k = L::Set1(kK[1]); t < 40; ++t)
+				round(t, L::Xor(L::Xor(B, C), D), k);
+			for (const V k = L::Set1(kK[2]); t < 60; ++t)
+				round(t, L::Or(L::And(B, C), L::And(D, L::Or(B, C))), k);
+			for (const V k = L::Set1(kK[3]); t < 80; ++t)
+				round(t, L::Xor(L::Xor(B, C), D), k);
+
+			L::Store(state[0], L::Add(L::Load(state[0]), A));
+			L::Store(state[1], L::Add(L::Load(state[1]), B));
+			L::Store(state[2], L::Add(L::Load(state[2]), C));
+			L::Store(state[3], L::Add(L::Load(state[3]), D));
+			L::Store(state[4], L::Add(L::Load(state[4]), E));
+		}
+#endif  // defined(ARCH_CPU_X86_FAMILY)
+
+		// Picks the fastest block function the processor supports. Done once per
+		// process.
+		ProcessBlocksFunction GetProcessBlocksFunction() {
+			static const ProcessBlocksFunction process_blocks = [] {
+#if defined(ARCH_CPU_X86_FAMILY)
+				const CPU cpu;
+				if (cpu.has_sha() && cpu.has_sse41())
+					return cpu.has_avx() ? &ProcessBlocksShaAVX : &ProcessBlocksSha;
+				if (cpu.has_ssse3())
+					return &ProcessBlocksSSSE3;
+#endif
+				return &ProcessBlocksScalar;
+			}();
+			return process_blocks;
+		}
 
-		if (cursor > 64 - 8) {
-			// pad out to next block
-			while (cursor < 64)
-				M[cursor++] = 0;
+		// Multi-buffer functions. Each hashes every input into the digest at the
+		// same index.
+		using HashManyFunction = void (*)(span<const std::string_view> inputs,
+			span<SHA1Digest> digests);
+
+		void HashManyOneByOne(span<const std::string_view> inputs,
+			span<SHA1Digest> digests) {
+			for (size_t i = 0; i < inputs.size(); ++i) {
+				SHA1Context context;
+				SHA1Init(&context);
+				SHA1Update(&context, inputs[i]);
+				SHA1Final(&digests[i], &context);
+			}
+		}
 
-			Process();
+#if defined(ARCH_CPU_X86_FAMILY)
+		template <typename V>
+		void HashManyInLanes(span<const std::string_view> inputs,
+			span<SHA1Digest> digests) {
+			internal::HashManyInLanes<V, 5, internal::HashByteOrder::kBigEndian>(
+				inputs, digests, kInitialState, &ProcessBlockInLanes<V>);
+		}
+#endif  // defined(ARCH_CPU_X86_FAMILY)
+
+		// Eight AVX2 lanes outrun the SHA instructions, which in turn outrun
+		// four SSSE3 lanes.
+		HashManyFunction GetHashManyFunction() {
+			static const HashManyFunction hash_many = [] {
+#if defined(ARCH_CPU_X86_FAMILY)
+				const CPU cpu;
+				if (cpu.has_avx2())
+					return &HashManyInLanes<__m256i>;
+				if (cpu.has_sha() && cpu.has_sse41())
+					return &HashManyOneByOne;
+				if (cpu.has_ssse3())
+					return &HashManyInLanes<__m128i>;
+#endif
+				return &HashManyOneByOne;
+			}();
+			return hash_many;
 		}
 
-		while (cursor < 64 - 8)
-			M[cursor++] = 0;
+	}  // namespace
 
-		M[cursor++] = (l >> 56) & 0xff;
-		M[cursor++] = (l >> 48) & 0xff;
-		M[cursor++] = (l >> 40) & 0xff;
-		M[cursor++] = (l >> 32) & 0xff;
-		M[cursor++] = (l >> 24) & 0xff;
-		M[cursor++] = (l >> 16) & 0xff;
-		M[cursor++] = (l >> 8) & 0xff;
-		M[cursor++] = l & 0xff;
+	void SHA1Init(SHA1Context* context) {
+		memcpy(context->state, kInitialState, sizeof(kInitialState));
+		context->length = 0;
 	}
 
-	void SecureHashAlgorithm::Process() {
-		uint32_t t;
-
-		// Each a...e corresponds to a section in the FIPS 180-3 algorithm.
-
-		// a.
-		//
-		// W and M are in a union, so no need to memcpy.
-		// memcpy(W, M, sizeof(M));
-		for (t = 0; t < 16; ++t)
-			W[t] = ByteSwap(W[t]);
-
-		// b.
-		for (t = 16; t < 80; ++t)
-			W[t] = S(1, W[t - 3] ^ W[t - 8] ^ W[t - 14] ^ W[t - 16]);
-
-		// c.
-		A = H[0];
-		B = H[1];
-		C = H[2];
-		D = H[3];
-		E = H[4];
-
-		// d.
-		for (t = 0; t < 80; ++t) {
-			const uint32_t TEMP = S(5, A) + f(t, B, C, D) + E + W[t] + K(t);
-			E = D;
-			D = C;
-			C = S(30, B);
-			B = A;
-			A = TEMP;
-		}
-
-		// e.
-		H[0] += A;
-		H[1] += B;
-		H[2] += C;
-		H[3] += D;
-		H[4] += E;
-
-		cursor = 0;
+	void SHA1Update(SHA1Context* context, std::string_view data) {
+		const auto* bytes = reinterpret_cast<const uint8_t*>(data.data());
+		size_t size = data.size();
+		size_t buffered = context->length % kBlockSize;
+		context->length += size;
+		const ProcessBlocksFunction process_blocks = GetProcessBlocksFunction();
+		if (buffered) {
+			const size_t copied = std::min(kBlockSize - buffered, size);
+			memcpy(context->buffer + buffered, bytes, copied);
+			bytes += copied;
+			size -= copied;
+			if (buffered + copied < kBlockSize)
+				return;
+			process_blocks(context->state, context->buffer, 1);
+		}
+		process_blocks(context->state, bytes, size / kBlockSize);
+		if (size % kBlockSize) {
+			memcpy(context->buffer, bytes + size / kBlockSize * kBlockSize,
+				size % kBlockSize);
+		}
+	}
+
+	void SHA1Final(SHA1Digest* digest, SHA1Context* context) {
+		uint8_t tail[2 * kBlockSize];
+		const size_t blocks = internal::PadHashTail<internal::HashByteOrder::kBigEndian>(
+			context->buffer,
+			context->length % kBlockSize, context->length, tail);
+		GetProcessBlocksFunction()(context->state, tail, blocks);
+		StoreDigest(context->state, digest);
+	}
+
+	void SHA1HashMany(span<const std::string_view> inputs,
+		span<SHA1Digest> digests) {
+		CHECK_EQ(inputs.size(), digests.size());
+		GetHashManyFunction()(inputs, digests);
 	}
 
 	std::array<uint8_t, kSHA1Length> SHA1HashSpan(span<const uint8_t> data) {
@@ -193,18 +377,20 @@ namespace base {
 	}
 
 	std::string SHA1HashString(const std::string& str) {
-		char hash[SecureHashAlgorithm::kDigestSizeBytes];
+		char hash[kSHA1Length];
 		SHA1HashBytes(reinterpret_cast<const unsigned char*>(str.c_str()),
 			str.length(), reinterpret_cast<unsigned char*>(hash));
-		return std::string(hash, SecureHashAlgorithm::kDigestSizeBytes);
+		return std::string(hash, kSHA1Length);
 	}
 
 	void SHA1HashBytes(const unsigned char* data, size_t len, unsigned char* hash) {
-		SecureHashAlgorithm sha;
-		sha.Update(data, len);
-		sha.Final();
-
-		memcpy(hash, sha.Digest(), SecureHashAlgorithm::kDigestSizeBytes);
+		SHA1Context context;
+		SHA1Init(&context);
+		SHA1Update(&context,
+			std::string_view(reinterpret_cast<const char*>(data), len));
+		SHA1Digest digest;
+		SHA1Final(&digest, &context);
+		memcpy(hash, digest.data(), kSHA1Length);
 	}
 
 }  // namespace base
@@ -5,7 +5,10 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 #include <string>
+#include <string_view>
+
 #include "base_export.h"
 #include "containers/span.h"
 
@@ -15,6 +18,9 @@ namespace base {
 
 	enum { kSHA1Length = 20 };  // Length in bytes of a SHA-1 hash.
 
+	// The output of a SHA-1 operation.
+	using SHA1Digest = std::array<uint8_t, kSHA1Length>;
+
 	// Computes the SHA-1 hash of the input |data| and returns the full hash.
 	BASE_EXPORT std::array<uint8_t, kSHA1Length> SHA1HashSpan(
 		span<const uint8_t> data);
@@ -29,5 +35,44 @@ namespace base {
 		size_t len,
 		unsigned char* hash);
 
-}  // namespace base
+	// Used for storing intermediate data during a SHA-1 computation. Callers
+	// should not access the data.
+	struct SHA1Context {
+		uint32_t state[5];
+		// Bytes hashed so far.
+		uint64_t length;
+		// The start of an incomplete block.
+		uint8_t buffer[64];
+	};
+
+	// The SHA-1 of data that arrives in pieces, such as a large file read a
+	// buffer at a time, is computed incrementally:
+	//   SHA1Context context;
+	//   SHA1Init(&context);
+	//   SHA1Update(&context, data1);
+	//   SHA1Update(&context, data2);
+	//   ...
+	//   SHA1Digest digest;
+	//   SHA1Final(&digest, &context);
+
+	// Initializes the given SHA-1 context structure for subsequent calls to
+	// SHA1Update().
+	BASE_EXPORT void SHA1Init(SHA1Context* context);
 
+	// Adds |data| to the hash. Can be called any number of times between
+	// SHA1Init() and SHA1Final().
+	BASE_EXPORT void SHA1Update(SHA1Context* context, std::string_view data);
+
+	// Finalizes the SHA-1 operation and fills |digest| with the hash.
+	// SHA1Init() must be called again before the context is reused.
+	BASE_EXPORT void SHA1Final(SHA1Digest* digest, SHA1Context* context);
+
+	// Computes the SHA-1 hash of each of |inputs| into the matching entry of
+	// |digests|, which must have the same size. For many small inputs, such as
+	// the entries of a cache, this is several times faster than hashing them
+	// one by one: they are hashed side by side in the lanes of vector
+	// registers.
+	BASE_EXPORT void SHA1HashMany(span<const std::string_view> inputs,
+		span<SHA1Digest> digests);
+
+}  // namespace base
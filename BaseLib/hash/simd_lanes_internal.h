@@ -0,0 +1,260 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <immintrin.h>
+#endif
+
+#include "containers/span.h"
+#include "logging.h"
+
+// Helpers shared by the MD5 and SHA-1 implementations, which both work on
+// 64-byte blocks of 32-bit words and differ mostly in the byte order of
+// those words, the length and the digest.
+
+namespace base {
+	namespace internal {
+
+		constexpr size_t kHashBlockSize = 64;
+
+		enum class HashByteOrder {
+			kLittleEndian,  // MD5.
+			kBigEndian,     // SHA-1.
+		};
+
+		// Writes the last |size| bytes of a message of |length| bytes, fewer
+		// than a block, followed by the padding, to |tail|. Returns the number
+		// of blocks written, 1 or 2.
+		template <HashByteOrder kOrder>
+		size_t PadHashTail(const uint8_t* data,
+			size_t size,
+			uint64_t length,
+			uint8_t tail[2 * kHashBlockSize]) {
+			DCHECK_LT(size, kHashBlockSize);
+			const size_t blocks = size < kHashBlockSize - 8 ? 1 : 2;
+			const size_t tail_size = blocks * kHashBlockSize;
+			memcpy(tail, data, size);
+			tail[size] = 0x80;
+			memset(tail + size + 1, 0, tail_size - 8 - size - 1);
+			const uint64_t bits = length * 8;
+			for (size_t i = 0; i < 8; ++i) {
+				const size_t index = kOrder == HashByteOrder::kBigEndian
+					? tail_size - 1 - i : tail_size - 8 + i;
+				tail[index] = static_cast<uint8_t>(bits >> (8 * i));
+			}
+			return blocks;
+		}
+
+#if defined(ARCH_CPU_X86_FAMILY)
+		// Operations on one 32-bit word of each of 4 or 8 messages, for
+		// hashing them side by side.
+		template <typename V>
+		struct HashLanes;
+
+		template <>
+		struct HashLanes<__m128i> {
+			static constexpr size_t kCount = 4;
+
+			static __m128i Load(const uint32_t* p) {
+				return _mm_load_si128(reinterpret_cast<const __m128i*>(p));
+			}
+			static void Store(uint32_t* p, __m128i v) {
+				_mm_store_si128(reinterpret_cast<__m128i*>(p), v);
+			}
+			static __m128i Set1(uint32_t x) {
+				return _mm_set1_epi32(static_cast<int>(x));
+			}
+			static __m128i Add(__m128i a, __m128i b) { return _mm_add_epi32(a, b); }
+			static __m128i And(__m128i a, __m128i b) { return _mm_and_si128(a, b); }
+			static __m128i Or(__m128i a, __m128i b) { return _mm_or_si128(a, b); }
+			static __m128i Xor(__m128i a, __m128i b) { return _mm_xor_si128(a, b); }
+			template <int n>
+			static __m128i RotateLeft(__m128i x) {
+				return _mm_or_si128(_mm_slli_epi32(x, n), _mm_srli_epi32(x, 32 - n));
+			}
+
+			// Sets |words| to words 4 * |group| to 4 * |group| + 3 of each
+			// block by transposing the 4 x 4 words loaded. Big endian words are
+			// byte swapped, which takes SSSE3; little endian ones only SSE2.
+			template <HashByteOrder kOrder>
+			static void LoadWords(const uint8_t* const blocks[kCount],
+				size_t group,
+				__m128i words[4]) {
+				__m128i rows[4];
+				for (size_t i = 0; i < 4; ++i) {
+					rows[i] = _mm_loadu_si128(
+						reinterpret_cast<const __m128i*>(blocks[i] + 16 * group));
+					if constexpr (kOrder == HashByteOrder::kBigEndian) {
+						rows[i] = _mm_shuffle_epi8(rows[i], _mm_setr_epi8(
+							3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+					}
+				}
+				const __m128i low01 = _mm_unpacklo_epi32(rows[0], rows[1]);
+				const __m128i low23 = _mm_unpacklo_epi32(rows[2], rows[3]);
+				const __m128i high01 = _mm_unpackhi_epi32(rows[0], rows[1]);
+				const __m128i high23 = _mm_unpackhi_epi32(rows[2], rows[3]);
+				words[0] = _mm_unpacklo_epi64(low01, low23);
+				words[1] = _mm_unpackhi_epi64(low01, low23);
+				words[2] = _mm_unpacklo_epi64(high01, high23);
+				words[3] = _mm_unpackhi_epi64(high01, high23);
+			}
+		};
+
+		template <>
+		struct HashLanes<__m256i> {
+			static constexpr size_t kCount = 8;
+
+			static __m256i Load(const uint32_t* p) {
+				return _mm256_load_si256(reinterpret_cast<const __m256i*>(p));
+			}
+			static void Store(uint32_t* p, __m256i v) {
+				_mm256_store_si256(reinterpret_cast<__m256i*>(p), v);
+			}
+			static __m256i Set1(uint32_t x) {
+				return _mm256_set1_epi32(static_cast<int>(x));
+			}
+			static __m256i Add(__m256i a, __m256i b) {
+				return _mm256_add_epi32(a, b);
+			}
+			static __m256i And(__m256i a, __m256i b) {
+				return _mm256_and_si256(a, b);
+			}
+			static __m256i Or(__m256i a, __m256i b) { return _mm256_or_si256(a, b); }
+			static __m256i Xor(__m256i a, __m256i b) {
+				return _mm256_xor_si256(a, b);
+			}
+			template <int n>
+			static __m256i RotateLeft(__m256i x) {
+				return _mm256_or_si256(_mm256_slli_epi32(x, n),
+					_mm256_srli_epi32(x, 32 - n));
+			}
+
+			// As above, with blocks 4 to 7 in the high 128-bit lanes; the
+			// unpacks work within 128-bit lanes.
+			template <HashByteOrder kOrder>
+			static void LoadWords(const uint8_t* const blocks[kCount],
+				size_t group,
+				__m256i words[4]) {
+				__m256i rows[4];
+				for (size_t i = 0; i < 4; ++i) {
+					rows[i] = _mm256_inserti128_si256(
+						_mm256_castsi128_si256(_mm_loadu_si128(
+							reinterpret_cast<const __m128i*>(blocks[i] + 16 * group))),
+						_mm_loadu_si128(reinterpret_cast<const __m128i*>(
+							blocks[i + 4] + 16 * group)), 1);
+					if constexpr (kOrder == HashByteOrder::kBigEndian) {
+						rows[i] = _mm256_shuffle_epi8(rows[i], _mm256_setr_epi8(
+							3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+							3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+					}
+				}
+				const __m256i low01 = _mm256_unpacklo_epi32(rows[0], rows[1]);
+				const __m256i low23 = _mm256_unpacklo_epi32(rows[2], rows[3]);
+				const __m256i high01 = _mm256_unpackhi_epi32(rows[0], rows[1]);
+				const __m256i high23 = _mm256_unpackhi_epi32(rows[2], rows[3]);
+				words[0] = _mm256_unpacklo_epi64(low01, low23);
+				words[1] = _mm256_unpackhi_epi64(low01, low23);
+				words[2] = _mm256_unpacklo_epi64(high01, high23);
+				words[3] = _mm256_unpackhi_epi64(high01, high23);
+			}
+		};
+
+		// Hashes each of |inputs| into the digest at the same index, a block of
+		// each of several messages at a time. |transform| adds one block of
+		// each lane's message to the state of every lane:
+		//   void transform(uint32_t state[kStateWords][HashLanes<V>::kCount],
+		//       const uint8_t* const blocks[HashLanes<V>::kCount]);
+		// Each lane takes the next message as soon as it is done with one, so
+		// messages of different sizes keep all lanes busy until the last few;
+		// lanes left without a message hash a dummy block. Digests are the
+		// final state words in |kOrder|.
+		template <typename V,
+			size_t kStateWords,
+			HashByteOrder kOrder,
+			typename Digest,
+			typename Transform>
+		void HashManyInLanes(span<const std::string_view> inputs,
+			span<Digest> digests,
+			const uint32_t(&initial_state)[kStateWords],
+			Transform transform) {
+			static_assert(sizeof(Digest) == 4 * kStateWords,
+				"Digest must hold exactly the state words");
+			constexpr size_t kCount = HashLanes<V>::kCount;
+			struct Lane {
+				size_t input;
+				const uint8_t* data;
+				size_t whole_blocks;
+				size_t blocks;
+				size_t next_block;
+				uint8_t tail[2 * kHashBlockSize];
+			};
+			static constexpr uint8_t kIdleBlock[kHashBlockSize] = {};
+
+			alignas(32) uint32_t state[kStateWords][kCount];
+			Lane lanes[kCount];
+			const uint8_t* blocks[kCount];
+			size_t next_input = 0;
+			size_t busy_lanes = 0;
+			const auto start = [&](size_t lane_index) {
+				Lane& lane = lanes[lane_index];
+				if (next_input == inputs.size()) {
+					lane.input = inputs.size();
+					return;
+				}
+				const std::string_view input = inputs[next_input];
+				lane.input = next_input++;
+				lane.data = reinterpret_cast<const uint8_t*>(input.data());
+				lane.whole_blocks = input.size() / kHashBlockSize;
+				lane.blocks = lane.whole_blocks + PadHashTail<kOrder>(
+					lane.data + lane.whole_blocks * kHashBlockSize,
+					input.size() % kHashBlockSize, input.size(), lane.tail);
+				lane.next_block = 0;
+				for (size_t i = 0; i < kStateWords; ++i)
+					state[i][lane_index] = initial_state[i];
+				++busy_lanes;
+			};
+			for (size_t i = 0; i < kCount; ++i)
+				start(i);
+
+			while (busy_lanes) {
+				for (size_t i = 0; i < kCount; ++i) {
+					const Lane& lane = lanes[i];
+					if (lane.input == inputs.size())
+						blocks[i] = kIdleBlock;
+					else if (lane.next_block < lane.whole_blocks)
+						blocks[i] = lane.data + lane.next_block * kHashBlockSize;
+					else
+						blocks[i] = lane.tail + (lane.next_block - lane.whole_blocks) * kHashBlockSize;
+				}
+				transform(state, blocks);
+				for (size_t i = 0; i < kCount; ++i) {
+					Lane& lane = lanes[i];
+					if (lane.input == inputs.size() || ++lane.next_block < lane.blocks)
+						continue;
+					auto* digest = reinterpret_cast<uint8_t*>(&digests[lane.input]);
+					for (size_t j = 0; j < kStateWords; ++j) {
+						for (size_t k = 0; k < 4; ++k) {
+							const size_t shift = kOrder == HashByteOrder::kBigEndian
+								? 8 * (3 - k) : 8 * k;
+							digest[4 * j + k] = static_cast<uint8_t>(state[j][i] >> shift);
+						}
+					}
+					--busy_lanes;
+					start(i);
+				}
+			}
+		}
+#endif  // defined(ARCH_CPU_X86_FAMILY)
+
+	}  // namespace internal
+}  // namespace base
@@ -0,0 +1,279 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "json/json_arena_document.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "logging.h"
+#include "memory/monotonic_arena.h"
+#include "strings/string_util.h"
+
+namespace base {
+
+	// ArenaValue //////////////////////////////////////////////////////////////////
+
+	bool ArenaValue::GetBool() const {
+		CHECK(is_bool());
+		return bool_value_;
+	}
+
+	int ArenaValue::GetInt() const {
+		CHECK(is_int());
+		return int_value_;
+	}
+
+	double ArenaValue::GetDouble() const {
+		if (is_double())
+			return double_value_;
+		if (is_int())
+			return int_value_;
+		CHECK(false);
+		return 0.0;
+	}
+
+	std::string_view ArenaValue::GetString() const {
+		CHECK(is_string());
+		return std::string_view(string_value_, size_);
+	}
+
+	span<const ArenaValue> ArenaValue::GetList() const {
+		CHECK(is_list());
+		return span<const ArenaValue>(list_, size_);
+	}
+
+	span<const ArenaValue::Member> ArenaValue::DictItems() const {
+		CHECK(is_dict());
+		return span<const Member>(dict_, size_);
+	}
+
+	size_t ArenaValue::DictSize() const {
+		CHECK(is_dict());
+		return size_;
+	}
+
+	const ArenaValue* ArenaValue::FindKey(std::string_view key) const {
+		const span<const Member> items = DictItems();
+		const auto found = std::lower_bound(
+			items.begin(), items.end(), key,
+			[](const Member& member, std::string_view key) {
+				return member.key < key;
+			});
+		if (found == items.end() || found->key != key)
+			return nullptr;
+		return &found->value;
+	}
+
+	const ArenaValue* ArenaValue::FindPath(std::string_view path) const {
+		const ArenaValue* cur = this;
+		size_t start = 0;
+		while (true) {
+			if (!cur->is_dict())
+				return nullptr;
+			const size_t dot = path.find('.', start);
+			cur = cur->FindKey(path.substr(start, dot == std::string_view::npos
+				? std::string_view::npos : dot - start));
+			if (!cur || dot == std::string_view::npos)
+				return cur;
+			start = dot + 1;
+		}
+	}
+
+	Value ArenaValue::ToValue() const {
+		switch (type_) {
+		case Value::Type::BOOLEAN:
+			return Value(bool_value_);
+		case Value::Type::INTEGER:
+			return Value(int_value_);
+		case Value::Type::DOUBLE:
+			return Value(double_value_);
+		case Value::Type::STRING:
+			return Value(GetString());
+		case Value::Type::LIST: {
+			Value::ListStorage list;
+			list.reserve(size_);
+			for (const ArenaValue& element : GetList())
+				list.push_back(element.ToValue());
+			return Value(std::move(list));
+		}
+		case Value::Type::DICTIONARY: {
+			// The vector constructor of flat_map sorts and deduplicates the
+			// members again, even though they already are sorted and unique, but
+			// building the vector first still avoids inserting them one by one.
+			std::vector<Value::DictStorage::value_type> storage;
+			storage.reserve(size_);
+			for (const Member& member : DictItems()) {
+				storage.emplace_back(std::string(member.key),
+					std::make_unique<Value>(member.value.ToValue()));
+			}
+			return Value(Value::DictStorage(std::move(storage)));
+		}
+		default:
+			return Value();
+		}
+	}
+
+	// JSONArenaDocument ///////////////////////////////////////////////////////////
+
+	JSONArenaDocument::JSONArenaDocument(std::unique_ptr<MonotonicArena> arena,
+		const ArenaValue* root)
+		: arena_(std::move(arena)), root_(root) {
+		DCHECK(root_);
+	}
+
+	JSONArenaDocument::JSONArenaDocument(JSONArenaDocument&& other) noexcept =
+		default;
+
+	JSONArenaDocument& JSONArenaDocument::operator=(
+		JSONArenaDocument&& other) noexcept = default;
+
+	JSONArenaDocument::~JSONArenaDocument() = default;
+
+	size_t JSONArenaDocument::EstimateMemoryUsage() const {
+		return sizeof(MonotonicArena) + arena_->bytes_reserved();
+	}
+
+	namespace internal {
+
+		// ArenaValueBuilder ///////////////////////////////////////////////////////
+
+		ArenaValueBuilder::ArenaValueBuilder(MonotonicArena* arena,
+			std::string_view borrowable_input)
+			: arena_(arena), borrowable_input_(borrowable_input) {}
+
+		ArenaValueBuilder::~ArenaValueBuilder() = default;
+
+		bool ArenaValueBuilder::OnDictBegin() {
+			return BeginContainer();
+		}
+
+		bool ArenaValueBuilder::OnDictEnd() {
+			const auto begin = pending_.begin() + EndContainer();
+
+			// Sort by key, keeping only the last of several members with the same
+			// key, which is what a Value built from the same input would hold.
+			std::stable_sort(begin, pending_.end(),
+				[](const ArenaValue::Member& a, const ArenaValue::Member& b) {
+					return a.key < b.key;
+				});
+			auto out = begin;
+			for (auto it = begin; it != pending_.end(); ++it) {
+				if (it + 1 != pending_.end() && it[1].key == it->key)
+					continue;
+				*out++ = *it;
+			}
+
+			const size_t count = out - begin;
+			ArenaValue::Member* members =
+				arena_->AllocateArray<ArenaValue::Member>(count);
+			std::uninitialized_copy(begin, out, members);
+			pending_.erase(begin, pending_.end());
+
+			ArenaValue dict;
+			dict.type_ = Value::Type::DICTIONARY;
+			dict.size_ = static_cast<uint32_t>(count);
+			dict.dict_ = members;
+			return Add(dict);
+		}
+
+		bool ArenaValueBuilder::OnListBegin() {
+			return BeginContainer();
+		}
+
+		bool ArenaValueBuilder::OnListEnd() {
+			const auto begin = pending_.begin() + EndContainer();
+
+			const size_t count = pending_.end() - begin;
+			auto* elements = arena_->AllocateArray<ArenaValue>(count);
+			for (size_t i = 0; i < count; ++i)
+				new (&elements[i]) ArenaValue(begin[i].value);
+			pending_.erase(begin, pending_.end());
+
+			ArenaValue list;
+			list.type_ = Value::Type::LIST;
+			list.size_ = static_cast<uint32_t>(count);
+			list.list_ = elements;
+			return Add(list);
+		}
+
+		bool ArenaValueBuilder::OnKey(std::string_view key) {
+			key_ = Store(key);
+			return true;
+		}
+
+		bool ArenaValueBuilder::OnString(std::string_view value) {
+			const std::string_view stored = Store(value);
+			ArenaValue string;
+			string.type_ = Value::Type::STRING;
+			string.size_ = static_cast<uint32_t>(stored.size());
+			string.string_value_ = stored.data();
+			return Add(string);
+		}
+
+		bool ArenaValueBuilder::OnInt(int value) {
+			ArenaValue integer;
+			integer.type_ = Value::Type::INTEGER;
+			integer.int_value_ = value;
+			return Add(integer);
+		}
+
+		bool ArenaValueBuilder::OnDouble(double value) {
+			ArenaValue number;
+			number.type_ = Value::Type::DOUBLE;
+			number.double_value_ = value;
+			return Add(number);
+		}
+
+		bool ArenaValueBuilder::OnBool(bool value) {
+			ArenaValue boolean;
+			boolean.type_ = Value::Type::BOOLEAN;
+			boolean.bool_value_ = value;
+			return Add(boolean);
+		}
+
+		bool ArenaValueBuilder::OnNull() {
+			return Add(ArenaValue());
+		}
+
+		bool ArenaValueBuilder::Add(const ArenaValue& value) {
+			if (open_.empty()) {
+				auto* root = arena_->AllocateArray<ArenaValue>(1);
+				*root = value;
+				root_ = root;
+				return true;
+			}
+			pending_.push_back(ArenaValue::Member{ key_, value });
+			key_ = std::string_view();
+			return true;
+		}
+
+		std::string_view ArenaValueBuilder::Store(std::string_view str) {
+			// The parser hands out views of the input for strings without escape
+			// sequences, and of its own scratch buffer otherwise.
+			const char* const begin = borrowable_input_.data();
+			if (begin && str.data() >= begin &&
+				str.data() + str.size() <= begin + borrowable_input_.size()) {
+				return str;
+			}
+			return arena_->CopyString(str);
+		}
+
+		bool ArenaValueBuilder::BeginContainer() {
+			open_.emplace_back(pending_.size(), key_);
+			key_ = std::string_view();
+			return true;
+		}
+
+		size_t ArenaValueBuilder::EndContainer() {
+			DCHECK(!open_.empty());
+			const size_t start = open_.back().first;
+			key_ = open_.back().second;
+			open_.pop_back();
+			return start;
+		}
+
+	}  // namespace internal
+
+}  // namespace base
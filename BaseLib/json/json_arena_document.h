@@ -0,0 +1,185 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <cstdint>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base_export.h"
+#include "containers/span.h"
+#include "json/json_event_handler.h"
+#include "macros.h"
+#include "values.h"
+
+namespace base {
+
+	class MonotonicArena;
+
+	namespace internal {
+		class ArenaValueBuilder;
+	}  // namespace internal
+
+	// A read-only JSON value living in the MonotonicArena of a JSONArenaDocument.
+	// It mirrors the reading half of the Value API, but its strings, list
+	// elements and dictionary members are all placed in the arena, so building a
+	// document costs a few large allocations instead of one per node, and
+	// destroying it frees everything at once.
+	//
+	// ArenaValues are only valid as long as the document that owns them, and
+	// with JSON_BORROW_INPUT_STRINGS, as long as the input it was parsed from.
+	// Use ToValue() to obtain an independent Value.
+	class BASE_EXPORT ArenaValue {
+	public:
+		struct Member;
+
+		[[nodiscard]] Value::Type type() const { return type_; }
+
+		[[nodiscard]] bool is_none() const { return type() == Value::Type::NONE; }
+		[[nodiscard]] bool is_bool() const { return type() == Value::Type::BOOLEAN; }
+		[[nodiscard]] bool is_int() const { return type() == Value::Type::INTEGER; }
+		[[nodiscard]] bool is_double() const { return type() == Value::Type::DOUBLE; }
+		[[nodiscard]] bool is_string() const { return type() == Value::Type::STRING; }
+		[[nodiscard]] bool is_dict() const { return type() == Value::Type::DICTIONARY; }
+		[[nodiscard]] bool is_list() const { return type() == Value::Type::LIST; }
+
+		// These will all CHECK that the type matches.
+		[[nodiscard]] bool GetBool() const;
+		[[nodiscard]] int GetInt() const;
+		[[nodiscard]] double GetDouble() const;  // Implicitly converts from int.
+		[[nodiscard]] std::string_view GetString() const;
+		[[nodiscard]] span<const ArenaValue> GetList() const;
+
+		// Dictionary members, sorted by key. Like Value, a dictionary holds the
+		// last of several members with the same key in the input.
+		// Note: These CHECK that type() is Type::DICTIONARY.
+		[[nodiscard]] span<const Member> DictItems() const;
+		[[nodiscard]] size_t DictSize() const;
+
+		// Looks up |key| with a binary search. Returns nullptr if not found.
+		// Note: This CHECKs that type() is Type::DICTIONARY.
+		[[nodiscard]] const ArenaValue* FindKey(std::string_view key) const;
+
+		// Follows a dot-separated |path| of dictionary keys, like
+		// Value::FindPath(). Returns nullptr if any component is missing.
+		[[nodiscard]] const ArenaValue* FindPath(std::string_view path) const;
+
+		// Returns a deep copy of this value as a regular heap-allocated Value.
+		[[nodiscard]] Value ToValue() const;
+
+	private:
+		friend class internal::ArenaValueBuilder;
+
+		ArenaValue() : type_(Value::Type::NONE), size_(0), int_value_(0) {}
+
+		Value::Type type_;
+
+		// Length of the string, or number of list elements or dictionary members.
+		uint32_t size_;
+
+		union {
+			bool bool_value_;
+			int int_value_;
+			double double_value_;
+			const char* string_value_;
+			const ArenaValue* list_;
+			const Member* dict_;
+		};
+	};
+
+	struct ArenaValue::Member {
+		std::string_view key;
+		ArenaValue value;
+	};
+
+	// Owns the arena that holds the ArenaValue tree produced by
+	// JSONReader::ReadToArena().
+	class BASE_EXPORT JSONArenaDocument {
+	public:
+		JSONArenaDocument(std::unique_ptr<MonotonicArena> arena,
+			const ArenaValue* root);
+		JSONArenaDocument(JSONArenaDocument&& other) noexcept;
+		JSONArenaDocument& operator=(JSONArenaDocument&& other) noexcept;
+		~JSONArenaDocument();
+
+		[[nodiscard]] const ArenaValue& root() const { return *root_; }
+
+		// Number of bytes the document holds on to.
+		[[nodiscard]] size_t EstimateMemoryUsage() const;
+
+	private:
+		std::unique_ptr<MonotonicArena> arena_;
+		const ArenaValue* root_;
+
+		DISALLOW_COPY_AND_ASSIGN(JSONArenaDocument);
+	};
+
+	namespace internal {
+
+		// Builds an ArenaValue tree in |arena| from the events of
+		// JSONParser::ParseEvents(). Used by JSONReader::ReadToArena().
+		class BASE_EXPORT ArenaValueBuilder : public JSONEventHandler {
+		public:
+			// Strings that lie within |borrowable_input| are referenced rather
+			// than copied into |arena|.
+			explicit ArenaValueBuilder(MonotonicArena* arena,
+				std::string_view borrowable_input = std::string_view());
+			~ArenaValueBuilder() override;
+
+			// The root of the document. Only valid once parsing succeeded.
+			[[nodiscard]] const ArenaValue* root() const { return root_; }
+
+			// JSONEventHandler:
+			bool OnDictBegin() override;
+			bool OnDictEnd() override;
+			bool OnListBegin() override;
+			bool OnListEnd() override;
+			bool OnKey(std::string_view key) override;
+			bool OnString(std::string_view value) override;
+			bool OnInt(int value) override;
+			bool OnDouble(double value) override;
+			bool OnBool(bool value) override;
+			bool OnNull() override;
+
+		private:
+			// Adds |value| to the innermost open container, or makes it the root.
+			bool Add(const ArenaValue& value);
+
+			// Opens a container, remembering the key it is stored under.
+			bool BeginContainer();
+
+			// Returns |str| itself if it may be borrowed, or a copy in the arena.
+			std::string_view Store(std::string_view str);
+
+			// Closes the innermost container. Returns the index of its first member
+			// in |pending_| and restores the key it is stored under.
+			size_t EndContainer();
+
+			MonotonicArena* const arena_;
+			const std::string_view borrowable_input_;
+
+			// Members of the containers still being parsed, innermost last. List
+			// elements have an empty key. Reused across containers, so its size
+			// is bounded by the open containers rather than the whole document.
+			std::vector<ArenaValue::Member> pending_;
+
+			// For each open container, the index of its first member in
+			// |pending_| and the key it will be stored under in its parent.
+			std::vector<std::pair<size_t, std::string_view>> open_;
+
+			// The key of the next member of the innermost dictionary.
+			std::string_view key_;
+
+			const ArenaValue* root_ = nullptr;
+
+			DISALLOW_COPY_AND_ASSIGN(ArenaValueBuilder);
+		};
+
+	}  // namespace internal
+
+}  // namespace base
@@ -0,0 +1,54 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "base_export.h"
+
+namespace base {
+
+	// Receives the tokens of a JSON document from JSONReader::ReadEvents() in
+	// document order, without a Value tree ever being built. This is useful to
+	// pull a few fields out of a very large document, or to convert it into a
+	// different representation, in memory bounded by the nesting depth.
+	//
+	// Every callback returns true to continue parsing or false to stop it; after
+	// a callback returns false no further callbacks are made. The default
+	// implementations ignore the token and continue.
+	//
+	// std::string_view arguments are only valid for the duration of the call.
+	// They point into the input unless the string contained escape sequences.
+	//
+	// Unlike the Value tree built by JSONReader::Read(), which keeps the last of
+	// several entries with the same key, every key of an object is reported.
+	class BASE_EXPORT JSONEventHandler {
+	public:
+		virtual ~JSONEventHandler() = default;
+
+		// A '{' was read. Each member is reported as OnKey() followed by the
+		// callbacks for its value, and the object ends with OnDictEnd().
+		virtual bool OnDictBegin() { return true; }
+		virtual bool OnDictEnd() { return true; }
+
+		// A '[' was read. The elements follow, and the list ends with
+		// OnListEnd().
+		virtual bool OnListBegin() { return true; }
+		virtual bool OnListEnd() { return true; }
+
+		// The key of the next object member.
+		virtual bool OnKey(std::string_view key) { return true; }
+
+		// Scalar values. Numbers are reported the way JSONReader::Read() would
+		// store them: as an int when they fit, otherwise as a double.
+		virtual bool OnString(std::string_view value) { return true; }
+		virtual bool OnInt(int value) { return true; }
+		virtual bool OnDouble(double value) { return true; }
+		virtual bool OnBool(bool value) { return true; }
+		virtual bool OnNull() { return true; }
+	};
+
+}  // namespace base
@@ -0,0 +1,459 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "json/json_incremental_parser.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "compiler_specific.h"
+#include "logging.h"
+#include "strings/string_util.h"
+
+namespace base {
+
+	namespace {
+
+		const char kByteOrderMark[] = "\xEF\xBB\xBF";
+		const size_t kByteOrderMarkLength = 3;
+
+		// Bytes that can continue a number. internal::JSONParser decides whether
+		// they actually make up one.
+		bool IsNumberByte(char c) {
+			return IsAsciiDigit(c) || c == '-' || c == '+' || c == '.' || c == 'e' ||
+				c == 'E';
+		}
+
+	}  // namespace
+
+	JSONIncrementalParser::Container::Container(bool is_dict) : is_dict(is_dict) {}
+
+	JSONIncrementalParser::Container::Container(Container&& other) = default;
+
+	JSONIncrementalParser::Container& JSONIncrementalParser::Container::operator=(
+		Container&& other) = default;
+
+	JSONIncrementalParser::Container::~Container() = default;
+
+	JSONIncrementalParser::JSONIncrementalParser(int options, size_t max_depth)
+		: options_(options), max_depth_(max_depth), scalar_parser_(options) {
+		CHECK_LE(max_depth, internal::kAbsoluteMaxDepth);
+		if (options_ & JSON_INTERN_KEYS)
+			key_table_ = MakeRefCounted<DictKeyTable>();
+		Reset();
+	}
+
+	JSONIncrementalParser::~JSONIncrementalParser() = default;
+
+	bool JSONIncrementalParser::Feed(std::string_view fragment) {
+		size_t pos = 0;
+		while (pos < fragment.size() && state_ != State::kError) {
+			switch (token_) {
+			case Token::kNone:
+				pos = ConsumeStructural(fragment, pos);
+				break;
+			case Token::kString:
+				pos = ConsumeString(fragment, pos);
+				break;
+			case Token::kNumber:
+			case Token::kLiteral:
+				pos = ConsumeWord(fragment, pos);
+				break;
+			case Token::kSlash:
+			case Token::kLineComment:
+			case Token::kBlockComment:
+				pos = ConsumeComment(fragment, pos);
+				break;
+			}
+		}
+		if (state_ == State::kError)
+			return false;
+
+		// Keep the part of an unfinished token that is in this fragment, which
+		// the caller is free to reuse once this returns.
+		if (token_ == Token::kString || token_ == Token::kNumber ||
+			token_ == Token::kLiteral) {
+			const size_t start =
+				token_offset_ > offset_ ? token_offset_ - offset_ : 0;
+			token_bytes_.append(fragment.data() + start, fragment.size() - start);
+		}
+		offset_ += fragment.size();
+		return true;
+	}
+
+	bool JSONIncrementalParser::Feed(span<const uint8_t> fragment) {
+		return Feed(std::string_view(reinterpret_cast<const char*>(fragment.data()),
+			fragment.size()));
+	}
+
+	JSONReader::ValueWithError JSONIncrementalParser::Finish() {
+		if (state_ != State::kError) {
+			switch (token_) {
+			case Token::kString:
+				// Unterminated.
+				ReportError(JSONReader::JSON_SYNTAX_ERROR, offset_);
+				break;
+			case Token::kNumber:
+			case Token::kLiteral:
+				EndToken(std::string_view(), 0);
+				break;
+			case Token::kSlash:
+				ReportUnexpected(token_offset_);
+				break;
+			case Token::kNone:
+			case Token::kLineComment:
+			case Token::kBlockComment:
+				// Like internal::JSONParser, let an unterminated comment end the
+				// input.
+				break;
+			}
+		}
+		if (state_ != State::kError && state_ != State::kDone)
+			ReportUnexpected(offset_);
+
+		JSONReader::ValueWithError result;
+		if (state_ == State::kDone) {
+			result.value = std::move(root_);
+		} else {
+			result.error_code = error_code_;
+			result.error_message = internal::JSONParser::FormatErrorMessage(
+				error_line_, error_column_, JSONReader::ErrorCodeToString(error_code_));
+			result.error_line = error_line_;
+			result.error_column = error_column_;
+		}
+		Reset();
+		return result;
+	}
+
+	size_t JSONIncrementalParser::ConsumeStructural(std::string_view fragment,
+		size_t pos) {
+		const size_t offset = offset_ + pos;
+		const char c = fragment[pos];
+
+		// Skip a Byte-Order-Mark at the start of the input, which may itself be
+		// split across fragments.
+		if (offset == bom_length_ && bom_length_ < kByteOrderMarkLength) {
+			if (c == kByteOrderMark[bom_length_]) {
+				++bom_length_;
+				return pos + 1;
+			}
+			if (bom_length_) {
+				ReportError(JSONReader::JSON_UNEXPECTED_TOKEN, 0);
+				return pos;
+			}
+		}
+
+		switch (c) {
+		case '\r':
+		case '\n':
+			// Don't increment line_number_ twice for "\r\n".
+			if (!(c == '\n' && last_line_break_was_cr_ &&
+				offset_last_line_ + 1 == offset)) {
+				++line_number_;
+			}
+			offset_last_line_ = offset;
+			last_line_break_was_cr_ = c == '\r';
+			return pos + 1;
+		case ' ':
+		case '\t':
+			do {
+				++pos;
+			} while (pos < fragment.size() &&
+				(fragment[pos] == ' ' || fragment[pos] == '\t'));
+			return pos;
+		case '/':
+			StartToken(Token::kSlash, pos);
+			return pos + 1;
+		default:
+			break;
+		}
+
+		switch (state_) {
+		case State::kFirstListItem:
+		case State::kNextListItem:
+			if (c == ']') {
+				if (state_ == State::kNextListItem &&
+					!(options_ & JSON_ALLOW_TRAILING_COMMAS)) {
+					ReportError(JSONReader::JSON_TRAILING_COMMA, offset);
+					return pos;
+				}
+				CloseContainer();
+				return pos + 1;
+			}
+			FALLTHROUGH;
+		case State::kValue:
+			switch (c) {
+			case '{':
+			case '[':
+				OpenContainer(c == '{', offset);
+				return pos + 1;
+			case '"':
+				StartToken(Token::kString, pos);
+				return pos + 1;
+			case 't':
+			case 'f':
+			case 'n':
+				StartToken(Token::kLiteral, pos);
+				return pos + 1;
+			default:
+				if (c == '-' || IsAsciiDigit(c)) {
+					StartToken(Token::kNumber, pos);
+					return pos + 1;
+				}
+				break;
+			}
+			break;
+		case State::kFirstKey:
+		case State::kNextKey:
+			if (c == '}') {
+				if (state_ == State::kNextKey &&
+					!(options_ & JSON_ALLOW_TRAILING_COMMAS)) {
+					ReportError(JSONReader::JSON_TRAILING_COMMA, offset);
+					return pos;
+				}
+				CloseContainer();
+				return pos + 1;
+			}
+			if (c == '"') {
+				StartToken(Token::kString, pos);
+				return pos + 1;
+			}
+			break;
+		case State::kColon:
+			if (c == ':') {
+				state_ = State::kValue;
+				return pos + 1;
+			}
+			break;
+		case State::kSeparator: {
+			const bool is_dict = stack_.back().is_dict;
+			if (c == ',') {
+				state_ = is_dict ? State::kNextKey : State::kNextListItem;
+				return pos + 1;
+			}
+			if (c == (is_dict ? '}' : ']')) {
+				CloseContainer();
+				return pos + 1;
+			}
+			break;
+		}
+		case State::kDone:
+		case State::kError:
+			break;
+		}
+
+		ReportUnexpected(offset);
+		return pos;
+	}
+
+	size_t JSONIncrementalParser::ConsumeString(std::string_view fragment,
+		size_t pos) {
+		while (true) {
+			if (escaped_) {
+				if (pos == fragment.size())
+					return pos;
+				escaped_ = false;
+				++pos;
+			}
+			const size_t special = fragment.find_first_of("\"\\", pos);
+			if (special == std::string_view::npos)
+				return fragment.size();
+			if (fragment[special] == '\\') {
+				escaped_ = true;
+				pos = special + 1;
+				continue;
+			}
+			EndToken(fragment, special + 1);
+			return special + 1;
+		}
+	}
+
+	size_t JSONIncrementalParser::ConsumeWord(std::string_view fragment,
+		size_t pos) {
+		const bool is_number = token_ == Token::kNumber;
+		while (pos < fragment.size() &&
+			(is_number ? IsNumberByte(fragment[pos]) : IsAsciiAlpha(fragment[pos]))) {
+			++pos;
+		}
+		// A word only ends at the first byte that cannot be part of it.
+		if (pos < fragment.size())
+			EndToken(fragment, pos);
+		return pos;
+	}
+
+	size_t JSONIncrementalParser::ConsumeComment(std::string_view fragment,
+		size_t pos) {
+		switch (token_) {
+		case Token::kSlash:
+			if (fragment[pos] == '/') {
+				token_ = Token::kLineComment;
+			} else if (fragment[pos] == '*') {
+				token_ = Token::kBlockComment;
+				comment_star_ = false;
+			} else {
+				ReportUnexpected(token_offset_);
+				return pos;
+			}
+			return pos + 1;
+		case Token::kLineComment: {
+			// The line break itself is left for the line bookkeeping.
+			const size_t line_break = fragment.find_first_of("\r\n", pos);
+			if (line_break == std::string_view::npos)
+				return fragment.size();
+			token_ = Token::kNone;
+			return line_break;
+		}
+		case Token::kBlockComment:
+			for (; pos < fragment.size(); ++pos) {
+				if (comment_star_ && fragment[pos] == '/') {
+					token_ = Token::kNone;
+					return pos + 1;
+				}
+				comment_star_ = fragment[pos] == '*';
+			}
+			return pos;
+		default:
+			NOTREACHED();
+			return fragment.size();
+		}
+	}
+
+	void JSONIncrementalParser::StartToken(Token type, size_t pos) {
+		DCHECK(token_bytes_.empty());
+		token_ = type;
+		token_offset_ = offset_ + pos;
+		escaped_ = false;
+		comment_star_ = false;
+	}
+
+	bool JSONIncrementalParser::EndToken(std::string_view fragment, size_t end) {
+		token_ = Token::kNone;
+
+		// A token that began in an earlier fragment is completed in
+		// |token_bytes_|; otherwise it is decoded where it is.
+		std::string_view token;
+		if (token_bytes_.empty()) {
+			const size_t start = token_offset_ - offset_;
+			token = fragment.substr(start, end - start);
+		} else {
+			token_bytes_.append(fragment.data(), end);
+			token = token_bytes_;
+		}
+
+		std::optional<Value> value = scalar_parser_.Parse(token);
+		token_bytes_.clear();
+		if (!value) {
+			// Bytes after the end of the token are seen by the token that follows,
+			// so data after the "root" here is a malformed token, and numbers out
+			// of range fail without error information.
+			JSONReader::JsonParseError code = scalar_parser_.error_code();
+			if (code == JSONReader::JSON_NO_ERROR ||
+				code == JSONReader::JSON_UNEXPECTED_DATA_AFTER_ROOT) {
+				code = JSONReader::JSON_SYNTAX_ERROR;
+			}
+			const int column = std::max(scalar_parser_.error_column(), 1);
+			return ReportError(code, token_offset_ + column - 1);
+		}
+
+		if (state_ == State::kFirstKey || state_ == State::kNextKey) {
+			std::string& key = value->GetString();
+			stack_.back().key = key_table_ ? key_table_->Intern(std::move(key))
+				: DictKey(std::move(key));
+			state_ = State::kColon;
+		} else {
+			AddValue(std::move(*value));
+		}
+		return true;
+	}
+
+	void JSONIncrementalParser::AddValue(Value value) {
+		if (stack_.empty()) {
+			root_ = std::move(value);
+			state_ = State::kDone;
+			return;
+		}
+
+		Container& container = stack_.back();
+		if (container.is_dict) {
+			container.dict.emplace_back(std::move(container.key),
+				std::make_unique<Value>(std::move(value)));
+		} else {
+			container.list.push_back(std::move(value));
+		}
+		state_ = State::kSeparator;
+	}
+
+	bool JSONIncrementalParser::OpenContainer(bool is_dict, size_t offset) {
+		// Same limit as internal::JSONParser's StackMarker.
+		if (stack_.size() + 1 >= max_depth_)
+			return ReportError(JSONReader::JSON_TOO_MUCH_NESTING, offset);
+		stack_.emplace_back(is_dict);
+		state_ = is_dict ? State::kFirstKey : State::kFirstListItem;
+		return true;
+	}
+
+	void JSONIncrementalParser::CloseContainer() {
+		Container container = std::move(stack_.back());
+		stack_.pop_back();
+		if (container.is_dict) {
+			// Reverse the members to keep the last of elements with the same key in
+			// the input.
+			std::reverse(container.dict.begin(), container.dict.end());
+			AddValue(Value(Value::DictStorage(std::move(container.dict))));
+		} else {
+			AddValue(Value(std::move(container.list)));
+		}
+	}
+
+	bool JSONIncrementalParser::ReportUnexpected(size_t offset) {
+		switch (state_) {
+		case State::kValue:
+		case State::kFirstListItem:
+		case State::kNextListItem:
+			return ReportError(JSONReader::JSON_UNEXPECTED_TOKEN, offset);
+		case State::kFirstKey:
+		case State::kNextKey:
+			return ReportError(JSONReader::JSON_UNQUOTED_DICTIONARY_KEY, offset);
+		case State::kColon:
+		case State::kSeparator:
+			return ReportError(JSONReader::JSON_SYNTAX_ERROR, offset);
+		case State::kDone:
+			return ReportError(JSONReader::JSON_UNEXPECTED_DATA_AFTER_ROOT, offset);
+		case State::kError:
+			return false;
+		}
+		NOTREACHED();
+		return false;
+	}
+
+	bool JSONIncrementalParser::ReportError(JSONReader::JsonParseError code,
+		size_t offset) {
+		state_ = State::kError;
+		error_code_ = code;
+		error_line_ = line_number_;
+		error_column_ = static_cast<int>(offset - offset_last_line_) + 1;
+		return false;
+	}
+
+	void JSONIncrementalParser::Reset() {
+		state_ = State::kValue;
+		token_ = Token::kNone;
+		stack_.clear();
+		root_.reset();
+		token_bytes_.clear();
+		token_offset_ = 0;
+		escaped_ = false;
+		comment_star_ = false;
+		offset_ = 0;
+		bom_length_ = 0;
+		line_number_ = 1;
+		offset_last_line_ = 0;
+		last_line_break_was_cr_ = false;
+		error_code_ = JSONReader::JSON_NO_ERROR;
+		error_line_ = 0;
+		error_column_ = 0;
+	}
+
+}  // namespace base
@@ -0,0 +1,170 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <cstdint>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base_export.h"
+#include "containers/span.h"
+#include "dict_key.h"
+#include "json/json_common.h"
+#include "json/json_parser.h"
+#include "json/json_reader.h"
+#include "macros.h"
+#include "memory/scoped_refptr.h"
+#include "values.h"
+
+namespace base {
+
+	// Parses a JSON document that arrives in fragments, such as successive reads
+	// from a file, a pipe or a serial port, without first gathering the whole
+	// document in one buffer. Each fragment is parsed as soon as it is fed, and
+	// the containers being built are kept on an explicit stack until the next
+	// one arrives. Only a token cut in two by a fragment boundary is copied
+	// aside. Strings, numbers and literals are decoded by internal::JSONParser,
+	// so the result and the JSONParserOptions honored are the same as with
+	// JSONReader::Read() on the whole input.
+	//
+	//   JSONIncrementalParser parser;
+	//   char buffer[4096];
+	//   int read;
+	//   while ((read = file.ReadAtCurrentPos(buffer, sizeof(buffer))) > 0) {
+	//     if (!parser.Feed(std::string_view(buffer, read)))
+	//       break;
+	//   }
+	//   JSONReader::ValueWithError result = parser.Finish();
+	class BASE_EXPORT JSONIncrementalParser {
+	public:
+		explicit JSONIncrementalParser(
+			int options = JSON_PARSE_RFC,
+			size_t max_depth = internal::kAbsoluteMaxDepth);
+		~JSONIncrementalParser();
+
+		// Parses the next fragment of the input. Returns false once the input is
+		// known to be invalid; later fragments are ignored and Finish() reports
+		// the error.
+		bool Feed(std::string_view fragment);
+		bool Feed(span<const uint8_t> fragment);
+
+		// Returns true once the root value is complete. Only whitespace and
+		// comments may follow it.
+		[[nodiscard]] bool has_root() const { return state_ == State::kDone; }
+
+		// Marks the end of the input and returns the root value, or the error
+		// with its location in the whole input. The parser is then ready for
+		// another document.
+		JSONReader::ValueWithError Finish();
+
+	private:
+		// What the parser expects next outside of a token.
+		enum class State {
+			kValue,          // The root value, or the value after a ':'.
+			kFirstListItem,  // A value or ']' after '['.
+			kNextListItem,   // A value after ','.
+			kFirstKey,       // A key or '}' after '{'.
+			kNextKey,        // A key after ','.
+			kColon,          // The ':' after a key.
+			kSeparator,      // ',' or the end of the container after a value.
+			kDone,           // Nothing but whitespace after the root value.
+			kError,
+		};
+
+		// The token, or comment, the parser is in the middle of.
+		enum class Token {
+			kNone,
+			kString,
+			kNumber,
+			kLiteral,
+			kSlash,  // A '/' that starts a comment.
+			kLineComment,
+			kBlockComment,
+		};
+
+		// A list or dictionary whose closing bracket has not been seen yet.
+		struct Container {
+			explicit Container(bool is_dict);
+			Container(Container&& other);
+			Container& operator=(Container&& other);
+			~Container();
+
+			bool is_dict;
+			Value::ListStorage list;
+			std::vector<Value::DictStorage::value_type> dict;
+			// The key of the dictionary member whose value is being parsed.
+			DictKey key;
+		};
+
+		// Each of these handles the bytes of |fragment| from |pos| on and returns
+		// the position of the first byte it did not consume.
+		size_t ConsumeStructural(std::string_view fragment, size_t pos);
+		size_t ConsumeString(std::string_view fragment, size_t pos);
+		size_t ConsumeWord(std::string_view fragment, size_t pos);
+		size_t ConsumeComment(std::string_view fragment, size_t pos);
+
+		// Starts a token of |type| at |pos|.
+		void StartToken(Token type, size_t pos);
+
+		// Ends the current token before |end|, and decodes it.
+		bool EndToken(std::string_view fragment, size_t end);
+
+		// Adds a finished |value| to the innermost container, or makes it the
+		// root.
+		void AddValue(Value value);
+
+		bool OpenContainer(bool is_dict, size_t offset);
+		void CloseContainer();
+
+		// Reports the error for an unexpected byte, or the end of the input, at
+		// |offset| in the current state.
+		bool ReportUnexpected(size_t offset);
+		bool ReportError(JSONReader::JsonParseError code, size_t offset);
+
+		void Reset();
+
+		const int options_;
+		const size_t max_depth_;
+
+		// Decodes complete scalar tokens.
+		internal::JSONParser scalar_parser_;
+		// Interns dictionary keys if JSON_INTERN_KEYS is set.
+		scoped_refptr<DictKeyTable> key_table_;
+
+		State state_;
+		Token token_;
+		std::vector<Container> stack_;
+		std::optional<Value> root_;
+
+		// The bytes of the current token that were in earlier fragments. Empty
+		// while the token lies within the fragment being parsed.
+		std::string token_bytes_;
+		// The input offset at which the current token starts.
+		size_t token_offset_;
+		// Whether the next string byte is escaped.
+		bool escaped_;
+		// Whether the last byte of a block comment was '*'.
+		bool comment_star_;
+
+		// Number of bytes of input consumed before the current fragment.
+		size_t offset_;
+		// Number of bytes of the UTF-8 Byte-Order-Mark at the start of the input.
+		size_t bom_length_;
+		// Line bookkeeping, as in internal::JSONParser.
+		int line_number_;
+		size_t offset_last_line_;
+		bool last_line_break_was_cr_;
+
+		JSONReader::JsonParseError error_code_;
+		int error_line_;
+		int error_column_;
+
+		DISALLOW_COPY_AND_ASSIGN(JSONIncrementalParser);
+	};
+
+}  // namespace base
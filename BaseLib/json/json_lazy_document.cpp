@@ -0,0 +1,377 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "json/json_lazy_document.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "json/json_reader.h"
+#include "logging.h"
+
+namespace base {
+
+	// Makes the structural pass over the input for JSONLazyDocument::Create().
+	class JSONLazyDocument::Indexer {
+	public:
+		explicit Indexer(JSONLazyDocument* document)
+			: document_(document),
+			  json_(document->json_),
+			  allow_trailing_commas_(
+				  (document->options_ & JSON_ALLOW_TRAILING_COMMAS) != 0) {}
+
+		bool Run() {
+			// Like JSONParser, skip a UTF-8 byte order mark.
+			if (json_.substr(0, 3) == "\xEF\xBB\xBF")
+				pos_ = 3;
+			if (!SkipBlank())
+				return false;
+			if (Peek() == '{') {
+				document_->root_object_ = IndexObject(1);
+				if (document_->root_object_ == kNotIndexed)
+					return false;
+			} else if (!SkipValue(0)) {
+				return false;
+			}
+			return SkipBlank() && pos_ == json_.size();
+		}
+
+	private:
+		[[nodiscard]] char Peek() const {
+			return pos_ < json_.size() ? json_[pos_] : '\0';
+		}
+
+		// Skips whitespace and comments. Returns false for an unterminated
+		// block comment.
+		bool SkipBlank() {
+			while (pos_ < json_.size()) {
+				const char c = json_[pos_];
+				if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+					++pos_;
+				} else if (c == '/' && json_.substr(pos_, 2) == "//") {
+					pos_ = std::min(json_.find_first_of("\r\n", pos_), json_.size());
+				} else if (c == '/' && json_.substr(pos_, 2) == "/*") {
+					const size_t end = json_.find("*/", pos_ + 2);
+					if (end == std::string_view::npos)
+						return false;
+					pos_ = end + 2;
+				} else {
+					break;
+				}
+			}
+			return true;
+		}
+
+		// Skips the string starting at the current '"'. Sets |has_escapes| if it
+		// contains a backslash.
+		bool SkipString(bool* has_escapes) {
+			DCHECK_EQ('"', Peek());
+			*has_escapes = false;
+			++pos_;
+			while (true) {
+				pos_ = json_.find_first_of("\"\\", pos_);
+				if (pos_ == std::string_view::npos)
+					return false;
+				if (json_[pos_] == '"') {
+					++pos_;
+					return true;
+				}
+				// Skip the escaped character, which may be a quote.
+				*has_escapes = true;
+				pos_ += 2;
+			}
+		}
+
+		// Skips a value of any type, nested in |depth| containers.
+		bool SkipValue(size_t depth) {
+			bool has_escapes;
+			switch (Peek()) {
+			case '"':
+				return SkipString(&has_escapes);
+			case '{':
+			case '[':
+				return SkipContainer(depth);
+			case '\0':
+			case ',':
+			case ':':
+			case '}':
+			case ']':
+				return false;
+			default:
+				// A number or literal, checked when parsed.
+				while (pos_ < json_.size()) {
+					const char c = json_[pos_];
+					if (c == ',' || c == '}' || c == ']' || c == ' ' || c == '\t' ||
+						c == '\r' || c == '\n' || c == '/') {
+						break;
+					}
+					++pos_;
+				}
+				return true;
+			}
+		}
+
+		// Skips the container starting at the current position by matching
+		// brackets, without indexing anything in it.
+		bool SkipContainer(size_t depth) {
+			std::string closers;
+			bool has_escapes;
+			while (pos_ < json_.size()) {
+				const char c = json_[pos_];
+				switch (c) {
+				case '{':
+				case '[':
+					if (depth + closers.size() + 1 >= document_->max_depth_)
+						return false;
+					closers.push_back(c == '{' ? '}' : ']');
+					++pos_;
+					break;
+				case '}':
+				case ']':
+					if (closers.empty() || closers.back() != c)
+						return false;
+					closers.pop_back();
+					++pos_;
+					if (closers.empty())
+						return true;
+					break;
+				case '"':
+					if (!SkipString(&has_escapes))
+						return false;
+					break;
+				case '/':
+					if (!SkipBlank() || Peek() == '/')
+						return false;
+					break;
+				default:
+					++pos_;
+					break;
+				}
+			}
+			return false;
+		}
+
+		// Indexes the dictionary starting at the current '{', which is at
+		// nesting level |depth|. Returns its index in |objects_|, or kNotIndexed
+		// on error.
+		int32_t IndexObject(size_t depth) {
+			DCHECK_EQ('{', Peek());
+			if (depth >= document_->max_depth_)
+				return kNotIndexed;
+			++pos_;
+
+			const size_t first_pending = pending_.size();
+			if (!SkipBlank())
+				return kNotIndexed;
+			if (Peek() != '}') {
+				while (true) {
+					Member member;
+					if (!IndexKey(&member.key) || !SkipBlank() || Peek() != ':')
+						return kNotIndexed;
+					++pos_;
+					if (!SkipBlank())
+						return kNotIndexed;
+
+					member.value_begin = static_cast<uint32_t>(pos_);
+					member.object = kNotIndexed;
+					if (Peek() == '{') {
+						member.object = IndexObject(depth + 1);
+						if (member.object == kNotIndexed)
+							return kNotIndexed;
+					} else if (!SkipValue(depth)) {
+						return kNotIndexed;
+					}
+					member.value_end = static_cast<uint32_t>(pos_);
+					pending_.push_back(member);
+
+					if (!SkipBlank())
+						return kNotIndexed;
+					if (Peek() == '}')
+						break;
+					if (Peek() != ',')
+						return kNotIndexed;
+					++pos_;
+					if (!SkipBlank())
+						return kNotIndexed;
+					if (Peek() == '}') {
+						if (!allow_trailing_commas_)
+							return kNotIndexed;
+						break;
+					}
+				}
+			}
+			++pos_;
+			return AddObject(first_pending);
+		}
+
+		// Reads the key starting at the current position.
+		bool IndexKey(std::string_view* key) {
+			if (Peek() != '"')
+				return false;
+			const size_t begin = pos_;
+			bool has_escapes;
+			if (!SkipString(&has_escapes))
+				return false;
+			if (!has_escapes) {
+				*key = json_.substr(begin + 1, pos_ - begin - 2);
+				return true;
+			}
+			// Let the parser deal with escape sequences.
+			std::optional<Value> decoded = JSONReader::Read(
+				json_.substr(begin, pos_ - begin), document_->options_);
+			if (!decoded)
+				return false;
+			document_->decoded_keys_.push_back(std::move(decoded->GetString()));
+			*key = document_->decoded_keys_.back();
+			return true;
+		}
+
+		// Moves the members pending from |first_pending| on into a new Object.
+		int32_t AddObject(size_t first_pending) {
+			const auto begin = pending_.begin() + first_pending;
+
+			// Sort by key, keeping only the last of several members with the same
+			// key, which is what a Value built from the same input would hold.
+			std::stable_sort(begin, pending_.end(),
+				[](const Member& a, const Member& b) { return a.key < b.key; });
+			auto& members = document_->members_;
+			const size_t first_member = members.size();
+			for (auto it = begin; it != pending_.end(); ++it) {
+				if (it + 1 != pending_.end() && it[1].key == it->key)
+					continue;
+				members.push_back(*it);
+			}
+			pending_.erase(begin, pending_.end());
+
+			document_->objects_.push_back(
+				Object{ static_cast<uint32_t>(first_member),
+						static_cast<uint32_t>(members.size() - first_member) });
+			return static_cast<int32_t>(document_->objects_.size() - 1);
+		}
+
+		JSONLazyDocument* const document_;
+		const std::string_view json_;
+		const bool allow_trailing_commas_;
+		size_t pos_ = 0;
+
+		// Members of the dictionaries being indexed, innermost last.
+		std::vector<Member> pending_;
+
+		DISALLOW_COPY_AND_ASSIGN(Indexer);
+	};
+
+	JSONLazyDocument::JSONLazyDocument(std::string_view json,
+									   int options,
+									   size_t max_depth)
+		: json_(json), options_(options), max_depth_(max_depth) {}
+
+	JSONLazyDocument::JSONLazyDocument(JSONLazyDocument&& other) noexcept =
+		default;
+
+	JSONLazyDocument& JSONLazyDocument::operator=(
+		JSONLazyDocument&& other) noexcept = default;
+
+	JSONLazyDocument::~JSONLazyDocument() = default;
+
+	// static
+	std::optional<JSONLazyDocument> JSONLazyDocument::Create(
+		std::string_view json,
+		int options,
+		size_t max_depth) {
+		CHECK_LE(max_depth, internal::kAbsoluteMaxDepth);
+		// Offsets are stored in 32 bits. JSONParser rejects larger inputs too.
+		if (json.size() > static_cast<size_t>(std::numeric_limits<int32_t>::max()))
+			return std::nullopt;
+
+		JSONLazyDocument document(json, options, max_depth);
+		if (!Indexer(&document).Run())
+			return std::nullopt;
+		return document;
+	}
+
+	const Value* JSONLazyDocument::FindKey(std::string_view key) {
+		const std::optional<size_t> member = FindMember(root_object_, key);
+		return member ? GetMemberValue(*member, 1) : nullptr;
+	}
+
+	const Value* JSONLazyDocument::FindPath(std::string_view path) {
+		int32_t object = root_object_;
+		size_t depth = 1;
+		size_t start = 0;
+		while (true) {
+			const size_t dot = path.find('.', start);
+			const std::string_view key = path.substr(
+				start, dot == std::string_view::npos ? std::string_view::npos
+													 : dot - start);
+			const std::optional<size_t> member = FindMember(object, key);
+			if (!member)
+				return nullptr;
+			if (dot == std::string_view::npos)
+				return GetMemberValue(*member, depth);
+
+			object = members_[*member].object;
+			if (object == kNotIndexed) {
+				// Not a dictionary we can step into without parsing it. Parse it
+				// and let Value resolve the rest of the path.
+				const Value* value = GetMemberValue(*member, depth);
+				if (!value || !value->is_dict())
+					return nullptr;
+				return value->FindPath(path.substr(dot + 1));
+			}
+			start = dot + 1;
+			++depth;
+		}
+	}
+
+	std::optional<Value> JSONLazyDocument::ToValue() const {
+		return JSONReader::Read(json_, options_, max_depth_);
+	}
+
+	size_t JSONLazyDocument::EstimateMemoryUsage() const {
+		size_t usage = objects_.capacity() * sizeof(Object) +
+			members_.capacity() * sizeof(Member) +
+			values_.size() * sizeof(decltype(values_)::value_type);
+		for (const std::string& key : decoded_keys_)
+			usage += sizeof(key) + key.capacity();
+		for (const auto& value : values_) {
+			if (value.second)
+				usage += sizeof(Value) + value.second->EstimateMemoryUsage();
+		}
+		return usage;
+	}
+
+	std::optional<size_t> JSONLazyDocument::FindMember(
+		int32_t object,
+		std::string_view key) const {
+		if (object == kNotIndexed)
+			return std::nullopt;
+		const Object& entry = objects_[object];
+		const auto begin = members_.begin() + entry.first_member;
+		const auto end = begin + entry.member_count;
+		const auto found = std::lower_bound(
+			begin, end, key,
+			[](const Member& member, std::string_view key) {
+				return member.key < key;
+			});
+		if (found == end || found->key != key)
+			return std::nullopt;
+		return found - members_.begin();
+	}
+
+	const Value* JSONLazyDocument::GetMemberValue(size_t member, size_t depth) {
+		auto it = values_.find(member);
+		if (it == values_.end()) {
+			const Member& entry = members_[member];
+			std::optional<Value> value = JSONReader::Read(
+				json_.substr(entry.value_begin, entry.value_end - entry.value_begin),
+				options_, max_depth_ - depth);
+			it = values_.emplace(member, value ? std::make_unique<Value>(
+													 std::move(*value))
+											   : nullptr).first;
+		}
+		return it->second.get();
+	}
+
+}  // namespace base
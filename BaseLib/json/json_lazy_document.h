@@ -0,0 +1,118 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <cstdint>
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "base_export.h"
+#include "containers/flat_map.h"
+#include "macros.h"
+#include "values.h"
+
+namespace base {
+
+	// A JSON document that is parsed on demand. Creating it makes a single
+	// structural pass over the input that records where the members of each
+	// dictionary start and end, without building any Values. FindKey() and
+	// FindPath() then parse only the subtree they return, and cache it.
+	// Subtrees that are never looked at cost only their index entries, which
+	// makes this well suited to pulling a few fields out of a large document.
+	//
+	// Only dictionaries reachable through other dictionaries from the root are
+	// indexed; a list is parsed as a whole when accessed.
+	//
+	// The structural pass checks that brackets are balanced, strings are
+	// terminated, and that dictionary members are well-formed, but not the
+	// contents of strings, numbers or lists. Those are validated when parsed,
+	// and a value that fails to parse is reported as missing.
+	//
+	// The document refers to the input, which must outlive it. Not thread-safe.
+	class BASE_EXPORT JSONLazyDocument {
+	public:
+		JSONLazyDocument(JSONLazyDocument&& other) noexcept;
+		JSONLazyDocument& operator=(JSONLazyDocument&& other) noexcept;
+		~JSONLazyDocument();
+
+		// Whether the root of the document is a dictionary. FindKey() and
+		// FindPath() only find anything if it is.
+		[[nodiscard]] bool is_dict() const { return root_object_ != kNotIndexed; }
+
+		// Returns the value of |key| in the root dictionary, parsing it on first
+		// access. Returns nullptr if there is no such key or its value is invalid.
+		const Value* FindKey(std::string_view key);
+
+		// Like Value::FindPath(): follows a dot-separated |path| of dictionary
+		// keys from the root. Only the value at the end of the path is parsed.
+		const Value* FindPath(std::string_view path);
+
+		// Parses the whole document.
+		[[nodiscard]] std::optional<Value> ToValue() const;
+
+		// Number of bytes used by the index and the values parsed so far.
+		[[nodiscard]] size_t EstimateMemoryUsage() const;
+
+	private:
+		friend class JSONReader;
+		class Indexer;
+
+		static constexpr int32_t kNotIndexed = -1;
+
+		// A dictionary member. The key refers to the input unless it needed
+		// unescaping, in which case it refers to |decoded_keys_|.
+		struct Member {
+			std::string_view key;
+			uint32_t value_begin;
+			uint32_t value_end;
+			// The index in |objects_| if the value is an indexed dictionary.
+			int32_t object;
+		};
+
+		// The members of a dictionary, sorted by key, are
+		// members_[first_member, first_member + member_count).
+		struct Object {
+			uint32_t first_member;
+			uint32_t member_count;
+		};
+
+		JSONLazyDocument(std::string_view json, int options, size_t max_depth);
+
+		// Indexes |json|, which is parsed with |options| (see JSONParserOptions)
+		// and |max_depth| like JSONReader::Read(). Returns base::nullopt if the
+		// structure of |json| is invalid. Used by JSONReader::ReadLazy().
+		static std::optional<JSONLazyDocument> Create(std::string_view json,
+													  int options,
+													  size_t max_depth);
+
+		// Returns the index of |key| in |members_| if |object| has it.
+		[[nodiscard]] std::optional<size_t> FindMember(int32_t object,
+													   std::string_view key) const;
+
+		// Returns the parsed value of |members_[member]|, which belongs to a
+		// dictionary at nesting level |depth|.
+		const Value* GetMemberValue(size_t member, size_t depth);
+
+		std::string_view json_;
+		int options_;
+		size_t max_depth_;
+
+		int32_t root_object_ = kNotIndexed;
+		std::vector<Object> objects_;
+		std::vector<Member> members_;
+		std::deque<std::string> decoded_keys_;
+
+		// Parsed member values by index in |members_|. Values that failed to
+		// parse are cached as nullptr.
+		flat_map<size_t, std::unique_ptr<Value>> values_;
+
+		DISALLOW_COPY_AND_ASSIGN(JSONLazyDocument);
+	};
+
+}  // namespace base
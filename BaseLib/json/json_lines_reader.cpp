@@ -0,0 +1,161 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "json/json_lines_reader.h"
+
+#include <atomic>
+#include <utility>
+
+#include "bind.h"
+#include "files/file_path.h"
+#include "files/memory_mapped_file.h"
+#include "json/json_parser.h"
+#include "location.h"
+#include "task/post_job.h"
+#include "threading/scoped_blocking_call.h"
+
+namespace base {
+
+	namespace {
+
+		// A run of whole lines of the input, and the records parsed from it.
+		struct Chunk {
+			explicit Chunk(std::string_view text) : text(text) {}
+
+			std::string_view text;
+			std::vector<JSONReader::ValueWithError> records;
+			// The number of lines in |text|. Records that failed to parse carry
+			// their line number within the chunk until the chunks are joined.
+			int lines = 0;
+		};
+
+		std::vector<Chunk> SplitIntoChunks(std::string_view input) {
+			std::vector<Chunk> chunks;
+			chunks.reserve(input.size() / JSONLinesReader::kChunkSize + 1);
+			while (!input.empty()) {
+				size_t length = input.size();
+				if (length > JSONLinesReader::kChunkSize) {
+					const size_t newline =
+						input.find('\n', JSONLinesReader::kChunkSize - 1);
+					if (newline != std::string_view::npos)
+						length = newline + 1;
+				}
+				chunks.emplace_back(input.substr(0, length));
+				input.remove_prefix(length);
+			}
+			return chunks;
+		}
+
+		bool IsBlank(std::string_view line) {
+			return line.find_first_not_of(" \t\r") == std::string_view::npos;
+		}
+
+		void ParseChunk(Chunk* chunk, int options) {
+			// One parser for the whole chunk lets JSON_INTERN_KEYS share the keys
+			// of all its records.
+			internal::JSONParser parser(options);
+			std::string_view text = chunk->text;
+			while (!text.empty()) {
+				const size_t newline = text.find('\n');
+				const std::string_view line = text.substr(0, newline);
+				text.remove_prefix(newline == std::string_view::npos ? text.size()
+																	 : newline + 1);
+				++chunk->lines;
+				if (IsBlank(line))
+					continue;
+				JSONReader::ValueWithError record;
+				record.value = parser.Parse(line);
+				if (!record.value) {
+					record.error_code = parser.error_code();
+					record.error_message = parser.GetErrorMessage();
+					record.error_line = chunk->lines;
+					record.error_column = parser.error_column();
+				}
+				chunk->records.push_back(std::move(record));
+			}
+		}
+
+		// The state of the job parsing |chunks|. Workers claim chunks in order
+		// until none are left.
+		class ParseJob {
+		public:
+			ParseJob(std::vector<Chunk>* chunks, int options)
+				: chunks_(chunks), options_(options) {}
+
+			void Run(experimental::JobDelegate* delegate) {
+				while (!delegate->ShouldYield()) {
+					const size_t chunk =
+						next_chunk_.fetch_add(1, std::memory_order_relaxed);
+					if (chunk >= chunks_->size())
+						return;
+					ParseChunk(&(*chunks_)[chunk], options_);
+				}
+			}
+
+			// The number of chunks that are not claimed yet.
+			size_t GetMaxConcurrency() const {
+				const size_t next_chunk = next_chunk_.load(std::memory_order_relaxed);
+				return next_chunk < chunks_->size() ? chunks_->size() - next_chunk : 0;
+			}
+
+		private:
+			std::vector<Chunk>* const chunks_;
+			const int options_;
+			std::atomic<size_t> next_chunk_{ 0 };
+
+			DISALLOW_COPY_AND_ASSIGN(ParseJob);
+		};
+
+	}  // namespace
+
+	// static
+	std::vector<JSONReader::ValueWithError> JSONLinesReader::Read(
+		std::string_view input,
+		int options,
+		const TaskTraits& traits) {
+		std::vector<Chunk> chunks = SplitIntoChunks(input);
+		if (chunks.size() == 1) {
+			ParseChunk(&chunks[0], options);
+		} else if (chunks.size() > 1) {
+			ParseJob job(&chunks, options);
+			experimental::JobHandle handle = experimental::PostJob(
+				FROM_HERE, traits, BindRepeating(&ParseJob::Run, Unretained(&job)),
+				BindRepeating(&ParseJob::GetMaxConcurrency, Unretained(&job)));
+			handle.Join();
+		}
+
+		size_t record_count = 0;
+		for (const Chunk& chunk : chunks)
+			record_count += chunk.records.size();
+		std::vector<JSONReader::ValueWithError> records;
+		records.reserve(record_count);
+		int first_line = 0;
+		for (Chunk& chunk : chunks) {
+			for (JSONReader::ValueWithError& record : chunk.records) {
+				if (!record.value)
+					record.error_line += first_line;
+				records.push_back(std::move(record));
+			}
+			first_line += chunk.lines;
+		}
+		return records;
+	}
+
+	// static
+	std::optional<std::vector<JSONReader::ValueWithError>>
+		JSONLinesReader::ReadFile(const FilePath& path,
+								  int options,
+								  const TaskTraits& traits) {
+		MemoryMappedFile file;
+		{
+			ScopedBlockingCall scoped_blocking_call(FROM_HERE, BlockingType::MAY_BLOCK);
+			if (!file.Initialize(path))
+				return std::nullopt;
+		}
+		return Read(std::string_view(reinterpret_cast<const char*>(file.data()),
+									 file.length()),
+					options, traits);
+	}
+
+}  // namespace base
@@ -0,0 +1,56 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "base_export.h"
+#include "json/json_reader.h"
+#include "macros.h"
+#include "task/task_traits.h"
+
+namespace base {
+
+	class FilePath;
+
+	// Reads newline-delimited JSON (JSON Lines, NDJSON), where every line of
+	// the input is a JSON value of its own. The input is split into chunks at
+	// line boundaries, and the chunks are parsed in parallel by a job on the
+	// thread pool (see base::PostJob()), in which the calling thread
+	// participates. Records are returned in input order.
+	//
+	// Lines holding only whitespace, including a trailing "\r" and a final
+	// newline, are skipped. Any other line that fails to parse yields a record
+	// with its error, whose |error_line| is the line number in the whole input.
+	//
+	// Usage requires a ThreadPoolInstance, except for inputs small enough to
+	// make up a single chunk, which are parsed on the calling thread.
+	class BASE_EXPORT JSONLinesReader {
+	public:
+		// Inputs are split into chunks of about this many bytes.
+		static constexpr size_t kChunkSize = 64 * 1024;
+
+		// Parses every record of |input| with |options| (see JSONParserOptions).
+		// Blocks until all of them are parsed.
+		static std::vector<JSONReader::ValueWithError> Read(
+			std::string_view input,
+			int options = JSON_PARSE_RFC,
+			const TaskTraits& traits = { ThreadPool(), TaskPriority::USER_VISIBLE });
+
+		// Like Read(), on the contents of the file at |path|, which is memory
+		// mapped rather than read into memory. Returns base::nullopt if the file
+		// cannot be mapped.
+		static std::optional<std::vector<JSONReader::ValueWithError>> ReadFile(
+			const FilePath& path,
+			int options = JSON_PARSE_RFC,
+			const TaskTraits& traits = { ThreadPool(), TaskPriority::USER_VISIBLE });
+
+	private:
+		DISALLOW_IMPLICIT_CONSTRUCTORS(JSONLinesReader);
+	};
+
+}  // namespace base
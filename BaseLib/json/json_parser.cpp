@@ -5,12 +5,21 @@
 #include "json/json_parser.h"
 
 #include <cmath>
+#include <limits>
 #include <utility>
 #include <vector>
 
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <immintrin.h>
+#endif
+
+#include "bits.h"
+#include "cpu.h"
+#include "json/json_event_handler.h"
 #include "logging.h"
 #include "macros.h"
 #include "numerics/safe_conversions.h"
+#include "strings/decimal_to_double.h"
 #include "strings/string_number_conversions.h"
 #include "strings/string_util.h"
 #include "strings/stringprintf.h"
@@ -25,6 +34,134 @@ namespace base::internal {
 		const int32_t kExtendedASCIIStart = 0x80;
 		constexpr uint32_t kUnicodeReplacementPoint = 0xFFFD;
 
+		// Structural scanners. Each returns the length of the longest prefix of
+		// [begin, end) made of bytes the caller can skip over without looking at
+		// them individually. The vector variants process 16 or 32 bytes per step
+		// and hand the tail to the next narrower variant, so all of them return
+		// the same result for the same input.
+		using ScanFunction = size_t (*)(const char* begin, const char* end);
+
+		// A byte is "plain" inside a string if it can be copied verbatim: anything
+		// but '"', '\\' and bytes >= 0x80, which need escape processing or UTF-8
+		// validation. Control characters are accepted as-is by this parser, so
+		// they are plain as well.
+		inline bool IsPlainStringByte(char c) {
+			return c != '"' && c != '\\' && static_cast<unsigned char>(c) < 0x80;
+		}
+
+		// Spaces and tabs are the only whitespace that can be skipped in bulk;
+		// line breaks update the line bookkeeping and comments need parsing.
+		inline bool IsBlankByte(char c) {
+			return c == ' ' || c == '\t';
+		}
+
+		size_t CountPlainStringBytesScalar(const char* begin, const char* end) {
+			const char* p = begin;
+			while (p != end && IsPlainStringByte(*p))
+				++p;
+			return p - begin;
+		}
+
+		size_t CountBlankBytesScalar(const char* begin, const char* end) {
+			const char* p = begin;
+			while (p != end && IsBlankByte(*p))
+				++p;
+			return p - begin;
+		}
+
+#if defined(ARCH_CPU_X86_FAMILY)
+		size_t CountPlainStringBytesSSE2(const char* begin, const char* end) {
+			const __m128i quote = _mm_set1_epi8('"');
+			const __m128i backslash = _mm_set1_epi8('\\');
+			const char* p = begin;
+			for (; end - p >= 16; p += 16) {
+				const __m128i chunk =
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+				// Non-ASCII bytes already have their top bit set, so OR-ing them in
+				// lets a single movemask catch all three kinds of special bytes.
+				const __m128i special = _mm_or_si128(
+					chunk, _mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+						_mm_cmpeq_epi8(chunk, backslash)));
+				const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(special));
+				if (mask)
+					return (p - begin) + bits::CountTrailingZeroBits(mask);
+			}
+			return (p - begin) + CountPlainStringBytesScalar(p, end);
+		}
+
+		size_t CountBlankBytesSSE2(const char* begin, const char* end) {
+			const __m128i space = _mm_set1_epi8(' ');
+			const __m128i tab = _mm_set1_epi8('\t');
+			const char* p = begin;
+			for (; end - p >= 16; p += 16) {
+				const __m128i chunk =
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+				const __m128i blank = _mm_or_si128(_mm_cmpeq_epi8(chunk, space),
+					_mm_cmpeq_epi8(chunk, tab));
+				const auto mask =
+					~static_cast<uint32_t>(_mm_movemask_epi8(blank)) & 0xFFFFu;
+				if (mask)
+					return (p - begin) + bits::CountTrailingZeroBits(mask);
+			}
+			return (p - begin) + CountBlankBytesScalar(p, end);
+		}
+
+		size_t CountPlainStringBytesAVX2(const char* begin, const char* end) {
+			const __m256i quote = _mm256_set1_epi8('"');
+			const __m256i backslash = _mm256_set1_epi8('\\');
+			const char* p = begin;
+			for (; end - p >= 32; p += 32) {
+				const __m256i chunk =
+					_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+				const __m256i special = _mm256_or_si256(
+					chunk, _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote),
+						_mm256_cmpeq_epi8(chunk, backslash)));
+				const auto mask =
+					static_cast<uint32_t>(_mm256_movemask_epi8(special));
+				if (mask)
+					return (p - begin) + bits::CountTrailingZeroBits(mask);
+			}
+			return (p - begin) + CountPlainStringBytesSSE2(p, end);
+		}
+
+		size_t CountBlankBytesAVX2(const char* begin, const char* end) {
+			const __m256i space = _mm256_set1_epi8(' ');
+			const __m256i tab = _mm256_set1_epi8('\t');
+			const char* p = begin;
+			for (; end - p >= 32; p += 32) {
+				const __m256i chunk =
+					_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+				const __m256i blank = _mm256_or_si256(
+					_mm256_cmpeq_epi8(chunk, space), _mm256_cmpeq_epi8(chunk, tab));
+				const auto mask =
+					~static_cast<uint32_t>(_mm256_movemask_epi8(blank));
+				if (mask)
+					return (p - begin) + bits::CountTrailingZeroBits(mask);
+			}
+			return (p - begin) + CountBlankBytesSSE2(p, end);
+		}
+#endif  // defined(ARCH_CPU_X86_FAMILY)
+
+		struct Scanner {
+			ScanFunction count_plain_string_bytes;
+			ScanFunction count_blank_bytes;
+		};
+
+		// Picks the widest scanner the processor supports. Done once per process.
+		const Scanner& GetScanner() {
+			static const Scanner scanner = [] {
+#if defined(ARCH_CPU_X86_FAMILY)
+				const CPU cpu;
+				if (cpu.has_avx2())
+					return Scanner{ &CountPlainStringBytesAVX2, &CountBlankBytesAVX2 };
+				if (cpu.has_sse2())
+					return Scanner{ &CountPlainStringBytesSSE2, &CountBlankBytesSSE2 };
+#endif
+				return Scanner{ &CountPlainStringBytesScalar, &CountBlankBytesScalar };
+			}();
+			return scanner;
+		}
+
 	}  // namespace
 
 	// This is U+FFFD.
@@ -46,26 +183,11 @@ namespace base::internal {
 	JSONParser::~JSONParser() = default;
 
 	std::optional<Value> JSONParser::Parse(std::string_view input) {
-		input_ = input;
-		index_ = 0;
-		line_number_ = 1;
-		index_last_line_ = 0;
-
-		error_code_ = JSONReader::JSON_NO_ERROR;
-		error_line_ = 0;
-		error_column_ = 0;
-
-		// ICU and ReadUnicodeCharacter() use int32_t for lengths, so ensure
-		// that the index_ will not overflow when parsing.
-		if (!base::IsValueInRangeForNumericType<int32_t>(input.length())) {
-			ReportError(JSONReader::JSON_TOO_LARGE, 0);
+		if (!StartParsing(input))
 			return std::nullopt;
-		}
 
-		// When the input JSON string starts with a UTF-8 Byte-Order-Mark,
-		// advance the start position to avoid the ParseNextToken function mis-
-		// treating a Unicode BOM as an invalid character and returning NULL.
-		ConsumeIfMatch("\xEF\xBB\xBF");
+		if ((options_ & JSON_INTERN_KEYS) && !key_table_)
+			key_table_ = MakeRefCounted<DictKeyTable>();
 
 		// Parse the first and any nested tokens.
 		auto root(ParseNextToken());
@@ -81,6 +203,24 @@ namespace base::internal {
 		return root;
 	}
 
+	bool JSONParser::ParseEvents(std::string_view input,
+		JSONEventHandler* handler) {
+		if (!StartParsing(input))
+			return false;
+
+		// A false return without error information means |handler| stopped.
+		if (!EmitNextToken(handler))
+			return error_code_ == JSONReader::JSON_NO_ERROR;
+
+		// Make sure the input stream is at an end.
+		if (GetNextToken() != T_END_OF_INPUT) {
+			ReportError(JSONReader::JSON_UNEXPECTED_DATA_AFTER_ROOT, 1);
+			return false;
+		}
+
+		return true;
+	}
+
 	JSONReader::JsonParseError JSONParser::error_code() const {
 		return error_code_;
 	}
@@ -126,6 +266,15 @@ namespace base::internal {
 		}
 	}
 
+	void JSONParser::StringBuilder::AppendRun(const char* run, size_t length) {
+		if (!string_) {
+			DCHECK_EQ(pos_ + length_, run);
+			length_ += length;
+		} else {
+			string_->append(run, length);
+		}
+	}
+
 	void JSONParser::StringBuilder::Convert() {
 		if (string_)
 			return;
@@ -138,8 +287,38 @@ namespace base::internal {
 		return std::string(pos_, length_);
 	}
 
+	std::string_view JSONParser::StringBuilder::AsStringView() const {
+		if (string_)
+			return *string_;
+		return std::string_view(pos_, length_);
+	}
+
 	// JSONParser private //////////////////////////////////////////////////////////
 
+	bool JSONParser::StartParsing(std::string_view input) {
+		input_ = input;
+		index_ = 0;
+		line_number_ = 1;
+		index_last_line_ = 0;
+
+		error_code_ = JSONReader::JSON_NO_ERROR;
+		error_line_ = 0;
+		error_column_ = 0;
+
+		// ICU and ReadUnicodeCharacter() use int32_t for lengths, so ensure
+		// that the index_ will not overflow when parsing.
+		if (!base::IsValueInRangeForNumericType<int32_t>(input.length())) {
+			ReportError(JSONReader::JSON_TOO_LARGE, 0);
+			return false;
+		}
+
+		// When the input JSON string starts with a UTF-8 Byte-Order-Mark,
+		// advance the start position to avoid the ParseNextToken function mis-
+		// treating a Unicode BOM as an invalid character and returning NULL.
+		ConsumeIfMatch("\xEF\xBB\xBF");
+		return true;
+	}
+
 	std::optional<std::string_view> JSONParser::PeekChars(size_t count) const {
 		if (index_ + count > input_.length())
 			return std::nullopt;
@@ -220,6 +399,7 @@ namespace base::internal {
 	}
 
 	void JSONParser::EatWhitespaceAndComments() {
+		const ScanFunction count_blank_bytes = GetScanner().count_blank_bytes;
 		while (std::optional<char> c = PeekChar()) {
 			switch (*c) {
 			case '\r':
@@ -229,10 +409,13 @@ namespace base::internal {
 				if (!(c == '\n' && index_ > 0 && input_[index_ - 1] == '\r')) {
 					++line_number_;
 				}
-				FALLTHROUGH;
+				ConsumeChar();
+				break;
 			case ' ':
 			case '\t':
-				ConsumeChar();
+				// Indentation usually comes in long runs, skip it in one step.
+				index_ += static_cast<int>(count_blank_bytes(
+					pos(), input_.data() + input_.length()));
 				break;
 			case '/':
 				if (!EatComment())
@@ -342,8 +525,13 @@ namespace base::internal {
 				return std::nullopt;
 			}
 
-			dict_storage.emplace_back(key.DestructiveAsString(),
-				std::make_unique<Value>(std::move(*value)));
+			if (key_table_) {
+				dict_storage.emplace_back(key_table_->Intern(key.AsStringView()),
+					std::make_unique<Value>(std::move(*value)));
+			} else {
+				dict_storage.emplace_back(key.DestructiveAsString(),
+					std::make_unique<Value>(std::move(*value)));
+			}
 
 			token = GetNextToken();
 			if (token == T_LIST_SEPARATOR) {
@@ -409,6 +597,151 @@ namespace base::internal {
 		return Value(std::move(list_storage));
 	}
 
+	bool JSONParser::EmitNextToken(JSONEventHandler* handler) {
+		return EmitToken(GetNextToken(), handler);
+	}
+
+	bool JSONParser::EmitToken(Token token, JSONEventHandler* handler) {
+		switch (token) {
+		case T_OBJECT_BEGIN:
+			return EmitDictionary(handler);
+		case T_ARRAY_BEGIN:
+			return EmitList(handler);
+		case T_STRING: {
+			StringBuilder string;
+			if (!ConsumeStringRaw(&string))
+				return false;
+			return handler->OnString(string.AsStringView());
+		}
+		case T_NUMBER: {
+			// Scalar Values live inline, so reusing ConsumeNumber() and
+			// ConsumeLiteral() does not allocate.
+			std::optional<Value> value = ConsumeNumber();
+			if (!value) {
+				// Numbers outside the range of a double fail without error
+				// information; report them so they are not mistaken for a stop.
+				if (error_code_ == JSONReader::JSON_NO_ERROR)
+					ReportError(JSONReader::JSON_SYNTAX_ERROR, 0);
+				return false;
+			}
+			if (value->is_int())
+				return handler->OnInt(value->GetInt());
+			return handler->OnDouble(value->GetDouble());
+		}
+		case T_BOOL_TRUE:
+		case T_BOOL_FALSE:
+		case T_NULL: {
+			std::optional<Value> value = ConsumeLiteral();
+			if (!value)
+				return false;
+			if (value->is_bool())
+				return handler->OnBool(value->GetBool());
+			return handler->OnNull();
+		}
+		default:
+			ReportError(JSONReader::JSON_UNEXPECTED_TOKEN, 1);
+			return false;
+		}
+	}
+
+	bool JSONParser::EmitDictionary(JSONEventHandler* handler) {
+		if (ConsumeChar() != '{') {
+			ReportError(JSONReader::JSON_UNEXPECTED_TOKEN, 1);
+			return false;
+		}
+
+		const StackMarker depth_check(max_depth_, &stack_depth_);
+		if (depth_check.IsTooDeep()) {
+			ReportError(JSONReader::JSON_TOO_MUCH_NESTING, 0);
+			return false;
+		}
+
+		if (!handler->OnDictBegin())
+			return false;
+
+		Token token = GetNextToken();
+		while (token != T_OBJECT_END) {
+			if (token != T_STRING) {
+				ReportError(JSONReader::JSON_UNQUOTED_DICTIONARY_KEY, 1);
+				return false;
+			}
+
+			// First consume the key.
+			StringBuilder key;
+			if (!ConsumeStringRaw(&key))
+				return false;
+
+			// Read the separator.
+			token = GetNextToken();
+			if (token != T_OBJECT_PAIR_SEPARATOR) {
+				ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
+				return false;
+			}
+
+			ConsumeChar();
+			if (!handler->OnKey(key.AsStringView()))
+				return false;
+
+			// The next token is the value.
+			if (!EmitNextToken(handler))
+				return false;
+
+			token = GetNextToken();
+			if (token == T_LIST_SEPARATOR) {
+				ConsumeChar();
+				token = GetNextToken();
+				if (token == T_OBJECT_END && !(options_ & JSON_ALLOW_TRAILING_COMMAS)) {
+					ReportError(JSONReader::JSON_TRAILING_COMMA, 1);
+					return false;
+				}
+			} else if (token != T_OBJECT_END) {
+				ReportError(JSONReader::JSON_SYNTAX_ERROR, 0);
+				return false;
+			}
+		}
+
+		ConsumeChar();  // Closing '}'.
+		return handler->OnDictEnd();
+	}
+
+	bool JSONParser::EmitList(JSONEventHandler* handler) {
+		if (ConsumeChar() != '[') {
+			ReportError(JSONReader::JSON_UNEXPECTED_TOKEN, 1);
+			return false;
+		}
+
+		const StackMarker depth_check(max_depth_, &stack_depth_);
+		if (depth_check.IsTooDeep()) {
+			ReportError(JSONReader::JSON_TOO_MUCH_NESTING, 0);
+			return false;
+		}
+
+		if (!handler->OnListBegin())
+			return false;
+
+		auto token = GetNextToken();
+		while (token != T_ARRAY_END) {
+			if (!EmitToken(token, handler))
+				return false;
+
+			token = GetNextToken();
+			if (token == T_LIST_SEPARATOR) {
+				ConsumeChar();
+				token = GetNextToken();
+				if (token == T_ARRAY_END && !(options_ & JSON_ALLOW_TRAILING_COMMAS)) {
+					ReportError(JSONReader::JSON_TRAILING_COMMA, 1);
+					return false;
+				}
+			} else if (token != T_ARRAY_END) {
+				ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
+				return false;
+			}
+		}
+
+		ConsumeChar();  // Closing ']'.
+		return handler->OnListEnd();
+	}
+
 	std::optional<Value> JSONParser::ConsumeString() {
 		StringBuilder string;
 		if (!ConsumeStringRaw(&string))
@@ -428,7 +761,20 @@ namespace base::internal {
 		// std::string.
 		StringBuilder string(pos());
 
+		const ScanFunction count_plain_string_bytes =
+			GetScanner().count_plain_string_bytes;
+		const char* const input_end = input_.data() + input_.length();
+
 		while (PeekChar()) {
+			// Copy the bytes up to the next quote, escape or non-ASCII byte in bulk;
+			// only those need to be looked at one code point at a time.
+			const size_t run_length = count_plain_string_bytes(pos(), input_end);
+			if (run_length) {
+				string.AppendRun(pos(), run_length);
+				index_ += static_cast<int>(run_length);
+				continue;
+			}
+
 			uint32_t next_char = 0;
 			if (!ReadUnicodeCharacter(input_.data(),
 				static_cast<int32_t>(input_.length()),
@@ -607,6 +953,7 @@ namespace base::internal {
 			return std::nullopt;
 		}
 		auto end_index = index_;
+		bool is_integer = true;
 
 		// The optional fraction part.
 		if (PeekChar() == '.') {
@@ -616,6 +963,7 @@ namespace base::internal {
 				return std::nullopt;
 			}
 			end_index = index_;
+			is_integer = false;
 		}
 
 		// std::optional exponent part.
@@ -630,6 +978,7 @@ namespace base::internal {
 				return std::nullopt;
 			}
 			end_index = index_;
+			is_integer = false;
 		}
 
 		// ReadInt is greedy because numbers have no easily detectable sentinel,
@@ -653,12 +1002,32 @@ namespace base::internal {
 
 		const std::string_view num_string(num_start, end_index - start_index);
 
-		int num_int;
-		if (StringToInt(num_string, &num_int))
-			return Value(num_int);
-
+		// ReadInt() has validated the digits of integers, which are converted
+		// directly. Those out of the range of an int become doubles, like
+		// integers too long to convert exactly do below.
 		double num_double;
-		if (StringToDouble(num_string.data(), &num_double) &&
+		if (is_integer) {
+			std::string_view digits = num_string;
+			const bool negative = digits.front() == '-';
+			if (negative)
+				digits.remove_prefix(1);
+			// Any 19 digits fit in 64 bits.
+			if (digits.size() <= 19) {
+				uint64_t magnitude = 0;
+				for (const char c : digits)
+					magnitude = magnitude * 10 + (c - '0');
+				const uint64_t max_magnitude =
+					static_cast<uint64_t>(std::numeric_limits<int>::max()) + negative;
+				if (magnitude <= max_magnitude) {
+					const auto num_int = static_cast<int64_t>(magnitude);
+					return Value(static_cast<int>(negative ? -num_int : num_int));
+				}
+				if (DecimalToDouble(magnitude, 0, negative, &num_double))
+					return Value(num_double);
+			}
+		}
+
+		if (StringToDouble(num_string, &num_double) &&
 			std::isfinite(num_double)) {
 			return Value(num_double);
 		}
@@ -10,13 +10,16 @@
 #include <optional>
 #include "base_export.h"
 #include "compiler_specific.h"
+#include "dict_key.h"
 #include "gtest_prod_util.h"
 #include "json/json_common.h"
 #include "json/json_reader.h"
 #include "macros.h"
+#include "memory/scoped_refptr.h"
 
 namespace base {
 
+	class JSONEventHandler;
 	class Value;
 
 	namespace internal {
@@ -48,6 +51,12 @@ namespace base {
 			// convert to a FooValue at the same time.
 			std::optional<Value> Parse(std::string_view input);
 
+			// Parses the input string like Parse(), but reports every token to
+			// |handler| instead of building a Value. Returns false if a parse error
+			// occurred; returns true if the whole input was parsed or |handler|
+			// stopped parsing early.
+			bool ParseEvents(std::string_view input, JSONEventHandler* handler);
+
 			// Returns the error code.
 			[[nodiscard]] JSONReader::JsonParseError error_code() const;
 
@@ -62,6 +71,18 @@ namespace base {
 			// returns 0.
 			[[nodiscard]] int error_column() const;
 
+			// Interns dictionary keys in |table|, as JSON_INTERN_KEYS does in a
+			// table of the parser's own, so that Values parsed by several parsers
+			// or built by other code can share their keys.
+			void set_key_table(scoped_refptr<DictKeyTable> table) {
+				key_table_ = std::move(table);
+			}
+
+			// Given the line and column number of an error, formats one of the error
+			// message contants from json_reader.h for human display.
+			static std::string FormatErrorMessage(int line, int column,
+				const std::string& description);
+
 		private:
 			enum Token {
 				T_OBJECT_BEGIN,           // {
@@ -101,6 +122,11 @@ namespace base {
 				// converted, or by appending the UTF8 bytes for the code point.
 				void Append(uint32_t point);
 
+				// Appends the |length| ASCII bytes starting at |run|. If the string has
+				// not been converted, |run| must immediately follow the bytes already in
+				// the builder, and only |length_| is increased.
+				void AppendRun(const char* run, size_t length);
+
 				// Converts the builder from its default std::string_view to a full std::string,
 				// performing a copy. Once a builder is converted, it cannot be made a
 				// std::string_view again.
@@ -111,6 +137,10 @@ namespace base {
 				// in cases where the builder will not be needed any more.
 				std::string DestructiveAsString();
 
+				// Returns the string built so far without copying it. The view is
+				// invalidated by any further change to the builder.
+				[[nodiscard]] std::string_view AsStringView() const;
+
 			private:
 				// The beginning of the input string.
 				const char* pos_;
@@ -123,6 +153,10 @@ namespace base {
 				std::optional<std::string> string_;
 			};
 
+			// Resets the parser state for |input| and skips a leading Byte-Order-Mark.
+			// Returns false with error information set if |input| is too large.
+			bool StartParsing(std::string_view input);
+
 			// Returns the next |count| bytes of the input stream, or nullopt if fewer
 			// than |count| bytes remain.
 			[[nodiscard]] std::optional<std::string_view> PeekChars(size_t count) const;
@@ -169,6 +203,16 @@ namespace base {
 			// Calls through ConsumeStringRaw and wraps it in a value.
 			std::optional<Value> ConsumeString();
 
+			// Event counterparts of ParseNextToken(), ParseToken(), ConsumeDictionary()
+			// and ConsumeList() used by ParseEvents(). Instead of returning Values
+			// they report tokens to |handler|. They return false when parsing has to
+			// stop, either because of an error, in which case error information is
+			// set, or because |handler| asked to stop.
+			bool EmitNextToken(JSONEventHandler* handler);
+			bool EmitToken(Token token, JSONEventHandler* handler);
+			bool EmitDictionary(JSONEventHandler* handler);
+			bool EmitList(JSONEventHandler* handler);
+
 			// Assuming that the parser is wound to a double quote, this parses a string,
 			// decoding any escape sequences and converts UTF-16 to UTF-8. Returns true on
 			// success and places result into |out|. Returns false on failure with
@@ -202,17 +246,16 @@ namespace base {
 			// adjustment by |column_adjust|.
 			void ReportError(JSONReader::JsonParseError code, int column_adjust);
 
-			// Given the line and column number of an error, formats one of the error
-			// message contants from json_reader.h for human display.
-			static std::string FormatErrorMessage(int line, int column,
-				const std::string& description);
-
 			// base::JSONParserOptions that control parsing.
 			const int options_;
 
 			// Maximum depth to parse.
 			const size_t max_depth_;
 
+			// Interns dictionary keys if JSON_INTERN_KEYS is set. Kept across calls
+			// to Parse(), so that documents parsed in turn share their keys.
+			scoped_refptr<DictKeyTable> key_table_;
+
 			// The input stream being parsed. Note: Not guaranteed to NUL-terminated.
 			std::string_view input_;
 
@@ -8,6 +8,7 @@
 
 #include "json/json_parser.h"
 #include "logging.h"
+#include "memory/monotonic_arena.h"
 
 namespace base {
 
@@ -63,6 +64,27 @@ namespace base {
 		return value ? Value::ToUniquePtrValue(std::move(*value)) : nullptr;
 	}
 
+	// static
+	std::optional<JSONArenaDocument> JSONReader::ReadToArena(std::string_view json,
+															 int options,
+															 size_t max_depth) {
+		auto arena = std::make_unique<MonotonicArena>();
+		internal::ArenaValueBuilder builder(
+			arena.get(), (options & JSON_BORROW_INPUT_STRINGS) ? json
+																: std::string_view());
+		internal::JSONParser parser(options, max_depth);
+		if (!parser.ParseEvents(json, &builder))
+			return std::nullopt;
+		return JSONArenaDocument(std::move(arena), builder.root());
+	}
+
+	// static
+	std::optional<JSONLazyDocument> JSONReader::ReadLazy(std::string_view json,
+														 int options,
+														 size_t max_depth) {
+		return JSONLazyDocument::Create(json, options, max_depth);
+	}
+
 	// static
 	JSONReader::ValueWithError JSONReader::ReadAndReturnValueWithError(
 			std::string_view json, 
@@ -141,6 +163,11 @@ namespace base {
 		return value ? std::make_unique<Value>(std::move(*value)) : nullptr;
 	}
 
+	bool JSONReader::ReadEvents(std::string_view json,
+								JSONEventHandler* handler) const {
+		return parser_->ParseEvents(json, handler);
+	}
+
 	JSONReader::JsonParseError JSONReader::error_code() const {
 		return parser_->error_code();
 	}
@@ -32,11 +32,15 @@
 #include <optional>
 
 #include "base_export.h"
+#include "json/json_arena_document.h"
 #include "json/json_common.h"
+#include "json/json_lazy_document.h"
 #include "values.h"
 
 namespace base {
 
+	class JSONEventHandler;
+
 	namespace internal {
 		class JSONParser;
 	}
@@ -53,6 +57,20 @@ namespace base {
 		// character (U+FFFD). If not set, invalid characters trigger a hard error and
 		// parsing fails.
 		JSON_REPLACE_INVALID_CHARACTERS = 1 << 1,
+
+		// Only used by JSONReader::ReadToArena(). If set, strings and dictionary
+		// keys that need no unescaping reference the input instead of being
+		// copied into the document, so the input (for example a memory-mapped
+		// file) must outlive the document. Value always owns its strings, so the
+		// other Read methods ignore this option.
+		JSON_BORROW_INPUT_STRINGS = 1 << 2,
+
+		// If set, dictionary keys are interned in a DictKeyTable, so that every
+		// distinct key of the result is allocated once however many
+		// dictionaries have it. This saves memory on documents made of many
+		// records with the same keys, if the keys are too long to be stored
+		// inline in a std::string.
+		JSON_INTERN_KEYS = 1 << 3,
 	};
 
 	class BASE_EXPORT JSONReader {
@@ -129,6 +147,25 @@ namespace base {
 		static ValueWithError ReadAndReturnValueWithError(std::string_view json,
 														  int options);
 
+		// Reads and parses |json| like Read(), but places the resulting tree in a
+		// MonotonicArena owned by the returned document instead of allocating
+		// every node on the heap. This is considerably cheaper to build and to
+		// destroy when the result is only read. See JSON_BORROW_INPUT_STRINGS to
+		// avoid copying strings as well. Returns base::nullopt on error.
+		static std::optional<JSONArenaDocument> ReadToArena(
+			std::string_view json,
+			int options = JSON_PARSE_RFC,
+			size_t max_depth = internal::kAbsoluteMaxDepth);
+
+		// Indexes |json| for on-demand parsing with a JSONLazyDocument, which
+		// refers to |json| and must not outlive it. Returns base::nullopt if the
+		// structure of |json| is invalid; see JSONLazyDocument for what is
+		// checked up front.
+		static std::optional<JSONLazyDocument> ReadLazy(
+			std::string_view json,
+			int options = JSON_PARSE_RFC,
+			size_t max_depth = internal::kAbsoluteMaxDepth);
+
 		// Deprecated. Use the ReadAndReturnValueWithError() method above.
 		// Reads and parses |json| like Read(). |error_code_out| and |error_msg_out|
 		// are optional. If specified and nullptr is returned, they will be populated
@@ -153,7 +190,15 @@ namespace base {
 		// Non-static version of Read() above.
 		[[nodiscard]] std::unique_ptr<Value> ReadToValueDeprecated(std::string_view json) const;
 
-		// Returns the error code if the last call to ReadToValue() failed.
+		// Parses |json| with the same rules and error reporting as ReadToValue(),
+		// but reports every token to |handler| instead of building a Value tree,
+		// so memory use is bounded by the nesting depth rather than the size of
+		// the document. Returns false on a parse error, and true if the whole
+		// input was parsed or |handler| stopped parsing early.
+		bool ReadEvents(std::string_view json, JSONEventHandler* handler) const;
+
+		// Returns the error code if the last call to ReadToValue() or ReadEvents()
+		// failed.
 		// Returns JSON_NO_ERROR otherwise.
 		[[nodiscard]] JsonParseError error_code() const;
 
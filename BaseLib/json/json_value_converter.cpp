@@ -4,10 +4,70 @@
 
 #include "json/json_value_converter.h"
 
+#include "hash/hash.h"
 #include "strings/utf_string_conversions.h"
 
 namespace base::internal {
 
+	FieldNameTable::FieldNameTable() = default;
+
+	FieldNameTable::~FieldNameTable() = default;
+
+	void FieldNameTable::Build(const std::vector<std::string_view>& names) {
+		size_t capacity = 4;
+		while (capacity < 2 * names.size())
+			capacity *= 2;
+		slots_.assign(capacity, Slot{ 0, kNotFound });
+		fields_.clear();
+		fields_.reserve(names.size());
+
+		const size_t mask = capacity - 1;
+		for (size_t i = 0; i < names.size(); ++i) {
+			const std::string_view name = names[i];
+			fields_.push_back(
+				{ name, kNotFound, name.empty() || name.find('.') != std::string_view::npos });
+			if (fields_.back().is_path)
+				continue;
+
+			const size_t hash = HashName(name);
+			for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+				Slot& entry = slots_[slot];
+				if (entry.index == kNotFound) {
+					entry = { hash, i };
+					break;
+				}
+				if (entry.hash == hash && fields_[entry.index].name == name) {
+					// Chain the field to the last one registered with this name.
+					size_t last = entry.index;
+					while (fields_[last].next != kNotFound)
+						last = fields_[last].next;
+					fields_[last].next = i;
+					break;
+				}
+			}
+		}
+	}
+
+	size_t FieldNameTable::Find(std::string_view key) const {
+		if (slots_.empty())
+			return kNotFound;
+		const size_t mask = slots_.size() - 1;
+		const size_t hash = HashName(key);
+		for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+			const Slot& entry = slots_[slot];
+			if (entry.index == kNotFound)
+				return kNotFound;
+			if (entry.hash == hash && fields_[entry.index].name == key)
+				return entry.index;
+		}
+	}
+
+	// static
+	size_t FieldNameTable::HashName(std::string_view name) {
+		return FastHash(
+			make_span(reinterpret_cast<const uint8_t*>(name.data()), name.size()));
+	}
+
 	bool BasicValueConverter<int>::Convert(
 			const Value& value, int* field) const {
 		if (!value.is_int())
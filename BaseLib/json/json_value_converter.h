@@ -6,8 +6,10 @@
 
 #include <stddef.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "base_export.h"
@@ -80,6 +82,12 @@
 //           "your_enum", &Message::ye, &ConvertFunc);
 //     }
 //   };
+//
+// Once RegisterJSONConverter() returns, the constructor indexes the field
+// names in a hash table (see Finalize()), so that Convert() visits every
+// member of the dictionary once, and looks each key up in constant time,
+// rather than searching the dictionary for every registered field. Fields
+// are still converted in the order they were registered in.
 
 namespace base {
 
@@ -88,6 +96,55 @@ namespace base {
 
 	namespace internal {
 
+		// Maps the names of a JSONValueConverter's fields to their indices.
+		// Names are hashed when the table is built, into an open-addressed
+		// table that is at most half full, so that looking a key up takes one
+		// hash and usually a single string comparison.
+		class BASE_EXPORT FieldNameTable {
+		public:
+			static constexpr size_t kNotFound = static_cast<size_t>(-1);
+
+			FieldNameTable();
+			~FieldNameTable();
+
+			// Indexes the fields named |names|, which must outlive the table.
+			// Names with a '.', and the empty name, are paths to look up with
+			// Value::FindPath() instead, and are not indexed.
+			void Build(const std::vector<std::string_view>& names);
+
+			// Returns the index of the first field named |key|, or kNotFound.
+			[[nodiscard]] size_t Find(std::string_view key) const;
+
+			// Returns the index of the next field with the same name as the
+			// field at |index|, or kNotFound.
+			[[nodiscard]] size_t next(size_t index) const { return fields_[index].next; }
+
+			[[nodiscard]] bool is_path(size_t index) const { return fields_[index].is_path; }
+
+			// The number of fields the table was built for.
+			[[nodiscard]] size_t size() const { return fields_.size(); }
+
+		private:
+			struct Field {
+				std::string_view name;
+				size_t next;
+				bool is_path;
+			};
+
+			struct Slot {
+				size_t hash;
+				// The first field with the name, or kNotFound if the slot is empty.
+				size_t index;
+			};
+
+			static size_t HashName(std::string_view name);
+
+			std::vector<Field> fields_;
+			std::vector<Slot> slots_;
+
+			DISALLOW_COPY_AND_ASSIGN(FieldNameTable);
+		};
+
 		template<typename StructType>
 		class FieldConverterBase {
 		public:
@@ -347,6 +404,19 @@ namespace base {
 	public:
 		JSONValueConverter() {
 			StructType::RegisterJSONConverter(this);
+			Finalize();
+		}
+
+		// Indexes the names of the registered fields for Convert(). The
+		// constructor calls this after RegisterJSONConverter(); fields
+		// registered later on are only dispatched through the table once this
+		// is called again, and Convert() looks every field up until then.
+		void Finalize() {
+			std::vector<std::string_view> names;
+			names.reserve(fields_.size());
+			for (const auto& field : fields_)
+				names.push_back(field->field_path());
+			table_.Build(names);
 		}
 
 		void RegisterIntField(const std::string& field_name,
@@ -482,7 +552,50 @@ namespace base {
 		bool Convert(const base::Value& value, StructType* output) const {
 			if (!value.is_dict())
 				return false;
+			if (table_.size() != fields_.size())
+				return ConvertEachField(value, output);
+
+			// Find the values of the fields in one pass over the dictionary, and
+			// convert them in the order the fields were registered in.
+			const size_t count = fields_.size();
+			const base::Value* inline_values[kMaxInlineFields];
+			std::unique_ptr<const base::Value*[]> heap_values;
+			const base::Value** values = inline_values;
+			if (count > kMaxInlineFields) {
+				heap_values = std::make_unique<const base::Value*[]>(count);
+				values = heap_values.get();
+			}
+			std::fill_n(values, count, nullptr);
+			for (const auto& item : value.DictItems()) {
+				for (size_t i = table_.Find(item.first);
+					i != internal::FieldNameTable::kNotFound; i = table_.next(i)) {
+					values[i] = &item.second;
+				}
+			}
+
+			for (size_t i = 0; i < count; ++i) {
+				const internal::FieldConverterBase<StructType>* field_converter =
+					fields_[i].get();
+				const base::Value* field =
+					table_.is_path(i) ? value.FindPath(field_converter->field_path())
+					: values[i];
+				if (field) {
+					if (!field_converter->ConvertField(*field, output)) {
+						DVLOG(1) << "failure at field " << field_converter->field_path();
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+
+	private:
+		// Structs with up to this many fields are converted without allocating.
+		static constexpr size_t kMaxInlineFields = 64;
 
+		// Looks every field up in |value|, for fields registered after
+		// Finalize().
+		bool ConvertEachField(const base::Value& value, StructType* output) const {
 			for (size_t i = 0; i < fields_.size(); ++i) {
 				const internal::FieldConverterBase<StructType>* field_converter =
 					fields_[i].get();
@@ -497,9 +610,9 @@ namespace base {
 			return true;
 		}
 
-	private:
 		std::vector<std::unique_ptr<internal::FieldConverterBase<StructType>>>
 			fields_;
+		internal::FieldNameTable table_;
 
 		DISALLOW_COPY_AND_ASSIGN(JSONValueConverter);
 	};
@@ -6,6 +6,7 @@
 
 #include <cstdint>
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
@@ -18,6 +19,52 @@ namespace base {
 
 	const char kPrettyPrintLineEnding[] = "\r\n";
 
+	namespace {
+
+		// Returns a rough estimate of the length of the JSON written for |node|,
+		// assuming strings need no escaping and numbers are short. This is
+		// cheap compared with writing, and lets the output be reserved up
+		// front rather than grown repeatedly while writing. Containers nested
+		// deeper than |max_depth|, which cannot be written, are not counted.
+		size_t EstimateJSONLength(const Value& node,
+								  bool pretty_print,
+								  size_t max_depth) {
+			switch (node.type()) {
+			case Value::Type::NONE:
+			case Value::Type::BOOLEAN:
+				return 4;
+			case Value::Type::INTEGER:
+			case Value::Type::DOUBLE:
+				return 2;
+			case Value::Type::STRING:
+				return node.GetString().size() + 2;
+			case Value::Type::LIST: {
+				size_t length = 2;
+				if (!max_depth)
+					return length;
+				for (const auto& value : node.GetList())
+					length += EstimateJSONLength(value, pretty_print, max_depth - 1) + 1;
+				return length;
+			}
+			case Value::Type::DICTIONARY: {
+				size_t length = 2;
+				if (!max_depth)
+					return length;
+				for (const auto& pair : node.DictItems()) {
+					length += pair.first.size() + 4 +
+						EstimateJSONLength(pair.second, pretty_print, max_depth - 1);
+					if (pretty_print)
+						length += 4;
+				}
+				return length;
+			}
+			default:
+				return 0;
+			}
+		}
+
+	}  // namespace
+
 	// static
 	bool JSONWriter::Write(const Value& node, std::string* json, size_t max_depth) {
 		return WriteWithOptions(node, 0, json, max_depth);
@@ -29,8 +76,9 @@ namespace base {
 									  std::string* json,
 									  size_t max_depth) {
 		json->clear();
-		// Is there a better way to estimate the size of the output?
-		json->reserve(1024);
+		json->reserve(std::max<size_t>(
+			1024, EstimateJSONLength(node, (options & OPTIONS_PRETTY_PRINT) != 0,
+									 max_depth)));
 
 		JSONWriter writer(options, json, max_depth);
 		bool result = writer.BuildJSONString(node, 0U);
@@ -71,7 +119,7 @@ namespace base {
 			return true;
 
 		case Value::Type::INTEGER:
-			json_string_->append(NumberToString(node.GetInt()));
+			AppendNumber(json_string_, node.GetInt());
 			return true;
 
 		case Value::Type::DOUBLE: {
@@ -80,25 +128,26 @@ namespace base {
 				value <= std::numeric_limits<int64_t>::max() &&
 				value >= std::numeric_limits<int64_t>::min() &&
 				std::floor(value) == value) {
-				json_string_->append(NumberToString(static_cast<int64_t>(value)));
+				AppendNumber(json_string_, static_cast<int64_t>(value));
 				return true;
 			}
-			auto real = NumberToString(value);
-			// Ensure that the number has a .0 if there's no decimal or 'e'.  This
-			// makes sure that when we read the JSON back, it's interpreted as a
-			// real rather than an int.
-			if (real.find_first_of(".eE") == std::string::npos)
-				real.append(".0");
+			char buffer[kMaxNumberChars];
+			const std::string_view real(buffer, ToChars(value, buffer));
 
 			// The JSON spec requires that non-integer values in the range (-1,1)
 			// have a zero before the decimal point - ".52" is not valid, "0.52" is.
-			if (real[0] == '.') {
-				real.insert(static_cast<size_t>(0), static_cast<size_t>(1), '0');
-			} else if (real.length() > 1 && real[0] == '-' && real[1] == '.') {
-				// "-.1" bad "-0.1" good
-				real.insert(static_cast<size_t>(1), static_cast<size_t>(1), '0');
-			}
-			json_string_->append(real);
+			// "-.1" bad "-0.1" good
+			const size_t sign_length = real[0] == '-' ? 1 : 0;
+			json_string_->append(real.substr(0, sign_length));
+			if (real.size() > sign_length && real[sign_length] == '.')
+				json_string_->push_back('0');
+			json_string_->append(real.substr(sign_length));
+
+			// Ensure that the number has a .0 if there's no decimal or 'e'.  This
+			// makes sure that when we read the JSON back, it's interpreted as a
+			// real rather than an int.
+			if (real.find_first_of(".eE") == std::string_view::npos)
+				json_string_->append(".0");
 			return true;
 		}
 
@@ -9,6 +9,14 @@
 #include <limits>
 #include <string>
 
+#include "build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <immintrin.h>
+#endif
+
+#include "bits.h"
+#include "cpu.h"
 #include "strings/string_util.h"
 #include "strings/stringprintf.h"
 #include "strings/utf_string_conversion_utils.h"
@@ -75,6 +83,234 @@ namespace base {
 			return true;
 		}
 
+		// Escape sequences for the ASCII characters that need one, in the same
+		// spelling EscapeSpecialCodePoint() and kU16EscapeFormat produce, or
+		// nullptr for characters that are copied as-is.
+		struct ASCIIEscapeTable {
+			const char* escapes[0x80] = {};
+			uint8_t lengths[0x80] = {};
+
+			constexpr ASCIIEscapeTable() {
+				constexpr const char* kControlEscapes[0x20] = {
+					"\\u0000", "\\u0001", "\\u0002", "\\u0003",
+					"\\u0004", "\\u0005", "\\u0006", "\\u0007",
+					"\\b",     "\\t",     "\\n",     "\\u000B",
+					"\\f",     "\\r",     "\\u000E", "\\u000F",
+					"\\u0010", "\\u0011", "\\u0012", "\\u0013",
+					"\\u0014", "\\u0015", "\\u0016", "\\u0017",
+					"\\u0018", "\\u0019", "\\u001A", "\\u001B",
+					"\\u001C", "\\u001D", "\\u001E", "\\u001F",
+				};
+				for (int c = 0; c < 0x20; ++c)
+					Set(c, kControlEscapes[c]);
+				Set('"', "\\\"");
+				Set('\\', "\\\\");
+				Set('<', "\\u003C");
+			}
+
+			constexpr void Set(int c, const char* escape) {
+				escapes[c] = escape;
+				lengths[c] = 0;
+				while (escape[lengths[c]])
+					++lengths[c];
+			}
+		};
+
+		constexpr ASCIIEscapeTable kASCIIEscapes;
+
+		// Returns whether the byte |c| of UTF-8 input can be copied to the output
+		// as-is. Non-ASCII bytes are not clean because the code point they are
+		// part of must be validated, and U+2028 and U+2029 are escaped.
+		inline bool IsCleanByte(char c) {
+			const auto byte = static_cast<unsigned char>(c);
+			return byte < 0x80 && !kASCIIEscapes.escapes[byte];
+		}
+
+		// Clean byte scanners. Each returns the length of the longest prefix of
+		// [begin, end) made of clean bytes. The vector variants hand their tail
+		// to the next narrower variant, so all of them agree.
+		using ScanFunction = size_t (*)(const char* begin, const char* end);
+
+		size_t CountCleanBytesScalar(const char* begin, const char* end) {
+			const char* p = begin;
+			while (p != end && IsCleanByte(*p))
+				++p;
+			return p - begin;
+		}
+
+#if defined(ARCH_CPU_X86_FAMILY)
+		size_t CountCleanBytesSSE2(const char* begin, const char* end) {
+			const __m128i space = _mm_set1_epi8(' ');
+			const __m128i quote = _mm_set1_epi8('"');
+			const __m128i backslash = _mm_set1_epi8('\\');
+			const __m128i less_than = _mm_set1_epi8('<');
+			const char* p = begin;
+			for (; end - p >= 16; p += 16) {
+				const __m128i chunk =
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+				// As signed bytes, both control characters and non-ASCII bytes
+				// compare less than a space.
+				const __m128i special = _mm_or_si128(
+					_mm_or_si128(_mm_cmplt_epi8(chunk, space),
+						_mm_cmpeq_epi8(chunk, quote)),
+					_mm_or_si128(_mm_cmpeq_epi8(chunk, backslash),
+						_mm_cmpeq_epi8(chunk, less_than)));
+				const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(special));
+				if (mask)
+					return (p - begin) + bits::CountTrailingZeroBits(mask);
+			}
+			return (p - begin) + CountCleanBytesScalar(p, end);
+		}
+
+		size_t CountCleanBytesAVX2(const char* begin, const char* end) {
+			const __m256i space = _mm256_set1_epi8(' ');
+			const __m256i quote = _mm256_set1_epi8('"');
+			const __m256i backslash = _mm256_set1_epi8('\\');
+			const __m256i less_than = _mm256_set1_epi8('<');
+			const char* p = begin;
+			for (; end - p >= 32; p += 32) {
+				const __m256i chunk =
+					_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+				const __m256i special = _mm256_or_si256(
+					_mm256_or_si256(_mm256_cmpgt_epi8(space, chunk),
+						_mm256_cmpeq_epi8(chunk, quote)),
+					_mm256_or_si256(_mm256_cmpeq_epi8(chunk, backslash),
+						_mm256_cmpeq_epi8(chunk, less_than)));
+				const auto mask =
+					static_cast<uint32_t>(_mm256_movemask_epi8(special));
+				if (mask)
+					return (p - begin) + bits::CountTrailingZeroBits(mask);
+			}
+			return (p - begin) + CountCleanBytesSSE2(p, end);
+		}
+#endif  // defined(ARCH_CPU_X86_FAMILY)
+
+		// Picks the widest scanner the processor supports. Done once per process.
+		ScanFunction GetCountCleanBytes() {
+			static const ScanFunction count_clean_bytes = [] {
+#if defined(ARCH_CPU_X86_FAMILY)
+				const CPU cpu;
+				if (cpu.has_avx2())
+					return &CountCleanBytesAVX2;
+				if (cpu.has_sse2())
+					return &CountCleanBytesSSE2;
+#endif
+				return &CountCleanBytesScalar;
+			}();
+			return count_clean_bytes;
+		}
+
+		// Returns the length of the well-formed UTF-8 sequence for a non-ASCII
+		// character at the start of [p, end) if it can be copied as-is, or 0 if
+		// it is malformed or needs escaping or replacement.
+		size_t CleanUTF8SequenceLength(const unsigned char* p,
+			const unsigned char* end) {
+			const auto is_continuation = [](unsigned char c) {
+				return (c & 0xC0) == 0x80;
+			};
+			const size_t available = end - p;
+			const unsigned char lead = p[0];
+			if (lead >= 0xC2 && lead <= 0xDF) {
+				// U+0080 to U+07FF are all valid characters.
+				return available >= 2 && is_continuation(p[1]) ? 2 : 0;
+			}
+			if (lead >= 0xE0 && lead <= 0xEF) {
+				if (available < 3 || !is_continuation(p[1]) ||
+					!is_continuation(p[2])) {
+					return 0;
+				}
+				const uint32_t code_point =
+					((lead & 0x0F) << 12) | ((p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+				// Rejects overlong forms and surrogates too.
+				return code_point >= 0x800 && IsValidCharacter(code_point) &&
+					code_point != 0x2028 && code_point != 0x2029 ? 3 : 0;
+			}
+			if (lead >= 0xF0 && lead <= 0xF4) {
+				if (available < 4 || !is_continuation(p[1]) ||
+					!is_continuation(p[2]) || !is_continuation(p[3])) {
+					return 0;
+				}
+				const uint32_t code_point = ((lead & 0x07) << 18) |
+					((p[1] & 0x3F) << 12) | ((p[2] & 0x3F) << 6) | (p[3] & 0x3F);
+				return code_point >= 0x10000 && IsValidCharacter(code_point) ? 4 : 0;
+			}
+			return 0;
+		}
+
+		// UTF-8 version of EscapeJSONStringImpl() below, with the same output.
+		// Runs of clean bytes are copied in bulk and valid multi-byte characters
+		// are copied without being re-encoded.
+		bool EscapeJSONStringUTF8(std::string_view str,
+			bool put_in_quotes,
+			std::string* dest) {
+			auto did_replacement = false;
+
+			// Casting is necessary because ICU uses int32_t. Try and do so safely.
+			CHECK_LE(str.length(),
+				static_cast<size_t>(std::numeric_limits<int32_t>::max()));
+			const auto length = static_cast<int32_t>(str.length());
+
+			// Most strings need few escapes, if any.
+			dest->reserve(dest->size() + str.length() + 2);
+
+			if (put_in_quotes)
+				dest->push_back('"');
+
+			const ScanFunction count_clean_bytes = GetCountCleanBytes();
+			const char* const begin = str.data();
+			const char* const end = begin + length;
+			const char* p = begin;
+			while (true) {
+				const size_t run_length = count_clean_bytes(p, end);
+				dest->append(p, run_length);
+				p += run_length;
+				if (p == end)
+					break;
+
+				const auto byte = static_cast<unsigned char>(*p);
+				if (byte < 0x80) {
+					dest->append(kASCIIEscapes.escapes[byte],
+						kASCIIEscapes.lengths[byte]);
+					++p;
+					continue;
+				}
+
+				// Copy runs of valid multi-byte characters in one go as well.
+				const char* const run_begin = p;
+				while (p != end) {
+					const size_t sequence_length = CleanUTF8SequenceLength(
+						reinterpret_cast<const unsigned char*>(p),
+						reinterpret_cast<const unsigned char*>(end));
+					if (!sequence_length)
+						break;
+					p += sequence_length;
+				}
+				if (p != run_begin) {
+					dest->append(run_begin, p - run_begin);
+					continue;
+				}
+
+				// Malformed input, or a character that needs escaping.
+				auto i = static_cast<int32_t>(p - begin);
+				uint32_t code_point;
+				if (!ReadUnicodeCharacter(begin, length, &i, &code_point) ||
+					code_point == static_cast<decltype(code_point)>(CBU_SENTINEL) ||
+					!IsValidCharacter(code_point)) {
+					WriteUnicodeCharacter(kReplacementCodePoint, dest);
+					did_replacement = true;
+				} else if (!EscapeSpecialCodePoint(code_point, dest)) {
+					// Valid UTF-8 round-trips unchanged.
+					dest->append(p, begin + i + 1 - p);
+				}
+				p = begin + i + 1;
+			}
+
+			if (put_in_quotes)
+				dest->push_back('"');
+
+			return !did_replacement;
+		}
+
 		template <typename S>
 		bool EscapeJSONStringImpl(const S& str, bool put_in_quotes, std::string* dest) {
 			auto did_replacement = false;
@@ -115,7 +351,7 @@ namespace base {
 	}  // namespace
 
 	bool EscapeJSONString(std::string_view str, bool put_in_quotes, std::string* dest) {
-		return EscapeJSONStringImpl(str, put_in_quotes, dest);
+		return EscapeJSONStringUTF8(str, put_in_quotes, dest);
 	}
 
 	bool EscapeJSONString(std::wstring_view str,
@@ -126,7 +362,7 @@ namespace base {
 
 	std::string GetQuotedJSONString(std::string_view str) {
 		std::string dest;
-		EscapeJSONStringImpl(str, true, &dest);
+		EscapeJSONStringUTF8(str, true, &dest);
 		return dest;
 	}
 
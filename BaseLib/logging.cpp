@@ -285,7 +285,7 @@ namespace logging {
 		// (but will always be valid or nullptr).
 		VlogInfo* vlog_info = g_vlog_info;
 		return vlog_info ?
-			vlog_info->GetVlogLevel(std::string(file, N - 1)) :
+			vlog_info->GetVlogLevelForStaticFile(file, N - 1) :
 			GetVlogVerbosity();
 	}
 
@@ -253,10 +253,12 @@ namespace logging {
 	// Gets the VLOG default verbosity level.
 	BASE_EXPORT int GetVlogVerbosity();
 
-	// Note that |N| is the size *with* the null terminator.
+	// Note that |N| is the size *with* the null terminator. |file_start| must
+	// stay valid and unchanged, since the --vmodule match is cached per pointer.
 	BASE_EXPORT int GetVlogLevelHelper(const char* file_start, size_t N);
 
 	// Gets the current vlog level for the given file (usually taken from __FILE__).
+	// |file| must be a string literal.
 	template <size_t N>
 	int GetVlogLevel(const char(&file)[N]) {
 		return GetVlogLevelHelper(file, N);
@@ -380,9 +382,10 @@ namespace logging {
 	(::logging::ShouldCreateLogMessage(::logging::LOG_##severity))
 
 // We don't do any caching tricks with VLOG_IS_ON() like the
-// google-glog version since it increases binary size.  This means
-// that using the v-logging functions in conjunction with --vmodule
-// may be slow.
+// google-glog version since it increases binary size. Instead the
+// --vmodule patterns are matched once per __FILE__ string and the
+// result is kept in a small lock-free table, so --vmodule adds a hash
+// lookup per v-logging statement.
 #define VLOG_IS_ON(verboselevel) \
 	((verboselevel) <= ::logging::GetVlogLevel(__FILE__))
 
@@ -0,0 +1,70 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "memory/monotonic_arena.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "bits.h"
+#include "logging.h"
+#include "process/memory.h"
+
+namespace base {
+
+	// Blocks are allocated with their header in front of the usable space.
+	struct MonotonicArena::Block {
+		Block* next;
+	};
+
+	MonotonicArena::MonotonicArena(size_t initial_block_size)
+		: next_block_size_(std::max<size_t>(initial_block_size, 64)) {}
+
+	MonotonicArena::~MonotonicArena() {
+		while (head_) {
+			Block* next = head_->next;
+			free(head_);
+			head_ = next;
+		}
+	}
+
+	void* MonotonicArena::Allocate(size_t size, size_t alignment) {
+		DCHECK(bits::IsPowerOfTwo(alignment));
+		auto address = reinterpret_cast<uintptr_t>(cursor_);
+		auto aligned = (address + alignment - 1) & ~(uintptr_t{alignment} - 1);
+		if (!cursor_ || aligned + size > reinterpret_cast<uintptr_t>(limit_)) {
+			AddBlock(size, alignment);
+			address = reinterpret_cast<uintptr_t>(cursor_);
+			aligned = (address + alignment - 1) & ~(uintptr_t{alignment} - 1);
+		}
+		cursor_ = reinterpret_cast<char*>(aligned + size);
+		return reinterpret_cast<void*>(aligned);
+	}
+
+	std::string_view MonotonicArena::CopyString(std::string_view str) {
+		if (str.empty())
+			return std::string_view();
+		auto* copy = static_cast<char*>(Allocate(str.size(), 1));
+		memcpy(copy, str.data(), str.size());
+		return std::string_view(copy, str.size());
+	}
+
+	void MonotonicArena::AddBlock(size_t size, size_t alignment) {
+		const size_t needed = sizeof(Block) + size + alignment;
+		const size_t block_size = std::max(needed, next_block_size_);
+		next_block_size_ = std::min(next_block_size_ * 2, kMaxBlockSize);
+
+		auto* block = static_cast<Block*>(malloc(block_size));
+		if (!block)
+			TerminateBecauseOutOfMemory(block_size);
+		block->next = head_;
+		head_ = block;
+		bytes_reserved_ += block_size;
+
+		cursor_ = reinterpret_cast<char*>(block + 1);
+		limit_ = reinterpret_cast<char*>(block) + block_size;
+	}
+
+}  // namespace base
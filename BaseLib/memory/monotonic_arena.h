@@ -0,0 +1,68 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <type_traits>
+
+#include "base_export.h"
+#include "macros.h"
+
+namespace base {
+
+	// A bump-pointer allocator. Memory is carved out of a chain of blocks and is
+	// only ever released all at once, when the arena is destroyed. This makes
+	// building large trees of small objects cheap, and tearing them down a matter
+	// of freeing a handful of blocks.
+	//
+	// Destructors of objects placed in the arena are never run, so only trivially
+	// destructible types may be allocated. Not thread-safe.
+	class BASE_EXPORT MonotonicArena {
+	public:
+		// Blocks start at |initial_block_size| bytes and double in size, up to
+		// kMaxBlockSize, as the arena grows. Larger allocations get a block of
+		// their own.
+		explicit MonotonicArena(size_t initial_block_size = 4096);
+		~MonotonicArena();
+
+		static constexpr size_t kMaxBlockSize = 1024 * 1024;
+
+		// Returns |size| bytes aligned to |alignment|, which must be a power of
+		// two. The memory is uninitialized.
+		void* Allocate(size_t size, size_t alignment);
+
+		// Returns uninitialized storage for |count| objects of type T.
+		template <typename T>
+		T* AllocateArray(size_t count) {
+			static_assert(std::is_trivially_destructible<T>::value,
+				"MonotonicArena never runs destructors");
+			return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+		}
+
+		// Copies |str| into the arena and returns a view of the copy.
+		std::string_view CopyString(std::string_view str);
+
+		// Total size of the blocks obtained from the heap so far.
+		[[nodiscard]] size_t bytes_reserved() const { return bytes_reserved_; }
+
+	private:
+		struct Block;
+
+		// Links in a new block large enough for |size| bytes at |alignment|.
+		void AddBlock(size_t size, size_t alignment);
+
+		Block* head_ = nullptr;
+		char* cursor_ = nullptr;
+		char* limit_ = nullptr;
+		size_t next_block_size_;
+		size_t bytes_reserved_ = 0;
+
+		DISALLOW_COPY_AND_ASSIGN(MonotonicArena);
+	};
+
+}  // namespace base
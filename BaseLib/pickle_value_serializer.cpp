@@ -0,0 +1,392 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "pickle_value_serializer.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "json/json_common.h"
+#include "logging.h"
+#include "pickle.h"
+#include "strings/string_util.h"
+
+namespace base {
+
+	namespace {
+
+		// Bump this whenever the encoding changes.
+		const int kFormatVersion = 1;
+
+		enum Tag : uint8_t {
+			kTagNone = 0,
+			kTagFalse,
+			kTagTrue,
+			kTagInt,
+			kTagDouble,
+			kTagString,
+			kTagBinary,
+			kTagList,
+			kTagDict,
+		};
+
+		// Zigzag encoding maps small negative numbers to small unsigned ones.
+		uint32_t ZigzagEncode(int value) {
+			return (static_cast<uint32_t>(value) << 1) ^
+				static_cast<uint32_t>(value >> 31);
+		}
+
+		int ZigzagDecode(uint32_t value) {
+			return static_cast<int>((value >> 1) ^ (~(value & 1) + 1));
+		}
+
+		class Encoder {
+		public:
+			explicit Encoder(std::string* out) : out_(out) {}
+
+			// Returns false if |value| is nested more than |max_depth| deep.
+			bool Encode(const Value& value, size_t max_depth) {
+				switch (value.type()) {
+				case Value::Type::NONE:
+					out_->push_back(kTagNone);
+					return true;
+				case Value::Type::BOOLEAN:
+					out_->push_back(value.GetBool() ? kTagTrue : kTagFalse);
+					return true;
+				case Value::Type::INTEGER:
+					out_->push_back(kTagInt);
+					WriteVarint(ZigzagEncode(value.GetInt()));
+					return true;
+				case Value::Type::DOUBLE: {
+					const double number = value.GetDouble();
+					char bytes[sizeof(number)];
+					memcpy(bytes, &number, sizeof(number));
+					out_->push_back(kTagDouble);
+					out_->append(bytes, sizeof(bytes));
+					return true;
+				}
+				case Value::Type::STRING:
+					out_->push_back(kTagString);
+					WriteString(value.GetString());
+					return true;
+				case Value::Type::BINARY: {
+					const Value::BlobStorage& blob = value.GetBlob();
+					out_->push_back(kTagBinary);
+					WriteString(std::string_view(
+						reinterpret_cast<const char*>(blob.data()), blob.size()));
+					return true;
+				}
+				case Value::Type::LIST:
+					if (!max_depth)
+						return false;
+					out_->push_back(kTagList);
+					WriteVarint(value.GetList().size());
+					for (const Value& element : value.GetList()) {
+						if (!Encode(element, max_depth - 1))
+							return false;
+					}
+					return true;
+				case Value::Type::DICTIONARY:
+					if (!max_depth)
+						return false;
+					out_->push_back(kTagDict);
+					WriteVarint(value.DictSize());
+					for (const auto& item : value.DictItems()) {
+						WriteString(item.first);
+						if (!Encode(item.second, max_depth - 1))
+							return false;
+					}
+					return true;
+				default:
+					NOTREACHED();
+					return false;
+				}
+			}
+
+		private:
+			void WriteVarint(uint64_t value) {
+				char bytes[10];
+				size_t length = 0;
+				while (value >= 0x80) {
+					bytes[length++] = static_cast<char>(value | 0x80);
+					value >>= 7;
+				}
+				bytes[length++] = static_cast<char>(value);
+				out_->append(bytes, length);
+			}
+
+			void WriteString(std::string_view str) {
+				WriteVarint(str.size());
+				out_->append(str.data(), str.size());
+			}
+
+			std::string* const out_;
+
+			DISALLOW_COPY_AND_ASSIGN(Encoder);
+		};
+
+		class Decoder {
+		public:
+			Decoder(const char* data, size_t size) : pos_(data), end_(data + size) {}
+
+			using Error = PickleValueDeserializer::Error;
+
+			// Decodes a value nested in at most |max_depth| containers.
+			bool Decode(Value* out, size_t max_depth) {
+				uint8_t tag;
+				if (!ReadByte(&tag))
+					return false;
+				switch (tag) {
+				case kTagNone:
+					*out = Value();
+					return true;
+				case kTagFalse:
+				case kTagTrue:
+					*out = Value(tag == kTagTrue);
+					return true;
+				case kTagInt: {
+					uint64_t zigzag;
+					if (!ReadVarint(&zigzag))
+						return false;
+					if (zigzag > std::numeric_limits<uint32_t>::max())
+						return Fail(Error::kInvalidEncoding);
+					*out = Value(ZigzagDecode(static_cast<uint32_t>(zigzag)));
+					return true;
+				}
+				case kTagDouble: {
+					double number;
+					if (static_cast<size_t>(end_ - pos_) < sizeof(number))
+						return Fail(Error::kTruncated);
+					memcpy(&number, pos_, sizeof(number));
+					pos_ += sizeof(number);
+					// Value does not hold NaN or infinities.
+					if (!std::isfinite(number))
+						return Fail(Error::kInvalidEncoding);
+					*out = Value(number);
+					return true;
+				}
+				case kTagString: {
+					std::string_view str;
+					if (!ReadUTF8String(&str))
+						return false;
+					*out = Value(str);
+					return true;
+				}
+				case kTagBinary: {
+					std::string_view blob;
+					if (!ReadString(&blob))
+						return false;
+					*out = Value(Value::BlobStorage(blob.begin(), blob.end()));
+					return true;
+				}
+				case kTagList:
+					return DecodeList(out, max_depth);
+				case kTagDict:
+					return DecodeDict(out, max_depth);
+				default:
+					return Fail(Error::kInvalidEncoding);
+				}
+			}
+
+			[[nodiscard]] bool at_end() const { return pos_ == end_; }
+			[[nodiscard]] Error error() const { return error_; }
+
+		private:
+			bool DecodeList(Value* out, size_t max_depth) {
+				if (!max_depth)
+					return Fail(Error::kTooMuchNesting);
+				size_t count;
+				if (!ReadCount(&count))
+					return false;
+				Value::ListStorage list;
+				list.reserve(count);
+				for (size_t i = 0; i < count; ++i) {
+					list.emplace_back();
+					if (!Decode(&list.back(), max_depth - 1))
+						return false;
+				}
+				*out = Value(std::move(list));
+				return true;
+			}
+
+			bool DecodeDict(Value* out, size_t max_depth) {
+				if (!max_depth)
+					return Fail(Error::kTooMuchNesting);
+				size_t count;
+				if (!ReadCount(&count))
+					return false;
+				// Members were written in key order, so each one is appended with
+				// the end as its hint, which takes no search.
+				Value::DictStorage dict;
+				dict.reserve(count);
+				for (size_t i = 0; i < count; ++i) {
+					std::string_view key;
+					if (!ReadUTF8String(&key))
+						return false;
+					if (i && !(std::prev(dict.end())->first < key))
+						return Fail(Error::kUnsortedKeys);
+					auto value = std::make_unique<Value>();
+					if (!Decode(value.get(), max_depth - 1))
+						return false;
+					dict.try_emplace(dict.end(), std::string(key), std::move(value));
+				}
+				*out = Value(std::move(dict));
+				return true;
+			}
+
+			bool ReadByte(uint8_t* byte) {
+				if (pos_ == end_)
+					return Fail(Error::kTruncated);
+				*byte = static_cast<uint8_t>(*pos_++);
+				return true;
+			}
+
+			bool ReadVarint(uint64_t* value) {
+				*value = 0;
+				for (int shift = 0; shift < 64; shift += 7) {
+					uint8_t byte;
+					if (!ReadByte(&byte))
+						return false;
+					*value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+					if (!(byte & 0x80))
+						return true;
+				}
+				return Fail(Error::kInvalidEncoding);
+			}
+
+			// Reads the number of elements of a container. Every element takes at
+			// least one byte, which bounds how much memory a corrupt count can make
+			// the decoder reserve.
+			bool ReadCount(size_t* count) {
+				uint64_t value;
+				if (!ReadVarint(&value))
+					return false;
+				if (value > static_cast<uint64_t>(end_ - pos_))
+					return Fail(Error::kTruncated);
+				*count = static_cast<size_t>(value);
+				return true;
+			}
+
+			bool ReadString(std::string_view* str) {
+				uint64_t length;
+				if (!ReadVarint(&length))
+					return false;
+				if (length > static_cast<uint64_t>(end_ - pos_))
+					return Fail(Error::kTruncated);
+				*str = std::string_view(pos_, static_cast<size_t>(length));
+				pos_ += length;
+				return true;
+			}
+
+			// Reads a string, which Value requires to be UTF-8.
+			bool ReadUTF8String(std::string_view* str) {
+				if (!ReadString(str))
+					return false;
+				if (!IsStringUTF8(*str))
+					return Fail(Error::kInvalidEncoding);
+				return true;
+			}
+
+			bool Fail(Error error) {
+				if (error_ == Error::kNoError)
+					error_ = error;
+				return false;
+			}
+
+			const char* pos_;
+			const char* const end_;
+			Error error_ = Error::kNoError;
+
+			DISALLOW_COPY_AND_ASSIGN(Decoder);
+		};
+
+	}  // namespace
+
+	// PickleValueSerializer ///////////////////////////////////////////////////////
+
+	PickleValueSerializer::PickleValueSerializer(Pickle* pickle)
+		: pickle_(pickle) {
+		DCHECK(pickle_);
+	}
+
+	PickleValueSerializer::~PickleValueSerializer() = default;
+
+	bool PickleValueSerializer::Serialize(const Value& root) {
+		std::string encoded;
+		Encoder encoder(&encoded);
+		if (!encoder.Encode(root, internal::kAbsoluteMaxDepth) ||
+			encoded.size() > static_cast<size_t>(std::numeric_limits<int>::max())) {
+			return false;
+		}
+		pickle_->WriteInt(kFormatVersion);
+		pickle_->WriteData(encoded.data(), static_cast<int>(encoded.size()));
+		return true;
+	}
+
+	// PickleValueDeserializer /////////////////////////////////////////////////////
+
+	PickleValueDeserializer::PickleValueDeserializer(PickleIterator* iter)
+		: iter_(iter) {
+		DCHECK(iter_);
+	}
+
+	PickleValueDeserializer::~PickleValueDeserializer() = default;
+
+	std::unique_ptr<Value> PickleValueDeserializer::Deserialize(
+		int* error_code,
+		std::string* error_message) {
+		Error error = kNoError;
+		int version;
+		const char* data;
+		int length;
+		auto value = std::make_unique<Value>();
+		if (!iter_->ReadInt(&version) || version != kFormatVersion ||
+			!iter_->ReadData(&data, &length)) {
+			error = kInvalidHeader;
+		} else {
+			Decoder decoder(data, length);
+			if (!decoder.Decode(value.get(), internal::kAbsoluteMaxDepth))
+				error = decoder.error();
+			else if (!decoder.at_end())
+				error = kTrailingData;
+		}
+
+		if (error == kNoError)
+			return value;
+		if (error_code)
+			*error_code = error;
+		if (error_message)
+			*error_message = ErrorToString(error);
+		return nullptr;
+	}
+
+	// static
+	const char* PickleValueDeserializer::ErrorToString(Error error) {
+		switch (error) {
+		case kNoError:
+			return "";
+		case kInvalidHeader:
+			return "Not a serialized value, or an unsupported version.";
+		case kTruncated:
+			return "Serialized value is truncated.";
+		case kInvalidEncoding:
+			return "Serialized value has an invalid encoding.";
+		case kUnsortedKeys:
+			return "Dictionary keys are not sorted.";
+		case kTooMuchNesting:
+			return "Serialized value is nested too deeply.";
+		case kTrailingData:
+			return "Unexpected data after the serialized value.";
+		}
+		NOTREACHED();
+		return "";
+	}
+
+}  // namespace base
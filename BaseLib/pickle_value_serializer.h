@@ -0,0 +1,85 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "base_export.h"
+#include "macros.h"
+#include "values.h"
+
+namespace base {
+
+	class Pickle;
+	class PickleIterator;
+
+	// Serializes Values into a compact binary format carried by a Pickle. This
+	// is considerably faster to write and read than JSON, keeps doubles exact,
+	// and can hold binary values, which makes it a better choice for caches and
+	// IPC between components that agree on it. The data starts with a format
+	// version, so that readers reject formats they do not understand.
+	//
+	// Each value is a one-byte type tag followed by its payload: integers as
+	// zigzag varints, doubles as their 8 bytes, strings and blobs with a
+	// varint length prefix, and lists and dictionaries with a varint element
+	// count. Dictionary members are written in key order. Like the rest of
+	// Pickle, doubles are in host byte order.
+	class BASE_EXPORT PickleValueSerializer : public ValueSerializer {
+	public:
+		// The serialized value is appended to |pickle|, which must outlive the
+		// serializer.
+		explicit PickleValueSerializer(Pickle* pickle);
+		~PickleValueSerializer() override;
+
+		// Appends |root| to the pickle. Fails, leaving the pickle unchanged, if
+		// |root| is nested too deeply to be deserialized again.
+		bool Serialize(const Value& root) override;
+
+	private:
+		Pickle* const pickle_;
+
+		DISALLOW_COPY_AND_ASSIGN(PickleValueSerializer);
+	};
+
+	class BASE_EXPORT PickleValueDeserializer : public ValueDeserializer {
+	public:
+		enum Error {
+			kNoError = 0,
+			// The pickle is not in the expected format or version.
+			kInvalidHeader,
+			// A length or count reaches past the end of the data.
+			kTruncated,
+			// An unknown type tag, a malformed varint, a NaN or infinite double,
+			// or a string or dictionary key that is not UTF-8.
+			kInvalidEncoding,
+			// Dictionary keys are not in strictly increasing order.
+			kUnsortedKeys,
+			// Nesting is deeper than the JSON parser allows.
+			kTooMuchNesting,
+			// Bytes are left over after the root value.
+			kTrailingData,
+		};
+
+		// Reads the next value from |iter|, whose pickle must outlive the
+		// deserializer.
+		explicit PickleValueDeserializer(PickleIterator* iter);
+		~PickleValueDeserializer() override;
+
+		// Validates and decodes the value. Returns null on error, and sets
+		// |error_code| to one of the Error values and |error_message| to a
+		// description of it if they are non-null.
+		std::unique_ptr<Value> Deserialize(int* error_code,
+										   std::string* error_message) override;
+
+		static const char* ErrorToString(Error error);
+
+	private:
+		PickleIterator* const iter_;
+
+		DISALLOW_COPY_AND_ASSIGN(PickleValueDeserializer);
+	};
+
+}  // namespace base
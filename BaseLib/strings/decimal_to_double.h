@@ -0,0 +1,34 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <cstdint>
+
+#include "base_export.h"
+
+namespace base {
+
+	namespace internal {
+
+		// Sets |*output| to the double nearest to |mantissa| * 10^|exponent10|,
+		// negated if |negative|, rounding ties to even. Exactly representable
+		// inputs are computed with a single floating-point operation (Clinger's
+		// fast path), and the others with the Eisel-Lemire algorithm, which takes
+		// a 128-bit multiplication by a table entry.
+		//
+		// Returns false without touching |*output| in the rare cases where the
+		// algorithm cannot tell which way to round, and for results that
+		// underflow to a subnormal or zero or overflow to infinity. Callers must
+		// then fall back to an exact conversion such as double_conversion's
+		// StringToDoubleConverter, whose results this function reproduces
+		// bit for bit whenever it succeeds.
+		BASE_EXPORT bool DecimalToDouble(uint64_t mantissa,
+										 int exponent10,
+										 bool negative,
+										 double* output);
+
+	}  // namespace internal
+
+}  // namespace base
@@ -0,0 +1,325 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "strings/multi_string_matcher.h"
+
+#include <cstring>
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <immintrin.h>
+#endif
+
+#include "bits.h"
+#include "cpu.h"
+#include "logging.h"
+#include "strings/string_split.h"
+
+namespace base {
+
+	namespace {
+
+		// Substring finders. Each returns the offset of the first occurrence of
+		// the |pattern_size| bytes at |pattern| that lies entirely in
+		// [begin, end), or npos. The vector variants load the bytes that would
+		// line up with the first and with the last pattern byte for 16 or 32
+		// start positions at once, and only compare the rest of the pattern where
+		// both agree. |pattern_size| is at least 2.
+		using FindSubstringFunction = size_t (*)(const char* begin,
+			const char* end,
+			const char* pattern,
+			size_t pattern_size);
+
+		size_t FindSubstringScalar(const char* begin,
+			const char* end,
+			const char* pattern,
+			size_t pattern_size) {
+			return std::string_view(begin, end - begin)
+				.find(std::string_view(pattern, pattern_size));
+		}
+
+		// Returns the offset of the first match among the start positions in
+		// |mask|, counted from |p|, or npos.
+		size_t CheckCandidates(const char* p,
+			uint32_t mask,
+			const char* pattern,
+			size_t pattern_size) {
+			while (mask) {
+				const size_t offset = bits::CountTrailingZeroBits(mask);
+				if (!memcmp(p + offset + 1, pattern + 1, pattern_size - 2))
+					return offset;
+				mask &= mask - 1;
+			}
+			return std::string_view::npos;
+		}
+
+		size_t AddOffset(size_t offset, size_t found) {
+			return found == std::string_view::npos ? found : offset + found;
+		}
+
+#if defined(ARCH_CPU_X86_FAMILY)
+		size_t FindSubstringSSE2(const char* begin,
+			const char* end,
+			const char* pattern,
+			size_t pattern_size) {
+			const __m128i first = _mm_set1_epi8(pattern[0]);
+			const __m128i last = _mm_set1_epi8(pattern[pattern_size - 1]);
+			// One past the last position a match can start at.
+			const char* const limit = end - pattern_size + 1;
+			const char* p = begin;
+			for (; limit - p >= 16; p += 16) {
+				const __m128i block_first =
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+				const __m128i block_last = _mm_loadu_si128(
+					reinterpret_cast<const __m128i*>(p + pattern_size - 1));
+				const __m128i candidates = _mm_and_si128(
+					_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last));
+				const auto mask =
+					static_cast<uint32_t>(_mm_movemask_epi8(candidates));
+				const size_t found = CheckCandidates(p, mask, pattern, pattern_size);
+				if (found != std::string_view::npos)
+					return (p - begin) + found;
+			}
+			return AddOffset(p - begin,
+				FindSubstringScalar(p, end, pattern, pattern_size));
+		}
+
+		size_t FindSubstringAVX2(const char* begin,
+			const char* end,
+			const char* pattern,
+			size_t pattern_size) {
+			const __m256i first = _mm256_set1_epi8(pattern[0]);
+			const __m256i last = _mm256_set1_epi8(pattern[pattern_size - 1]);
+			const char* const limit = end - pattern_size + 1;
+			const char* p = begin;
+			for (; limit - p >= 32; p += 32) {
+				const __m256i block_first =
+					_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+				const __m256i block_last = _mm256_loadu_si256(
+					reinterpret_cast<const __m256i*>(p + pattern_size - 1));
+				const __m256i candidates = _mm256_and_si256(
+					_mm256_cmpeq_epi8(block_first, first),
+					_mm256_cmpeq_epi8(block_last, last));
+				const auto mask =
+					static_cast<uint32_t>(_mm256_movemask_epi8(candidates));
+				const size_t found = CheckCandidates(p, mask, pattern, pattern_size);
+				if (found != std::string_view::npos)
+					return (p - begin) + found;
+			}
+			return AddOffset(p - begin,
+				FindSubstringSSE2(p, end, pattern, pattern_size));
+		}
+#endif  // defined(ARCH_CPU_X86_FAMILY)
+
+		// Picks the widest finder the processor supports. Done once per process.
+		FindSubstringFunction GetFindSubstringFunction() {
+			static const FindSubstringFunction find_substring = [] {
+#if defined(ARCH_CPU_X86_FAMILY)
+				const CPU cpu;
+				if (cpu.has_avx2())
+					return &FindSubstringAVX2;
+				if (cpu.has_sse2())
+					return &FindSubstringSSE2;
+#endif
+				return &FindSubstringScalar;
+			}();
+			return find_substring;
+		}
+
+	}  // namespace
+
+	namespace internal {
+
+		size_t FindSubstring(std::string_view text,
+			std::string_view pattern,
+			size_t pos) {
+			if (pos > text.size() || pattern.size() > text.size() - pos)
+				return std::string_view::npos;
+			if (pattern.size() <= 1)
+				return pattern.empty() ? pos : text.find(pattern[0], pos);
+			return AddOffset(pos, GetFindSubstringFunction()(text.data() + pos,
+				text.data() + text.size(), pattern.data(), pattern.size()));
+		}
+
+	}  // namespace internal
+
+	MultiStringMatcher::MultiStringMatcher(span<const std::string_view> patterns) {
+		Build(patterns);
+	}
+
+	MultiStringMatcher::MultiStringMatcher(
+		std::initializer_list<std::string_view> patterns)
+		: MultiStringMatcher(make_span(patterns.begin(), patterns.end())) {}
+
+	MultiStringMatcher::~MultiStringMatcher() = default;
+
+	void MultiStringMatcher::Build(span<const std::string_view> patterns) {
+		pattern_lengths_.reserve(patterns.size());
+		size_t distinct_patterns = 0;
+		for (size_t i = 0; i < patterns.size(); ++i) {
+			pattern_lengths_.push_back(patterns[i].size());
+			if (patterns[i].empty())
+				continue;
+			if (distinct_patterns == 0) {
+				single_pattern_ = std::string(patterns[i]);
+				single_pattern_index_ = i;
+				distinct_patterns = 1;
+			} else if (patterns[i] != single_pattern_) {
+				distinct_patterns = 2;
+			}
+		}
+		if (distinct_patterns < 2)
+			return;
+		single_pattern_.clear();
+
+		for (const auto pattern : patterns) {
+			for (const char c : pattern) {
+				auto& byte_class = byte_classes_[static_cast<uint8_t>(c)];
+				if (!byte_class)
+					byte_class = static_cast<uint16_t>(class_count_++);
+			}
+		}
+
+		// Build the trie, with -1 for missing transitions.
+		transitions_.assign(class_count_, -1);
+		depths_.push_back(0);
+		outputs_.push_back(-1);
+		for (size_t i = 0; i < patterns.size(); ++i) {
+			State state = 0;
+			for (const char c : patterns[i]) {
+				const size_t index = state * class_count_ +
+					byte_classes_[static_cast<uint8_t>(c)];
+				if (transitions_[index] < 0) {
+					transitions_[index] = static_cast<State>(depths_.size());
+					transitions_.resize(transitions_.size() + class_count_, -1);
+					depths_.push_back(depths_[state] + 1);
+					outputs_.push_back(-1);
+				}
+				state = transitions_[index];
+			}
+			if (state && outputs_[state] < 0)
+				outputs_[state] = static_cast<int32_t>(i);
+		}
+
+		// Fill in the missing transitions from the failure links, breadth first
+		// so that the failure state of each state is complete before it is
+		// used. A state that ends no pattern itself inherits the output of its
+		// failure state, the longest pattern that is a proper suffix.
+		std::vector<State> failures(depths_.size(), 0);
+		std::vector<State> queue;
+		queue.reserve(depths_.size());
+		queue.push_back(0);
+		for (size_t head = 0; head < queue.size(); ++head) {
+			const State state = queue[head];
+			for (size_t byte_class = 0; byte_class < class_count_; ++byte_class) {
+				State& next = transitions_[state * class_count_ + byte_class];
+				const State fallback = state ?
+					transitions_[failures[state] * class_count_ + byte_class] : 0;
+				if (next < 0) {
+					next = fallback;
+					continue;
+				}
+				failures[next] = fallback;
+				if (outputs_[next] < 0)
+					outputs_[next] = outputs_[fallback];
+				queue.push_back(next);
+			}
+		}
+
+		for (const auto pattern : patterns) {
+			if (!pattern.empty() &&
+				first_bytes_.find(pattern[0]) == std::string::npos) {
+				first_bytes_ += pattern[0];
+			}
+		}
+		if (first_bytes_.size() > internal::kMaxVectorizedCharacters)
+			first_bytes_.clear();
+	}
+
+	bool MultiStringMatcher::FindNext(std::string_view text,
+		size_t pos,
+		Match* match) const {
+		if (!single_pattern_.empty()) {
+			const size_t offset = internal::FindSubstring(text, single_pattern_, pos);
+			if (offset == std::string_view::npos)
+				return false;
+			*match = { single_pattern_index_, offset, single_pattern_.size() };
+			return true;
+		}
+		if (transitions_.empty())
+			return false;
+
+		// |match| holds the best candidate so far. It is final once the
+		// automaton has moved past its start, since no longer match can begin
+		// there any more.
+		bool found = false;
+		State state = 0;
+		for (size_t i = pos; i < text.size(); ++i) {
+			if (!state && !found && !first_bytes_.empty()) {
+				i = internal::FindFirstOf(text, first_bytes_, i);
+				if (i == std::string_view::npos)
+					return false;
+			}
+			state = Next(state, static_cast<uint8_t>(text[i]));
+			if (found && i + 1 - depths_[state] > match->offset)
+				return true;
+			const int32_t output = outputs_[state];
+			if (output < 0)
+				continue;
+			const size_t length = pattern_lengths_[output];
+			const size_t offset = i + 1 - length;
+			if (!found || offset < match->offset ||
+				(offset == match->offset && length > match->length)) {
+				*match = { static_cast<size_t>(output), offset, length };
+				found = true;
+			}
+		}
+		return found;
+	}
+
+	std::optional<MultiStringMatcher::Match> MultiStringMatcher::FindFirst(
+		std::string_view text,
+		size_t pos) const {
+		Match match;
+		if (pos > text.size() || !FindNext(text, pos, &match))
+			return std::nullopt;
+		return match;
+	}
+
+	std::vector<MultiStringMatcher::Match> MultiStringMatcher::FindAll(
+		std::string_view text) const {
+		std::vector<Match> matches;
+		Match match;
+		for (size_t pos = 0; FindNext(text, pos, &match);
+			pos = match.offset + match.length) {
+			matches.push_back(match);
+		}
+		return matches;
+	}
+
+	size_t MultiStringMatcher::ReplaceAll(
+		std::string* text,
+		span<const std::string_view> replacements) const {
+		DCHECK_EQ(pattern_count(), replacements.size());
+		const std::string_view input = *text;
+		Match match;
+		if (!FindNext(input, 0, &match))
+			return 0;
+
+		std::string output;
+		output.reserve(input.size());
+		size_t count = 0;
+		size_t pos = 0;
+		do {
+			output.append(input.data() + pos, match.offset - pos);
+			output.append(replacements[match.pattern].data(),
+				replacements[match.pattern].size());
+			pos = match.offset + match.length;
+			++count;
+		} while (FindNext(input, pos, &match));
+		output.append(input.data() + pos, input.size() - pos);
+		text->swap(output);
+		return count;
+	}
+
+}  // namespace base
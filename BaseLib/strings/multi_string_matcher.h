@@ -0,0 +1,117 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base_export.h"
+#include "containers/span.h"
+
+namespace base {
+
+	namespace internal {
+
+		// Returns the position of the first occurrence of |pattern| in |text| at
+		// or after |pos|, or npos. Same result as std::string_view::find(), but
+		// candidate positions are filtered on the first and last byte of the
+		// pattern 16 or 32 bytes at a time when the processor allows.
+		BASE_EXPORT size_t FindSubstring(std::string_view text,
+			std::string_view pattern,
+			size_t pos);
+
+	}  // namespace internal
+
+	// MultiStringMatcher finds any of a set of patterns in one pass over the
+	// text, however many patterns there are. It is built once from the
+	// patterns (an Aho-Corasick automaton) and can then be used on any number
+	// of texts, from any thread.
+	//
+	// Matches are leftmost-longest: among the matches starting earliest, the
+	// longest pattern wins, and the search resumes after it. So with patterns
+	// "ab" and "abcd", "xabcd" matches "abcd" at 1.
+	//
+	// To expand the placeholders of a template:
+	//
+	//   const std::string_view kPlaceholders[] = { "{{name}}", "{{id}}" };
+	//   static const base::NoDestructor<base::MultiStringMatcher> matcher(
+	//       kPlaceholders);
+	//   const std::string_view values[] = { name, id };
+	//   matcher->ReplaceAll(&page, values);
+	class BASE_EXPORT MultiStringMatcher {
+	public:
+		struct Match {
+			// Index of the matching pattern.
+			size_t pattern;
+			// Position of the match in the text.
+			size_t offset;
+			size_t length;
+		};
+
+		// Empty patterns never match. When a pattern appears more than once, the
+		// first index is reported.
+		explicit MultiStringMatcher(span<const std::string_view> patterns);
+		MultiStringMatcher(std::initializer_list<std::string_view> patterns);
+		~MultiStringMatcher();
+
+		MultiStringMatcher(const MultiStringMatcher&) = delete;
+		MultiStringMatcher& operator=(const MultiStringMatcher&) = delete;
+
+		// Returns the first match in |text| at or after |pos|.
+		std::optional<Match> FindFirst(std::string_view text, size_t pos = 0) const;
+
+		// Returns every match in |text|, in order, without overlaps.
+		std::vector<Match> FindAll(std::string_view text) const;
+
+		// Replaces every match in |*text| with |replacements[match.pattern]| in
+		// a single pass, and returns the number of replacements. Unlike calling
+		// ReplaceSubstringsAfterOffset() once per pattern, replaced text is
+		// never searched again.
+		size_t ReplaceAll(std::string* text,
+			span<const std::string_view> replacements) const;
+
+		size_t pattern_count() const { return pattern_lengths_.size(); }
+
+	private:
+		using State = int32_t;
+
+		void Build(span<const std::string_view> patterns);
+
+		// Runs the automaton from |pos|; see FindFirst().
+		bool FindNext(std::string_view text, size_t pos, Match* match) const;
+
+		State Next(State state, uint8_t byte) const {
+			return transitions_[state * class_count_ + byte_classes_[byte]];
+		}
+
+		std::vector<size_t> pattern_lengths_;
+
+		// With a single distinct pattern, the vectorized substring search beats
+		// the automaton and no table is built.
+		std::string single_pattern_;
+		size_t single_pattern_index_ = 0;
+
+		// Bytes that occur in no pattern share class 0, so the transition table
+		// has one column per distinct pattern byte, plus one.
+		uint16_t byte_classes_[256] = {};
+		size_t class_count_ = 1;
+
+		// For each state: its transitions, the length of the pattern prefix it
+		// stands for, and the longest pattern ending there, or -1.
+		std::vector<State> transitions_;
+		std::vector<uint32_t> depths_;
+		std::vector<int32_t> outputs_;
+
+		// The distinct first bytes of the patterns, if few enough to skip to
+		// the next of them with internal::FindFirstOf(); empty otherwise.
+		std::string first_bytes_;
+	};
+
+}  // namespace base
@@ -3,6 +3,9 @@
 // found in the LICENSE file.
 
 #include "strings/pattern.h"
+
+#include <algorithm>
+
 #include "third_party/icu/icu_utf.h"
 
 namespace base {
@@ -132,6 +135,23 @@ namespace base {
 			}
 		};
 
+		// Returns the character at |*index| in |string| and moves past it. Invalid
+		// UTF-8 decodes to CBU_SENTINEL, as in MatchPattern().
+		int32_t NextCharacter(std::string_view string,
+			size_t* index,
+			CompiledPattern::Syntax syntax) {
+			const auto byte = static_cast<uint8_t>(string[*index]);
+			if (syntax == CompiledPattern::Syntax::kFilePath || byte < 0x80) {
+				++*index;
+				return byte;
+			}
+			base_icu::UChar32 c;
+			int32_t offset = static_cast<int32_t>(*index);
+			CBU8_NEXT(string.data(), offset, static_cast<int32_t>(string.size()), c);
+			*index = offset;
+			return c;
+		}
+
 		struct NextCharUTF16 {
 			base_icu::UChar32 operator()(const wchar_t** p, const wchar_t* end) const {
 				base_icu::UChar32 c;
@@ -154,4 +174,184 @@ namespace base {
 			pattern.data() + pattern.size(), NextCharUTF16());
 	}
 
+	CompiledPattern::CompiledPattern(std::string_view pattern, Syntax syntax)
+		: syntax_(syntax) {
+		enum class TokenType { kCharacter, kAnyOne, kOptionalOne, kStar };
+		struct Token {
+			TokenType type;
+			int32_t character;
+		};
+
+		// Split the pattern into tokens. For kWildcard, a run of wildcards with a
+		// * in it is a single *, as in MatchPattern().
+		std::vector<Token> tokens;
+		bool escape = false;
+		for (size_t i = 0; i < pattern.size();) {
+			const int32_t c = NextCharacter(pattern, &i, syntax);
+			const bool wildcard = !escape && (c == '*' || c == '?');
+			if (syntax == Syntax::kWildcard && !escape && c == '\\') {
+				escape = true;
+				continue;
+			}
+			escape = false;
+			if (!wildcard) {
+				tokens.push_back({ TokenType::kCharacter,
+					syntax == Syntax::kFilePath && c == '\\' ? '/' : c });
+			} else if (c == '*') {
+				while (!tokens.empty() && (tokens.back().type == TokenType::kStar ||
+					tokens.back().type == TokenType::kOptionalOne)) {
+					tokens.pop_back();
+				}
+				tokens.push_back({ TokenType::kStar, 0 });
+			} else if (syntax == Syntax::kFilePath) {
+				tokens.push_back({ TokenType::kAnyOne, 0 });
+			} else if (tokens.empty() || tokens.back().type != TokenType::kStar) {
+				tokens.push_back({ TokenType::kOptionalOne, 0 });
+			}
+		}
+
+		accept_position_ = tokens.size();
+		words_ = accept_position_ / 64 + 1;
+		masks_.assign((kTableSize + 1) * words_, 0);
+		star_positions_.assign(words_, 0);
+		empty_positions_.assign(words_, 0);
+		const size_t any_offset = kTableSize * words_;
+
+		size_t empty_run = 0;
+		for (size_t i = 0; i < tokens.size(); ++i) {
+			const Word bit = Word{ 1 } << (i % 64);
+			const size_t word = i / 64;
+			const Token& token = tokens[i];
+			switch (token.type) {
+			case TokenType::kCharacter:
+				if (token.character >= 0 && token.character < kTableSize) {
+					masks_[token.character * words_ + word] |= bit;
+					if (syntax == Syntax::kFilePath && token.character == '/')
+						masks_['\\' * words_ + word] |= bit;
+				} else if (token.character != CBU_SENTINEL) {
+					auto other = std::find_if(other_characters_.begin(),
+						other_characters_.end(), [&token](const auto& entry) {
+							return entry.first == token.character;
+						});
+					if (other == other_characters_.end()) {
+						other_characters_.emplace_back(token.character, masks_.size());
+						masks_.resize(masks_.size() + words_, 0);
+						other = other_characters_.end() - 1;
+					}
+					masks_[other->second + word] |= bit;
+				}
+				break;
+			case TokenType::kAnyOne:
+				masks_[any_offset + word] |= bit;
+				break;
+			case TokenType::kOptionalOne:
+				masks_[any_offset + word] |= bit;
+				empty_positions_[word] |= bit;
+				break;
+			case TokenType::kStar:
+				empty_positions_[word] |= bit;
+				star_positions_[(i + 1) / 64] |= Word{ 1 } << ((i + 1) % 64);
+				break;
+			}
+			if (token.type == TokenType::kOptionalOne ||
+				token.type == TokenType::kStar) {
+				longest_empty_run_ = std::max(longest_empty_run_, ++empty_run);
+			} else {
+				empty_run = 0;
+			}
+		}
+
+		// Characters that the pattern does not name advance the wildcards only;
+		// the ones it names advance the wildcards too.
+		for (size_t offset = 0; offset < masks_.size(); offset += words_) {
+			if (offset == any_offset)
+				continue;
+			for (size_t word = 0; word < words_; ++word)
+				masks_[offset + word] |= masks_[any_offset + word];
+		}
+		ends_with_star_ = !tokens.empty() && tokens.back().type == TokenType::kStar;
+	}
+
+	CompiledPattern::CompiledPattern(const CompiledPattern& other) = default;
+
+	CompiledPattern::CompiledPattern(CompiledPattern&& other) noexcept = default;
+
+	CompiledPattern& CompiledPattern::operator=(const CompiledPattern& other) =
+		default;
+
+	CompiledPattern& CompiledPattern::operator=(CompiledPattern&& other) noexcept =
+		default;
+
+	CompiledPattern::~CompiledPattern() = default;
+
+	bool CompiledPattern::Match(std::string_view eval) const {
+		const Word accept_bit = Word{ 1 } << (accept_position_ % 64);
+
+		if (words_ == 1) {
+			// The common case, one register for the whole automaton.
+			const Word stars = star_positions_[0];
+			const Word empty = empty_positions_[0];
+			Word state = 1;
+			for (size_t run = 0; run < longest_empty_run_; ++run)
+				state |= (state & empty) << 1;
+			for (size_t i = 0; i < eval.size();) {
+				if (ends_with_star_ && (state & accept_bit))
+					return true;
+				const Word* masks = MasksFor(NextCharacter(eval, &i, syntax_));
+				state = ((state & masks[0]) << 1) | (state & stars);
+				if (!state)
+					return false;
+				for (size_t run = 0; run < longest_empty_run_; ++run)
+					state |= (state & empty) << 1;
+			}
+			return (state & accept_bit) != 0;
+		}
+
+		std::vector<Word> state(words_, 0);
+		std::vector<Word> next(words_);
+		state[0] = 1;
+		FollowEmptyMatches(state.data());
+		const size_t accept_word = accept_position_ / 64;
+		for (size_t i = 0; i < eval.size();) {
+			if (ends_with_star_ && (state[accept_word] & accept_bit))
+				return true;
+			const Word* masks = MasksFor(NextCharacter(eval, &i, syntax_));
+			Word carry = 0;
+			Word active = 0;
+			for (size_t word = 0; word < words_; ++word) {
+				const Word advanced = state[word] & masks[word];
+				next[word] = (advanced << 1) | carry |
+					(state[word] & star_positions_[word]);
+				carry = advanced >> 63;
+				active |= next[word];
+			}
+			if (!active)
+				return false;
+			FollowEmptyMatches(next.data());
+			state.swap(next);
+		}
+		return (state[accept_word] & accept_bit) != 0;
+	}
+
+	const CompiledPattern::Word* CompiledPattern::MasksFor(int32_t c) const {
+		if (c >= 0 && c < kTableSize)
+			return &masks_[c * words_];
+		for (const auto& other : other_characters_) {
+			if (other.first == c)
+				return &masks_[other.second];
+		}
+		return &masks_[kTableSize * words_];
+	}
+
+	void CompiledPattern::FollowEmptyMatches(Word* state) const {
+		for (size_t run = 0; run < longest_empty_run_; ++run) {
+			Word carry = 0;
+			for (size_t word = 0; word < words_; ++word) {
+				const Word skipped = state[word] & empty_positions_[word];
+				state[word] |= (skipped << 1) | carry;
+				carry = skipped >> 63;
+			}
+		}
+	}
+
 }  // namespace base
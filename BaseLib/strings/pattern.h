@@ -5,7 +5,11 @@
 // found in the LICENSE file.
 
 #include "base_export.h"
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace base {
 
@@ -17,5 +21,77 @@ namespace base {
 	BASE_EXPORT bool MatchPattern(std::string_view eval, std::string_view pattern);
 	BASE_EXPORT bool MatchPattern(std::wstring_view eval, std::wstring_view pattern);
 
+	// A wildcard pattern compiled once and then matched against any number of
+	// strings. MatchPattern() interprets the pattern again on every call and
+	// may backtrack; Match() runs the pattern as a bit-parallel automaton over
+	// the string, so it takes time linear in the length of the string, one
+	// pass per 64 characters of pattern.
+	//
+	//   const CompiledPattern pattern("*.example.???");
+	//   for (const auto& host : hosts) {
+	//     if (pattern.Match(host))
+	//       ...
+	//   }
+	class BASE_EXPORT CompiledPattern {
+	public:
+		enum class Syntax {
+			// As MatchPattern(): characters are UTF-8 sequences, ? matches zero or
+			// one of them, * any number, and \ escapes the next character.
+			kWildcard,
+			// As logging::MatchVlogPattern(): characters are bytes, ? matches
+			// exactly one, * any number, and / and \ match each other. Nothing is
+			// escaped.
+			kFilePath,
+		};
+
+		explicit CompiledPattern(std::string_view pattern,
+			Syntax syntax = Syntax::kWildcard);
+		CompiledPattern(const CompiledPattern& other);
+		CompiledPattern(CompiledPattern&& other) noexcept;
+		CompiledPattern& operator=(const CompiledPattern& other);
+		CompiledPattern& operator=(CompiledPattern&& other) noexcept;
+		~CompiledPattern();
+
+		// Returns true if all of |eval| matches the pattern.
+		bool Match(std::string_view eval) const;
+
+	private:
+		using Word = uint64_t;
+
+		// Returns the masks of the pattern positions that can consume |c|.
+		const Word* MasksFor(int32_t c) const;
+
+		// Follows the ? and * that can match nothing from every position in
+		// |state|.
+		void FollowEmptyMatches(Word* state) const;
+
+		Syntax syntax_;
+
+		// Position i of the automaton, bit i % 64 of word i / 64, stands for
+		// "the first i tokens of the pattern have matched". There is one more
+		// position than there are tokens; the last one accepts.
+		size_t words_ = 1;
+		size_t accept_position_ = 0;
+
+		// Per character below |kTableSize|, the positions that advance on it,
+		// then the positions that advance on any other character.
+		static constexpr int32_t kTableSize = 256;
+		std::vector<Word> masks_;
+		// Characters outside the table that the pattern names, and where their
+		// masks start in |masks_|.
+		std::vector<std::pair<int32_t, size_t>> other_characters_;
+
+		// Positions after a *, which stay active on any character.
+		std::vector<Word> star_positions_;
+		// Positions before a token that can match nothing, and the longest run
+		// of such tokens.
+		std::vector<Word> empty_positions_;
+		size_t longest_empty_run_ = 0;
+
+		// Once the accepting position is active it stays so, because the
+		// pattern ends in *.
+		bool ends_with_star_ = false;
+	};
+
 }  // namespace base
 
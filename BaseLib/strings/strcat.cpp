@@ -4,6 +4,11 @@
 
 #include "strings/strcat.h"
 
+#include <algorithm>
+#include <cstring>
+
+#include "logging.h"
+
 namespace base {
 
 	namespace {
@@ -38,6 +43,51 @@ namespace base {
 
 	}  // namespace
 
+	AlphaNum::AlphaNum(int value)
+		: piece_(digits_, ToChars(value, digits_)) {}
+
+	AlphaNum::AlphaNum(unsigned int value)
+		: piece_(digits_, ToChars(value, digits_)) {}
+
+	AlphaNum::AlphaNum(long value)
+		: piece_(digits_, ToChars(value, digits_)) {}
+
+	AlphaNum::AlphaNum(unsigned long value)
+		: piece_(digits_, ToChars(value, digits_)) {}
+
+	AlphaNum::AlphaNum(long long value)
+		: piece_(digits_, ToChars(value, digits_)) {}
+
+	AlphaNum::AlphaNum(unsigned long long value)
+		: piece_(digits_, ToChars(value, digits_)) {}
+
+	AlphaNum::AlphaNum(double value)
+		: piece_(digits_, ToChars(value, digits_)) {}
+
+	AlphaNum::AlphaNum(Hex hex) {
+		DCHECK_LE(hex.min_width, sizeof(digits_));
+		static constexpr char kHexChars[] = "0123456789ABCDEF";
+		// Format from the end of the buffer, then move the digits to the front.
+		char* const end = digits_ + sizeof(digits_);
+		char* begin = end;
+		const char* const padded = end - std::min(hex.min_width, sizeof(digits_));
+		do {
+			*--begin = kHexChars[hex.value & 0xF];
+			hex.value >>= 4;
+		} while (hex.value);
+		while (begin > padded)
+			*--begin = '0';
+		const size_t length = end - begin;
+		memmove(digits_, begin, length);
+		piece_ = std::string_view(digits_, length);
+	}
+
+	std::string StrCat(span<const AlphaNum> pieces) {
+		std::string result;
+		StrAppendT(&result, pieces);
+		return result;
+	}
+
 	std::string StrCat(span<const std::string_view> pieces) {
 		std::string result;
 		StrAppendT(&result, pieces);
@@ -62,6 +112,10 @@ namespace base {
 		return result;
 	}
 
+	void StrAppend(std::string* dest, span<const AlphaNum> pieces) {
+		StrAppendT(dest, pieces);
+	}
+
 	void StrAppend(std::string* dest, span<const std::string_view> pieces) {
 		StrAppendT(dest, pieces);
 	}
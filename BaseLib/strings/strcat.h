@@ -4,10 +4,14 @@
 
 #pragma once
 
+#include <cstdint>
 #include <initializer_list>
+#include <string>
+#include <string_view>
 
 #include "base_export.h"
 #include "containers/span.h"
+#include "strings/string_number_conversions.h"
 
 // Guard against conflict with Win32 API StrCat macro:
 // check StrCat wasn't and will not be redefined.
@@ -23,6 +27,11 @@ namespace base {
 	//
 	//   std::string result = base::StrCat({"foo ", result, "\nfoo ", bar});
 	//
+	// Narrow StrCat also takes numbers, which it formats without creating
+	// temporary strings (see AlphaNum below):
+	//
+	//   std::string id = base::StrCat({"tab_", tab_index, "@", base::Hex(ptr)});
+	//
 	// To join an array of strings with a separator, see base::JoinString in
 	// base/strings/string_util.h.
 	//
@@ -42,24 +51,69 @@ namespace base {
 	// requirements and using only initializer_list is simpler and generates
 	// roughly the same amount of code at the call sites.
 	//
-	// Abseil's StrCat also allows numbers by using an intermediate class that can
-	// be implicitly constructed from either a string or various number types. This
-	// class formats the numbers into a static buffer for increased performance,
-	// and the call sites look nice.
-	//
-	// As-written Abseil's helper class for numbers generates slightly more code
-	// than the raw std::string_view version. We can de-inline the helper class'
-	// constructors which will cause the std::string_view constructors to be de-inlined
-	// for this call and generate slightly less code. This is something we can
-	// explore more in the future.
+	// Like Abseil's StrCat, the narrow version allows numbers by using an
+	// intermediate class, AlphaNum, that can be implicitly constructed from
+	// either a string or various number types. It formats numbers into a buffer
+	// of its own, so StrCat still knows the exact result size before it
+	// allocates. The number constructors are out of line to keep call sites
+	// small.
+
+	// Formats |value| in uppercase hexadecimal, without a "0x" prefix, padded
+	// with zeros to at least |min_width| digits.
+	struct Hex {
+		explicit Hex(uint64_t value, size_t min_width = 0)
+			: value(value), 
+			  min_width(min_width) {}
+		template <typename T>
+		explicit Hex(T* pointer, size_t min_width = 0)
+			: Hex(reinterpret_cast<uintptr_t>(pointer), min_width) {}
+
+		uint64_t value;
+		size_t min_width;
+	};
+
+	// One piece of narrow StrCat()/StrAppend() input. Strings are referenced,
+	// not copied, and numbers are formatted like NumberToString() does. An
+	// AlphaNum may point into itself, so it can be neither copied nor kept
+	// beyond the full expression that created it.
+	class BASE_EXPORT AlphaNum {
+	public:
+		AlphaNum(int value);
+		AlphaNum(unsigned int value);
+		AlphaNum(long value);
+		AlphaNum(unsigned long value);
+		AlphaNum(long long value);
+		AlphaNum(unsigned long long value);
+		AlphaNum(double value);
+		AlphaNum(Hex hex);
+
+		AlphaNum(const char* c_str) : piece_(c_str) {}
+		AlphaNum(std::string_view str) : piece_(str) {}
+		AlphaNum(const std::string& str) : piece_(str) {}
+
+		// A char would otherwise be formatted as its character code.
+		AlphaNum(char) = delete;
+
+		AlphaNum(const AlphaNum&) = delete;
+		AlphaNum& operator=(const AlphaNum&) = delete;
+
+		const char* data() const { return piece_.data(); }
+		size_t size() const { return piece_.size(); }
+		std::string_view piece() const { return piece_; }
+
+	private:
+		std::string_view piece_;
+		char digits_[kMaxNumberChars];
+	};
 
+	BASE_EXPORT std::string StrCat(span<const AlphaNum> pieces);
 	BASE_EXPORT std::string StrCat(span<const std::string_view> pieces);
 	BASE_EXPORT std::wstring StrCat(span<const std::wstring_view> pieces);
 	BASE_EXPORT std::string StrCat(span<const std::string> pieces);
 	BASE_EXPORT std::wstring StrCat(span<const std::wstring> pieces);
 
 	// Initializer list forwards to the array version.
-	inline std::string StrCat(std::initializer_list<std::string_view> pieces) {
+	inline std::string StrCat(std::initializer_list<AlphaNum> pieces) {
 		return StrCat(make_span(pieces.begin(), pieces.size()));
 	}
 	inline std::wstring StrCat(std::initializer_list<std::wstring_view> pieces) {
@@ -74,13 +128,14 @@ namespace base {
 	//   foo += StrCat(...);
 	// because it avoids a temporary string allocation and copy.
 
+	BASE_EXPORT void StrAppend(std::string* dest, span<const AlphaNum> pieces);
 	BASE_EXPORT void StrAppend(std::string* dest, span<const std::string_view> pieces);
 	BASE_EXPORT void StrAppend(std::wstring* dest, span<const std::wstring_view> pieces);
 	BASE_EXPORT void StrAppend(std::string* dest, span<const std::string> pieces);
 	BASE_EXPORT void StrAppend(std::wstring* dest, span<const std::wstring> pieces);
 
 	// Initializer list forwards to the array version.
-	inline void StrAppend(std::string* dest, std::initializer_list<std::string_view> pieces) {
+	inline void StrAppend(std::string* dest, std::initializer_list<AlphaNum> pieces) {
 		return StrAppend(dest, make_span(pieces.begin(), pieces.size()));
 	}
 	inline void StrAppend(std::wstring* dest, std::initializer_list<std::wstring_view> pieces) {
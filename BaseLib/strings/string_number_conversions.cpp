@@ -5,14 +5,22 @@
 #include "strings/string_number_conversions.h"
 
 #include <cctype>
+#include <cstring>
 #include <cwctype>
 
+#include <array>
 #include <limits>
 #include <type_traits>
 
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <immintrin.h>
+#endif
+
+#include "cpu.h"
 #include "logging.h"
 #include "no_destructor.h"
 #include "numerics/safe_math.h"
+#include "strings/decimal_to_double.h"
 #include "strings/string_util.h"
 #include "third_party/double_conversion/double-conversion.h"
 
@@ -20,40 +28,52 @@ namespace base {
 
 	namespace {
 
-		template <typename STR, typename INT>
-		struct IntToStringT {
-			static STR IntToString(INT value) {
-				// log10(2) ~= 0.3 bytes needed per bit or per byte log10(2**8) ~= 2.4.
-				// So round up to allocate 3 output characters per byte, plus 1 for '-'.
-				const size_t kOutputBufSize = 
-					3 * sizeof(INT) + std::numeric_limits<INT>::is_signed;
-
-				// Create the string in a temporary buffer, write it back to front, and
-				// then return the substr of what we ended up using.
-				using CHR = typename STR::value_type;
-				CHR outbuf[kOutputBufSize];
-
-				// The ValueOrDie call below can never fail, because UnsignedAbs is valid
-				// for all valid inputs.
-				typename std::make_unsigned<INT>::type res = 
-					CheckedNumeric<INT>(value).UnsignedAbs().ValueOrDie();
-
-				CHR* end = outbuf + kOutputBufSize;
-				CHR* i = end;
-				do {
-					--i;
-					DCHECK(i != outbuf);
-					*i = static_cast<CHR>((res % 10) + '0');
-					res /= 10;
-				} while (res != 0);
-				if (IsValueNegative(value)) {
-					--i;
-					DCHECK(i != outbuf);
-					*i = static_cast<CHR>('-');
-				}
-				return STR(i, end);
+		// The decimal digits of 0 to 99, two characters each.
+		constexpr char kDigitPairs[] =
+			"0001020304050607080910111213141516171819"
+			"2021222324252627282930313233343536373839"
+			"4041424344454647484950515253545556575859"
+			"6061626364656667686970717273747576777879"
+			"8081828384858687888990919293949596979899";
+
+		template <typename INT>
+		size_t IntToChars(INT value, span<char, kMaxNumberChars> buffer) {
+			// The ValueOrDie call below can never fail, because UnsignedAbs is valid
+			// for all valid inputs.
+			typename std::make_unsigned<INT>::type res =
+				CheckedNumeric<INT>(value).UnsignedAbs().ValueOrDie();
+
+			// Write the digits back to front at the end of |buffer|, two at a time,
+			// then move them to its start.
+			char* const end = buffer.data() + buffer.size();
+			char* begin = end;
+			while (res >= 100) {
+				begin -= 2;
+				memcpy(begin, &kDigitPairs[(res % 100) * 2], 2);
+				res /= 100;
 			}
-		};
+			if (res >= 10) {
+				begin -= 2;
+				memcpy(begin, &kDigitPairs[res * 2], 2);
+			} else {
+				*--begin = static_cast<char>('0' + res);
+			}
+			if (IsValueNegative(value))
+				*--begin = '-';
+
+			const auto size = static_cast<size_t>(end - begin);
+			memmove(buffer.data(), begin, size);
+			return size;
+		}
+
+		template <typename STR, typename INT>
+		STR IntToString(INT value) {
+			char buffer[kMaxNumberChars];
+			const size_t size = IntToChars(value, buffer);
+			// The number is ASCII, which the iterator constructor promotes to
+			// 16-bit characters for wide strings.
+			return STR(buffer, buffer + size);
+		}
 
 		// Utility to convert a character to a digit in a given base
 		template<typename CHAR, int BASE, bool BASE_LTE_10> class BaseCharToDigit {
@@ -308,54 +328,338 @@ namespace base {
 				input.begin(), input.end(), output);
 		}
 
+		// Converts |size| characters at |data| if they consist of nothing but a
+		// decimal number with at most 19 significant digits, which covers the
+		// output of NumberToString() and most numbers in JSON or CSV data.
+		// Returns false for anything else, and for the few numbers that
+		// internal::DecimalToDouble() cannot round, leaving them to the exact
+		// conversion.
+		template <typename CHAR>
+		bool FastStringToDouble(const CHAR* data, size_t size, double* output) {
+			constexpr int kMaxSignificantDigits = 19;
+			// Larger exponents over- or underflow with any mantissa.
+			constexpr int kMaxExponent = 100000;
+
+			const CHAR* p = data;
+			const CHAR* const end = data + size;
+			bool negative = false;
+			if (p != end && (*p == '-' || *p == '+')) {
+				negative = *p == '-';
+				++p;
+			}
+
+			uint64_t mantissa = 0;
+			int significant_digits = 0;
+			int exponent10 = 0;
+			bool has_digits = false;
+			for (bool fraction = false;; fraction = true) {
+				const CHAR* const digits_start = p;
+				for (; p != end && IsAsciiDigit(*p); ++p) {
+					if (fraction)
+						--exponent10;
+					if (significant_digits == 0 && *p == '0')
+						continue;
+					if (++significant_digits > kMaxSignificantDigits)
+						return false;
+					mantissa = mantissa * 10 + (*p - '0');
+				}
+				has_digits |= p != digits_start;
+				if (fraction || p == end || *p != '.')
+					break;
+				++p;
+			}
+			if (!has_digits)
+				return false;
+
+			if (p != end && (*p == 'e' || *p == 'E')) {
+				++p;
+				bool negative_exponent = false;
+				if (p != end && (*p == '-' || *p == '+')) {
+					negative_exponent = *p == '-';
+					++p;
+				}
+				if (p == end || !IsAsciiDigit(*p))
+					return false;
+				int exponent = 0;
+				for (; p != end && IsAsciiDigit(*p); ++p) {
+					if (exponent < kMaxExponent)
+						exponent = exponent * 10 + (*p - '0');
+				}
+				exponent10 += negative_exponent ? -exponent : exponent;
+			}
+
+			return p == end &&
+				internal::DecimalToDouble(mantissa, exponent10, negative, output);
+		}
+
+		// Hex encoders. Each writes the two upper case hex digits of each of the
+		// |size| bytes at |bytes| to |output|. The vector variants look up the
+		// digits of the nibbles of 16 or 32 bytes with a shuffle, interleave
+		// them, and hand the tail to the next narrower variant.
+		using HexEncodeFunction = void (*)(const uint8_t* bytes,
+			size_t size,
+			char* output);
+
+		constexpr char kHexDigits[] = "0123456789ABCDEF";
+
+		void HexEncodeScalar(const uint8_t* bytes, size_t size, char* output) {
+			for (size_t i = 0; i < size; ++i) {
+				*output++ = kHexDigits[bytes[i] >> 4];
+				*output++ = kHexDigits[bytes[i] & 0xf];
+			}
+		}
+
+		// The values of the hex digits of either case, or 0xff.
+		constexpr std::array<uint8_t, 256> MakeHexValues() {
+			std::array<uint8_t, 256> values = {};
+			for (auto& value : values)
+				value = 0xff;
+			for (uint8_t i = 0; i < 10; ++i)
+				values['0' + i] = i;
+			for (uint8_t i = 0; i < 6; ++i) {
+				values['a' + i] = 10 + i;
+				values['A' + i] = 10 + i;
+			}
+			return values;
+		}
+
+		constexpr std::array<uint8_t, 256> kHexValues = MakeHexValues();
+
+		// Hex decoders. Each decodes the |size| characters at |input|, an even
+		// number, a pair of hex digits per byte at |output|, and returns the
+		// number of characters decoded. That is less than |size| when a
+		// character is not a hex digit: the offset of its pair. The vector
+		// variants decode 32 or 64 characters per step, and leave any step with
+		// an invalid character to the next narrower variant.
+		using HexDecodeFunction = size_t (*)(const char* input,
+			size_t size,
+			uint8_t* output);
+
+		size_t HexDecodeScalar(const char* input, size_t size, uint8_t* output) {
+			size_t decoded = 0;
+			for (; decoded < size; decoded += 2) {
+				const uint8_t high = kHexValues[static_cast<uint8_t>(input[decoded])];
+				const uint8_t low =
+					kHexValues[static_cast<uint8_t>(input[decoded + 1])];
+				if ((high | low) & 0xf0)
+					break;
+				*output++ = static_cast<uint8_t>((high << 4) | low);
+			}
+			return decoded;
+		}
+
+#if defined(ARCH_CPU_X86_FAMILY)
+		void HexEncodeSSSE3(const uint8_t* bytes, size_t size, char* output) {
+			const __m128i digits =
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(kHexDigits));
+			const __m128i nibble = _mm_set1_epi8(0x0f);
+			size_t i = 0;
+			for (; size - i >= 16; i += 16) {
+				const __m128i chunk =
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+				const __m128i high = _mm_shuffle_epi8(digits,
+					_mm_and_si128(_mm_srli_epi16(chunk, 4), nibble));
+				const __m128i low =
+					_mm_shuffle_epi8(digits, _mm_and_si128(chunk, nibble));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(output + 2 * i),
+					_mm_unpacklo_epi8(high, low));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(output + 2 * i + 16),
+					_mm_unpackhi_epi8(high, low));
+			}
+			HexEncodeScalar(bytes + i, size - i, output + 2 * i);
+		}
+
+		void HexEncodeAVX2(const uint8_t* bytes, size_t size, char* output) {
+			const __m256i digits = _mm256_broadcastsi128_si256(
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(kHexDigits)));
+			const __m256i nibble = _mm256_set1_epi8(0x0f);
+			size_t i = 0;
+			for (; size - i >= 32; i += 32) {
+				const __m256i chunk =
+					_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i));
+				const __m256i high = _mm256_shuffle_epi8(digits,
+					_mm256_and_si256(_mm256_srli_epi16(chunk, 4), nibble));
+				const __m256i low =
+					_mm256_shuffle_epi8(digits, _mm256_and_si256(chunk, nibble));
+				// The unpacks work within 128-bit lanes: |first| holds the digits
+				// of bytes 0-7 and 16-23, |second| those of bytes 8-15 and 24-31.
+				const __m256i first = _mm256_unpacklo_epi8(high, low);
+				const __m256i second = _mm256_unpackhi_epi8(high, low);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(output + 2 * i),
+					_mm256_permute2x128_si256(first, second, 0x20));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(output + 2 * i + 32),
+					_mm256_permute2x128_si256(first, second, 0x31));
+			}
+			HexEncodeSSSE3(bytes + i, size - i, output + 2 * i);
+		}
+
+		// Returns the values of 16 hex digits of either case, and sets |*valid|
+		// to the bytes that are hex digits. A range is checked with one signed
+		// compare by moving it to the bottom of the signed bytes.
+		__m128i HexDigitValues(__m128i chars, __m128i* valid) {
+			const auto in_range = [](__m128i c, char first, char last) {
+				const __m128i shifted =
+					_mm_add_epi8(c, _mm_set1_epi8(static_cast<char>(0x80 - first)));
+				return _mm_cmpgt_epi8(
+					_mm_set1_epi8(static_cast<char>(-128 + (last - first) + 1)), shifted);
+			};
+			const __m128i lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+			const __m128i digit = in_range(chars, '0', '9');
+			const __m128i letter = in_range(lower, 'a', 'f');
+			*valid = _mm_or_si128(digit, letter);
+			return _mm_or_si128(
+				_mm_and_si128(digit, _mm_sub_epi8(chars, _mm_set1_epi8('0'))),
+				_mm_and_si128(letter, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+		}
+
+		__m256i HexDigitValues(__m256i chars, __m256i* valid) {
+			const auto in_range = [](__m256i c, char first, char last) {
+				const __m256i shifted = _mm256_add_epi8(c,
+					_mm256_set1_epi8(static_cast<char>(0x80 - first)));
+				return _mm256_cmpgt_epi8(
+					_mm256_set1_epi8(static_cast<char>(-128 + (last - first) + 1)),
+					shifted);
+			};
+			const __m256i lower = _mm256_or_si256(chars, _mm256_set1_epi8(0x20));
+			const __m256i digit = in_range(chars, '0', '9');
+			const __m256i letter = in_range(lower, 'a', 'f');
+			*valid = _mm256_or_si256(digit, letter);
+			return _mm256_or_si256(
+				_mm256_and_si256(digit, _mm256_sub_epi8(chars, _mm256_set1_epi8('0'))),
+				_mm256_and_si256(letter,
+					_mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10))));
+		}
+
+		size_t HexDecodeSSSE3(const char* input, size_t size, uint8_t* output) {
+			// Multiplies the first digit of each pair by 16 and adds the second.
+			const __m128i weights = _mm_set1_epi16(0x0110);
+			size_t decoded = 0;
+			for (; size - decoded >= 32; decoded += 32, output += 16) {
+				__m128i valid_first;
+				__m128i valid_second;
+				const __m128i first = HexDigitValues(_mm_loadu_si128(
+					reinterpret_cast<const __m128i*>(input + decoded)), &valid_first);
+				const __m128i second = HexDigitValues(_mm_loadu_si128(
+					reinterpret_cast<const __m128i*>(input + decoded + 16)),
+					&valid_second);
+				if (_mm_movemask_epi8(_mm_and_si128(valid_first, valid_second)) !=
+					0xffff) {
+					break;
+				}
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(output),
+					_mm_packus_epi16(_mm_maddubs_epi16(first, weights),
+						_mm_maddubs_epi16(second, weights)));
+			}
+			return decoded +
+				HexDecodeScalar(input + decoded, size - decoded, output);
+		}
+
+		size_t HexDecodeAVX2(const char* input, size_t size, uint8_t* output) {
+			const __m256i weights = _mm256_set1_epi16(0x0110);
+			size_t decoded = 0;
+			for (; size - decoded >= 64; decoded += 64, output += 32) {
+				__m256i valid_first;
+				__m256i valid_second;
+				const __m256i first = HexDigitValues(_mm256_loadu_si256(
+					reinterpret_cast<const __m256i*>(input + decoded)), &valid_first);
+				const __m256i second = HexDigitValues(_mm256_loadu_si256(
+					reinterpret_cast<const __m256i*>(input + decoded + 32)),
+					&valid_second);
+				if (_mm256_movemask_epi8(
+					_mm256_and_si256(valid_first, valid_second)) != -1) {
+					break;
+				}
+				// The pack works within 128-bit lanes, which leaves the middle
+				// quarters swapped.
+				const __m256i bytes = _mm256_packus_epi16(
+					_mm256_maddubs_epi16(first, weights),
+					_mm256_maddubs_epi16(second, weights));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(output),
+					_mm256_permute4x64_epi64(bytes, 0xd8));
+			}
+			return decoded +
+				HexDecodeSSSE3(input + decoded, size - decoded, output);
+		}
+#endif  // defined(ARCH_CPU_X86_FAMILY)
+
+		// Pick the widest encoder and decoder the processor supports. Done once
+		// per process.
+		HexEncodeFunction GetHexEncodeFunction() {
+			static const HexEncodeFunction hex_encode = [] {
+#if defined(ARCH_CPU_X86_FAMILY)
+				const CPU cpu;
+				if (cpu.has_avx2())
+					return &HexEncodeAVX2;
+				if (cpu.has_ssse3())
+					return &HexEncodeSSSE3;
+#endif
+				return &HexEncodeScalar;
+			}();
+			return hex_encode;
+		}
+
+		HexDecodeFunction GetHexDecodeFunction() {
+			static const HexDecodeFunction hex_decode = [] {
+#if defined(ARCH_CPU_X86_FAMILY)
+				const CPU cpu;
+				if (cpu.has_avx2())
+					return &HexDecodeAVX2;
+				if (cpu.has_ssse3())
+					return &HexDecodeSSSE3;
+#endif
+				return &HexDecodeScalar;
+			}();
+			return hex_decode;
+		}
+
 	}  // namespace
 
 	std::string NumberToString(int value) {
-		return IntToStringT<std::string, int>::IntToString(value);
+		return IntToString<std::string, int>(value);
 	}
 
 	std::wstring NumberToString16(int value) {
-		return IntToStringT<std::wstring, int>::IntToString(value);
+		return IntToString<std::wstring, int>(value);
 	}
 
 	std::string NumberToString(unsigned int value) {
-		return IntToStringT<std::string, unsigned>::IntToString(value);
+		return IntToString<std::string, unsigned>(value);
 	}
 
 	std::wstring NumberToString16(unsigned int value) {
-		return IntToStringT<std::wstring, unsigned>::IntToString(value);
+		return IntToString<std::wstring, unsigned>(value);
 	}
 
 	std::string NumberToString(long value) {
-		return IntToStringT<std::string, long>::IntToString(value);
+		return IntToString<std::string, long>(value);
 	}
 
 	std::wstring NumberToString16(long value) {
-		return IntToStringT<std::wstring, long>::IntToString(value);
+		return IntToString<std::wstring, long>(value);
 	}
 
 	std::string NumberToString(unsigned long value) {
-		return IntToStringT<std::string, unsigned long>::IntToString(value);
+		return IntToString<std::string, unsigned long>(value);
 	}
 
 	std::wstring NumberToString16(unsigned long value) {
-		return IntToStringT<std::wstring, unsigned long>::IntToString(value);
+		return IntToString<std::wstring, unsigned long>(value);
 	}
 
 	std::string NumberToString(long long value) {
-		return IntToStringT<std::string, long long>::IntToString(value);
+		return IntToString<std::string, long long>(value);
 	}
 
 	std::wstring NumberToString16(long long value) {
-		return IntToStringT<std::wstring, long long>::IntToString(value);
+		return IntToString<std::wstring, long long>(value);
 	}
 
 	std::string NumberToString(unsigned long long value) {
-		return IntToStringT<std::string, unsigned long long>::IntToString(value);
+		return IntToString<std::string, unsigned long long>(value);
 	}
 
 	std::wstring NumberToString16(unsigned long long value) {
-		return IntToStringT<std::wstring, unsigned long long>::IntToString(value);
+		return IntToString<std::wstring, unsigned long long>(value);
 	}
 
 	static const double_conversion::DoubleToStringConverter*
@@ -367,20 +671,83 @@ namespace base {
 	}
 
 	std::string NumberToString(double value) {
-		char buffer[32];
-		double_conversion::StringBuilder builder(buffer, sizeof(buffer));
-		GetDoubleToStringConverter()->ToShortest(value, &builder);
-		return std::string(buffer, builder.position());
+		char buffer[kMaxNumberChars];
+		return std::string(buffer, ToChars(value, buffer));
 	}
 
 	std::wstring NumberToString16(double value) {
-		char buffer[32];
-		double_conversion::StringBuilder builder(buffer, sizeof(buffer));
-		GetDoubleToStringConverter()->ToShortest(value, &builder);
-		
+		char buffer[kMaxNumberChars];
+		const size_t size = ToChars(value, buffer);
+
 		// The number will be ASCII. This creates the string using the "input
 		// iterator" variant which promotes from 8-bit to 16-bit via "=".
-		return std::wstring(&buffer[0], &buffer[builder.position()]);
+		return std::wstring(&buffer[0], &buffer[size]);
+	}
+
+	size_t ToChars(int value, span<char, kMaxNumberChars> buffer) {
+		return IntToChars(value, buffer);
+	}
+
+	size_t ToChars(unsigned int value, span<char, kMaxNumberChars> buffer) {
+		return IntToChars(value, buffer);
+	}
+
+	size_t ToChars(long value, span<char, kMaxNumberChars> buffer) {
+		return IntToChars(value, buffer);
+	}
+
+	size_t ToChars(unsigned long value, span<char, kMaxNumberChars> buffer) {
+		return IntToChars(value, buffer);
+	}
+
+	size_t ToChars(long long value, span<char, kMaxNumberChars> buffer) {
+		return IntToChars(value, buffer);
+	}
+
+	size_t ToChars(unsigned long long value, span<char, kMaxNumberChars> buffer) {
+		return IntToChars(value, buffer);
+	}
+
+	size_t ToChars(double value, span<char, kMaxNumberChars> buffer) {
+		double_conversion::StringBuilder builder(buffer.data(),
+			static_cast<int>(buffer.size()));
+		GetDoubleToStringConverter()->ToShortest(value, &builder);
+		return static_cast<size_t>(builder.position());
+	}
+
+	void AppendNumber(std::string* output, int value) {
+		char buffer[kMaxNumberChars];
+		output->append(buffer, ToChars(value, buffer));
+	}
+
+	void AppendNumber(std::string* output, unsigned int value) {
+		char buffer[kMaxNumberChars];
+		output->append(buffer, ToChars(value, buffer));
+	}
+
+	void AppendNumber(std::string* output, long value) {
+		char buffer[kMaxNumberChars];
+		output->append(buffer, ToChars(value, buffer));
+	}
+
+	void AppendNumber(std::string* output, unsigned long value) {
+		char buffer[kMaxNumberChars];
+		output->append(buffer, ToChars(value, buffer));
+	}
+
+	void AppendNumber(std::string* output, long long value) {
+		char buffer[kMaxNumberChars];
+		output->append(buffer, ToChars(value, buffer));
+	}
+
+	void AppendNumber(std::string* output, unsigned long long value) {
+		char buffer[kMaxNumberChars];
+		output->append(buffer, ToChars(value, buffer));
+	}
+
+	void AppendNumber(std::string* output, double value) {
+		char buffer[kMaxNumberChars];
+		output->append(buffer, ToChars(value, buffer));
 	}
 
 	bool StringToInt(std::string_view input, int* output) {
@@ -425,6 +792,9 @@ namespace base {
 
 	template <typename STRING, typename CHAR>
 	bool StringToDoubleImpl(STRING input, const CHAR* data, double* output) {
+		if (FastStringToDouble(data, input.size(), output))
+			return true;
+
 		static NoDestructor<double_conversion::StringToDoubleConverter> converter(
 			double_conversion::StringToDoubleConverter::ALLOW_LEADING_SPACES |
 		    double_conversion::StringToDoubleConverter::ALLOW_TRAILING_JUNK,
@@ -456,15 +826,11 @@ namespace base {
 	}
 
 	std::string HexEncode(const void* bytes, size_t size) {
-		static const char kHexChars[] = "0123456789ABCDEF";
-
 		// Each input byte creates two output hex characters.
 		std::string ret(size * 2, '\0');
-
-		for (size_t i = 0; i < size; ++i) {
-			const auto b = reinterpret_cast<const char*>(bytes)[i];
-			ret[(i * 2)] = kHexChars[(b >> 4) & 0xf];
-			ret[(i * 2) + 1] = kHexChars[b & 0xf];
+		if (size) {
+			GetHexEncodeFunction()(static_cast<const uint8_t*>(bytes), size,
+				&ret[0]);
 		}
 		return ret;
 	}
@@ -473,6 +839,11 @@ namespace base {
 		return HexEncode(bytes.data(), bytes.size());
 	}
 
+	void HexEncode(span<const uint8_t> bytes, span<char> output) {
+		CHECK_EQ(output.size(), bytes.size() * 2);
+		GetHexEncodeFunction()(bytes.data(), bytes.size(), output.data());
+	}
+
 	bool HexStringToInt(std::string_view input, int* output) {
 		return IteratorRangeToNumber<HexIteratorRangeToIntTraits>::Invoke(
 			input.begin(), input.end(), output);
@@ -498,16 +869,20 @@ namespace base {
 		const auto count = input.size();
 		if (count == 0 || (count % 2) != 0)
 			return false;
-		for (uintptr_t i = 0; i < count / 2; ++i) {
-			uint8_t msb = 0;  // most significant 4 bits
-			uint8_t lsb = 0;  // least significant 4 bits
-			if (!CharToDigit<16>(input[i * 2], &msb) ||
-				!CharToDigit<16>(input[i * 2 + 1], &lsb)) {
-				return false;
-			}
-			output->push_back((msb << 4) | lsb);
-		}
-		return true;
+		// Append like push_back() did, in case |output| is not empty after all.
+		const size_t old_size = output->size();
+		output->resize(old_size + count / 2);
+		const size_t decoded = GetHexDecodeFunction()(
+			input.data(), count, output->data() + old_size);
+		output->resize(old_size + decoded / 2);
+		return decoded == count;
+	}
+
+	bool HexStringToSpan(std::string_view input, span<uint8_t> output) {
+		const auto count = input.size();
+		if (count == 0 || (count % 2) != 0 || output.size() != count / 2)
+			return false;
+		return GetHexDecodeFunction()(input.data(), count, output.data()) == count;
 	}
 
 } // namespace base
\ No newline at end of file
@@ -53,6 +53,39 @@ namespace base {
 	BASE_EXPORT std::string NumberToString(double value);
 	BASE_EXPORT std::wstring NumberToString16(double value);
 
+	// Allocation-free variants of the above, for code that formats many
+	// numbers. They produce the same characters as NumberToString(): integers
+	// in decimal, and doubles in their shortest form that reads back as the
+	// same double.
+
+	// Enough room for any number: a sign and the 20 digits of a 64-bit
+	// integer, or the shortest form of a double such as
+	// "-2.2250738585072014e-308".
+	constexpr size_t kMaxNumberChars = 32;
+
+	// Writes |value| at the start of |buffer|, which is not NUL-terminated, and
+	// returns the number of characters written.
+	BASE_EXPORT size_t ToChars(int value, span<char, kMaxNumberChars> buffer);
+	BASE_EXPORT size_t ToChars(unsigned int value,
+							   span<char, kMaxNumberChars> buffer);
+	BASE_EXPORT size_t ToChars(long value, span<char, kMaxNumberChars> buffer);
+	BASE_EXPORT size_t ToChars(unsigned long value,
+							   span<char, kMaxNumberChars> buffer);
+	BASE_EXPORT size_t ToChars(long long value,
+							   span<char, kMaxNumberChars> buffer);
+	BASE_EXPORT size_t ToChars(unsigned long long value,
+							   span<char, kMaxNumberChars> buffer);
+	BASE_EXPORT size_t ToChars(double value, span<char, kMaxNumberChars> buffer);
+
+	// Appends |value| to |*output|.
+	BASE_EXPORT void AppendNumber(std::string* output, int value);
+	BASE_EXPORT void AppendNumber(std::string* output, unsigned int value);
+	BASE_EXPORT void AppendNumber(std::string* output, long value);
+	BASE_EXPORT void AppendNumber(std::string* output, unsigned long value);
+	BASE_EXPORT void AppendNumber(std::string* output, long long value);
+	BASE_EXPORT void AppendNumber(std::string* output, unsigned long long value);
+	BASE_EXPORT void AppendNumber(std::string* output, double value);
+
 	// String -> number conversions ------------------------------------------------
 
 	// Perform a best-effort conversion of the input string to a numeric type,
@@ -108,6 +141,11 @@ namespace base {
 	BASE_EXPORT std::string HexEncode(const void* bytes, size_t size);
 	BASE_EXPORT std::string HexEncode(span<const uint8_t> bytes);
 
+	// Allocation-free variant of the above: writes the hex representation of
+	// |bytes| to |output|, which must hold exactly 2 * bytes.size() characters
+	// and is not NUL-terminated.
+	BASE_EXPORT void HexEncode(span<const uint8_t> bytes, span<char> output);
+
 	// Best effort conversion, see StringToInt above for restrictions.
 	// Will only successful parse hex values that will fit into |output|, i.e.
 	// -0x80000000 < |input| < 0x7FFFFFFF.
@@ -137,4 +175,9 @@ namespace base {
 	BASE_EXPORT bool HexStringToBytes(std::string_view input, 
 									  std::vector<uint8_t>* output);
 
+	// Same as HexStringToBytes(), but writes to |output|, which must be exactly
+	// half the size of |input|. Returns false otherwise, or if |input| has a
+	// character that is not a hex digit; |output| may then be partly written.
+	BASE_EXPORT bool HexStringToSpan(std::string_view input, span<uint8_t> output);
+
 } // namespace base
\ No newline at end of file
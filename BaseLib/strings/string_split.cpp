@@ -3,6 +3,15 @@
 // found in the LICENSE file.
 
 #include "strings/string_split.h"
+
+#include <cstring>
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <immintrin.h>
+#endif
+
+#include "bits.h"
+#include "cpu.h"
 #include "logging.h"
 #include "strings/string_util.h"
 
@@ -21,11 +30,11 @@ namespace base {
 		}
 		template<>  // Convert std::string_view to std::string
 		std::string PieceToOutputType<char, std::string>(std::string_view piece) {
-			return std::string(piece.data());
+			return std::string(piece);
 		}
 		template<>  // Convert std::wstring_view to std::wstring.
 		std::wstring PieceToOutputType<wchar_t, std::wstring>(std::wstring_view piece) {
-			return std::wstring(piece.data());
+			return std::wstring(piece);
 		}
 
 		// Returns either the ASCII or UTF-16 whitespace.
@@ -36,62 +45,102 @@ namespace base {
 		template<> std::string_view WhitespaceForType<char>() {
 			return kWhitespaceASCII;
 		}
-		// Optimize the single-character case to call find() on the string instead,
-		// since this is the common case and can be made faster. This could have been
-		// done with template specialization too, but would have been less clear.
-		//
-		// There is no corresponding FindFirstNotOf because std::string_view already
-		// implements these different versions that do the optimized searching.
-		size_t FindFirstOf(std::string_view piece, char c, size_t pos) {
-			return piece.find(c, pos);
+		// Character set finders. Each returns the offset of the first character
+		// in [begin, end) that is one of the |set_size| characters at |set|, or
+		// end - begin if there is none. The vector variants compare 16 or 32
+		// bytes per step against every character of the set and hand the tail
+		// to the next narrower variant. |set_size| is at most
+		// internal::kMaxVectorizedCharacters and never 0.
+		using FindFirstOfFunction = size_t (*)(const char* begin,
+			const char* end,
+			const char* set,
+			size_t set_size);
+
+		size_t FindFirstOfScalar(const char* begin,
+			const char* end,
+			const char* set,
+			size_t set_size) {
+			const char* p = begin;
+			while (p != end && !memchr(set, *p, set_size))
+				++p;
+			return p - begin;
 		}
-		size_t FindFirstOf(std::wstring_view piece, wchar_t c, size_t pos) {
-			return piece.find(c, pos);
+
+#if defined(ARCH_CPU_X86_FAMILY)
+		size_t FindFirstOfSSE2(const char* begin,
+			const char* end,
+			const char* set,
+			size_t set_size) {
+			__m128i needles[internal::kMaxVectorizedCharacters];
+			for (size_t i = 0; i < set_size; ++i)
+				needles[i] = _mm_set1_epi8(set[i]);
+			const char* p = begin;
+			for (; end - p >= 16; p += 16) {
+				const __m128i chunk =
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+				__m128i found = _mm_cmpeq_epi8(chunk, needles[0]);
+				for (size_t i = 1; i < set_size; ++i)
+					found = _mm_or_si128(found, _mm_cmpeq_epi8(chunk, needles[i]));
+				const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(found));
+				if (mask)
+					return (p - begin) + bits::CountTrailingZeroBits(mask);
+			}
+			return (p - begin) + FindFirstOfScalar(p, end, set, set_size);
 		}
-		size_t FindFirstOf(std::string_view piece, std::string_view one_of, size_t pos) {
-			return piece.find_first_of(one_of, pos);
+
+		size_t FindFirstOfAVX2(const char* begin,
+			const char* end,
+			const char* set,
+			size_t set_size) {
+			__m256i needles[internal::kMaxVectorizedCharacters];
+			for (size_t i = 0; i < set_size; ++i)
+				needles[i] = _mm256_set1_epi8(set[i]);
+			const char* p = begin;
+			for (; end - p >= 32; p += 32) {
+				const __m256i chunk =
+					_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+				__m256i found = _mm256_cmpeq_epi8(chunk, needles[0]);
+				for (size_t i = 1; i < set_size; ++i) {
+					found = _mm256_or_si256(found,
+						_mm256_cmpeq_epi8(chunk, needles[i]));
+				}
+				const auto mask =
+					static_cast<uint32_t>(_mm256_movemask_epi8(found));
+				if (mask)
+					return (p - begin) + bits::CountTrailingZeroBits(mask);
+			}
+			return (p - begin) + FindFirstOfSSE2(p, end, set, set_size);
 		}
-		size_t FindFirstOf(std::wstring_view piece, std::wstring_view one_of, size_t pos) {
-			return piece.find_first_of(one_of, pos);
+#endif  // defined(ARCH_CPU_X86_FAMILY)
+
+		// Picks the widest finder the processor supports. Done once per process.
+		FindFirstOfFunction GetFindFirstOfFunction() {
+			static const FindFirstOfFunction find_first_of = [] {
+#if defined(ARCH_CPU_X86_FAMILY)
+				const CPU cpu;
+				if (cpu.has_avx2())
+					return &FindFirstOfAVX2;
+				if (cpu.has_sse2())
+					return &FindFirstOfSSE2;
+#endif
+				return &FindFirstOfScalar;
+			}();
+			return find_first_of;
 		}
 
-		// General string splitter template. Can take 8- or 16-bit input, can produce
-		// the corresponding string or std::string_view output, and can take single- or
-		// multiple-character delimiters.
-		//
-		// DelimiterType is either a character (Str::value_type) or a string piece of
-		// multiple characters (std::basic_string_view<Str>). std::string_view has a version of
-		// find for both of these cases, and the single-character version is the most
-		// common and can be implemented faster, which is why this is a template.
-		template<typename Str, typename OutputStringType, typename DelimiterType>
+		// General string splitter template. Can take 8- or 16-bit input and can
+		// produce the corresponding string or std::string_view output. The pieces
+		// come from SplitStringRange, so the eager and lazy versions always agree.
+		template<typename Str, typename OutputStringType>
 		std::vector<OutputStringType> SplitStringT(
 			std::basic_string_view<Str> str,
-			DelimiterType delimiter,
+			std::basic_string_view<Str> delimiters,
 			WhitespaceHandling whitespace,
 			SplitResult result_type) {
 			std::vector<OutputStringType> result;
-			if (str.empty())
-				return result;
-
-			size_t start = 0;
-			while (start != std::basic_string_view<Str>::npos) {
-				size_t end = FindFirstOf(str, delimiter, start);
-
-				std::basic_string_view<Str> piece;
-				if (end == std::basic_string_view<Str>::npos) {
-					piece = str.substr(start);
-					start = std::basic_string_view<Str>::npos;
-				}
-				else {
-					piece = str.substr(start, end - start);
-					start = end + 1;
-				}
-
-				if (whitespace == TRIM_WHITESPACE)
-					piece = TrimString(piece, WhitespaceForType<Str>(), TRIM_ALL);
-
-				if (result_type == SPLIT_WANT_ALL || !piece.empty())
-					result.push_back(PieceToOutputType<Str, OutputStringType>(piece));
+			for (const auto piece :
+				SplitStringRange<Str>(str, delimiters, whitespace, result_type)) {
+				result.push_back(PieceToOutputType<Str, OutputStringType>(piece));
 			}
 			return result;
 		}
@@ -153,25 +202,37 @@ namespace base {
 
 	}  // namespace
 
+	namespace internal {
+
+		size_t FindFirstOf(std::string_view str,
+			std::string_view characters,
+			size_t pos) {
+			if (pos >= str.size() || characters.empty())
+				return std::string_view::npos;
+			if (characters.size() > kMaxVectorizedCharacters)
+				return str.find_first_of(characters, pos);
+			const char* begin = str.data() + pos;
+			const char* end = str.data() + str.size();
+			const size_t offset = GetFindFirstOfFunction()(
+				begin, end, characters.data(), characters.size());
+			return begin + offset == end ? std::string_view::npos : pos + offset;
+		}
+
+	}  // namespace internal
+
 	std::vector<std::string> SplitString(std::string_view input,
 		std::string_view separators,
 		WhitespaceHandling whitespace,
 		SplitResult result_type) {
-		if (separators.size() == 1) {
-			return SplitStringT<char, std::string, char>(input, separators[0], whitespace, result_type);
-		}
-		return SplitStringT<char, std::string, std::string_view>(input, separators, whitespace, result_type);
+		return SplitStringT<char, std::string>(
+			input, separators, whitespace, result_type);
 	}
 
 	std::vector<std::wstring> SplitString(std::wstring_view input,
 		std::wstring_view separators,
 		WhitespaceHandling whitespace,
 		SplitResult result_type) {
-		if (separators.size() == 1) {
-			return SplitStringT<wchar_t, std::wstring, wchar_t>(
-				input, separators[0], whitespace, result_type);
-		}
-		return SplitStringT<wchar_t, std::wstring, std::wstring_view>(
+		return SplitStringT<wchar_t, std::wstring>(
 			input, separators, whitespace, result_type);
 	}
 
@@ -179,11 +240,7 @@ namespace base {
 		std::string_view separators,
 		WhitespaceHandling whitespace,
 		SplitResult result_type) {
-		if (separators.size() == 1) {
-			return SplitStringT<char, std::string_view, char>(
-				input, separators[0], whitespace, result_type);
-		}
-		return SplitStringT<char, std::string_view, std::string_view>(
+		return SplitStringT<char, std::string_view>(
 			input, separators, whitespace, result_type);
 	}
 
@@ -191,11 +248,7 @@ namespace base {
 		std::wstring_view separators,
 		WhitespaceHandling whitespace,
 		SplitResult result_type) {
-		if (separators.size() == 1) {
-			return SplitStringT<wchar_t, std::wstring_view, wchar_t>(
-				input, separators[0], whitespace, result_type);
-		}
-		return SplitStringT<wchar_t, std::wstring_view, std::wstring_view>(
+		return SplitStringT<wchar_t, std::wstring_view>(
 			input, separators, whitespace, result_type);
 	}
 
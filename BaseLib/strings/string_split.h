@@ -4,11 +4,16 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <cstddef>
+#include <iterator>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "base_export.h"
+#include "strings/string_util.h"
 
 namespace base {
 	enum WhitespaceHandling {
@@ -73,6 +78,155 @@ namespace base {
 		WhitespaceHandling whitespace,
 		SplitResult result_type);
 
+	namespace internal {
+
+		// Returns the position of the first character of |str| at or after |pos|
+		// that is one of |characters|, or npos if there is none. Like
+		// std::string_view::find_first_of(), but sets of up to
+		// kMaxVectorizedCharacters characters are searched 16 or 32 bytes at a
+		// time when the processor allows.
+		constexpr size_t kMaxVectorizedCharacters = 8;
+		BASE_EXPORT size_t FindFirstOf(std::string_view str,
+			std::string_view characters,
+			size_t pos);
+		inline size_t FindFirstOf(std::wstring_view str,
+			std::wstring_view characters,
+			size_t pos) {
+			return str.find_first_of(characters, pos);
+		}
+
+	}  // namespace internal
+
+	// Lazy version of SplitStringPiece(): yields the same pieces one at a time,
+	// as the loop asks for them, without building a vector. The pieces reference
+	// |input|, which must outlive the range and stay unmodified.
+	//
+	// To go through a large file line by line without allocating:
+	//
+	//   for (std::string_view line : base::SplitStringPieceRange(
+	//            contents, "\n", base::TRIM_WHITESPACE,
+	//            base::SPLIT_WANT_NONEMPTY)) {
+	//     ...
+	template <typename Char>
+	class SplitStringRange {
+	public:
+		using Piece = std::basic_string_view<Char>;
+
+		class Iterator {
+		public:
+			using iterator_category = std::input_iterator_tag;
+			using value_type = Piece;
+			using difference_type = ptrdiff_t;
+			using pointer = const Piece*;
+			using reference = const Piece&;
+
+			// The end iterator.
+			Iterator() = default;
+
+			explicit Iterator(const SplitStringRange* range)
+				: range_(range), 
+				  next_(range->input_.empty() ? Piece::npos : 0) {
+				Advance();
+			}
+
+			reference operator*() const { return piece_; }
+			pointer operator->() const { return &piece_; }
+
+			Iterator& operator++() {
+				Advance();
+				return *this;
+			}
+
+			Iterator operator++(int) {
+				Iterator previous = *this;
+				Advance();
+				return previous;
+			}
+
+			bool operator==(const Iterator& other) const {
+				return range_ == other.range_ && next_ == other.next_ &&
+					piece_.data() == other.piece_.data();
+			}
+			bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+		private:
+			// Moves to the next piece the range yields, or turns into the end
+			// iterator.
+			void Advance() {
+				while (next_ != Piece::npos) {
+					const Piece& input = range_->input_;
+					const size_t end = range_->FindSeparator(next_);
+					if (end == Piece::npos) {
+						piece_ = input.substr(next_);
+						next_ = Piece::npos;
+					} else {
+						piece_ = input.substr(next_, end - next_);
+						next_ = end + 1;
+					}
+
+					if (range_->whitespace_ == TRIM_WHITESPACE)
+						piece_ = TrimString(piece_, WhitespaceChars(), TRIM_ALL);
+
+					if (range_->result_type_ == SPLIT_WANT_ALL || !piece_.empty())
+						return;
+				}
+				*this = Iterator();
+			}
+
+			static Piece WhitespaceChars() {
+				if constexpr (std::is_same<Char, char>::value)
+					return kWhitespaceASCII;
+				else
+					return kWhitespaceUTF16;
+			}
+
+			const SplitStringRange* range_ = nullptr;
+			size_t next_ = Piece::npos;
+			Piece piece_;
+		};
+
+		SplitStringRange(Piece input,
+			Piece separators,
+			WhitespaceHandling whitespace,
+			SplitResult result_type)
+			: input_(input), 
+			  separators_(separators), 
+			  whitespace_(whitespace), 
+			  result_type_(result_type) {}
+
+		Iterator begin() const { return Iterator(this); }
+		Iterator end() const { return Iterator(); }
+
+	private:
+		// A single separator is the common case, and find() on one character is
+		// the fastest search there is.
+		size_t FindSeparator(size_t pos) const {
+			if (separators_.size() == 1)
+				return input_.find(separators_[0], pos);
+			return internal::FindFirstOf(input_, separators_, pos);
+		}
+
+		Piece input_;
+		Piece separators_;
+		WhitespaceHandling whitespace_;
+		SplitResult result_type_;
+	};
+
+	inline SplitStringRange<char> SplitStringPieceRange(
+		std::string_view input,
+		std::string_view separators,
+		WhitespaceHandling whitespace,
+		SplitResult result_type) {
+		return SplitStringRange<char>(input, separators, whitespace, result_type);
+	}
+	inline SplitStringRange<wchar_t> SplitStringPieceRange(
+		std::wstring_view input,
+		std::wstring_view separators,
+		WhitespaceHandling whitespace,
+		SplitResult result_type) {
+		return SplitStringRange<wchar_t>(input, separators, whitespace, result_type);
+	}
+
 	using StringPairs = std::vector<std::pair<std::string, std::string>>;
 
 	// Splits |line| into key value pairs according to the given delimiters and
@@ -6,7 +6,11 @@
 
 #include <algorithm>
 #include <string>
+#include <string_view>
+#include <type_traits>
+
 #include "logging.h"
+#include "strings/string_split.h"
 
 namespace base {
 
@@ -178,8 +182,18 @@ namespace base {
 					break;
 				// else skip over delimiter.
 			}
-			while (token_end_ != end_ && delims_.find(*token_end_) == str::npos)
-				++token_end_;
+			if constexpr (std::is_same<char_type, char>::value) {
+				// Tokens are usually much longer than the runs of delimiters
+				// between them, so only the token end is searched in bulk.
+				if (token_end_ != end_) {
+					const std::string_view rest(&*token_end_, end_ - token_end_);
+					token_end_ += std::min(internal::FindFirstOf(rest, delims_, 0),
+						rest.size());
+				}
+			} else {
+				while (token_end_ != end_ && delims_.find(*token_end_) == str::npos)
+					++token_end_;
+			}
 			return true;
 		}
 
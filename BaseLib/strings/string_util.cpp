@@ -6,15 +6,24 @@
 
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <cwchar>
 
 #include <algorithm>
 #include <limits>
+#include <type_traits>
 #include <vector>
 
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <immintrin.h>
+#endif
+
+#include "bits.h"
+#include "cpu.h"
 #include "logging.h"
 #include "no_destructor.h"
 #include "stl_util.h"
+#include "strings/multi_string_matcher.h"
 #include "strings/utf_string_conversion_utils.h"
 #include "strings/utf_string_conversions.h"
 #include "third_party/icu/icu_utf.h"
@@ -59,10 +68,6 @@ namespace base {
 		// uintptr_t is an integer type that is also a machine word.
 		using MachineWord = uintptr_t;
 
-		inline bool IsMachineWordAligned(const void* pointer) {
-			return !(reinterpret_cast<MachineWord>(pointer) & (sizeof(MachineWord) - 1));
-		}
-
 		template <typename CharacterType>
 		struct NonASCIIMask;
 		template <>
@@ -74,10 +79,402 @@ namespace base {
 		template <>
 		struct NonASCIIMask<wchar_t> {
 			static constexpr MachineWord value() {
-				return static_cast<MachineWord>(0xFF80FF80FF80FF80ULL);
+				return static_cast<MachineWord>(sizeof(wchar_t) == 2
+					? 0xFF80FF80FF80FF80ULL
+					: 0xFFFFFF80FFFFFF80ULL);
 			}
 		};
 
+		// ASCII scanners. Each returns the length of the longest prefix of
+		// [begin, end) made of ASCII characters. The vector variants test 16 or
+		// 32 bytes per step and hand the tail to the next narrower variant, so
+		// all of them return the same result for the same input.
+		template <typename Char>
+		size_t CountASCIIScalar(const Char* begin, const Char* end) {
+			constexpr MachineWord non_ascii_bit_mask = NonASCIIMask<Char>::value();
+			constexpr size_t chars_per_word = sizeof(MachineWord) / sizeof(Char);
+			const Char* p = begin;
+			for (; static_cast<size_t>(end - p) >= chars_per_word; p += chars_per_word) {
+				MachineWord word;
+				memcpy(&word, p, sizeof(word));
+				if (word & non_ascii_bit_mask)
+					break;
+			}
+			while (p != end && static_cast<std::make_unsigned_t<Char>>(*p) < 0x80)
+				++p;
+			return p - begin;
+		}
+
+#if defined(ARCH_CPU_X86_FAMILY)
+		// Returns a vector with the non-ASCII bits of each wchar_t set.
+		inline __m128i WideNonASCIIBitsSSE2() {
+			return sizeof(wchar_t) == 2
+				? _mm_set1_epi16(static_cast<short>(0xFF80))
+				: _mm_set1_epi32(static_cast<int>(0xFFFFFF80));
+		}
+
+		size_t CountASCIISSE2(const char* begin, const char* end) {
+			const char* p = begin;
+			for (; end - p >= 16; p += 16) {
+				const __m128i chunk =
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+				const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(chunk));
+				if (mask)
+					return (p - begin) + bits::CountTrailingZeroBits(mask);
+			}
+			return (p - begin) + CountASCIIScalar(p, end);
+		}
+
+		size_t CountASCIISSE2(const wchar_t* begin, const wchar_t* end) {
+			constexpr ptrdiff_t kCharsPerVector = 16 / sizeof(wchar_t);
+			const __m128i non_ascii_bits = WideNonASCIIBitsSSE2();
+			const __m128i zero = _mm_setzero_si128();
+			const wchar_t* p = begin;
+			for (; end - p >= kCharsPerVector; p += kCharsPerVector) {
+				const __m128i chunk =
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+				// A byte compares unequal to zero if it holds non-ASCII bits of its
+				// character, so the first such byte lies in the first non-ASCII
+				// character.
+				const __m128i ascii =
+					_mm_cmpeq_epi8(_mm_and_si128(chunk, non_ascii_bits), zero);
+				const auto mask =
+					~static_cast<uint32_t>(_mm_movemask_epi8(ascii)) & 0xFFFFu;
+				if (mask) {
+					return (p - begin) +
+						bits::CountTrailingZeroBits(mask) / sizeof(wchar_t);
+				}
+			}
+			return (p - begin) + CountASCIIScalar(p, end);
+		}
+
+		size_t CountASCIIAVX2(const char* begin, const char* end) {
+			const char* p = begin;
+			for (; end - p >= 32; p += 32) {
+				const __m256i chunk =
+					_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+				const auto mask =
+					static_cast<uint32_t>(_mm256_movemask_epi8(chunk));
+				if (mask)
+					return (p - begin) + bits::CountTrailingZeroBits(mask);
+			}
+			return (p - begin) + CountASCIISSE2(p, end);
+		}
+
+		size_t CountASCIIAVX2(const wchar_t* begin, const wchar_t* end) {
+			constexpr ptrdiff_t kCharsPerVector = 32 / sizeof(wchar_t);
+			const __m256i non_ascii_bits =
+				_mm256_broadcastsi128_si256(WideNonASCIIBitsSSE2());
+			const __m256i zero = _mm256_setzero_si256();
+			const wchar_t* p = begin;
+			for (; end - p >= kCharsPerVector; p += kCharsPerVector) {
+				const __m256i chunk =
+					_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+				const __m256i ascii =
+					_mm256_cmpeq_epi8(_mm256_and_si256(chunk, non_ascii_bits), zero);
+				const auto mask =
+					~static_cast<uint32_t>(_mm256_movemask_epi8(ascii));
+				if (mask) {
+					return (p - begin) +
+						bits::CountTrailingZeroBits(mask) / sizeof(wchar_t);
+				}
+			}
+			return (p - begin) + CountASCIISSE2(p, end);
+		}
+#endif  // defined(ARCH_CPU_X86_FAMILY)
+
+		struct ASCIIScanner {
+			size_t (*count)(const char* begin, const char* end);
+			size_t (*count_wide)(const wchar_t* begin, const wchar_t* end);
+		};
+
+		// Picks the widest scanner the processor supports. Done once per process.
+		const ASCIIScanner& GetASCIIScanner() {
+			static const ASCIIScanner scanner = [] {
+#if defined(ARCH_CPU_X86_FAMILY)
+				const CPU cpu;
+				if (cpu.has_avx2())
+					return ASCIIScanner{ &CountASCIIAVX2, &CountASCIIAVX2 };
+				if (cpu.has_sse2())
+					return ASCIIScanner{ &CountASCIISSE2, &CountASCIISSE2 };
+#endif
+				return ASCIIScanner{ &CountASCIIScalar<char>, &CountASCIIScalar<wchar_t> };
+			}();
+			return scanner;
+		}
+
+		inline size_t CountASCII(const char* begin, const char* end) {
+			return GetASCIIScanner().count(begin, end);
+		}
+
+		inline size_t CountASCII(const wchar_t* begin, const wchar_t* end) {
+			return GetASCIIScanner().count_wide(begin, end);
+		}
+
+		// ASCII case folding. The converters write the case-converted
+		// [src, src + length) to |dest|, which may be |src|. The mismatch finders
+		// return the first index at which ToLowerASCII(a[i]) differs from b[i],
+		// lowercased too if |kLowerB|, or |length| if there is none. As with the
+		// ASCII scanners, the vector variants hand the tail to the next narrower
+		// variant. The ones comparing wide strings with narrow ones also hand
+		// over at the first non-ASCII narrow character, whose promotion the
+		// scalar code handles.
+		template <typename Char>
+		inline Char ChangeCaseASCII(Char c, bool to_lower) {
+			return to_lower ? ToLowerASCII(c) : ToUpperASCII(c);
+		}
+
+		template <typename Char, bool kToLower>
+		void ChangeCaseScalar(const Char* src, size_t length, Char* dest) {
+			for (size_t i = 0; i < length; ++i)
+				dest[i] = ChangeCaseASCII(src[i], kToLower);
+		}
+
+		template <typename Char, typename CharB, bool kLowerB>
+		size_t MismatchIgnoringCaseScalar(const Char* a, const CharB* b, size_t length) {
+			size_t i = 0;
+			while (i < length &&
+				ToLowerASCII(a[i]) == (kLowerB ? ToLowerASCII(b[i]) : b[i])) {
+				++i;
+			}
+			return i;
+		}
+
+#if defined(ARCH_CPU_X86_FAMILY)
+		// Lane-width helpers: |Char| selects 8-, 16- or 32-bit lanes.
+		template <typename Char>
+		__m128i Set1SSE2(int value) {
+			if constexpr (sizeof(Char) == 1)
+				return _mm_set1_epi8(static_cast<char>(value));
+			else if constexpr (sizeof(Char) == 2)
+				return _mm_set1_epi16(static_cast<short>(value));
+			else
+				return _mm_set1_epi32(value);
+		}
+
+		template <typename Char>
+		__m128i CompareGreaterSSE2(__m128i a, __m128i b) {
+			if constexpr (sizeof(Char) == 1)
+				return _mm_cmpgt_epi8(a, b);
+			else if constexpr (sizeof(Char) == 2)
+				return _mm_cmpgt_epi16(a, b);
+			else
+				return _mm_cmpgt_epi32(a, b);
+		}
+
+		// Flips bit 5 of the letters in [first, first + 25]. Lanes compare as
+		// signed, so non-ASCII values, negative or not, are never letters.
+		template <typename Char>
+		__m128i ChangeCaseSSE2(__m128i chunk, char first) {
+			const __m128i letters = _mm_and_si128(
+				CompareGreaterSSE2<Char>(chunk, Set1SSE2<Char>(first - 1)),
+				CompareGreaterSSE2<Char>(Set1SSE2<Char>(first + 26), chunk));
+			return _mm_xor_si128(chunk, _mm_and_si128(letters, Set1SSE2<Char>(0x20)));
+		}
+
+		// Loads the |16 / sizeof(Char)| characters at |p| into Char-sized lanes.
+		// Returns false if narrow characters loaded for wide lanes are not all
+		// ASCII.
+		template <typename Char, typename CharB>
+		bool LoadSSE2(const CharB* p, __m128i* chunk) {
+			if constexpr (sizeof(Char) == sizeof(CharB)) {
+				*chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+				return true;
+			} else {
+				const __m128i zero = _mm_setzero_si128();
+				__m128i narrow;
+				if constexpr (sizeof(Char) == 2) {
+					narrow = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+				} else {
+					int32_t bytes;
+					memcpy(&bytes, p, sizeof(bytes));
+					narrow = _mm_cvtsi32_si128(bytes);
+				}
+				if (_mm_movemask_epi8(narrow))
+					return false;
+				*chunk = _mm_unpacklo_epi8(narrow, zero);
+				if constexpr (sizeof(Char) == 4)
+					*chunk = _mm_unpacklo_epi16(*chunk, zero);
+				return true;
+			}
+		}
+
+		template <typename Char, bool kToLower>
+		void ChangeCaseSSE2(const Char* src, size_t length, Char* dest) {
+			constexpr size_t kCharsPerVector = 16 / sizeof(Char);
+			size_t i = 0;
+			for (; length - i >= kCharsPerVector; i += kCharsPerVector) {
+				const __m128i chunk =
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i),
+					ChangeCaseSSE2<Char>(chunk, kToLower ? 'A' : 'a'));
+			}
+			ChangeCaseScalar<Char, kToLower>(src + i, length - i, dest + i);
+		}
+
+		template <typename Char, typename CharB, bool kLowerB>
+		size_t MismatchIgnoringCaseSSE2(const Char* a, const CharB* b, size_t length) {
+			constexpr size_t kCharsPerVector = 16 / sizeof(Char);
+			size_t i = 0;
+			for (; length - i >= kCharsPerVector; i += kCharsPerVector) {
+				__m128i chunk_b;
+				if (!LoadSSE2<Char>(b + i, &chunk_b))
+					break;
+				if (kLowerB)
+					chunk_b = ChangeCaseSSE2<Char>(chunk_b, 'A');
+				const __m128i chunk_a = ChangeCaseSSE2<Char>(
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)), 'A');
+				const auto mask = ~static_cast<uint32_t>(
+					_mm_movemask_epi8(_mm_cmpeq_epi8(chunk_a, chunk_b))) & 0xFFFFu;
+				if (mask)
+					return i + bits::CountTrailingZeroBits(mask) / sizeof(Char);
+			}
+			return i + MismatchIgnoringCaseScalar<Char, CharB, kLowerB>(
+				a + i, b + i, length - i);
+		}
+
+		template <typename Char>
+		__m256i Set1AVX2(int value) {
+			return _mm256_broadcastsi128_si256(Set1SSE2<Char>(value));
+		}
+
+		template <typename Char>
+		__m256i CompareGreaterAVX2(__m256i a, __m256i b) {
+			if constexpr (sizeof(Char) == 1)
+				return _mm256_cmpgt_epi8(a, b);
+			else if constexpr (sizeof(Char) == 2)
+				return _mm256_cmpgt_epi16(a, b);
+			else
+				return _mm256_cmpgt_epi32(a, b);
+		}
+
+		template <typename Char>
+		__m256i ChangeCaseAVX2(__m256i chunk, char first) {
+			const __m256i letters = _mm256_and_si256(
+				CompareGreaterAVX2<Char>(chunk, Set1AVX2<Char>(first - 1)),
+				CompareGreaterAVX2<Char>(Set1AVX2<Char>(first + 26), chunk));
+			return _mm256_xor_si256(chunk,
+				_mm256_and_si256(letters, Set1AVX2<Char>(0x20)));
+		}
+
+		template <typename Char, typename CharB>
+		bool LoadAVX2(const CharB* p, __m256i* chunk) {
+			if constexpr (sizeof(Char) == sizeof(CharB)) {
+				*chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+				return true;
+			} else {
+				const __m128i narrow = sizeof(Char) == 2
+					? _mm_loadu_si128(reinterpret_cast<const __m128i*>(p))
+					: _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+				if (_mm_movemask_epi8(narrow))
+					return false;
+				*chunk = sizeof(Char) == 2 ? _mm256_cvtepu8_epi16(narrow)
+					: _mm256_cvtepu8_epi32(narrow);
+				return true;
+			}
+		}
+
+		template <typename Char, bool kToLower>
+		void ChangeCaseAVX2(const Char* src, size_t length, Char* dest) {
+			constexpr size_t kCharsPerVector = 32 / sizeof(Char);
+			size_t i = 0;
+			for (; length - i >= kCharsPerVector; i += kCharsPerVector) {
+				const __m256i chunk =
+					_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i),
+					ChangeCaseAVX2<Char>(chunk, kToLower ? 'A' : 'a'));
+			}
+			ChangeCaseSSE2<Char, kToLower>(src + i, length - i, dest + i);
+		}
+
+		template <typename Char, typename CharB, bool kLowerB>
+		size_t MismatchIgnoringCaseAVX2(const Char* a, const CharB* b, size_t length) {
+			constexpr size_t kCharsPerVector = 32 / sizeof(Char);
+			size_t i = 0;
+			for (; length - i >= kCharsPerVector; i += kCharsPerVector) {
+				__m256i chunk_b;
+				if (!LoadAVX2<Char>(b + i, &chunk_b))
+					break;
+				if (kLowerB)
+					chunk_b = ChangeCaseAVX2<Char>(chunk_b, 'A');
+				const __m256i chunk_a = ChangeCaseAVX2<Char>(
+					_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)), 'A');
+				const auto mask = ~static_cast<uint32_t>(
+					_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk_a, chunk_b)));
+				if (mask)
+					return i + bits::CountTrailingZeroBits(mask) / sizeof(Char);
+			}
+			return i + MismatchIgnoringCaseSSE2<Char, CharB, kLowerB>(
+				a + i, b + i, length - i);
+		}
+#endif  // defined(ARCH_CPU_X86_FAMILY)
+
+		template <typename Char>
+		using ChangeCaseFunction = void (*)(const Char* src, size_t length, Char* dest);
+		template <typename Char, typename CharB>
+		using MismatchFunction = size_t (*)(const Char* a, const CharB* b, size_t length);
+
+		struct CaseFolder {
+			ChangeCaseFunction<char> to_lower;
+			ChangeCaseFunction<wchar_t> to_lower_wide;
+			ChangeCaseFunction<char> to_upper;
+			ChangeCaseFunction<wchar_t> to_upper_wide;
+			// Both sides lowercased, for the case-insensitive comparisons.
+			MismatchFunction<char, char> mismatch;
+			MismatchFunction<wchar_t, wchar_t> mismatch_wide;
+			// Only the first side lowercased, for LowerCaseEqualsASCII().
+			MismatchFunction<char, char> mismatch_lowercase;
+			MismatchFunction<wchar_t, char> mismatch_lowercase_wide;
+		};
+
+#define CASE_FOLDER(Variant)                                          \
+		CaseFolder {                                                      \
+			&ChangeCase##Variant<char, true>,                             \
+			&ChangeCase##Variant<wchar_t, true>,                          \
+			&ChangeCase##Variant<char, false>,                            \
+			&ChangeCase##Variant<wchar_t, false>,                         \
+			&MismatchIgnoringCase##Variant<char, char, true>,             \
+			&MismatchIgnoringCase##Variant<wchar_t, wchar_t, true>,       \
+			&MismatchIgnoringCase##Variant<char, char, false>,            \
+			&MismatchIgnoringCase##Variant<wchar_t, char, false>,         \
+		}
+
+		// Picks the widest case folder the processor supports. Done once per
+		// process.
+		const CaseFolder& GetCaseFolder() {
+			static const CaseFolder folder = [] {
+#if defined(ARCH_CPU_X86_FAMILY)
+				const CPU cpu;
+				if (cpu.has_avx2())
+					return CASE_FOLDER(AVX2);
+				if (cpu.has_sse2())
+					return CASE_FOLDER(SSE2);
+#endif
+				return CASE_FOLDER(Scalar);
+			}();
+			return folder;
+		}
+
+#undef CASE_FOLDER
+
+		inline void ChangeCase(const char* src, size_t length, char* dest, bool to_lower) {
+			const CaseFolder& folder = GetCaseFolder();
+			(to_lower ? folder.to_lower : folder.to_upper)(src, length, dest);
+		}
+
+		inline void ChangeCase(const wchar_t* src, size_t length, wchar_t* dest, bool to_lower) {
+			const CaseFolder& folder = GetCaseFolder();
+			(to_lower ? folder.to_lower_wide : folder.to_upper_wide)(src, length, dest);
+		}
+
+		inline size_t MismatchIgnoringCase(const char* a, const char* b, size_t length) {
+			return GetCaseFolder().mismatch(a, b, length);
+		}
+
+		inline size_t MismatchIgnoringCase(const wchar_t* a, const wchar_t* b, size_t length) {
+			return GetCaseFolder().mismatch_wide(a, b, length);
+		}
+
 	}  // namespace
 
 	bool IsWprintfFormatPortable(const wchar_t* format) {
@@ -118,39 +515,47 @@ namespace base {
 	namespace {
 
 		template<typename Ch>
-		std::basic_string<Ch> ToLowerASCIIImpl(std::basic_string_view<Ch> str) {
-			std::basic_string<Ch> ret;
-			ret.reserve(str.size());
-			for (size_t i = 0; i < str.size(); i++)
-				ret.push_back(ToLowerASCII(str[i]));
-			return ret;
-		}
-
-		template<typename Ch>
-		std::basic_string<Ch> ToUpperASCIIImpl(std::basic_string_view<Ch> str) {
-			std::basic_string<Ch> ret;
-			ret.reserve(str.size());
-			for (size_t i = 0; i < str.size(); i++)
-				ret.push_back(ToUpperASCII(str[i]));
+		std::basic_string<Ch> ChangeCaseASCIIImpl(std::basic_string_view<Ch> str,
+			bool to_lower) {
+			// Copying first and converting in place beats filling the string and
+			// then converting into it.
+			std::basic_string<Ch> ret(str);
+			ChangeCase(ret.data(), ret.size(), ret.data(), to_lower);
 			return ret;
 		}
 
 	}  // namespace
 	
 	std::string ToLowerASCII(std::string_view str) {
-		return ToLowerASCIIImpl<char>(str);
+		return ChangeCaseASCIIImpl<char>(str, true);
 	}
 
 	std::wstring ToLowerASCII(std::wstring_view str) {
-		return ToLowerASCIIImpl<wchar_t>(str);
+		return ChangeCaseASCIIImpl<wchar_t>(str, true);
 	}
 
 	std::string ToUpperASCII(std::string_view str) {
-		return ToUpperASCIIImpl<char>(str);
+		return ChangeCaseASCIIImpl<char>(str, false);
 	}
 
 	std::wstring ToUpperASCII(std::wstring_view str) {
-		return ToUpperASCIIImpl<wchar_t>(str);
+		return ChangeCaseASCIIImpl<wchar_t>(str, false);
+	}
+
+	void ToLowerASCIIInPlace(std::string* str) {
+		ChangeCase(str->data(), str->size(), str->data(), true);
+	}
+
+	void ToLowerASCIIInPlace(std::wstring* str) {
+		ChangeCase(str->data(), str->size(), str->data(), true);
+	}
+
+	void ToUpperASCIIInPlace(std::string* str) {
+		ChangeCase(str->data(), str->size(), str->data(), false);
+	}
+
+	void ToUpperASCIIInPlace(std::wstring* str) {
+		ChangeCase(str->data(), str->size(), str->data(), false);
 	}
 
 	template<typename Ch>
@@ -159,16 +564,10 @@ namespace base {
 		// Find the first characters that aren't equal and compare them.  If the end
 		// of one of the strings is found before a nonequal character, the lengths
 		// of the strings are compared.
-		size_t i = 0;
-		while (i < a.length() && i < b.length()) {
-			Ch lower_a = ToLowerASCII(a[i]);
-			Ch lower_b = ToLowerASCII(b[i]);
-			if (lower_a < lower_b)
-				return -1;
-			if (lower_a > lower_b)
-				return 1;
-			i++;
-		}
+		const size_t i = MismatchIgnoringCase(a.data(), b.data(),
+			std::min(a.length(), b.length()));
+		if (i < a.length() && i < b.length())
+			return ToLowerASCII(a[i]) < ToLowerASCII(b[i]) ? -1 : 1;
 
 		// End of one string hit before finding a different character. Expect the
 		// common case to be "strings equal" at this point so check that first.
@@ -191,13 +590,13 @@ namespace base {
 	bool EqualsCaseInsensitiveASCII(std::string_view a, std::string_view b) {
 		if (a.length() != b.length())
 			return false;
-		return CompareCaseInsensitiveASCIIT<char>(a, b) == 0;
+		return MismatchIgnoringCase(a.data(), b.data(), a.length()) == a.length();
 	}
 
 	bool EqualsCaseInsensitiveASCII(std::wstring_view a, std::wstring_view b) {
 		if (a.length() != b.length())
 			return false;
-		return CompareCaseInsensitiveASCIIT<wchar_t>(a, b) == 0;
+		return MismatchIgnoringCase(a.data(), b.data(), a.length()) == a.length();
 	}
 
 	const std::string& EmptyString() {
@@ -297,6 +696,10 @@ namespace base {
 												 TrimPositions positions) {
 		size_t begin = (positions & TRIM_LEADING) ? 
 			input.find_first_not_of(trim_chars) : 0;
+		// std::basic_string_view::substr() throws rather than clamps, so return
+		// the empty tail explicitly when everything is trimmed.
+		if (begin == std::basic_string_view<Ch>::npos)
+			return input.substr(input.size());
 		const size_t end = (positions & TRIM_TRAILING) ? 
 			input.find_last_not_of(trim_chars) + 1 : input.size();
 		return input.substr(begin, end - begin);
@@ -432,53 +835,12 @@ namespace base {
 		return input.find_first_not_of(characters) == std::wstring_view::npos;
 	}
 
-	template <class Char>
-	inline bool DoIsStringASCII(const Char* characters, size_t length) {
-		if (!length)
-			return true;
-		constexpr MachineWord non_ascii_bit_mask = NonASCIIMask<Char>::value();
-		MachineWord all_char_bits = 0;
-		const Char* end = characters + length;
-
-		// Prologue: align the input.
-		while (!IsMachineWordAligned(characters) && characters < end)
-			all_char_bits |= *characters++;
-		if (all_char_bits & non_ascii_bit_mask)
-			return false;
-
-		// Compare the values of CPU word size.
-		constexpr size_t chars_per_word = sizeof(MachineWord) / sizeof(Char);
-		constexpr int batch_count = 16;
-		while (characters <= end - batch_count * chars_per_word) {
-			all_char_bits = 0;
-			for (int i = 0; i < batch_count; ++i) {
-				all_char_bits |= *(reinterpret_cast<const MachineWord*>(characters));
-				characters += chars_per_word;
-			}
-			if (all_char_bits & non_ascii_bit_mask)
-				return false;
-		}
-
-		// Process the remaining words.
-		all_char_bits = 0;
-		while (characters <= end - chars_per_word) {
-			all_char_bits |= *(reinterpret_cast<const MachineWord*>(characters));
-			characters += chars_per_word;
-		}
-
-		// Process the remaining bytes.
-		while (characters < end)
-			all_char_bits |= *characters++;
-
-		return !(all_char_bits & non_ascii_bit_mask);
-	}
-
 	bool IsStringASCII(std::string_view str) {
-		return DoIsStringASCII(str.data(), str.length());
+		return CountASCII(str.data(), str.data() + str.length()) == str.length();
 	}
 
 	bool IsStringASCII(std::wstring_view str) {
-		return DoIsStringASCII(str.data(), str.length());
+		return CountASCII(str.data(), str.data() + str.length()) == str.length();
 	}
 
 	bool IsStringUTF8(std::string_view str) {
@@ -487,6 +849,13 @@ namespace base {
 		int32_t char_index = 0;
 
 		while (char_index < src_len) {
+			// ASCII characters are always valid, so runs of them are skipped in
+			// bulk and only multibyte sequences are decoded one by one.
+			if (static_cast<unsigned char>(src[char_index]) < 0x80) {
+				char_index += static_cast<int32_t>(
+					CountASCII(src + char_index, src + src_len));
+				continue;
+			}
 			int32_t code_point;
 			CBU8_NEXT(src, char_index, src_len, code_point);
 			if (!IsValidCharacter(code_point))
@@ -510,24 +879,18 @@ namespace base {
 	// The hardcoded strings are typically very short so it doesn't matter, and the
 	// string piece gives additional flexibility for the caller (doesn't have to be
 	// null terminated) so we choose the std::string_view route.
-	template<typename Ch>
-	static inline bool DoLowerCaseEqualsASCII(std::basic_string_view<Ch> str, 
-											  std::string_view lowercase_ascii) {
+	bool LowerCaseEqualsASCII(std::string_view str, std::string_view lowercase_ascii) {
 		if (str.size() != lowercase_ascii.size())
 			return false;
-		for (size_t i = 0; i < str.size(); i++) {
-			if (ToLowerASCII(str[i]) != lowercase_ascii[i])
-				return false;
-		}
-		return true;
-	}
-
-	bool LowerCaseEqualsASCII(std::string_view str, std::string_view lowercase_ascii) {
-		return DoLowerCaseEqualsASCII<char>(str, lowercase_ascii);
+		return GetCaseFolder().mismatch_lowercase(str.data(), lowercase_ascii.data(),
+			str.size()) == str.size();
 	}
 
 	bool LowerCaseEqualsASCII(std::wstring_view str, std::string_view lowercase_ascii) {
-		return DoLowerCaseEqualsASCII<wchar_t>(str, lowercase_ascii);
+		if (str.size() != lowercase_ascii.size())
+			return false;
+		return GetCaseFolder().mismatch_lowercase_wide(str.data(),
+			lowercase_ascii.data(), str.size()) == str.size();
 	}
 
 	bool EqualsASCII(std::wstring_view str, std::string_view ascii) {
@@ -673,6 +1036,11 @@ namespace base {
 		size_t MatchSize() { return find_this.length(); }
 	};
 
+	template <>
+	size_t SubstringMatcher<char>::Find(const std::string& input, size_t pos) {
+		return internal::FindSubstring(input, find_this, pos);
+	}
+
 	// A Matcher for DoReplaceMatchesAfterOffset() that matches single characters.
 	template <class Ch>
 	struct CharacterMatcher {
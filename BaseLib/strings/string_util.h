@@ -106,6 +106,13 @@ namespace base {
 	BASE_EXPORT std::string ToUpperASCII(std::string_view str);
 	BASE_EXPORT std::wstring ToUpperASCII(std::wstring_view str);
 
+	// Same as ToLowerASCII() and ToUpperASCII(), converting |str| itself instead
+	// of allocating a copy.
+	BASE_EXPORT void ToLowerASCIIInPlace(std::string* str);
+	BASE_EXPORT void ToLowerASCIIInPlace(std::wstring* str);
+	BASE_EXPORT void ToUpperASCIIInPlace(std::string* str);
+	BASE_EXPORT void ToUpperASCIIInPlace(std::wstring* str);
+
 	// Functor for case-insensitive ASCII comparisons for STL algorithms like
 	// std::search.
 	//
@@ -9,11 +9,18 @@
 
 #include <type_traits>
 
+#include "build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <immintrin.h>
+#endif
+
 #include "bit_cast.h"
+#include "bits.h"
+#include "cpu.h"
 #include "strings/string_util.h"
 #include "strings/utf_string_conversion_utils.h"
 #include "third_party/icu/icu_utf.h"
-#include "build_config.h"
 
 namespace base {
 
@@ -70,18 +77,174 @@ namespace base {
 			out[(*size)++] = code_point;
 		}
 
+		// ASCII converters -----------------------------------------------------------
+		// Each copies the longest ASCII prefix of the |length| code units at |src|
+		// to |dest|, widening or narrowing every unit, and returns its length. The
+		// vector variants convert 16 or 32 units per step and hand the tail to the
+		// next narrower variant. They store whole steps, so up to one step past
+		// the returned length may be overwritten with junk; DoUTFConversion sizes
+		// |dest| for the worst case of the whole input, which keeps these stores
+		// in bounds, and overwrites the junk with what comes next.
+
+		template <typename Char>
+		inline bool IsASCIIUnit(Char c) {
+			return static_cast<std::make_unsigned_t<Char>>(c) < 0x80;
+		}
+
+		template <typename SrcChar, typename DestChar>
+		size_t ConvertASCIIScalar(const SrcChar* src, size_t length, DestChar* dest) {
+			size_t i = 0;
+			for (; i < length && IsASCIIUnit(src[i]); ++i)
+				dest[i] = static_cast<DestChar>(src[i]);
+			return i;
+		}
+
+#if defined(ARCH_CPU_X86_FAMILY)
+		size_t ConvertASCIISSE2(const char* src, size_t length, wchar_t* dest) {
+			const __m128i zero = _mm_setzero_si128();
+			size_t i = 0;
+			for (; length - i >= 16; i += 16) {
+				const __m128i chunk =
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+				const __m128i low = _mm_unpacklo_epi8(chunk, zero);
+				const __m128i high = _mm_unpackhi_epi8(chunk, zero);
+				auto* out = reinterpret_cast<__m128i*>(dest + i);
+				if constexpr (sizeof(wchar_t) == 2) {
+					_mm_storeu_si128(out, low);
+					_mm_storeu_si128(out + 1, high);
+				} else {
+					_mm_storeu_si128(out, _mm_unpacklo_epi16(low, zero));
+					_mm_storeu_si128(out + 1, _mm_unpackhi_epi16(low, zero));
+					_mm_storeu_si128(out + 2, _mm_unpacklo_epi16(high, zero));
+					_mm_storeu_si128(out + 3, _mm_unpackhi_epi16(high, zero));
+				}
+				const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(chunk));
+				if (mask)
+					return i + bits::CountTrailingZeroBits(mask);
+			}
+			return i + ConvertASCIIScalar(src + i, length - i, dest + i);
+		}
+
+		size_t ConvertASCIISSE2(const wchar_t* src, size_t length, char* dest) {
+			const __m128i zero = _mm_setzero_si128();
+			size_t i = 0;
+			for (; length - i >= 16; i += 16) {
+				const auto* in = reinterpret_cast<const __m128i*>(src + i);
+				// ASCII units fit in a byte, so the saturating packs narrow them
+				// exactly. |ascii| packs the per-unit comparison results the same
+				// way, leaving one byte per unit for the movemask.
+				__m128i narrowed;
+				__m128i ascii;
+				if constexpr (sizeof(wchar_t) == 2) {
+					const __m128i non_ascii_bits =
+						_mm_set1_epi16(static_cast<short>(0xFF80));
+					const __m128i a = _mm_loadu_si128(in);
+					const __m128i b = _mm_loadu_si128(in + 1);
+					narrowed = _mm_packus_epi16(a, b);
+					ascii = _mm_packs_epi16(
+						_mm_cmpeq_epi16(_mm_and_si128(a, non_ascii_bits), zero),
+						_mm_cmpeq_epi16(_mm_and_si128(b, non_ascii_bits), zero));
+				} else {
+					const __m128i non_ascii_bits =
+						_mm_set1_epi32(static_cast<int>(0xFFFFFF80));
+					const __m128i a = _mm_loadu_si128(in);
+					const __m128i b = _mm_loadu_si128(in + 1);
+					const __m128i c = _mm_loadu_si128(in + 2);
+					const __m128i d = _mm_loadu_si128(in + 3);
+					narrowed = _mm_packus_epi16(_mm_packs_epi32(a, b),
+						_mm_packs_epi32(c, d));
+					ascii = _mm_packs_epi16(
+						_mm_packs_epi32(
+							_mm_cmpeq_epi32(_mm_and_si128(a, non_ascii_bits), zero),
+							_mm_cmpeq_epi32(_mm_and_si128(b, non_ascii_bits), zero)),
+						_mm_packs_epi32(
+							_mm_cmpeq_epi32(_mm_and_si128(c, non_ascii_bits), zero),
+							_mm_cmpeq_epi32(_mm_and_si128(d, non_ascii_bits), zero)));
+				}
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), narrowed);
+				const auto mask =
+					~static_cast<uint32_t>(_mm_movemask_epi8(ascii)) & 0xFFFFu;
+				if (mask)
+					return i + bits::CountTrailingZeroBits(mask);
+			}
+			return i + ConvertASCIIScalar(src + i, length - i, dest + i);
+		}
+
+		size_t ConvertASCIIAVX2(const char* src, size_t length, wchar_t* dest) {
+			size_t i = 0;
+			for (; length - i >= 32; i += 32) {
+				const __m256i chunk =
+					_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+				const __m128i low = _mm256_castsi256_si128(chunk);
+				const __m128i high = _mm256_extracti128_si256(chunk, 1);
+				auto* out = reinterpret_cast<__m256i*>(dest + i);
+				if constexpr (sizeof(wchar_t) == 2) {
+					_mm256_storeu_si256(out, _mm256_cvtepu8_epi16(low));
+					_mm256_storeu_si256(out + 1, _mm256_cvtepu8_epi16(high));
+				} else {
+					_mm256_storeu_si256(out, _mm256_cvtepu8_epi32(low));
+					_mm256_storeu_si256(out + 1,
+						_mm256_cvtepu8_epi32(_mm_srli_si128(low, 8)));
+					_mm256_storeu_si256(out + 2, _mm256_cvtepu8_epi32(high));
+					_mm256_storeu_si256(out + 3,
+						_mm256_cvtepu8_epi32(_mm_srli_si128(high, 8)));
+				}
+				const auto mask =
+					static_cast<uint32_t>(_mm256_movemask_epi8(chunk));
+				if (mask)
+					return i + bits::CountTrailingZeroBits(mask);
+			}
+			return i + ConvertASCIISSE2(src + i, length - i, dest + i);
+		}
+#endif  // defined(ARCH_CPU_X86_FAMILY)
+
+		struct ASCIIConverter {
+			using ToWide = size_t (*)(const char* src, size_t length, wchar_t* dest);
+			using ToUTF8 = size_t (*)(const wchar_t* src, size_t length, char* dest);
+
+			ToWide to_wide;
+			ToUTF8 to_utf8;
+		};
+
+		// Picks the widest converter the processor supports. Done once per
+		// process. Narrowing stays on SSE2 under AVX2: packing across the two
+		// 128-bit lanes needs an extra permute and buys little over 16 units per
+		// step.
+		const ASCIIConverter& GetASCIIConverter() {
+			static const ASCIIConverter converter = [] {
+#if defined(ARCH_CPU_X86_FAMILY)
+				const CPU cpu;
+				if (cpu.has_avx2())
+					return ASCIIConverter{ &ConvertASCIIAVX2, &ConvertASCIISSE2 };
+				if (cpu.has_sse2())
+					return ASCIIConverter{ &ConvertASCIISSE2, &ConvertASCIISSE2 };
+#endif
+				return ASCIIConverter{ &ConvertASCIIScalar<char, wchar_t>,
+					&ConvertASCIIScalar<wchar_t, char> };
+			}();
+			return converter;
+		}
+
 		// DoUTFConversion ------------------------------------------------------------
 		// Main driver of UTFConversion specialized for different Src encodings.
 		// dest has to have enough room for the converted text.
 
-		template <typename DestChar>
 		bool DoUTFConversion(const char* src,
 			int32_t src_len,
-			DestChar* dest,
+			wchar_t* dest,
 			int32_t* dest_len) {
 			bool success = true;
+			const ASCIIConverter::ToWide convert_ascii = GetASCIIConverter().to_wide;
 
 			for (int32_t i = 0; i < src_len;) {
+				if (IsASCIIUnit(src[i])) {
+					const auto converted = static_cast<int32_t>(
+						convert_ascii(src + i, src_len - i, dest + *dest_len));
+					i += converted;
+					*dest_len += converted;
+					continue;
+				}
+
 				int32_t code_point;
 				CBU8_NEXT(src, i, src_len, code_point);
 
@@ -96,12 +259,12 @@ namespace base {
 			return success;
 		}
 
-		template <typename DestChar>
 		bool DoUTFConversion(const wchar_t* src,
 			int32_t src_len,
-			DestChar* dest,
+			char* dest,
 			int32_t* dest_len) {
 			bool success = true;
+			const ASCIIConverter::ToUTF8 convert_ascii = GetASCIIConverter().to_utf8;
 
 			auto ConvertSingleChar = [&success](wchar_t in) -> int32_t {
 				if (!CBU16_IS_SINGLE(in) || !IsValidCodepoint(in)) {
@@ -116,6 +279,14 @@ namespace base {
 			// Always have another symbol in order to avoid checking boundaries in the
 			// middle of the surrogate pair.
 			while (i < src_len - 1) {
+				if (IsASCIIUnit(src[i])) {
+					const auto converted = static_cast<int32_t>(
+						convert_ascii(src + i, src_len - i, dest + *dest_len));
+					i += converted;
+					*dest_len += converted;
+					continue;
+				}
+
 				int32_t code_point;
 
 				if (CBU16_IS_LEAD(src[i]) && CBU16_IS_TRAIL(src[i + 1])) {
@@ -166,11 +337,6 @@ namespace base {
 		}
 
 		bool UTFConversion(std::string_view src_str, std::wstring* dest_str) {
-			if (IsStringASCII(src_str)) {
-				dest_str->assign(src_str.begin(), src_str.end());
-				return true;
-			}
-
 			dest_str->resize(src_str.length() * size_coefficient_v<char, wchar_t>);
 
 			// Empty string is ASCII => it OK to call operator[].
@@ -4,11 +4,10 @@
 
 #include "token.h"
 
-#include <cinttypes>
-
+#include "big_endian.h"
 #include "pickle.h"
 #include "rand_util.h"
-#include "strings/stringprintf.h"
+#include "strings/string_number_conversions.h"
 
 namespace base {
 
@@ -23,7 +22,11 @@ namespace base {
 	}
 
 	std::string Token::ToString() const {
-		return StringPrintf("%016" PRIX64 "%016" PRIX64, high_, low_);
+		// The same digits as printing |high_| and then |low_| with %016X.
+		char bytes[sizeof(high_) + sizeof(low_)];
+		WriteBigEndian(bytes, high_);
+		WriteBigEndian(bytes + sizeof(high_), low_);
+		return HexEncode(bytes, sizeof(bytes));
 	}
 
 	void WriteTokenToPickle(Pickle* pickle, const Token& token) {
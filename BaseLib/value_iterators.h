@@ -10,6 +10,7 @@
 
 #include "base_export.h"
 #include "containers/flat_map.h"
+#include "dict_key.h"
 #include "macros.h"
 
 namespace base
@@ -20,7 +21,7 @@ namespace base
 	namespace detail
 	{
 
-		using DictStorage = base::flat_map<std::string, std::unique_ptr<Value>>;
+		using DictStorage = base::flat_map<DictKey, std::unique_ptr<Value>>;
 
 		// This iterator closely resembles DictStorage::iterator, with one
 		// important exception. It abstracts the underlying unique_ptr away, meaning its
@@ -176,16 +176,16 @@ namespace base {
 			double_value_ = bit_cast<DoubleStorage>(0.0);
 			return;
 		case Type::STRING:
-			new (&string_value_) std::string();
+			new (&string_value_) HeapStringStorage();
 			return;
 		case Type::BINARY:
-			new (&binary_value_) BlobStorage();
+			new (&binary_value_) HeapBlobStorage();
 			return;
 		case Type::DICTIONARY:
-			new (&dict_) DictStorage();
+			new (&dict_) HeapDictStorage();
 			return;
 		case Type::LIST:
-			new (&list_) ListStorage();
+			new (&list_) HeapListStorage();
 			return;
 			// TODO(crbug.com/859477): Remove after root cause is found.
 		case Type::DEAD:
@@ -216,7 +216,7 @@ namespace base {
 
 	Value::Value(std::string&& in_string) noexcept
 		: type_(Type::STRING), string_value_(std::move(in_string)) {
-		DCHECK(IsStringUTF8(string_value_));
+		DCHECK(IsStringUTF8(*string_value_));
 	}
 
 	Value::Value(const wchar_t* in_string16) : Value(std::wstring_view(in_string16)) {}
@@ -224,11 +224,13 @@ namespace base {
 	Value::Value(std::wstring_view in_string16) : Value(WideToUTF8(in_string16)) {}
 
 	Value::Value(const std::vector<char>& in_blob)
-		: type_(Type::BINARY), binary_value_(in_blob.begin(), in_blob.end()) {
+		: type_(Type::BINARY),
+		binary_value_(BlobStorage(in_blob.begin(), in_blob.end())) {
 	}
 
 	Value::Value(base::span<const uint8_t> in_blob)
-		: type_(Type::BINARY), binary_value_(in_blob.begin(), in_blob.end()) {
+		: type_(Type::BINARY),
+		binary_value_(BlobStorage(in_blob.begin(), in_blob.end())) {
 	}
 
 	Value::Value(BlobStorage&& in_blob) noexcept
@@ -236,9 +238,10 @@ namespace base {
 	}
 
 	Value::Value(const DictStorage& in_dict) : type_(Type::DICTIONARY), dict_() {
-		dict_.reserve(in_dict.size());
+		DictStorage& dict = dict_.GetForWrite();
+		dict.reserve(in_dict.size());
 		for (const auto& it : in_dict) {
-			dict_.try_emplace(dict_.end(), it.first,
+			dict.try_emplace(dict.end(), it.first,
 				std::make_unique<Value>(it.second->Clone()));
 		}
 	}
@@ -248,9 +251,10 @@ namespace base {
 	}
 
 	Value::Value(span<const Value> in_list) : type_(Type::LIST), list_() {
-		list_.reserve(in_list.size());
+		ListStorage& list = list_.GetForWrite();
+		list.reserve(in_list.size());
 		for (const auto& val : in_list)
-			list_.emplace_back(val.Clone());
+			list.emplace_back(val.Clone());
 	}
 
 	Value::Value(ListStorage&& in_list) noexcept
@@ -279,13 +283,13 @@ namespace base {
 		case Type::DOUBLE:
 			return Value(AsDoubleInternal());
 		case Type::STRING:
-			return Value(string_value_);
+			return Value(*string_value_);
 		case Type::BINARY:
-			return Value(binary_value_);
+			return Value(*binary_value_);
 		case Type::DICTIONARY:
-			return Value(dict_);
+			return Value(*dict_);
 		case Type::LIST:
-			return Value(list_);
+			return Value(*list_);
 			// TODO(crbug.com/859477): Remove after root cause is found.
 		case Type::DEAD:
 			CHECK(false);
@@ -331,72 +335,72 @@ namespace base {
 
 	const std::string& Value::GetString() const {
 		CHECK(is_string());
-		return string_value_;
+		return *string_value_;
 	}
 
 	std::string& Value::GetString() {
 		CHECK(is_string());
-		return string_value_;
+		return string_value_.GetForWrite();
 	}
 
 	const Value::BlobStorage& Value::GetBlob() const {
 		CHECK(is_blob());
-		return binary_value_;
+		return *binary_value_;
 	}
 
 	Value::ListStorage& Value::GetList() {
 		CHECK(is_list());
-		return list_;
+		return list_.GetForWrite();
 	}
 
 	span<const Value> Value::GetList() const {
 		CHECK(is_list());
-		return list_;
+		return *list_;
 	}
 
 	void Value::Append(bool value) {
 		CHECK(is_list());
-		list_.emplace_back(value);
+		list_.GetForWrite().emplace_back(value);
 	}
 
 	void Value::Append(int value) {
 		CHECK(is_list());
-		list_.emplace_back(value);
+		list_.GetForWrite().emplace_back(value);
 	}
 
 	void Value::Append(double value) {
 		CHECK(is_list());
-		list_.emplace_back(value);
+		list_.GetForWrite().emplace_back(value);
 	}
 
 	void Value::Append(const char* value) {
 		CHECK(is_list());
-		list_.emplace_back(value);
+		list_.GetForWrite().emplace_back(value);
 	}
 
 	void Value::Append(std::string_view value) {
 		CHECK(is_list());
-		list_.emplace_back(value);
+		list_.GetForWrite().emplace_back(value);
 	}
 
 	void Value::Append(std::string&& value) {
 		CHECK(is_list());
-		list_.emplace_back(std::move(value));
+		list_.GetForWrite().emplace_back(std::move(value));
 	}
 
 	void Value::Append(const wchar_t* value) {
 		CHECK(is_list());
-		list_.emplace_back(value);
+		list_.GetForWrite().emplace_back(value);
 	}
 
 	void Value::Append(std::wstring_view value) {
 		CHECK(is_list());
-		list_.emplace_back(value);
+		list_.GetForWrite().emplace_back(value);
 	}
 
 	void Value::Append(Value&& value) {
 		CHECK(is_list());
-		list_.emplace_back(std::move(value));
+		list_.GetForWrite().emplace_back(std::move(value));
 	}
 
 	Value* Value::FindKey(std::string_view key) {
@@ -405,8 +409,8 @@ namespace base {
 
 	const Value* Value::FindKey(std::string_view key) const {
 		CHECK(is_dict());
-		const auto found = dict_.find(key);
-		if (found == dict_.end())
+		const auto found = dict_->find(key);
+		if (found == dict_->end())
 			return nullptr;
 		return found->second.get();
 	}
@@ -447,17 +451,17 @@ namespace base {
 
 	const std::string* Value::FindStringKey(std::string_view key) const {
 		const auto result = FindKeyOfType(key, Type::STRING);
-		return result ? &result->string_value_ : nullptr;
+		return result ? &*result->string_value_ : nullptr;
 	}
 
 	std::string* Value::FindStringKey(std::string_view key) {
 		auto result = FindKeyOfType(key, Type::STRING);
-		return result ? &result->string_value_ : nullptr;
+		return result ? &result->string_value_.GetForWrite() : nullptr;
 	}
 
 	const Value::BlobStorage* Value::FindBlobKey(std::string_view key) const {
 		const auto value = FindKeyOfType(key, Type::BINARY);
-		return value ? &value->binary_value_ : nullptr;
+		return value ? &*value->binary_value_ : nullptr;
 	}
 
 	const Value* Value::FindDictKey(std::string_view key) const {
@@ -482,7 +486,7 @@ namespace base {
 
 	Value* Value::SetKey(std::string&& key, Value&& value) {
 		CHECK(is_dict());
-		return dict_
+		return dict_.GetForWrite()
 			.insert_or_assign(std::move(key),
 				std::make_unique<Value>(std::move(value)))
 			.first->second.get();
@@ -492,6 +496,18 @@ namespace base {
 		return SetKeyInternal(key, std::make_unique<Value>(std::move(value)));
 	}
 
+	Value* Value::SetKey(const std::string& key, Value&& value) {
+		return SetKeyInternal(key, std::make_unique<Value>(std::move(value)));
+	}
+
+	Value* Value::SetKey(DictKey key, Value&& value) {
+		CHECK(is_dict());
+		return dict_.GetForWrite()
+			.insert_or_assign(std::move(key),
+				std::make_unique<Value>(std::move(value)))
+			.first->second.get();
+	}
+
 	Value* Value::SetBoolKey(std::string_view key, bool value) {
 		return SetKeyInternal(key, std::make_unique<Value>(value));
 	}
@@ -522,17 +538,18 @@ namespace base {
 
 	bool Value::RemoveKey(std::string_view key) {
 		CHECK(is_dict());
-		return dict_.erase(key) != 0;
+		return dict_.GetForWrite().erase(key) != 0;
 	}
 
 	std::optional<Value> Value::ExtractKey(std::string_view key) {
 		CHECK(is_dict());
-		const auto found = dict_.find(key);
-		if (found == dict_.end())
+		DictStorage& dict = dict_.GetForWrite();
+		const auto found = dict.find(key);
+		if (found == dict.end())
 			return std::nullopt;
 
 		auto value = std::move(*found->second);
-		dict_.erase(found);
+		dict.erase(found);
 		return std::move(value);
 	}
 
@@ -592,19 +609,19 @@ namespace base {
 		const Value* cur = FindPath(path);
 		if (!cur || !cur->is_string())
 			return nullptr;
-		return &cur->string_value_;
+		return &*cur->string_value_;
 	}
 
 	std::string* Value::FindStringPath(std::string_view path) {
-		return const_cast<std::string*>(
-			static_cast<const Value*>(this)->FindStringPath(path));
+		Value* cur = FindPathOfType(path, Type::STRING);
+		return cur ? &cur->string_value_.GetForWrite() : nullptr;
 	}
 
 	const Value::BlobStorage* Value::FindBlobPath(std::string_view path) const {
 		const Value* cur = FindPath(path);
 		if (!cur || !cur->is_blob())
 			return nullptr;
-		return &cur->binary_value_;
+		return &*cur->binary_value_;
 	}
 
 	const Value* Value::FindDictPath(std::string_view path) const {
@@ -670,13 +687,14 @@ namespace base {
 		if (pos == std::string_view::npos)
 			return ExtractKey(path);
 
-		auto found = dict_.find(path.substr(0, pos));
-		if (found == dict_.end() || !found->second->is_dict())
+		DictStorage& dict = dict_.GetForWrite();
+		auto found = dict.find(path.substr(0, pos));
+		if (found == dict.end() || !found->second->is_dict())
 			return std::nullopt;
 
 		auto extracted = found->second->ExtractPath(path.substr(pos + 1));
-		if (extracted && found->second->dict_.empty())
-			dict_.erase(found);
+		if (extracted && found->second->dict_->empty())
+			dict.erase(found);
 
 		return extracted;
 	}
@@ -747,10 +765,11 @@ namespace base {
 
 			// Use lower_bound to avoid doing the search twice for missing keys.
 			const auto path_component = *cur_path;
-			auto found = cur->dict_.lower_bound(path_component);
-			if (found == cur->dict_.end() || found->first != path_component) {
+			DictStorage& dict = cur->dict_.GetForWrite();
+			auto found = dict.lower_bound(path_component);
+			if (found == dict.end() || found->first != path_component) {
 				// No key found, insert one.
-				const auto inserted = cur->dict_.try_emplace(
+				const auto inserted = dict.try_emplace(
 					found, path_component, std::make_unique<Value>(Type::DICTIONARY));
 				cur = inserted->second.get();
 			} else {
@@ -776,47 +795,49 @@ namespace base {
 		if (path.size() == 1)
 			return RemoveKey(path[0]);
 
-		auto found = dict_.find(path[0]);
-		if (found == dict_.end() || !found->second->is_dict())
+		DictStorage& dict = dict_.GetForWrite();
+		auto found = dict.find(path[0]);
+		if (found == dict.end() || !found->second->is_dict())
 			return false;
 
 		const auto removed = found->second->RemovePath(path.subspan(1));
-		if (removed && found->second->dict_.empty())
-			dict_.erase(found);
+		if (removed && found->second->dict_->empty())
+			dict.erase(found);
 
 		return removed;
 	}
 
 	Value::dict_iterator_proxy Value::DictItems() {
 		CHECK(is_dict());
-		return dict_iterator_proxy(&dict_);
+		return dict_iterator_proxy(&dict_.GetForWrite());
 	}
 
 	Value::const_dict_iterator_proxy Value::DictItems() const {
 		CHECK(is_dict());
-		return const_dict_iterator_proxy(&dict_);
+		return const_dict_iterator_proxy(&*dict_);
 	}
 
 	size_t Value::DictSize() const {
 		CHECK(is_dict());
-		return dict_.size();
+		return dict_->size();
 	}
 
 	bool Value::DictEmpty() const {
 		CHECK(is_dict());
-		return dict_.empty();
+		return dict_->empty();
 	}
 
 	void Value::MergeDictionary(const Value* dictionary) {
 		CHECK(is_dict());
 		CHECK(dictionary->is_dict());
-		for (const auto& pair : dictionary->dict_) {
+		for (const auto& pair : *dictionary->dict_) {
 			const auto& key = pair.first;
 			const auto& val = pair.second;
 			// Check whether we have to merge dictionaries.
 			if (val->is_dict()) {
-				auto found = dict_.find(key);
-				if (found != dict_.end() && found->second->is_dict()) {
+				DictStorage& dict = dict_.GetForWrite();
+				auto found = dict.find(key);
+				if (found != dict.end() && found->second->is_dict()) {
 					found->second->MergeDictionary(val.get());
 					continue;
 				}
@@ -858,7 +879,7 @@ namespace base {
 
 	bool Value::GetAsString(std::string* out_value) const {
 		if (out_value && is_string()) {
-			*out_value = string_value_;
+			*out_value = *string_value_;
 			return true;
 		}
 		return is_string();
@@ -866,7 +887,7 @@ namespace base {
 
 	bool Value::GetAsString(std::wstring* out_value) const {
 		if (out_value && is_string()) {
-			*out_value = UTF8ToWide(string_value_);
+			*out_value = UTF8ToWide(*string_value_);
 			return true;
 		}
 		return is_string();
@@ -882,7 +903,7 @@ namespace base {
 
 	bool Value::GetAsString(std::string_view* out_value) const {
 		if (out_value && is_string()) {
-			*out_value = string_value_;
+			*out_value = *string_value_;
 			return true;
 		}
 		return is_string();
@@ -942,22 +963,22 @@ namespace base {
 		case Value::Type::DOUBLE:
 			return lhs.AsDoubleInternal() == rhs.AsDoubleInternal();
 		case Value::Type::STRING:
-			return lhs.string_value_ == rhs.string_value_;
+			return *lhs.string_value_ == *rhs.string_value_;
 		case Value::Type::BINARY:
-			return lhs.binary_value_ == rhs.binary_value_;
+			return *lhs.binary_value_ == *rhs.binary_value_;
 			// TODO(crbug.com/646113): Clean this up when DictionaryValue and ListValue
 			// are completely inlined.
 		case Value::Type::DICTIONARY:
-			if (lhs.dict_.size() != rhs.dict_.size())
+			if (lhs.dict_->size() != rhs.dict_->size())
 				return false;
-			return std::equal(std::begin(lhs.dict_), std::end(lhs.dict_),
-				std::begin(rhs.dict_),
+			return std::equal(std::begin(*lhs.dict_), std::end(*lhs.dict_),
+				std::begin(*rhs.dict_),
 				[](const auto& u, const auto& v) {
 				return std::tie(u.first, *u.second) ==
 					std::tie(v.first, *v.second);
 			});
 		case Value::Type::LIST:
-			return lhs.list_ == rhs.list_;
+			return *lhs.list_ == *rhs.list_;
 			// TODO(crbug.com/859477): Remove after root cause is found.
 		case Value::Type::DEAD:
 			CHECK(false);
@@ -987,21 +1008,21 @@ namespace base {
 		case Value::Type::DOUBLE:
 			return lhs.AsDoubleInternal() < rhs.AsDoubleInternal();
 		case Value::Type::STRING:
-			return lhs.string_value_ < rhs.string_value_;
+			return *lhs.string_value_ < *rhs.string_value_;
 		case Value::Type::BINARY:
-			return lhs.binary_value_ < rhs.binary_value_;
+			return *lhs.binary_value_ < *rhs.binary_value_;
 			// TODO(crbug.com/646113): Clean this up when DictionaryValue and ListValue
 			// are completely inlined.
 		case Value::Type::DICTIONARY:
 			return std::lexicographical_compare(
-				std::begin(lhs.dict_), std::end(lhs.dict_), std::begin(rhs.dict_),
-				std::end(rhs.dict_),
+				std::begin(*lhs.dict_), std::end(*lhs.dict_), std::begin(*rhs.dict_),
+				std::end(*rhs.dict_),
 				[](const Value::DictStorage::value_type& u,
 					const Value::DictStorage::value_type& v) {
 				return std::tie(u.first, *u.second) < std::tie(v.first, *v.second);
 			});
 		case Value::Type::LIST:
-			return lhs.list_ < rhs.list_;
+			return *lhs.list_ < *rhs.list_;
 			// TODO(crbug.com/859477): Remove after root cause is found.
 		case Value::Type::DEAD:
 			CHECK(false);
@@ -1033,13 +1054,19 @@ namespace base {
 	size_t Value::EstimateMemoryUsage() const {
 		switch (type_) {
 		case Type::STRING:
-			return trace_event::EstimateMemoryUsage(string_value_);
+			if (!string_value_.allocated())
+				return 0;
+			return sizeof(std::string) +
+				trace_event::EstimateMemoryUsage(*string_value_);
 		case Type::BINARY:
-			return trace_event::EstimateMemoryUsage(binary_value_);
+			if (!binary_value_.allocated())
+				return 0;
+			return sizeof(BlobStorage) +
+				trace_event::EstimateMemoryUsage(*binary_value_);
 		case Type::DICTIONARY:
-			return trace_event::EstimateMemoryUsage(dict_);
+			return trace_event::EstimateMemoryUsage(*dict_);
 		case Type::LIST:
-			return trace_event::EstimateMemoryUsage(list_);
+			return trace_event::EstimateMemoryUsage(*list_);
 		default:
 			return 0;
 		}
@@ -1061,16 +1088,16 @@ namespace base {
 			double_value_ = that.double_value_;
 			return;
 		case Type::STRING:
-			new (&string_value_) std::string(std::move(that.string_value_));
+			new (&string_value_) HeapStringStorage(std::move(that.string_value_));
 			return;
 		case Type::BINARY:
-			new (&binary_value_) BlobStorage(std::move(that.binary_value_));
+			new (&binary_value_) HeapBlobStorage(std::move(that.binary_value_));
 			return;
 		case Type::DICTIONARY:
-			new (&dict_) DictStorage(std::move(that.dict_));
+			new (&dict_) HeapDictStorage(std::move(that.dict_));
 			return;
 		case Type::LIST:
-			new (&list_) ListStorage(std::move(that.list_));
+			new (&list_) HeapListStorage(std::move(that.list_));
 			return;
 			// TODO(crbug.com/859477): Remove after root cause is found.
 		case Type::DEAD:
@@ -1092,16 +1119,16 @@ namespace base {
 			return;
 
 		case Type::STRING:
-			string_value_.~basic_string();
+			string_value_.~HeapStringStorage();
 			return;
 		case Type::BINARY:
-			binary_value_.~BlobStorage();
+			binary_value_.~HeapBlobStorage();
 			return;
 		case Type::DICTIONARY:
-			dict_.~DictStorage();
+			dict_.~HeapDictStorage();
 			return;
 		case Type::LIST:
-			list_.~ListStorage();
+			list_.~HeapListStorage();
 			return;
 			// TODO(crbug.com/859477): Remove after root cause is found.
 		case Type::DEAD:
@@ -1118,7 +1145,7 @@ namespace base {
 		CHECK(is_dict());
 		// NOTE: We can't use |insert_or_assign| here, as only |try_emplace| does
 		// an explicit conversion from std::string_view to std::string if necessary.
-		auto result = dict_.try_emplace(key, std::move(val_ptr));
+		auto result = dict_.GetForWrite().try_emplace(key, std::move(val_ptr));
 		if (!result.second) {
 			// val_ptr is guaranteed to be still intact at this point.
 			result.first->second = std::move(val_ptr);
@@ -1139,10 +1166,11 @@ namespace base {
 				return nullptr;
 
 			// Use lower_bound to avoid doing the search twice for missing keys.
-			auto found = cur->dict_.lower_bound(path_component);
-			if (found == cur->dict_.end() || found->first != path_component) {
+			DictStorage& dict = cur->dict_.GetForWrite();
+			auto found = dict.lower_bound(path_component);
+			if (found == dict.end() || found->first != path_component) {
 				// No key found, insert one.
-				const auto inserted = cur->dict_.try_emplace(
+				const auto inserted = dict.try_emplace(
 					found, path_component, std::make_unique<Value>(Type::DICTIONARY));
 				cur = inserted->second.get();
 			} else {
@@ -1178,13 +1206,13 @@ namespace base {
 
 	bool DictionaryValue::HasKey(std::string_view key) const {
 		DCHECK(IsStringUTF8(key));
-		const auto current_entry = dict_.find(key);
-		DCHECK((current_entry == dict_.end()) || current_entry->second);
-		return current_entry != dict_.end();
+		const auto current_entry = dict_->find(key);
+		DCHECK((current_entry == dict_->end()) || current_entry->second);
+		return current_entry != dict_->end();
 	}
 
 	void DictionaryValue::Clear() {
-		dict_.clear();
+		dict_ = HeapDictStorage();
 	}
 
 	Value* DictionaryValue::Set(std::string_view path, std::unique_ptr<Value> in_value) {
@@ -1253,7 +1281,7 @@ namespace base {
 		std::unique_ptr<Value> in_value) {
 		// NOTE: We can't use |insert_or_assign| here, as only |try_emplace| does
 		// an explicit conversion from std::string_view to std::string if necessary.
-		auto result = dict_.try_emplace(key, std::move(in_value));
+		auto result = dict_.GetForWrite().try_emplace(key, std::move(in_value));
 		if (!result.second) {
 			// in_value is guaranteed to be still intact at this point.
 			result.first->second = std::move(in_value);
@@ -1394,8 +1422,8 @@ namespace base {
 	bool DictionaryValue::GetWithoutPathExpansion(std::string_view key,
 												  const Value** out_value) const {
 		DCHECK(IsStringUTF8(key));
-		const auto entry_iterator = dict_.find(key);
-		if (entry_iterator == dict_.end())
+		const auto entry_iterator = dict_->find(key);
+		if (entry_iterator == dict_->end())
 			return false;
 
 		if (out_value)
@@ -1523,13 +1551,14 @@ namespace base {
 			std::string_view key,
 			std::unique_ptr<Value>* out_value) {
 		DCHECK(IsStringUTF8(key));
-		auto entry_iterator = dict_.find(key);
-		if (entry_iterator == dict_.end())
+		DictStorage& dict = dict_.GetForWrite();
+		auto entry_iterator = dict.find(key);
+		if (entry_iterator == dict.end())
 			return false;
 
 		if (out_value)
 			* out_value = std::move(entry_iterator->second);
-		dict_.erase(entry_iterator);
+		dict.erase(entry_iterator);
 		return true;
 	}
 
@@ -1563,11 +1592,11 @@ namespace base {
 
 	void DictionaryValue::Swap(DictionaryValue* other) {
 		CHECK(other->is_dict());
-		dict_.swap(other->dict_);
+		std::swap(dict_, other->dict_);
 	}
 
 	DictionaryValue::Iterator::Iterator(const DictionaryValue& target)
-		: target_(target), it_(target.dict_.begin()) {
+		: target_(target), it_(target.dict_->begin()) {
 	}
 
 	DictionaryValue::Iterator::Iterator(const Iterator& other) = default;
@@ -1575,11 +1604,11 @@ namespace base {
 	DictionaryValue::Iterator::~Iterator() = default;
 
 	DictionaryValue* DictionaryValue::DeepCopy() const {
-		return new DictionaryValue(dict_);
+		return new DictionaryValue(*dict_);
 	}
 
 	std::unique_ptr<DictionaryValue> DictionaryValue::CreateDeepCopy() const {
-		return std::make_unique<DictionaryValue>(dict_);
+		return std::make_unique<DictionaryValue>(*dict_);
 	}
 
 	///////////////////// ListValue ////////////////////
@@ -1601,30 +1630,31 @@ namespace base {
 	}
 
 	void ListValue::Clear() {
-		list_.clear();
+		list_ = HeapListStorage();
 	}
 
 	void ListValue::Reserve(size_t n) {
-		list_.reserve(n);
+		list_.GetForWrite().reserve(n);
 	}
 
 	bool ListValue::Set(size_t index, std::unique_ptr<Value> in_value) {
 		if (!in_value)
 			return false;
 
-		if (index >= list_.size())
-			list_.resize(index + 1);
+		ListStorage& list = list_.GetForWrite();
+		if (index >= list.size())
+			list.resize(index + 1);
 
-		list_[index] = std::move(*in_value);
+		list[index] = std::move(*in_value);
 		return true;
 	}
 
 	bool ListValue::Get(size_t index, const Value** out_value) const {
-		if (index >= list_.size())
+		if (index >= list_->size())
 			return false;
 
 		if (out_value)
-			*out_value = &list_[index];
+			*out_value = &(*list_)[index];
 
 		return true;
 	}
@@ -1713,26 +1743,28 @@ namespace base {
 	}
 
 	bool ListValue::Remove(size_t index, std::unique_ptr<Value>* out_value) {
-		if (index >= list_.size())
+		ListStorage& list = list_.GetForWrite();
+		if (index >= list.size())
 			return false;
 
 		if (out_value)
-			*out_value = std::make_unique<Value>(std::move(list_[index]));
+			*out_value = std::make_unique<Value>(std::move(list[index]));
 
-		list_.erase(list_.begin() + index);
+		list.erase(list.begin() + index);
 		return true;
 	}
 
 	bool ListValue::Remove(const Value& value, size_t* index) {
-		const auto it = std::find(list_.begin(), list_.end(), value);
+		ListStorage& list = list_.GetForWrite();
+		const auto it = std::find(list.begin(), list.end(), value);
 
-		if (it == list_.end())
+		if (it == list.end())
 			return false;
 
 		if (index)
-			*index = std::distance(list_.begin(), it);
+			*index = std::distance(list.begin(), it);
 
-		list_.erase(it);
+		list.erase(it);
 		return true;
 	}
 
@@ -1741,78 +1773,81 @@ namespace base {
 		if (out_value)
 			*out_value = std::make_unique<Value>(std::move(*iter));
 
-		return list_.erase(iter);
+		return list_.GetForWrite().erase(iter);
 	}
 
 	void ListValue::Append(std::unique_ptr<Value> in_value) {
-		list_.push_back(std::move(*in_value));
+		list_.GetForWrite().push_back(std::move(*in_value));
 	}
 
 	void ListValue::AppendBoolean(bool in_value) {
-		list_.emplace_back(in_value);
+		list_.GetForWrite().emplace_back(in_value);
 	}
 
 	void ListValue::AppendInteger(int in_value) {
-		list_.emplace_back(in_value);
+		list_.GetForWrite().emplace_back(in_value);
 	}
 
 	void ListValue::AppendDouble(double in_value) {
-		list_.emplace_back(in_value);
+		list_.GetForWrite().emplace_back(in_value);
 	}
 
 	void ListValue::AppendString(std::string_view in_value) {
-		list_.emplace_back(in_value);
+		list_.GetForWrite().emplace_back(in_value);
 	}
 
 	void ListValue::AppendString(const std::wstring& in_value) {
-		list_.emplace_back(in_value);
+		list_.GetForWrite().emplace_back(in_value);
 	}
 
 	void ListValue::AppendStrings(const std::vector<std::string>& in_values) {
-		list_.reserve(list_.size() + in_values.size());
+		ListStorage& list = list_.GetForWrite();
+		list.reserve(list.size() + in_values.size());
 		for (const auto& in_value : in_values)
-			list_.emplace_back(in_value);
+			list.emplace_back(in_value);
 	}
 
 	void ListValue::AppendStrings(const std::vector<std::wstring>& in_values) {
-		list_.reserve(list_.size() + in_values.size());
+		ListStorage& list = list_.GetForWrite();
+		list.reserve(list.size() + in_values.size());
 		for (const auto& in_value : in_values)
-			list_.emplace_back(in_value);
+			list.emplace_back(in_value);
 	}
 
 	bool ListValue::AppendIfNotPresent(std::unique_ptr<Value> in_value) {
 		DCHECK(in_value);
-		if (Contains(list_, *in_value))
+		if (Contains(*list_, *in_value))
 			return false;
 
-		list_.push_back(std::move(*in_value));
+		list_.GetForWrite().push_back(std::move(*in_value));
 		return true;
 	}
 
 	bool ListValue::Insert(size_t index, std::unique_ptr<Value> in_value) {
 		DCHECK(in_value);
-		if (index > list_.size())
+		ListStorage& list = list_.GetForWrite();
+		if (index > list.size())
 			return false;
 
-		list_.insert(list_.begin() + index, std::move(*in_value));
+		list.insert(list.begin() + index, std::move(*in_value));
 		return true;
 	}
 
 	ListValue::const_iterator ListValue::Find(const Value& value) const {
-		return std::find(list_.begin(), list_.end(), value);
+		return std::find(list_->begin(), list_->end(), value);
 	}
 
 	void ListValue::Swap(ListValue* other) {
 		CHECK(other->is_list());
-		list_.swap(other->list_);
+		std::swap(list_, other->list_);
 	}
 
 	ListValue* ListValue::DeepCopy() const {
-		return new ListValue(list_);
+		return new ListValue(*list_);
 	}
 
 	std::unique_ptr<ListValue> ListValue::CreateDeepCopy() const {
-		return std::make_unique<ListValue>(list_);
+		return std::make_unique<ListValue>(*list_);
 	}
 
 	ValueSerializer::~ValueSerializer() = default;
@@ -32,7 +32,9 @@
 #include "base_export.h"
 #include "containers/flat_map.h"
 #include "containers/span.h"
+#include "dict_key.h"
 #include "macros.h"
+#include "no_destructor.h"
 #include "value_iterators.h"
 
 namespace base {
@@ -41,6 +43,46 @@ namespace base {
 	class ListValue;
 	class Value;
 
+	namespace internal {
+
+		// Holds the characters of a string Value, the bytes of a blob Value or
+		// the elements of a list or dictionary Value on the heap, so that they
+		// take a single pointer inside the Value. Empty contents need no
+		// allocation, which also leaves moved-from Values empty rather than
+		// null.
+		template <typename T>
+		class HeapValueStorage {
+		public:
+			HeapValueStorage() = default;
+			explicit HeapValueStorage(T&& contents)
+				: ptr_(contents.empty() ? nullptr
+							: std::make_unique<T>(std::move(contents))) {}
+			HeapValueStorage(HeapValueStorage&& other) noexcept = default;
+			HeapValueStorage& operator=(HeapValueStorage&& other) noexcept = default;
+			~HeapValueStorage() = default;
+
+			const T& operator*() const {
+				static const NoDestructor<T> empty;
+				return ptr_ ? *ptr_ : *empty;
+			}
+			const T* operator->() const { return &**this; }
+
+			// Whether the contents have their own allocation.
+			[[nodiscard]] bool allocated() const { return !!ptr_; }
+
+			// Returns the contents for modification.
+			T& GetForWrite() {
+				if (!ptr_)
+					ptr_ = std::make_unique<T>();
+				return *ptr_;
+			}
+
+		private:
+			std::unique_ptr<T> ptr_;
+		};
+
+	}  // namespace internal
+
 	// The Value class is the base class for Values. A Value can be instantiated
 	// via passing the appropriate type or backing storage to the constructor.
 	//
@@ -77,7 +119,7 @@ namespace base {
 	class BASE_EXPORT Value {
 	public:
 		using BlobStorage = std::vector<uint8_t>;
-		using DictStorage = flat_map<std::string, std::unique_ptr<Value>>;
+		using DictStorage = flat_map<DictKey, std::unique_ptr<Value>>;
 		using ListStorage = std::vector<Value>;
 		// See technical note below explaining why this is used.
 		using DoubleStorage = struct { alignas(4) char v[sizeof(double)]; };
@@ -248,6 +290,12 @@ namespace base {
 		Value* SetKey(std::string&& key, Value&& value);
 		// This overload is necessary to avoid ambiguity for const char* arguments.
 		Value* SetKey(const char* key, Value&& value);
+		// This overload is necessary to avoid ambiguity for std::string lvalues,
+		// which convert to both std::string_view and DictKey.
+		Value* SetKey(const std::string& key, Value&& value);
+		// This overload shares the storage of |key|, which is typically interned
+		// by a DictKeyTable.
+		Value* SetKey(DictKey key, Value&& value);
 
 		// |Set<Type>Key| looks up |key| in the underlying dictionary and associates
 		// a corresponding Value() constructed from the second parameter. Compared
@@ -482,6 +530,11 @@ namespace base {
 		[[nodiscard]] size_t EstimateMemoryUsage() const;
 
 	protected:
+		using HeapDictStorage = internal::HeapValueStorage<DictStorage>;
+		using HeapListStorage = internal::HeapValueStorage<ListStorage>;
+		using HeapStringStorage = internal::HeapValueStorage<std::string>;
+		using HeapBlobStorage = internal::HeapValueStorage<BlobStorage>;
+
 		// Special case for doubles, which are aligned to 8 bytes on some
 		// 32-bit architectures. In this case, a simple declaration as a
 		// double member would make the whole union 8 byte-aligned, which
@@ -490,16 +543,21 @@ namespace base {
 		//
 		// To override this, store the value as an array of 32-bit integers, and
 		// perform the appropriate bit casts when reading / writing to it.
+		//
+		// Strings, blobs, lists and dictionaries are kept behind a pointer, so
+		// that no member of the union is larger than a double or a pointer.
+		// Scalars are stored inline, and a Value takes 16 bytes on 64-bit
+		// platforms, which matters most for the elements of large lists.
 		Type type_ = Type::NONE;
 
 		union {
 			bool bool_value_;
 			int int_value_;
 			DoubleStorage double_value_{};
-			std::string string_value_;
-			BlobStorage binary_value_;
-			DictStorage dict_;
-			ListStorage list_;
+			HeapStringStorage string_value_;
+			HeapBlobStorage binary_value_;
+			HeapDictStorage dict_;
+			HeapListStorage list_;
 		};
 
 	private:
@@ -536,10 +594,10 @@ namespace base {
 		[[nodiscard]] bool HasKey(std::string_view key) const;
 
 		// Returns the number of Values in this dictionary.
-		[[nodiscard]] size_t size() const { return dict_.size(); }
+		[[nodiscard]] size_t size() const { return dict_->size(); }
 
 		// Returns whether the dictionary is empty.
-		[[nodiscard]] bool empty() const { return dict_.empty(); }
+		[[nodiscard]] bool empty() const { return dict_->empty(); }
 
 		// Clears any current contents of this dictionary.
 		void Clear();
@@ -695,7 +753,7 @@ namespace base {
 			Iterator(const Iterator& other);
 			~Iterator();
 
-			[[nodiscard]] bool IsAtEnd() const { return it_ == target_.dict_.end(); }
+			[[nodiscard]] bool IsAtEnd() const { return it_ == target_.dict_->end(); }
 			void Advance() { ++it_; }
 
 			[[nodiscard]] const std::string& key() const { return it_->first; }
@@ -708,12 +766,12 @@ namespace base {
 
 		// Iteration.
 		// DEPRECATED, use Value::DictItems() instead.
-		iterator begin() { return dict_.begin(); }
-		iterator end() { return dict_.end(); }
+		iterator begin() { return dict_.GetForWrite().begin(); }
+		iterator end() { return dict_.GetForWrite().end(); }
 
 		// DEPRECATED, use Value::DictItems() instead.
-		[[nodiscard]] const_iterator begin() const { return dict_.begin(); }
-		[[nodiscard]] const_iterator end() const { return dict_.end(); }
+		[[nodiscard]] const_iterator begin() const { return dict_->begin(); }
+		[[nodiscard]] const_iterator end() const { return dict_->end(); }
 
 		// DEPRECATED, use Value::Clone() instead.
 		// TODO(crbug.com/646113): Delete this and migrate callsites.
@@ -742,11 +800,11 @@ namespace base {
 
 		// Returns the number of Values in this list.
 		// DEPRECATED, use GetList()::size() instead.
-		[[nodiscard]] size_t GetSize() const { return list_.size(); }
+		[[nodiscard]] size_t GetSize() const { return list_->size(); }
 
 		// Returns whether the list is empty.
 		// DEPRECATED, use GetList()::empty() instead.
-		[[nodiscard]] bool empty() const { return list_.empty(); }
+		[[nodiscard]] bool empty() const { return list_->empty(); }
 
 		// Reserves storage for at least |n| values.
 		// DEPRECATED, use GetList()::reserve() instead.
@@ -851,14 +909,14 @@ namespace base {
 
 		// Iteration.
 		// DEPRECATED, use GetList()::begin() instead.
-		iterator begin() { return list_.begin(); }
+		iterator begin() { return list_.GetForWrite().begin(); }
 		// DEPRECATED, use GetList()::end() instead.
-		iterator end() { return list_.end(); }
+		iterator end() { return list_.GetForWrite().end(); }
 
 		// DEPRECATED, use GetList()::begin() instead.
-		[[nodiscard]] const_iterator begin() const { return list_.begin(); }
+		[[nodiscard]] const_iterator begin() const { return list_->begin(); }
 		// DEPRECATED, use GetList()::end() instead.
-		[[nodiscard]] const_iterator end() const { return list_.end(); }
+		[[nodiscard]] const_iterator end() const { return list_->end(); }
 
 		// DEPRECATED, use Value::Clone() instead.
 		// TODO(crbug.com/646113): Delete this and migrate callsites.
@@ -6,11 +6,13 @@
 
 #include <stddef.h>
 
+#include <atomic>
 #include <ostream>
 #include <utility>
 
 #include "logging.h"
 #include "stl_util.h"
+#include "strings/pattern.h"
 #include "strings/string_number_conversions.h"
 #include "strings/string_split.h"
 
@@ -23,15 +25,14 @@ namespace logging {
 
 		explicit VmodulePattern(const std::string& pattern);
 
-		VmodulePattern();
-
-		std::string pattern;
+		base::CompiledPattern pattern;
 		int vlog_level;
 		MatchTarget match_target;
 	};
 
 	VlogInfo::VmodulePattern::VmodulePattern(const std::string& pattern)
-		: pattern(pattern), vlog_level(VlogInfo::kDefaultVlogLevel), match_target(MATCH_MODULE) {
+		: pattern(pattern, base::CompiledPattern::Syntax::kFilePath),
+		vlog_level(VlogInfo::kDefaultVlogLevel), match_target(MATCH_MODULE) {
 		// If the pattern contains a {forward,back} slash, we assume that
 		// it's meant to be tested against the entire __FILE__ string.
 		std::string::size_type first_slash = pattern.find_first_of("\\/");
@@ -39,11 +40,54 @@ namespace logging {
 			match_target = MATCH_FILE;
 	}
 
-	VlogInfo::VmodulePattern::VmodulePattern() : vlog_level(VlogInfo::kDefaultVlogLevel),
-		match_target(MATCH_MODULE) {
-	}
+	// A fixed-size, lock-free hash table from file name pointers to pattern
+	// indices. Slots are claimed once and never change owner, so a reader that
+	// finds its pointer can trust the index once it is published; if the
+	// table is full the caller just matches the patterns again.
+	class VlogInfo::CallSiteCache {
+	public:
+		// Returns the cached result for |file|, or runs |find| and tries to
+		// cache what it returns.
+		template <typename Find>
+		int Get(const char* file, Find find) {
+			// Fibonacci hashing of the pointer, which is at least 8-aligned in
+			// practice.
+			const uint32_t hash =
+				static_cast<uint32_t>(reinterpret_cast<uintptr_t>(file) >> 3) *
+				0x9E3779B9u >> (32 - kSlotBits);
+			for (size_t probe = 0; probe < kMaxProbes; ++probe) {
+				Slot& slot = slots_[(hash + probe) % kSlots];
+				const char* owner = slot.file.load(std::memory_order_acquire);
+				if (!owner && slot.file.compare_exchange_strong(owner, file,
+					std::memory_order_acq_rel)) {
+					const int result = find();
+					slot.pattern.store(result, std::memory_order_release);
+					return result;
+				}
+				if (owner == file) {
+					const int result = slot.pattern.load(std::memory_order_acquire);
+					// The slot's owner may not have published yet.
+					return result == kPending ? find() : result;
+				}
+			}
+			return find();
+		}
 
-	VlogInfo::VlogInfo(const std::string& v_switch, const std::string& vmodule_switch, int* min_log_level) : min_log_level_(min_log_level) {
+	private:
+		static constexpr int kSlotBits = 10;
+		static constexpr size_t kSlots = size_t{ 1 } << kSlotBits;
+		static constexpr size_t kMaxProbes = 8;
+		static constexpr int kPending = -2;
+
+		struct Slot {
+			std::atomic<const char*> file{ nullptr };
+			std::atomic<int> pattern{ kPending };
+		};
+		Slot slots_[kSlots];
+	};
+
+	VlogInfo::VlogInfo(const std::string& v_switch, const std::string& vmodule_switch, int* min_log_level)
+		: min_log_level_(min_log_level), call_site_cache_(std::make_unique<CallSiteCache>()) {
 		DCHECK_NE(min_log_level, nullptr);
 
 		int vlog_level = 0;
@@ -79,35 +123,47 @@ namespace logging {
 		// Given a path, returns the basename with the extension chopped off
 		// (and any -inl suffix).  We avoid using FilePath to minimize the
 		// number of dependencies the logging system has.
-		std::string GetModule(const std::string& file) {
-			std::string module(file);
-			std::string::size_type last_slash_pos = module.find_last_of("\\/");
-			if (last_slash_pos != std::string::npos)
-				//module.remove_prefix(last_slash_pos + 1);
-				module.erase(0, last_slash_pos + 1);
-			std::string::size_type extension_start = module.rfind('.');
+		std::string_view GetModule(std::string_view file) {
+			std::string_view module(file);
+			std::string_view::size_type last_slash_pos = module.find_last_of("\\/");
+			if (last_slash_pos != std::string_view::npos)
+				module.remove_prefix(last_slash_pos + 1);
+			std::string_view::size_type extension_start = module.rfind('.');
 			module = module.substr(0, extension_start);
 			static const char kInlSuffix[] = "-inl";
-			static const int kInlSuffixLen = base::size(kInlSuffix) - 1;
-			if (module.substr(module.size() - kInlSuffixLen) == kInlSuffix)
-				//if (module.ends_with(kInlSuffix))
-					//module.remove_suffix(kInlSuffixLen);
-				module.erase(module.size() - kInlSuffixLen);
+			static const size_t kInlSuffixLen = base::size(kInlSuffix) - 1;
+			if (module.size() >= kInlSuffixLen &&
+				module.substr(module.size() - kInlSuffixLen) == kInlSuffix)
+				module.remove_suffix(kInlSuffixLen);
 			return module;
 		}
 
 	}  // namespace
 
-	int VlogInfo::GetVlogLevel(const std::string& file) const {
-		if (!vmodule_levels_.empty()) {
-			std::string module(GetModule(file));
-			for (const auto& it : vmodule_levels_) {
-				std::string target((it.match_target == VmodulePattern::MATCH_FILE) ? file : module);
-				if (MatchVlogPattern(target, it.pattern))
-					return it.vlog_level;
-			}
+	int VlogInfo::GetVlogLevel(std::string_view file) const {
+		const int pattern = FindVmodulePattern(file);
+		return pattern < 0 ? GetMaxVlogLevel() : vmodule_levels_[pattern].vlog_level;
+	}
+
+	int VlogInfo::GetVlogLevelForStaticFile(const char* file, size_t length) const {
+		if (vmodule_levels_.empty())
+			return GetMaxVlogLevel();
+		const int pattern = call_site_cache_->Get(file, [this, file, length] {
+			return FindVmodulePattern(std::string_view(file, length));
+		});
+		return pattern < 0 ? GetMaxVlogLevel() : vmodule_levels_[pattern].vlog_level;
+	}
+
+	int VlogInfo::FindVmodulePattern(std::string_view file) const {
+		if (vmodule_levels_.empty())
+			return -1;
+		const std::string_view module = GetModule(file);
+		for (size_t i = 0; i < vmodule_levels_.size(); ++i) {
+			const VmodulePattern& it = vmodule_levels_[i];
+			if (it.pattern.Match(it.match_target == VmodulePattern::MATCH_FILE ? file : module))
+				return static_cast<int>(i);
 		}
-		return GetMaxVlogLevel();
+		return -1;
 	}
 
 	void VlogInfo::SetMaxVlogLevel(int level) {
@@ -120,57 +176,7 @@ namespace logging {
 	}
 
 	bool MatchVlogPattern(const std::string& string, const std::string& vlog_pattern) {
-		std::string p(vlog_pattern);
-		std::string s(string);
-		// Consume characters until the next star.
-		while (!p.empty() && !s.empty() && (p[0] != '*')) {
-			switch (p[0]) {
-				// A slash (forward or back) must match a slash (forward or back).
-			case '/':
-			case '\\':
-				if ((s[0] != '/') && (s[0] != '\\'))
-					return false;
-				break;
-
-				// A '?' matches anything.
-			case '?':
-				break;
-
-				// Anything else must match literally.
-			default:
-				if (p[0] != s[0])
-					return false;
-				break;
-			}
-			//p.remove_prefix(1), s.remove_prefix(1);
-			p.erase(0, 1), s.erase(0, 1);
-		}
-
-		// An empty pattern here matches only an empty string.
-		if (p.empty())
-			return s.empty();
-
-		// Coalesce runs of consecutive stars.  There should be at least
-		// one.
-		while (!p.empty() && (p[0] == '*'))
-			//p.remove_prefix(1);
-			p.erase(0, 1);
-
-		// Since we moved past the stars, an empty pattern here matches
-		// anything.
-		if (p.empty())
-			return true;
-
-		// Since we moved past the stars and p is non-empty, if some
-		// non-empty substring of s matches p, then we ourselves match.
-		while (!s.empty()) {
-			if (MatchVlogPattern(s, p))
-				return true;
-			//s.remove_prefix(1);
-			s.erase(0, 1);
-		}
-
-		// Otherwise, we couldn't find a match.
-		return false;
+		return base::CompiledPattern(vlog_pattern, base::CompiledPattern::Syntax::kFilePath)
+			.Match(string);
 	}
 } // namespace logging
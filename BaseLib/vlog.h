@@ -4,7 +4,9 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "base_export.h"
@@ -40,18 +42,32 @@ namespace logging {
 
 		// Returns the vlog level for a given file (usually taken from
 		// __FILE__).
-		int GetVlogLevel(const std::string& file) const;
+		int GetVlogLevel(std::string_view file) const;
+
+		// Same as GetVlogLevel(), for a |file| of |length| characters that stays
+		// valid and unchanged for the life of the process, like __FILE__. The
+		// matching vmodule pattern is remembered per |file| pointer, so each
+		// call site pays for the pattern matching once.
+		int GetVlogLevelForStaticFile(const char* file, size_t length) const;
 
 	private:
 		void SetMaxVlogLevel(int level);
 		int GetMaxVlogLevel() const;
 
+		// Returns the index of the first pattern in |vmodule_levels_| that
+		// matches |file|, or -1.
+		int FindVmodulePattern(std::string_view file) const;
+
 		// VmodulePattern holds all the information for each pattern parsed
 		// from |vmodule_switch|.
 		struct VmodulePattern;
 		std::vector<VmodulePattern> vmodule_levels_;
 		int* min_log_level_;
 
+		// Results of FindVmodulePattern() per static file name.
+		class CallSiteCache;
+		std::unique_ptr<CallSiteCache> call_site_cache_;
+
 		DISALLOW_COPY_AND_ASSIGN(VlogInfo);
 	};
 
@@ -0,0 +1,83 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "pch.h"
+#include "base64.h"
+
+#include <algorithm>
+#include <string>
+
+#include "test/perf_test.h"
+#include "timer/lap_timer.h"
+
+namespace base {
+
+	namespace {
+
+		constexpr int kWarmupRuns = 2;
+		constexpr int kTimeCheckInterval = 4;
+		constexpr TimeDelta kTimeLimit = TimeDelta::FromMilliseconds(500);
+		constexpr size_t kBlobSize = 4 * 1024 * 1024;
+		constexpr size_t kChunkSize = 64 * 1024;
+
+		std::string GenerateBlob() {
+			std::string blob(kBlobSize, '\0');
+			uint32_t state = 1;
+			for (auto& byte : blob) {
+				state = state * 1103515245 + 12345;
+				byte = static_cast<char>(state >> 24);
+			}
+			return blob;
+		}
+
+	}  // namespace
+
+	// Encodes and decodes a 4 MiB blob in one call, then a chunk at a time as
+	// it would be while read from a file.
+	TEST(Base64PerfTest, Blob) {
+		const std::string blob = GenerateBlob();
+		std::string encoded;
+
+		LapTimer encode_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			Base64Encode(blob, &encoded);
+			encode_timer.NextLap();
+		} while (!encode_timer.HasTimeLimitExpired());
+		perf_test::PrintResult("base64_blob", "_encode", "",
+			encode_timer.TimePerLap().InMillisecondsF(), "ms", true);
+
+		std::string decoded;
+		LapTimer decode_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			EXPECT_TRUE(Base64Decode(encoded, &decoded));
+			decode_timer.NextLap();
+		} while (!decode_timer.HasTimeLimitExpired());
+		perf_test::PrintResult("base64_blob", "_decode", "",
+			decode_timer.TimePerLap().InMillisecondsF(), "ms", true);
+		EXPECT_EQ(blob, decoded);
+
+		// Only one chunk of output is held at a time.
+		std::string chunk;
+		size_t streamed_size = 0;
+		LapTimer stream_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			Base64Encoder encoder;
+			streamed_size = 0;
+			for (size_t i = 0; i < blob.size(); i += kChunkSize) {
+				chunk.clear();
+				encoder.Update(as_bytes(make_span(blob)).subspan(
+					i, std::min(kChunkSize, blob.size() - i)), &chunk);
+				streamed_size += chunk.size();
+			}
+			chunk.clear();
+			encoder.Finish(&chunk);
+			streamed_size += chunk.size();
+			stream_timer.NextLap();
+		} while (!stream_timer.HasTimeLimitExpired());
+		perf_test::PrintResult("base64_blob", "_stream_encode", "",
+			stream_timer.TimePerLap().InMillisecondsF(), "ms", true);
+		EXPECT_EQ(encoded.size(), streamed_size);
+	}
+
+}  // namespace base
@@ -5,6 +5,9 @@
 #include "pch.h"
 #include "base64.h"
 
+#include <algorithm>
+#include <string>
+
 namespace base {
 
 	TEST(Base64Test, Basic) {
@@ -36,4 +39,182 @@ namespace base {
 		EXPECT_EQ(text, kText);
 	}
 
+	namespace {
+
+		// Bytes that exercise every symbol, long enough for the vector paths.
+		std::string MakeBytes(size_t size) {
+			std::string bytes(size, '\0');
+			uint32_t state = 12345;
+			for (auto& byte : bytes) {
+				state = state * 1103515245 + 12345;
+				byte = static_cast<char>(state >> 24);
+			}
+			return bytes;
+		}
+
+		// A straightforward encoder to check the vector paths against.
+		std::string ReferenceEncode(const std::string& bytes) {
+			static const char kSymbols[] =
+				"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+			std::string encoded;
+			for (size_t i = 0; i < bytes.size(); i += 3) {
+				uint32_t group = static_cast<uint8_t>(bytes[i]) << 16;
+				if (i + 1 < bytes.size())
+					group |= static_cast<uint8_t>(bytes[i + 1]) << 8;
+				if (i + 2 < bytes.size())
+					group |= static_cast<uint8_t>(bytes[i + 2]);
+				encoded += kSymbols[group >> 18];
+				encoded += kSymbols[(group >> 12) & 0x3f];
+				encoded += i + 1 < bytes.size() ? kSymbols[(group >> 6) & 0x3f] : '=';
+				encoded += i + 2 < bytes.size() ? kSymbols[group & 0x3f] : '=';
+			}
+			return encoded;
+		}
+
+	}  // namespace
+
+	TEST(Base64Test, RFC4648Vectors) {
+		const struct {
+			const char* text;
+			const char* encoded;
+		} kCases[] = {
+			{"", ""},
+			{"f", "Zg=="},
+			{"fo", "Zm8="},
+			{"foo", "Zm9v"},
+			{"foob", "Zm9vYg=="},
+			{"fooba", "Zm9vYmE="},
+			{"foobar", "Zm9vYmFy"},
+		};
+		for (const auto& test_case : kCases) {
+			std::string encoded;
+			Base64Encode(test_case.text, &encoded);
+			EXPECT_EQ(test_case.encoded, encoded);
+			std::string decoded;
+			EXPECT_TRUE(Base64Decode(test_case.encoded, &decoded));
+			EXPECT_EQ(test_case.text, decoded);
+		}
+	}
+
+	TEST(Base64Test, LongInputs) {
+		for (size_t size = 0; size < 200; ++size) {
+			const std::string bytes = MakeBytes(size);
+			std::string encoded;
+			Base64Encode(bytes, &encoded);
+			EXPECT_EQ(ReferenceEncode(bytes), encoded) << size;
+			std::string decoded;
+			EXPECT_TRUE(Base64Decode(encoded, &decoded)) << size;
+			EXPECT_EQ(bytes, decoded) << size;
+		}
+	}
+
+	TEST(Base64Test, DecodeRejectsInvalidCharacters) {
+		const std::string encoded = Base64Encode(as_bytes(make_span(MakeBytes(96))));
+		ASSERT_EQ(128u, encoded.size());
+		for (size_t i = 0; i < encoded.size(); ++i) {
+			for (const char c : {'-', '_', '=', ' ', '\0', '\x80', '\xff'}) {
+				// Padding is only valid at the end.
+				if (c == '=' && i == encoded.size() - 1)
+					continue;
+				std::string bad = encoded;
+				bad[i] = c;
+				std::string decoded = "unchanged";
+				EXPECT_FALSE(Base64Decode(bad, &decoded)) << i;
+				EXPECT_EQ("unchanged", decoded);
+			}
+		}
+	}
+
+	TEST(Base64Test, DecodePadding) {
+		std::string decoded;
+		// Up to two padding characters, at the end only.
+		EXPECT_TRUE(Base64Decode("QQ==", &decoded));
+		EXPECT_EQ("A", decoded);
+		EXPECT_TRUE(Base64Decode("QUI=", &decoded));
+		EXPECT_EQ("AB", decoded);
+		EXPECT_FALSE(Base64Decode("Q===", &decoded));
+		EXPECT_FALSE(Base64Decode("====", &decoded));
+		EXPECT_FALSE(Base64Decode("QQ==QUJD", &decoded));
+		EXPECT_FALSE(Base64Decode("Q=Q=", &decoded));
+		// The size must be a multiple of 4.
+		EXPECT_FALSE(Base64Decode("QQ", &decoded));
+		EXPECT_FALSE(Base64Decode("QUJDR", &decoded));
+		// The unused bits of the last symbol are not checked.
+		EXPECT_TRUE(Base64Decode("QR==", &decoded));
+		EXPECT_EQ("A", decoded);
+	}
+
+	TEST(Base64Test, Encoder) {
+		const std::string bytes = MakeBytes(1000);
+		const std::string expected = Base64Encode(as_bytes(make_span(bytes)));
+		for (size_t chunk_size = 1; chunk_size < 70; ++chunk_size) {
+			Base64Encoder encoder;
+			std::string encoded;
+			for (size_t i = 0; i < bytes.size(); i += chunk_size) {
+				encoder.Update(as_bytes(make_span(bytes)).subspan(
+					i, std::min(chunk_size, bytes.size() - i)), &encoded);
+			}
+			encoder.Finish(&encoded);
+			EXPECT_EQ(expected, encoded) << chunk_size;
+		}
+
+		// Finish() makes the encoder ready for a new stream.
+		Base64Encoder encoder;
+		std::string encoded;
+		encoder.Update(as_bytes(make_span("f", 1)), &encoded);
+		encoder.Finish(&encoded);
+		encoder.Finish(&encoded);
+		encoder.Update(as_bytes(make_span("foob", 4)), &encoded);
+		encoder.Finish(&encoded);
+		EXPECT_EQ("Zg==Zm9vYg==", encoded);
+	}
+
+	TEST(Base64Test, Decoder) {
+		const std::string bytes = MakeBytes(1000);
+		const std::string encoded = Base64Encode(as_bytes(make_span(bytes)));
+		for (size_t chunk_size = 1; chunk_size < 70; ++chunk_size) {
+			Base64Decoder decoder;
+			std::string decoded;
+			for (size_t i = 0; i < encoded.size(); i += chunk_size)
+				EXPECT_TRUE(decoder.Update(encoded.substr(i, chunk_size), &decoded));
+			EXPECT_TRUE(decoder.Finish(&decoded));
+			EXPECT_EQ(bytes, decoded) << chunk_size;
+		}
+	}
+
+	// The decoder accepts exactly what Base64Decode() accepts, whichever way
+	// the input is split.
+	TEST(Base64Test, DecoderMatchesBase64Decode) {
+		const char* const kInputs[] = {
+			"", "Zg==", "Zm8=", "Zm9vYmFy", "Zm9vYg==", "QR==", "Zg", "Zm9", "Zg=",
+			"Z===", "====", "Zg==Zg==", "Zg==Zm9v", "Zm=v", "Zm9v=", "Zm9vY", "Zm9v ",
+			"Zm9v-_==",
+		};
+		for (const std::string_view input : kInputs) {
+			std::string expected;
+			const bool expected_valid = Base64Decode(input, &expected);
+			for (size_t split = 0; split <= input.size(); ++split) {
+				Base64Decoder decoder;
+				std::string decoded;
+				bool valid = decoder.Update(input.substr(0, split), &decoded);
+				valid = decoder.Update(input.substr(split), &decoded) && valid;
+				valid = decoder.Finish(&decoded) && valid;
+				EXPECT_EQ(expected_valid, valid) << input << " " << split;
+				if (expected_valid)
+					EXPECT_EQ(expected, decoded) << input << " " << split;
+			}
+		}
+
+		// A failed stream does not affect the next one.
+		Base64Decoder decoder;
+		std::string decoded;
+		EXPECT_FALSE(decoder.Update("Zg==Zg==", &decoded));
+		EXPECT_FALSE(decoder.Update("Zg==", &decoded));
+		EXPECT_FALSE(decoder.Finish(&decoded));
+		decoded.clear();
+		EXPECT_TRUE(decoder.Update("Zm9v", &decoded));
+		EXPECT_TRUE(decoder.Finish(&decoded));
+		EXPECT_EQ("foo", decoded);
+	}
+
 }  // namespace base
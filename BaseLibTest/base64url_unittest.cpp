@@ -4,6 +4,11 @@
 
 #include "pch.h"
 #include "base64url.h"
+
+#include <algorithm>
+#include <string>
+
+#include "base64.h"
 #include "macros.h"
 
 namespace base {
@@ -95,6 +100,35 @@ namespace base {
 			ASSERT_FALSE(Base64UrlDecode("====", Base64UrlDecodePolicy::IGNORE_PADDING, &output));
 		}
 
+		TEST(Base64UrlTest, LongInputs) {
+			std::string bytes;
+			for (int i = 0; i < 300; ++i)
+				bytes += static_cast<char>(i * 7);
+			for (size_t size = 0; size <= bytes.size(); size += 7) {
+				const std::string input = bytes.substr(0, size);
+				std::string base64;
+				Base64Encode(input, &base64);
+				std::string expected = base64;
+				std::replace(expected.begin(), expected.end(), '+', '-');
+				std::replace(expected.begin(), expected.end(), '/', '_');
+
+				std::string output;
+				Base64UrlEncode(input, Base64UrlEncodePolicy::INCLUDE_PADDING, &output);
+				EXPECT_EQ(expected, output);
+				ASSERT_TRUE(Base64UrlDecode(output, Base64UrlDecodePolicy::REQUIRE_PADDING, &output));
+				EXPECT_EQ(input, output);
+
+				// The conventional alphabet is rejected anywhere in the input.
+				if (base64.find_first_of("+/") != std::string::npos)
+					EXPECT_FALSE(Base64UrlDecode(base64, Base64UrlDecodePolicy::REQUIRE_PADDING, &output));
+
+				Base64UrlEncode(input, Base64UrlEncodePolicy::OMIT_PADDING, &output);
+				EXPECT_EQ(expected.substr(0, expected.find('=')), output);
+				ASSERT_TRUE(Base64UrlDecode(output, Base64UrlDecodePolicy::DISALLOW_PADDING, &output));
+				EXPECT_EQ(input, output);
+			}
+		}
+
 	}  // namespace
 
 }  // namespace base
@@ -0,0 +1,122 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "pch.h"
+#include "dict_key.h"
+
+#include <string>
+
+#include "json/json_reader.h"
+#include "values.h"
+
+namespace base {
+
+	TEST(DictKeyTest, Compare) {
+		const DictKey empty;
+		EXPECT_TRUE(empty.empty());
+		EXPECT_EQ("", empty.str());
+		EXPECT_EQ(empty, DictKey(""));
+
+		const DictKey a("a");
+		const DictKey b(std::string("b"));
+		EXPECT_EQ("a", a.str());
+		EXPECT_TRUE(a < b);
+		EXPECT_FALSE(b < a);
+		EXPECT_FALSE(a < a);
+		EXPECT_NE(a, b);
+		EXPECT_EQ(a, DictKey("a"));
+		EXPECT_FALSE(a.SharesStorageWith(DictKey("a")));
+
+		EXPECT_TRUE(a == "a");
+		EXPECT_TRUE("b" == b);
+		EXPECT_TRUE(a != "ab");
+		EXPECT_TRUE(a < std::string_view("ab"));
+		EXPECT_TRUE(std::string_view("") < a);
+		// A view of the key's own characters.
+		const std::string_view prefix(a.str().data(), 0);
+		EXPECT_TRUE(prefix < a);
+		EXPECT_FALSE(a < prefix);
+		EXPECT_TRUE(a == std::string_view(a.str()));
+
+		EXPECT_TRUE(a == std::string("a"));
+		EXPECT_TRUE(std::string("a") < b);
+
+		const std::string& str = a;
+		EXPECT_EQ(&a.str(), &str);
+		// Only interned keys share their characters.
+		const DictKey copy = a;
+		EXPECT_EQ(a, copy);
+		EXPECT_FALSE(copy.SharesStorageWith(a));
+	}
+
+	TEST(DictKeyTest, Intern) {
+		auto table = MakeRefCounted<DictKeyTable>();
+		const DictKey id = table->Intern("id");
+		EXPECT_TRUE(id.SharesStorageWith(table->Intern(std::string("id"))));
+		EXPECT_FALSE(id.SharesStorageWith(table->Intern("name")));
+		EXPECT_EQ(2u, table->size());
+		EXPECT_TRUE(table->Intern("").empty());
+		const DictKey copy = id;
+		EXPECT_TRUE(copy.SharesStorageWith(id));
+
+		// Keys outlive the table.
+		table = nullptr;
+		EXPECT_EQ("id", id.str());
+	}
+
+	TEST(DictKeyTest, SetKey) {
+		auto table = MakeRefCounted<DictKeyTable>();
+		Value list(Value::Type::LIST);
+		for (int i = 0; i < 3; ++i) {
+			Value record(Value::Type::DICTIONARY);
+			record.SetKey(table->Intern("a long key that does not fit inline"),
+				Value(i));
+			record.SetKey(table->Intern("id"), Value(i));
+			// Setting an existing key by string keeps its storage.
+			record.SetKey("id", Value(i + 1));
+			list.Append(std::move(record));
+		}
+		EXPECT_EQ(2u, table->size());
+		EXPECT_EQ(2, *list.GetList()[1].FindIntKey("id"));
+
+		auto first = list.GetList()[0].DictItems().begin();
+		auto second = list.GetList()[1].DictItems().begin();
+		EXPECT_EQ(&(*first).first, &(*second).first);
+		EXPECT_EQ(Value(0), (*first).second);
+	}
+
+	TEST(DictKeyTest, JSONInternKeys) {
+		const std::string json = R"([{"id": 1, "nested": {"id": 2}},
+			{"id": 3, "nested": {"id": 4}}])";
+		const std::optional<Value> interned =
+			JSONReader::Read(json, JSON_INTERN_KEYS);
+		const std::optional<Value> plain = JSONReader::Read(json);
+		ASSERT_TRUE(interned);
+		EXPECT_EQ(*plain, *interned);
+
+		const auto records = interned->GetList();
+		const std::string& id0 = (*records[0].DictItems().begin()).first;
+		const std::string& id1 = (*records[1].DictItems().begin()).first;
+		const std::string& nested_id =
+			(*records[1].FindKey("nested")->DictItems().begin()).first;
+		EXPECT_EQ(&id0, &id1);
+		EXPECT_EQ(&id0, &nested_id);
+		const std::string& plain_id0 =
+			(*plain->GetList()[0].DictItems().begin()).first;
+		const std::string& plain_id1 =
+			(*plain->GetList()[1].DictItems().begin()).first;
+		EXPECT_NE(&plain_id0, &plain_id1);
+
+		// Interning saves allocating a key too long to be stored inline in a
+		// std::string once per dictionary.
+		std::string long_keys = "[";
+		for (int i = 0; i < 10; ++i)
+			long_keys += R"({"a key too long to be stored inline": 1},)";
+		long_keys.back() = ']';
+		EXPECT_LT(
+			JSONReader::Read(long_keys, JSON_INTERN_KEYS)->EstimateMemoryUsage(),
+			JSONReader::Read(long_keys)->EstimateMemoryUsage());
+	}
+
+}  // namespace base
@@ -0,0 +1,63 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "pch.h"
+#include "hash/md5.h"
+
+#include <string>
+#include <vector>
+
+#include "test/perf_test.h"
+#include "timer/lap_timer.h"
+
+namespace base {
+
+	namespace {
+
+		constexpr int kWarmupRuns = 2;
+		constexpr int kTimeCheckInterval = 4;
+		constexpr TimeDelta kTimeLimit = TimeDelta::FromMilliseconds(500);
+		constexpr size_t kEntryCount = 10000;
+		constexpr size_t kEntrySize = 100;
+
+	}  // namespace
+
+	// Hashes 10000 100-byte entries one by one, then all at once, as when
+	// validating a cache.
+	TEST(MD5PerfTest, ManyEntries) {
+		std::vector<std::string> entries;
+		uint32_t state = 1;
+		for (size_t i = 0; i < kEntryCount; ++i) {
+			std::string entry(kEntrySize, '\0');
+			for (auto& byte : entry) {
+				state = state * 1103515245 + 12345;
+				byte = static_cast<char>(state >> 24);
+			}
+			entries.push_back(entry);
+		}
+		const std::vector<std::string_view> inputs(entries.begin(), entries.end());
+		std::vector<MD5Digest> digests(inputs.size());
+
+		LapTimer serial_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			for (size_t i = 0; i < inputs.size(); ++i)
+				MD5Sum(inputs[i].data(), inputs[i].size(), &digests[i]);
+			serial_timer.NextLap();
+		} while (!serial_timer.HasTimeLimitExpired());
+		perf_test::PrintResult("md5_entries", "_serial", "",
+			serial_timer.TimePerLap().InMillisecondsF(), "ms", true);
+
+		std::vector<MD5Digest> many_digests(inputs.size());
+		LapTimer many_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			MD5SumMany(inputs, many_digests);
+			many_timer.NextLap();
+		} while (!many_timer.HasTimeLimitExpired());
+		perf_test::PrintResult("md5_entries", "_many", "",
+			many_timer.TimePerLap().InMillisecondsF(), "ms", true);
+		for (size_t i = 0; i < inputs.size(); ++i)
+			EXPECT_EQ(MD5DigestToBase16(digests[i]), MD5DigestToBase16(many_digests[i]));
+	}
+
+}  // namespace base
@@ -6,8 +6,12 @@
 #include <cstring>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "hash/md5.h"
+#include "files/file_path.h"
+#include "files/file_util.h"
+#include "files/scoped_temp_dir.h"
 
 namespace base {
 
@@ -181,4 +185,49 @@ namespace base {
 		EXPECT_EQ(expected, actual);
 	}
 
+	TEST(MD5, MD5SumMany) {
+		// Mixed sizes, so that the inputs finish at different times.
+		std::vector<std::string> data;
+		for (size_t i = 0; i < 100; ++i) {
+			std::string input(i % 9 == 0 ? 1000 + i : i * 3, '\0');
+			for (size_t j = 0; j < input.size(); ++j)
+				input[j] = static_cast<char>(i + j * 7);
+			data.push_back(input);
+		}
+
+		for (const size_t count : { 0, 1, 3, 8, 9, 100 }) {
+			const std::vector<std::string_view> inputs(data.begin(),
+				data.begin() + count);
+			std::vector<MD5Digest> digests(count);
+			MD5SumMany(inputs, digests);
+			for (size_t i = 0; i < count; ++i) {
+				EXPECT_EQ(MD5String(inputs[i]), MD5DigestToBase16(digests[i]))
+					<< "input " << i << " of " << count;
+			}
+		}
+	}
+
+	TEST(MD5, MD5SumFile) {
+		ScopedTempDir temp_dir;
+		ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+
+		// Empty, within a block, and past the 4 MiB chunks the file is read in.
+		for (const size_t size : { 0, 3, 9 * 1024 * 1024 + 5 }) {
+			std::string data(size, '\0');
+			for (size_t i = 0; i < size; ++i)
+				data[i] = static_cast<char>(i * 31 + 7);
+			const FilePath path = temp_dir.GetPath().AppendASCII("data");
+			ASSERT_EQ(static_cast<int>(size),
+				WriteFile(path, data.data(), static_cast<int>(size)));
+
+			MD5Digest digest{};
+			ASSERT_TRUE(MD5SumFile(path, &digest));
+			EXPECT_EQ(MD5String(data), MD5DigestToBase16(digest)) << size;
+		}
+
+		MD5Digest digest{};
+		EXPECT_FALSE(
+			MD5SumFile(temp_dir.GetPath().AppendASCII("missing"), &digest));
+	}
+
 }  // namespace base
@@ -0,0 +1,86 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "pch.h"
+#include "hash/sha1.h"
+
+#include <string>
+#include <vector>
+
+#include "test/perf_test.h"
+#include "timer/lap_timer.h"
+
+namespace base {
+
+	namespace {
+
+		constexpr int kWarmupRuns = 2;
+		constexpr int kTimeCheckInterval = 4;
+		constexpr TimeDelta kTimeLimit = TimeDelta::FromMilliseconds(500);
+		constexpr size_t kBlobSize = 16 * 1024 * 1024;
+		constexpr size_t kEntryCount = 10000;
+		constexpr size_t kEntrySize = 100;
+
+		std::string GenerateData(size_t size, uint32_t seed) {
+			std::string data(size, '\0');
+			uint32_t state = seed;
+			for (auto& byte : data) {
+				state = state * 1103515245 + 12345;
+				byte = static_cast<char>(state >> 24);
+			}
+			return data;
+		}
+
+	}  // namespace
+
+	// Hashes a 16 MiB blob, as for content addressing of a large file.
+	TEST(SHA1PerfTest, Blob) {
+		const std::string blob = GenerateData(kBlobSize, 1);
+		SHA1Digest digest;
+
+		LapTimer timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			SHA1Context context;
+			SHA1Init(&context);
+			SHA1Update(&context, blob);
+			SHA1Final(&digest, &context);
+			timer.NextLap();
+		} while (!timer.HasTimeLimitExpired());
+		perf_test::PrintResult("sha1_blob", "", "",
+			timer.TimePerLap().InMillisecondsF(), "ms", true);
+	}
+
+	// Hashes 10000 100-byte entries one by one, then all at once.
+	TEST(SHA1PerfTest, ManyEntries) {
+		std::vector<std::string> entries;
+		for (size_t i = 0; i < kEntryCount; ++i)
+			entries.push_back(GenerateData(kEntrySize, static_cast<uint32_t>(i)));
+		const std::vector<std::string_view> inputs(entries.begin(), entries.end());
+		std::vector<SHA1Digest> digests(inputs.size());
+
+		LapTimer serial_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			for (size_t i = 0; i < inputs.size(); ++i) {
+				SHA1Context context;
+				SHA1Init(&context);
+				SHA1Update(&context, inputs[i]);
+				SHA1Final(&digests[i], &context);
+			}
+			serial_timer.NextLap();
+		} while (!serial_timer.HasTimeLimitExpired());
+		perf_test::PrintResult("sha1_entries", "_serial", "",
+			serial_timer.TimePerLap().InMillisecondsF(), "ms", true);
+
+		std::vector<SHA1Digest> many_digests(inputs.size());
+		LapTimer many_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			SHA1HashMany(inputs, many_digests);
+			many_timer.NextLap();
+		} while (!many_timer.HasTimeLimitExpired());
+		perf_test::PrintResult("sha1_entries", "_many", "",
+			many_timer.TimePerLap().InMillisecondsF(), "ms", true);
+		EXPECT_EQ(digests, many_digests);
+	}
+
+}  // namespace base
@@ -6,6 +6,7 @@
 #include "hash/sha1.h"
 
 #include <string>
+#include <vector>
 
 TEST(SHA1Test, Test1) {
 	// Example A.1 from FIPS 180-2: one-block message.
@@ -89,3 +90,66 @@ TEST(SHA1Test, Test3Bytes) {
 	for (size_t i = 0; i < base::kSHA1Length; i++)
 		EXPECT_EQ(expected[i], output[i]);
 }
+
+TEST(SHA1Test, ContextTest) {
+	// Example A.2 from FIPS 180-2, a byte at a time.
+	const std::string input =
+		"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+	const base::SHA1Digest expected = { 0x84, 0x98, 0x3e, 0x44, 0x1c, 0x3b,
+		0xd2, 0x6e, 0xba, 0xae, 0x4a, 0xa1, 0xf9, 0x51, 0x29, 0xe5, 0xe5, 0x46,
+		0x70, 0xf1 };
+
+	base::SHA1Context context;
+	base::SHA1Init(&context);
+	for (const char c : input)
+		base::SHA1Update(&context, std::string_view(&c, 1));
+	base::SHA1Digest digest;
+	base::SHA1Final(&digest, &context);
+	EXPECT_EQ(expected, digest);
+}
+
+// Splitting the input must not change the hash, wherever the pieces fall
+// relative to the 64-byte blocks and to the padding.
+TEST(SHA1Test, ContextMatchesOneShot) {
+	std::string data(300, '\0');
+	for (size_t i = 0; i < data.size(); ++i)
+		data[i] = static_cast<char>(i * 37 + 11);
+
+	for (size_t size = 0; size <= data.size(); ++size) {
+		const std::string_view input(data.data(), size);
+		const auto expected = base::SHA1HashSpan(base::as_bytes(
+			base::make_span(input.data(), input.size())));
+		for (const size_t piece : { 1, 7, 63, 64, 65, 200 }) {
+			base::SHA1Context context;
+			base::SHA1Init(&context);
+			for (size_t pos = 0; pos < size; pos += piece)
+				base::SHA1Update(&context, input.substr(pos, piece));
+			base::SHA1Digest digest;
+			base::SHA1Final(&digest, &context);
+			EXPECT_EQ(expected, digest) << "size " << size << " piece " << piece;
+		}
+	}
+}
+
+TEST(SHA1Test, HashMany) {
+	// Mixed sizes, so that the inputs finish at different times.
+	std::vector<std::string> data;
+	for (size_t i = 0; i < 100; ++i) {
+		std::string input(i % 9 == 0 ? 1000 + i : i * 3, '\0');
+		for (size_t j = 0; j < input.size(); ++j)
+			input[j] = static_cast<char>(i + j * 7);
+		data.push_back(input);
+	}
+
+	for (const size_t count : { 0, 1, 3, 8, 9, 100 }) {
+		const std::vector<std::string_view> inputs(data.begin(),
+			data.begin() + count);
+		std::vector<base::SHA1Digest> digests(count);
+		base::SHA1HashMany(inputs, digests);
+		for (size_t i = 0; i < count; ++i) {
+			EXPECT_EQ(base::SHA1HashSpan(base::as_bytes(
+				base::make_span(inputs[i].data(), inputs[i].size()))), digests[i])
+				<< "input " << i << " of " << count;
+		}
+	}
+}
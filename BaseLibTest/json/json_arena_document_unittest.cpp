@@ -0,0 +1,171 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "pch.h"
+#include "json/json_arena_document.h"
+
+#include <optional>
+#include <string>
+
+#include "json/json_reader.h"
+#include "values.h"
+
+namespace base {
+
+	TEST(JSONArenaDocumentTest, Scalars) {
+		std::optional<JSONArenaDocument> doc = JSONReader::ReadToArena("42");
+		ASSERT_TRUE(doc);
+		ASSERT_TRUE(doc->root().is_int());
+		EXPECT_EQ(42, doc->root().GetInt());
+		EXPECT_EQ(42.0, doc->root().GetDouble());
+
+		doc = JSONReader::ReadToArena("1e300");
+		ASSERT_TRUE(doc);
+		ASSERT_TRUE(doc->root().is_double());
+		EXPECT_EQ(1e300, doc->root().GetDouble());
+
+		doc = JSONReader::ReadToArena(R"("abc")");
+		ASSERT_TRUE(doc);
+		ASSERT_TRUE(doc->root().is_string());
+		EXPECT_EQ("abc", doc->root().GetString());
+
+		doc = JSONReader::ReadToArena("null");
+		ASSERT_TRUE(doc);
+		EXPECT_TRUE(doc->root().is_none());
+
+		doc = JSONReader::ReadToArena("true");
+		ASSERT_TRUE(doc);
+		ASSERT_TRUE(doc->root().is_bool());
+		EXPECT_TRUE(doc->root().GetBool());
+	}
+
+	TEST(JSONArenaDocumentTest, Containers) {
+		std::optional<JSONArenaDocument> doc = JSONReader::ReadToArena(
+			R"({"list": [1, "two", [], {}], "dict": {"b": 2, "a": 1}, "": 0})");
+		ASSERT_TRUE(doc);
+		const ArenaValue& root = doc->root();
+		ASSERT_TRUE(root.is_dict());
+		EXPECT_EQ(3u, root.DictSize());
+
+		// Members are sorted by key.
+		auto items = root.DictItems();
+		EXPECT_EQ("", items[0].key);
+		EXPECT_EQ("dict", items[1].key);
+		EXPECT_EQ("list", items[2].key);
+
+		const ArenaValue* list = root.FindKey("list");
+		ASSERT_TRUE(list && list->is_list());
+		auto elements = list->GetList();
+		ASSERT_EQ(4u, elements.size());
+		EXPECT_EQ(1, elements[0].GetInt());
+		EXPECT_EQ("two", elements[1].GetString());
+		EXPECT_TRUE(elements[2].GetList().empty());
+		EXPECT_EQ(0u, elements[3].DictSize());
+
+		const ArenaValue* a = root.FindPath("dict.a");
+		ASSERT_TRUE(a);
+		EXPECT_EQ(1, a->GetInt());
+		EXPECT_EQ(0, root.FindKey("")->GetInt());
+		EXPECT_EQ(nullptr, root.FindKey("missing"));
+		EXPECT_EQ(nullptr, root.FindPath("dict.c"));
+		EXPECT_EQ(nullptr, root.FindPath("list.a"));
+	}
+
+	TEST(JSONArenaDocumentTest, DuplicateKeysKeepLast) {
+		std::optional<JSONArenaDocument> doc =
+			JSONReader::ReadToArena(R"({"a": 1, "b": 2, "a": 3, "a": {"c": 4}})");
+		ASSERT_TRUE(doc);
+		EXPECT_EQ(2u, doc->root().DictSize());
+		const ArenaValue* c = doc->root().FindPath("a.c");
+		ASSERT_TRUE(c);
+		EXPECT_EQ(4, c->GetInt());
+	}
+
+	TEST(JSONArenaDocumentTest, ToValueMatchesRead) {
+		static const char* const kInputs[] = {
+			"[]",
+			"{}",
+			"-0.5",
+			R"("\u00e9\ud83d\ude00")",
+			R"({"k": [true, false, null, 1, 2.25, "s", {"z": [], "y": {"x": 1}}]})",
+			R"([[[[1]]], {"a": 1, "a": 2}, {"b": [{"c": "d"}]}])",
+		};
+		for (const char* input : kInputs) {
+			SCOPED_TRACE(input);
+			std::optional<JSONArenaDocument> doc = JSONReader::ReadToArena(input);
+			ASSERT_TRUE(doc);
+			std::optional<Value> value = JSONReader::Read(input);
+			ASSERT_TRUE(value);
+			EXPECT_EQ(*value, doc->root().ToValue());
+		}
+	}
+
+	TEST(JSONArenaDocumentTest, InvalidInput) {
+		EXPECT_FALSE(JSONReader::ReadToArena(""));
+		EXPECT_FALSE(JSONReader::ReadToArena("[1, 2"));
+		EXPECT_FALSE(JSONReader::ReadToArena(R"({"a": 1,})"));
+		EXPECT_TRUE(JSONReader::ReadToArena(R"({"a": 1,})",
+			JSON_ALLOW_TRAILING_COMMAS));
+		EXPECT_FALSE(JSONReader::ReadToArena("[[1]]", JSON_PARSE_RFC, 1));
+	}
+
+	TEST(JSONArenaDocumentTest, BorrowInputStrings) {
+		const std::string input =
+			R"({"plain": "value", "esc\u0061ped": "line\nbreak", "list": ["x"]})";
+		const char* const begin = input.data();
+		const char* const end = begin + input.size();
+		auto in_input = [&](std::string_view str) {
+			return str.data() >= begin && str.data() + str.size() <= end;
+		};
+
+		std::optional<JSONArenaDocument> doc =
+			JSONReader::ReadToArena(input, JSON_BORROW_INPUT_STRINGS);
+		ASSERT_TRUE(doc);
+		const ArenaValue& root = doc->root();
+
+		// Strings without escape sequences point into the input.
+		EXPECT_EQ("value", root.FindKey("plain")->GetString());
+		EXPECT_TRUE(in_input(root.FindKey("plain")->GetString()));
+		EXPECT_TRUE(in_input(root.FindKey("list")->GetList()[0].GetString()));
+		EXPECT_TRUE(in_input(root.DictItems()[2].key));
+
+		// Those that needed unescaping are materialized in the document.
+		EXPECT_EQ("escaped", root.DictItems()[0].key);
+		EXPECT_FALSE(in_input(root.DictItems()[0].key));
+		EXPECT_EQ("line\nbreak", root.FindKey("escaped")->GetString());
+		EXPECT_FALSE(in_input(root.FindKey("escaped")->GetString()));
+
+		EXPECT_EQ(*JSONReader::Read(input), root.ToValue());
+
+		// Without the option, nothing refers to the input.
+		doc = JSONReader::ReadToArena(input);
+		ASSERT_TRUE(doc);
+		EXPECT_EQ("value", doc->root().FindKey("plain")->GetString());
+		EXPECT_FALSE(in_input(doc->root().FindKey("plain")->GetString()));
+	}
+
+	TEST(JSONArenaDocumentTest, BorrowedStringsWithReplacedCharacters) {
+		// Invalid UTF-8 is replaced, so such strings are never borrowed.
+		const std::string input = "[\"a\xFF" "b\", \"ok\"]";
+		std::optional<JSONArenaDocument> doc = JSONReader::ReadToArena(
+			input, JSON_BORROW_INPUT_STRINGS | JSON_REPLACE_INVALID_CHARACTERS);
+		ASSERT_TRUE(doc);
+		auto list = doc->root().GetList();
+		EXPECT_EQ("a\xEF\xBF\xBD" "b", list[0].GetString());
+		EXPECT_EQ(input.data() + 9, list[1].GetString().data());
+	}
+
+	TEST(JSONArenaDocumentTest, MoveKeepsValuesAlive) {
+		std::optional<JSONArenaDocument> doc =
+			JSONReader::ReadToArena(R"({"key": "value"})");
+		ASSERT_TRUE(doc);
+		const ArenaValue* value = doc->root().FindKey("key");
+		JSONArenaDocument moved = std::move(*doc);
+		doc.reset();
+		EXPECT_EQ(value, moved.root().FindKey("key"));
+		EXPECT_EQ("value", value->GetString());
+		EXPECT_GT(moved.EstimateMemoryUsage(), 0u);
+	}
+
+}  // namespace base
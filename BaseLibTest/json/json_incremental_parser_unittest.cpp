@@ -0,0 +1,196 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "pch.h"
+#include "json/json_incremental_parser.h"
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+
+#include "json/json_reader.h"
+#include "values.h"
+
+namespace base {
+
+	namespace {
+
+		// Documents covering every kind of token and error, which are split at
+		// every position.
+		const char* const kDocuments[] = {
+			R"({"a": [1, -2.5, 3e2, true, false, null], "b": {"c": "d"}})",
+			R"(  [ "esc\"aped\\", "\u00e9\ud83d\ude00", "caf)" "\xC3\xA9" R"(" ] )",
+			"\xEF\xBB\xBF{\"bom\": 1}",
+			"// comment\n{\"x\": /* inline */ 1}\r\n// trailing",
+			R"({"dup": 1, "dup": 2})",
+			"[[[[]]], {}, [], {\"\": \"\"}]",
+			"-0.125",
+			"\"root\"",
+			"true",
+			"12345678901",
+			// Invalid.
+			"",
+			"[1, 2",
+			"[1, 2,]",
+			"{\"a\" 1}",
+			"{a: 1}",
+			"[1 2]",
+			"[tru]",
+			"\"unterminated",
+			"[\"bad\\q\"]",
+			"[01]",
+			"{} {}",
+			"[\n  1,\n  x\n]",
+		};
+
+		// Feeds |json| to |parser| in fragments of |fragment_size| bytes.
+		JSONReader::ValueWithError FeedInFragments(JSONIncrementalParser* parser,
+												   std::string_view json,
+												   size_t fragment_size) {
+			while (!json.empty()) {
+				const size_t size = std::min(fragment_size, json.size());
+				// Copy each fragment, so that nothing can refer to it later.
+				const std::string fragment(json.substr(0, size));
+				if (!parser->Feed(fragment))
+					break;
+				json.remove_prefix(size);
+			}
+			return parser->Finish();
+		}
+
+		void ExpectSameResult(const JSONReader::ValueWithError& expected,
+							  const JSONReader::ValueWithError& actual) {
+			ASSERT_EQ(expected.value.has_value(), actual.value.has_value())
+				<< actual.error_message;
+			if (expected.value) {
+				EXPECT_EQ(*expected.value, *actual.value);
+				return;
+			}
+			EXPECT_EQ(expected.error_code, actual.error_code);
+			EXPECT_EQ(expected.error_line, actual.error_line);
+			EXPECT_FALSE(actual.error_message.empty());
+		}
+
+	}  // namespace
+
+	TEST(JSONIncrementalParserTest, MatchesJSONReader) {
+		JSONIncrementalParser parser;
+		for (const char* json : kDocuments) {
+			SCOPED_TRACE(json);
+			const JSONReader::ValueWithError expected =
+				JSONReader::ReadAndReturnValueWithError(json, JSON_PARSE_RFC);
+
+			// In one piece, byte by byte, and in two pieces split anywhere.
+			ExpectSameResult(expected, FeedInFragments(&parser, json, 1 << 20));
+			ExpectSameResult(expected, FeedInFragments(&parser, json, 1));
+			const std::string_view input(json);
+			for (size_t split = 1; split < input.size(); ++split) {
+				parser.Feed(std::string(input.substr(0, split)));
+				parser.Feed(std::string(input.substr(split)));
+				ExpectSameResult(expected, parser.Finish());
+			}
+		}
+	}
+
+	TEST(JSONIncrementalParserTest, Options) {
+		JSONIncrementalParser parser(JSON_ALLOW_TRAILING_COMMAS |
+			JSON_REPLACE_INVALID_CHARACTERS);
+		const char json[] = "{\"a\": [1, 2,], \"b\": \"\xFF\",}";
+		const JSONReader::ValueWithError expected =
+			JSONReader::ReadAndReturnValueWithError(
+				json, JSON_ALLOW_TRAILING_COMMAS | JSON_REPLACE_INVALID_CHARACTERS);
+		ASSERT_TRUE(expected.value);
+		ExpectSameResult(expected, FeedInFragments(&parser, json, 1));
+
+		JSONIncrementalParser interning(JSON_INTERN_KEYS);
+		const char records[] = R"([{"id": 1}, {"id": 2}])";
+		const JSONReader::ValueWithError result =
+			FeedInFragments(&interning, records, 2);
+		ASSERT_TRUE(result.value);
+		EXPECT_EQ(*JSONReader::Read(records), *result.value);
+		const auto list = result.value->GetList();
+		EXPECT_EQ(&(*list[0].DictItems().begin()).first,
+			&(*list[1].DictItems().begin()).first);
+	}
+
+	TEST(JSONIncrementalParserTest, ErrorLocation) {
+		JSONIncrementalParser parser;
+		EXPECT_TRUE(parser.Feed("[\n  1,\n"));
+		EXPECT_FALSE(parser.Feed("  x\n]"));
+		// Later fragments are ignored.
+		EXPECT_FALSE(parser.Feed("1"));
+		JSONReader::ValueWithError result = parser.Finish();
+		EXPECT_FALSE(result.value);
+		EXPECT_EQ(JSONReader::JSON_UNEXPECTED_TOKEN, result.error_code);
+		EXPECT_EQ(3, result.error_line);
+		EXPECT_EQ(4, result.error_column);
+
+		// A token split across fragments reports its error in the whole input.
+		EXPECT_TRUE(parser.Feed("[1, tr"));
+		EXPECT_FALSE(parser.Feed("ux]"));
+		result = parser.Finish();
+		EXPECT_EQ(JSONReader::JSON_SYNTAX_ERROR, result.error_code);
+		EXPECT_EQ(1, result.error_line);
+		EXPECT_EQ(5, result.error_column);
+
+		// JSONReader fails without error information on numbers out of range.
+		EXPECT_FALSE(JSONReader::Read("[1e999]"));
+		result = FeedInFragments(&parser, "[1e999]", 3);
+		EXPECT_FALSE(result.value);
+		EXPECT_EQ(JSONReader::JSON_SYNTAX_ERROR, result.error_code);
+		EXPECT_EQ(2, result.error_column);
+	}
+
+	TEST(JSONIncrementalParserTest, RootCompletion) {
+		JSONIncrementalParser parser;
+		EXPECT_TRUE(parser.Feed("{\"a\": [1"));
+		EXPECT_FALSE(parser.has_root());
+		EXPECT_TRUE(parser.Feed("]} "));
+		EXPECT_TRUE(parser.has_root());
+		EXPECT_TRUE(parser.Feed(" \n"));
+		JSONReader::ValueWithError result = parser.Finish();
+		ASSERT_TRUE(result.value);
+		EXPECT_EQ(*JSONReader::Read(R"({"a": [1]})"), *result.value);
+
+		// A number is only known to be complete at the end of the input.
+		EXPECT_TRUE(parser.Feed("12"));
+		EXPECT_FALSE(parser.has_root());
+		EXPECT_TRUE(parser.Feed("3"));
+		result = parser.Finish();
+		ASSERT_TRUE(result.value);
+		EXPECT_EQ(Value(123), *result.value);
+	}
+
+	TEST(JSONIncrementalParserTest, Bytes) {
+		JSONIncrementalParser parser;
+		const uint8_t json[] = { '[', '"', 0xC3, 0xA9, '"', ']' };
+		EXPECT_TRUE(parser.Feed(span<const uint8_t>(json, 3)));
+		EXPECT_TRUE(parser.Feed(span<const uint8_t>(json + 3, 3)));
+		const JSONReader::ValueWithError result = parser.Finish();
+		ASSERT_TRUE(result.value);
+		EXPECT_EQ("\xC3\xA9", result.value->GetList()[0].GetString());
+	}
+
+	TEST(JSONIncrementalParserTest, TooDeep) {
+		std::string json;
+		for (int i = 0; i < 199; ++i)
+			json += '[';
+		json += std::string(199, ']');
+		JSONIncrementalParser parser;
+		EXPECT_TRUE(FeedInFragments(&parser, json, 7).value);
+		EXPECT_TRUE(JSONReader::Read(json));
+
+		json = "[" + json + "]";
+		const JSONReader::ValueWithError result =
+			FeedInFragments(&parser, json, 7);
+		EXPECT_FALSE(result.value);
+		EXPECT_EQ(JSONReader::JSON_TOO_MUCH_NESTING, result.error_code);
+		EXPECT_FALSE(JSONReader::Read(json));
+
+		JSONIncrementalParser shallow(JSON_PARSE_RFC, 3);
+		EXPECT_TRUE(FeedInFragments(&shallow, "[[1]]", 1).value);
+		EXPECT_FALSE(FeedInFragments(&shallow, "[[[1]]]", 1).value);
+	}
+
+}  // namespace base
@@ -0,0 +1,138 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "pch.h"
+#include "json/json_lazy_document.h"
+
+#include <optional>
+#include <string>
+
+#include "json/json_reader.h"
+#include "values.h"
+
+namespace base {
+
+	namespace {
+
+		const char kDocument[] = R"({
+			"name": "lazy",
+			"version": 3,
+			"nested": {"inner": {"flag": true, "ratio": 0.5}, "list": [1, {"a": 2}]},
+			"esc\u0061ped": "yes",
+			"dup": 1,
+			// Comments are skipped like whitespace.
+			"dup": {"x": "last wins"},
+			"empty": {}
+		})";
+
+	}  // namespace
+
+	TEST(JSONLazyDocumentTest, FindKey) {
+		std::optional<JSONLazyDocument> doc = JSONReader::ReadLazy(kDocument);
+		ASSERT_TRUE(doc);
+		EXPECT_TRUE(doc->is_dict());
+
+		const Value* name = doc->FindKey("name");
+		ASSERT_TRUE(name);
+		EXPECT_EQ(Value("lazy"), *name);
+		EXPECT_EQ(Value(3), *doc->FindKey("version"));
+		EXPECT_EQ(Value("yes"), *doc->FindKey("escaped"));
+		EXPECT_EQ(Value(Value::Type::DICTIONARY), *doc->FindKey("empty"));
+		EXPECT_EQ(nullptr, doc->FindKey("missing"));
+		EXPECT_EQ(nullptr, doc->FindKey("inner"));
+
+		// Values are parsed once and cached.
+		EXPECT_EQ(name, doc->FindKey("name"));
+
+		const Value* nested = doc->FindKey("nested");
+		ASSERT_TRUE(nested);
+		EXPECT_EQ(*JSONReader::Read(kDocument)->FindKey("nested"), *nested);
+	}
+
+	TEST(JSONLazyDocumentTest, FindPath) {
+		std::optional<JSONLazyDocument> doc = JSONReader::ReadLazy(kDocument);
+		ASSERT_TRUE(doc);
+
+		const Value* flag = doc->FindPath("nested.inner.flag");
+		ASSERT_TRUE(flag);
+		EXPECT_EQ(Value(true), *flag);
+		EXPECT_EQ(Value(0.5), *doc->FindPath("nested.inner.ratio"));
+		EXPECT_EQ(Value("last wins"), *doc->FindPath("dup.x"));
+		EXPECT_EQ(nullptr, doc->FindPath("nested.inner.missing"));
+		EXPECT_EQ(nullptr, doc->FindPath("name.length"));
+		EXPECT_EQ(nullptr, doc->FindPath("nested.list.a"));
+	}
+
+	TEST(JSONLazyDocumentTest, OnlyTouchedValuesAreParsed) {
+		std::optional<JSONLazyDocument> doc = JSONReader::ReadLazy(
+			R"({"good": [1, 2], "bad": [1, 2,, 3], "worse": tru})");
+		ASSERT_TRUE(doc);
+		EXPECT_TRUE(doc->FindKey("good"));
+		EXPECT_EQ(nullptr, doc->FindKey("bad"));
+		EXPECT_EQ(nullptr, doc->FindKey("worse"));
+		EXPECT_FALSE(doc->ToValue());
+	}
+
+	TEST(JSONLazyDocumentTest, NonDictionaryRoot) {
+		std::optional<JSONLazyDocument> doc =
+			JSONReader::ReadLazy(R"([{"a": 1}, "]"])");
+		ASSERT_TRUE(doc);
+		EXPECT_FALSE(doc->is_dict());
+		EXPECT_EQ(nullptr, doc->FindKey("a"));
+		EXPECT_EQ(*JSONReader::Read(R"([{"a": 1}, "]"])"), *doc->ToValue());
+
+		doc = JSONReader::ReadLazy("  42  ");
+		ASSERT_TRUE(doc);
+		EXPECT_FALSE(doc->is_dict());
+		EXPECT_EQ(Value(42), *doc->ToValue());
+	}
+
+	TEST(JSONLazyDocumentTest, InvalidStructure) {
+		static const char* const kInvalid[] = {
+			"",
+			"{",
+			R"({"a": 1)",
+			R"({"a" 1})",
+			R"({a: 1})",
+			R"({"a": 1,})",
+			R"({"a": [1, 2})",
+			R"({"a": "unterminated})",
+			R"({"a": 1} extra)",
+			R"({"a": 1 /* unterminated comment })",
+		};
+		for (const char* input : kInvalid) {
+			SCOPED_TRACE(input);
+			EXPECT_FALSE(JSONReader::ReadLazy(input));
+		}
+		EXPECT_TRUE(JSONReader::ReadLazy(R"({"a": 1,})",
+			JSON_ALLOW_TRAILING_COMMAS));
+	}
+
+	TEST(JSONLazyDocumentTest, MaxDepth) {
+		const char kNested[] = R"({"a": {"b": [[1]]}})";
+		EXPECT_TRUE(JSONReader::Read(kNested, JSON_PARSE_RFC, 5));
+		EXPECT_FALSE(JSONReader::Read(kNested, JSON_PARSE_RFC, 4));
+
+		std::optional<JSONLazyDocument> doc =
+			JSONReader::ReadLazy(kNested, JSON_PARSE_RFC, 5);
+		ASSERT_TRUE(doc);
+		EXPECT_TRUE(doc->FindPath("a.b"));
+		EXPECT_FALSE(JSONReader::ReadLazy(kNested, JSON_PARSE_RFC, 4));
+		EXPECT_FALSE(JSONReader::ReadLazy(R"({"a": {"b": {}}})",
+			JSON_PARSE_RFC, 3));
+	}
+
+	TEST(JSONLazyDocumentTest, MoveKeepsParsedValues) {
+		std::optional<JSONLazyDocument> doc = JSONReader::ReadLazy(kDocument);
+		ASSERT_TRUE(doc);
+		const Value* name = doc->FindKey("name");
+		const size_t usage = doc->EstimateMemoryUsage();
+		JSONLazyDocument moved = std::move(*doc);
+		doc.reset();
+		EXPECT_EQ(name, moved.FindKey("name"));
+		EXPECT_EQ("yes", moved.FindKey("escaped")->GetString());
+		EXPECT_GT(moved.EstimateMemoryUsage(), usage);
+	}
+
+}  // namespace base
@@ -0,0 +1,104 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "pch.h"
+#include "json/json_lines_reader.h"
+
+#include <string>
+#include <vector>
+
+#include "files/file_path.h"
+#include "files/file_util.h"
+#include "files/scoped_temp_dir.h"
+#include "strings/string_number_conversions.h"
+#include "test/task_environment.h"
+#include "values.h"
+
+namespace base {
+
+	namespace {
+
+		// Returns |lines| records of the form {"id":N,"name":"record N"}, with
+		// the record at |invalid_line| (1-based) left unterminated.
+		std::string GenerateLines(int lines, int invalid_line = 0) {
+			std::string input;
+			for (int i = 1; i <= lines; ++i) {
+				input += R"({"id":)" + NumberToString(i) + R"(,"name":"record )" +
+					NumberToString(i) + "\"";
+				if (i != invalid_line)
+					input += "}";
+				input += "\n";
+			}
+			return input;
+		}
+
+		void ExpectRecords(const std::vector<JSONReader::ValueWithError>& records,
+						   int lines,
+						   int invalid_line) {
+			ASSERT_EQ(static_cast<size_t>(lines), records.size());
+			for (int i = 1; i <= lines; ++i) {
+				const JSONReader::ValueWithError& record = records[i - 1];
+				if (i == invalid_line) {
+					EXPECT_FALSE(record.value);
+					EXPECT_EQ(invalid_line, record.error_line);
+					EXPECT_NE(JSONReader::JSON_NO_ERROR, record.error_code);
+					continue;
+				}
+				ASSERT_TRUE(record.value) << record.error_message;
+				EXPECT_EQ(i, *record.value->FindIntKey("id"));
+			}
+		}
+
+	}  // namespace
+
+	TEST(JSONLinesReaderTest, SingleChunk) {
+		const std::vector<JSONReader::ValueWithError> records = JSONLinesReader::Read(
+			"{\"a\": 1}\r\n"
+			"\n"
+			"  \t\r\n"
+			"[1, 2]\n"
+			"{\"a\": }\n"
+			"\"last\"");
+		ASSERT_EQ(4u, records.size());
+		EXPECT_EQ(*JSONReader::Read(R"({"a": 1})"), *records[0].value);
+		EXPECT_EQ(*JSONReader::Read("[1, 2]"), *records[1].value);
+		EXPECT_FALSE(records[2].value);
+		EXPECT_EQ(5, records[2].error_line);
+		EXPECT_EQ(Value("last"), *records[3].value);
+
+		EXPECT_TRUE(JSONLinesReader::Read("").empty());
+		EXPECT_TRUE(JSONLinesReader::Read("\n\n").empty());
+		EXPECT_EQ(1u, JSONLinesReader::Read("[1,]", JSON_ALLOW_TRAILING_COMMAS)
+			.size());
+	}
+
+	TEST(JSONLinesReaderTest, ManyChunks) {
+		test::TaskEnvironment task_environment;
+		const int kLines = 20000;
+		const int kInvalidLine = 12345;
+		const std::string input = GenerateLines(kLines, kInvalidLine);
+		ASSERT_GT(input.size(), 10 * JSONLinesReader::kChunkSize);
+		ExpectRecords(JSONLinesReader::Read(input), kLines, kInvalidLine);
+	}
+
+	TEST(JSONLinesReaderTest, ReadFile) {
+		test::TaskEnvironment task_environment;
+		ScopedTempDir temp_dir;
+		ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+		const FilePath path = temp_dir.GetPath().AppendASCII("records.jsonl");
+		const int kLines = 5000;
+		const std::string input = GenerateLines(kLines, 1);
+		ASSERT_EQ(static_cast<int>(input.size()),
+			WriteFile(path, input.data(), static_cast<int>(input.size())));
+
+		std::optional<std::vector<JSONReader::ValueWithError>> records =
+			JSONLinesReader::ReadFile(path);
+		ASSERT_TRUE(records);
+		ExpectRecords(*records, kLines, 1);
+
+		EXPECT_FALSE(JSONLinesReader::ReadFile(
+			temp_dir.GetPath().AppendASCII("missing.jsonl")));
+	}
+
+}  // namespace base
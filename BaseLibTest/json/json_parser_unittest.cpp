@@ -7,11 +7,13 @@
 
 #include <stddef.h>
 
+#include <limits>
 #include <memory>
 #include <optional>
 
 #include "json/json_reader.h"
 #include "stl_util.h"
+#include "strings/string_number_conversions.h"
 #include "strings/stringprintf.h"
 #include "values.h"
 
@@ -216,6 +218,37 @@ namespace base::internal {
 		ASSERT_TRUE(value);
 		EXPECT_TRUE(value->GetAsDouble(&number_d));
 		EXPECT_EQ(420, number_d);
+
+		// Integers at the limits of an int.
+		for (const int expected : { std::numeric_limits<int>::max(),
+									std::numeric_limits<int>::min(), 0 }) {
+			input = NumberToString(expected) + ",|";
+			parser.reset(NewTestParser(input));
+			value = parser->ConsumeNumber();
+			ASSERT_TRUE(value);
+			EXPECT_EQ(Value(expected), *value);
+		}
+
+		// Integers beyond them become doubles, rounded to nearest even.
+		const struct {
+			const char* input;
+			double expected;
+		} kLargeIntegers[] = {
+			{ "2147483648,|", 2147483648.0 },
+			{ "-2147483649,|", -2147483649.0 },
+			{ "9007199254740993,|", 9007199254740992.0 },
+			{ "9223372036854775807,|", 9223372036854775808.0 },
+			{ "18446744073709551615,|", 18446744073709551616.0 },
+			{ "123456789012345678901234567890,|", 1.2345678901234568e29 },
+		};
+		for (const auto& test : kLargeIntegers) {
+			input = test.input;
+			parser.reset(NewTestParser(input));
+			value = parser->ConsumeNumber();
+			ASSERT_TRUE(value) << test.input;
+			ASSERT_TRUE(value->is_double()) << test.input;
+			EXPECT_EQ(test.expected, value->GetDouble()) << test.input;
+		}
 	}
 
 	TEST_F(JSONParserTest, ErrorMessages) {
@@ -438,4 +471,70 @@ namespace base::internal {
 			EXPECT_FALSE(JSONReader::Read(input));
 		}
 	}
+
+	// The string and whitespace scanners work on 16 and 32 byte blocks; make sure
+	// special bytes are found at every offset within and across blocks.
+	TEST_F(JSONParserTest, LongStringsAcrossScanBlocks) {
+		const char* const kSpecials[] = { "\\\"", "\\n", "\\u00e9", "\xC3\xA9" };
+		const char* const kDecoded[] = { "\"", "\n", "\xC3\xA9", "\xC3\xA9" };
+		for (size_t i = 0; i < base::size(kSpecials); ++i) {
+			for (size_t prefix = 0; prefix < 70; ++prefix) {
+				SCOPED_TRACE(StringPrintf("special %zu, prefix %zu", i, prefix));
+				const std::string head(prefix, 'a');
+				const std::string tail(prefix % 37, 'b');
+				const std::string input = "\"" + head + kSpecials[i] + tail + "\"";
+
+				std::optional<Value> value = JSONReader::Read(input);
+				ASSERT_TRUE(value);
+				ASSERT_TRUE(value->is_string());
+				EXPECT_EQ(head + kDecoded[i] + tail, value->GetString());
+			}
+		}
+	}
+
+	TEST_F(JSONParserTest, LongWhitespaceRuns) {
+		for (size_t indent = 0; indent < 70; ++indent) {
+			SCOPED_TRACE(StringPrintf("indent %zu", indent));
+			const std::string blanks(indent, indent % 2 ? ' ' : '\t');
+			const std::string input = "{" + blanks + "\"a\"" + blanks + ":" + blanks +
+				"[" + blanks + "true" + blanks + "]" + blanks + "}" + blanks;
+
+			std::optional<Value> value = JSONReader::Read(input);
+			ASSERT_TRUE(value);
+			const Value* list = value->FindListKey("a");
+			ASSERT_TRUE(list);
+			ASSERT_EQ(1u, list->GetList().size());
+			EXPECT_TRUE(list->GetList()[0].GetBool());
+		}
+	}
+
+	TEST_F(JSONParserTest, ErrorPositionsAfterLongRuns) {
+		const std::string blanks(45, ' ');
+		const std::string text(50, 'x');
+
+		// The bad escape is reported just past the escape sequence, after a long
+		// plain run.
+		JSONReader::ValueWithError result = JSONReader::ReadAndReturnValueWithError(
+			"[\n" + blanks + "\"" + text + "\\q\"]", JSON_PARSE_RFC);
+		EXPECT_FALSE(result.value);
+		EXPECT_EQ(JSONReader::JSON_INVALID_ESCAPE, result.error_code);
+		EXPECT_EQ(2, result.error_line);
+		EXPECT_EQ(static_cast<int>(blanks.size() + text.size() + 4),
+			result.error_column);
+
+		// An unexpected token is reported right after the skipped blanks.
+		result = JSONReader::ReadAndReturnValueWithError(
+			"[\r\n\t" + blanks + "x]", JSON_PARSE_RFC);
+		EXPECT_FALSE(result.value);
+		EXPECT_EQ(JSONReader::JSON_UNEXPECTED_TOKEN, result.error_code);
+		EXPECT_EQ(2, result.error_line);
+		EXPECT_EQ(static_cast<int>(blanks.size() + 3), result.error_column);
+
+		// Unterminated long strings still fail at the end of input.
+		result = JSONReader::ReadAndReturnValueWithError("\"" + text,
+			JSON_PARSE_RFC);
+		EXPECT_FALSE(result.value);
+		EXPECT_EQ(JSONReader::JSON_SYNTAX_ERROR, result.error_code);
+		EXPECT_EQ(static_cast<int>(text.size() + 1), result.error_column);
+	}
 } // namespace base
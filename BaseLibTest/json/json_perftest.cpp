@@ -0,0 +1,513 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "pch.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "json/json_arena_document.h"
+#include "json/json_incremental_parser.h"
+#include "json/json_lazy_document.h"
+#include "json/json_lines_reader.h"
+#include "json/json_reader.h"
+#include "json/json_value_converter.h"
+#include "json/json_writer.h"
+#include "json/string_escape.h"
+#include "pickle.h"
+#include "pickle_value_serializer.h"
+#include "strings/string_number_conversions.h"
+#include "test/perf_test.h"
+#include "test/task_environment.h"
+#include "timer/lap_timer.h"
+#include "values.h"
+
+namespace base {
+
+	namespace {
+
+		constexpr int kWarmupRuns = 2;
+		constexpr int kTimeCheckInterval = 4;
+		constexpr TimeDelta kTimeLimit = TimeDelta::FromMilliseconds(500);
+
+		// Builds a small object typical of API responses: many short keys and
+		// strings, a few numbers and a nested list, in about 150 bytes.
+		std::string GenerateRecord(int i) {
+			const std::string id = NumberToString(i);
+			return R"({"id":)" + id + R"(,"name":"record )" + id +
+				R"(","active":)" + (i % 3 ? "true" : "false") +
+				R"(,"score":)" + NumberToString(i * 0.25) +
+				R"(,"tags":["alpha","beta"],"owner":{"id":)" + id +
+				R"(,"email":"user)" + id + R"(@example.com"}})";
+		}
+
+		// Builds a list of |records| records.
+		std::string GenerateDocument(int records) {
+			std::string json = "[";
+			for (int i = 0; i < records; ++i) {
+				if (i)
+					json += ',';
+				json += GenerateRecord(i);
+			}
+			json += ']';
+			return json;
+		}
+
+		// Builds |records| records in JSON Lines format.
+		std::string GenerateLines(int records) {
+			std::string lines;
+			for (int i = 0; i < records; ++i)
+				lines += GenerateRecord(i) + '\n';
+			return lines;
+		}
+
+		// About 1 MB of mostly ASCII text with occasional characters that need
+		// escaping, like log messages or trace event arguments.
+		std::string GenerateASCIIText() {
+			std::string text;
+			while (text.size() < 1024 * 1024)
+				text += "The quick brown fox jumps over the lazy dog.\n\t\"quoted\" ";
+			return text;
+		}
+
+		// About 1 MB of text that is mostly multi-byte UTF-8.
+		std::string GenerateUTF8Text() {
+			std::string text;
+			while (text.size() < 1024 * 1024) {
+				text += "\xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82 "
+					"\xE4\xB8\x96\xE7\x95\x8C \xF0\x9F\x98\x80 ";
+			}
+			return text;
+		}
+
+		// Builds a list of |count| numbers, like a time series or the
+		// coordinates of a shape.
+		std::string GenerateNumbers(int count) {
+			std::string json = "[";
+			for (int i = 0; i < count; ++i) {
+				if (i)
+					json += ',';
+				json += i % 2 ? NumberToString(i) : NumberToString(i * 0.5);
+			}
+			json += ']';
+			return json;
+		}
+
+		// Builds a list of |count| short strings and booleans, like a table of
+		// flags or enumeration values.
+		std::string GenerateScalars(int count) {
+			std::string json = "[";
+			for (int i = 0; i < count; ++i) {
+				if (i)
+					json += ',';
+				json += i % 4 ? R"("value )" + NumberToString(i % 100) + '"'
+					: (i % 8 ? "true" : "false");
+			}
+			json += ']';
+			return json;
+		}
+
+		std::string SizeTrace(const std::string& json) {
+			return NumberToString(json.size() / 1024) + "KB";
+		}
+
+		// Structs with 5, 50 and 500 int fields named f0, f00, f000 and so on,
+		// for JSONValueConverter.
+#define FIELDS_5(F, p) F(p##0) F(p##1) F(p##2) F(p##3) F(p##4)
+#define FIELDS_10(F, p) FIELDS_5(F, p##0) FIELDS_5(F, p##1)
+#define FIELDS_50(F, p) \
+  FIELDS_10(F, p##0) FIELDS_10(F, p##1) FIELDS_10(F, p##2) \
+  FIELDS_10(F, p##3) FIELDS_10(F, p##4)
+#define FIELDS_500(F, p) \
+  FIELDS_50(F, p##0) FIELDS_50(F, p##1) FIELDS_50(F, p##2) \
+  FIELDS_50(F, p##3) FIELDS_50(F, p##4) FIELDS_50(F, p##5) \
+  FIELDS_50(F, p##6) FIELDS_50(F, p##7) FIELDS_50(F, p##8) \
+  FIELDS_50(F, p##9)
+#define DECLARE_FIELD(name) int name = 0;
+#define REGISTER_FIELD(name) converter->RegisterIntField(#name, &Self::name);
+#define APPEND_NAME(name) names->push_back(#name);
+#define DEFINE_MESSAGE(Name, FIELDS)                                      \
+  struct Name {                                                           \
+    using Self = Name;                                                    \
+    FIELDS(DECLARE_FIELD, f)                                              \
+    int missing = 0;                                                      \
+    static void RegisterJSONConverter(JSONValueConverter<Name>* converter) { \
+      FIELDS(REGISTER_FIELD, f)                                           \
+    }                                                                     \
+    static void GetNames(std::vector<std::string>* names) {               \
+      FIELDS(APPEND_NAME, f)                                              \
+    }                                                                     \
+  };
+
+		DEFINE_MESSAGE(Message5, FIELDS_5)
+		DEFINE_MESSAGE(Message50, FIELDS_50)
+		DEFINE_MESSAGE(Message500, FIELDS_500)
+
+#undef DEFINE_MESSAGE
+#undef APPEND_NAME
+#undef REGISTER_FIELD
+#undef DECLARE_FIELD
+#undef FIELDS_500
+#undef FIELDS_50
+#undef FIELDS_10
+#undef FIELDS_5
+
+		// Compares converting a dictionary that holds every field of |Message|
+		// through the converter's table against looking each field up.
+		template <typename Message>
+		void ConvertMessage() {
+			constexpr int kConversionsPerLap = 100;
+			std::vector<std::string> names;
+			Message::GetNames(&names);
+			Value dict(Value::Type::DICTIONARY);
+			for (size_t i = 0; i < names.size(); ++i)
+				dict.SetIntKey(names[i], static_cast<int>(i));
+			const std::string trace = NumberToString(names.size()) + "_fields";
+
+			JSONValueConverter<Message> converter;
+			// Registering a field after construction leaves the table out of
+			// date, which makes Convert() look every field up instead.
+			JSONValueConverter<Message> lookup_converter;
+			lookup_converter.RegisterIntField("missing", &Message::missing);
+
+			for (const auto* current : { &converter, &lookup_converter }) {
+				LapTimer timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+				do {
+					for (int i = 0; i < kConversionsPerLap; ++i) {
+						Message message;
+						ASSERT_TRUE(current->Convert(dict, &message));
+					}
+					timer.NextLap();
+				} while (!timer.HasTimeLimitExpired());
+
+				perf_test::PrintResult("convert",
+					current == &converter ? "_table" : "_lookup", trace,
+					timer.TimePerLap().InMicrosecondsF() / kConversionsPerLap, "us",
+					true);
+			}
+		}
+
+	}  // namespace
+
+	// Compares building and destroying a heap-allocated Value tree against an
+	// arena-backed document for the same input.
+	TEST(JSONPerfTest, ReadVersusReadToArena) {
+		for (int records : {100, 10000}) {
+			const std::string json = GenerateDocument(records);
+			const std::string trace = SizeTrace(json);
+
+			LapTimer value_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+			do {
+				std::optional<Value> value = JSONReader::Read(json);
+				ASSERT_TRUE(value);
+				value_timer.NextLap();
+			} while (!value_timer.HasTimeLimitExpired());
+
+			LapTimer arena_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+			do {
+				std::optional<JSONArenaDocument> doc = JSONReader::ReadToArena(json);
+				ASSERT_TRUE(doc);
+				arena_timer.NextLap();
+			} while (!arena_timer.HasTimeLimitExpired());
+
+			LapTimer borrowed_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+			do {
+				std::optional<JSONArenaDocument> doc =
+					JSONReader::ReadToArena(json, JSON_BORROW_INPUT_STRINGS);
+				ASSERT_TRUE(doc);
+				borrowed_timer.NextLap();
+			} while (!borrowed_timer.HasTimeLimitExpired());
+
+			perf_test::PrintResult("parse_and_destroy", "_value", trace,
+				value_timer.TimePerLap().InMillisecondsF(), "ms", true);
+			perf_test::PrintResult("parse_and_destroy", "_arena", trace,
+				arena_timer.TimePerLap().InMillisecondsF(), "ms", true);
+			perf_test::PrintResult("parse_and_destroy", "_arena_borrowed", trace,
+				borrowed_timer.TimePerLap().InMillisecondsF(), "ms", true);
+
+			// The process-wide peak cannot be reset between runs, so compare
+			// what each representation holds on to instead.
+			const size_t value_bytes = JSONReader::Read(json)->EstimateMemoryUsage();
+			const size_t arena_bytes =
+				JSONReader::ReadToArena(json)->EstimateMemoryUsage();
+			const size_t borrowed_bytes =
+				JSONReader::ReadToArena(json, JSON_BORROW_INPUT_STRINGS)
+					->EstimateMemoryUsage();
+			perf_test::PrintResult("footprint", "_value", trace, value_bytes,
+				"bytes", true);
+			perf_test::PrintResult("footprint", "_arena", trace, arena_bytes,
+				"bytes", true);
+			perf_test::PrintResult("footprint", "_arena_borrowed", trace,
+				borrowed_bytes, "bytes", true);
+		}
+	}
+
+	TEST(JSONPerfTest, EscapeJSONString) {
+		const struct {
+			const char* trace;
+			std::string text;
+		} inputs[] = {
+			{ "ascii", GenerateASCIIText() },
+			{ "utf8", GenerateUTF8Text() },
+		};
+		for (const auto& input : inputs) {
+			std::string escaped;
+			LapTimer timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+			do {
+				escaped.clear();
+				EscapeJSONString(input.text, true, &escaped);
+				timer.NextLap();
+			} while (!timer.HasTimeLimitExpired());
+
+			const double mb = input.text.size() / (1024.0 * 1024.0);
+			perf_test::PrintResult("escape_json_string", "", input.trace,
+				mb * timer.LapsPerSecond(), "MB/s", true);
+		}
+	}
+
+	TEST(JSONPerfTest, Write) {
+		for (int records : {100, 10000}) {
+			const std::string json = GenerateDocument(records);
+			const std::optional<Value> value = JSONReader::Read(json);
+			ASSERT_TRUE(value);
+
+			for (bool pretty_print : {false, true}) {
+				const int options = pretty_print ? JSONWriter::OPTIONS_PRETTY_PRINT : 0;
+				LapTimer timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+				do {
+					std::string output;
+					ASSERT_TRUE(JSONWriter::WriteWithOptions(*value, options, &output));
+					timer.NextLap();
+				} while (!timer.HasTimeLimitExpired());
+
+				perf_test::PrintResult("write", pretty_print ? "_pretty" : "",
+					SizeTrace(json), timer.TimePerLap().InMillisecondsF(), "ms", true);
+			}
+		}
+	}
+
+	// Compares reading JSON Lines one record at a time on the calling thread
+	// against JSONLinesReader on the thread pool.
+	TEST(JSONPerfTest, ReadJSONLines) {
+		test::TaskEnvironment task_environment;
+		const std::string input = GenerateLines(100000);
+		const std::string trace = SizeTrace(input);
+
+		LapTimer serial_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			std::vector<std::optional<Value>> records;
+			std::string_view rest = input;
+			while (!rest.empty()) {
+				const size_t newline = rest.find('\n');
+				records.push_back(JSONReader::Read(rest.substr(0, newline)));
+				ASSERT_TRUE(records.back());
+				rest.remove_prefix(newline + 1);
+			}
+			serial_timer.NextLap();
+		} while (!serial_timer.HasTimeLimitExpired());
+
+		LapTimer parallel_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			ASSERT_EQ(100000u, JSONLinesReader::Read(input).size());
+			parallel_timer.NextLap();
+		} while (!parallel_timer.HasTimeLimitExpired());
+
+		perf_test::PrintResult("read_json_lines", "_serial", trace,
+			serial_timer.TimePerLap().InMillisecondsF(), "ms", true);
+		perf_test::PrintResult("read_json_lines", "_parallel", trace,
+			parallel_timer.TimePerLap().InMillisecondsF(), "ms", true);
+	}
+
+	// Compares round-tripping a Value through JSON against the binary pickle
+	// format.
+	TEST(JSONPerfTest, JSONVersusPickle) {
+		for (int records : {100, 10000}) {
+			const std::string json = GenerateDocument(records);
+			const std::optional<Value> value = JSONReader::Read(json);
+			ASSERT_TRUE(value);
+			const std::string trace = SizeTrace(json);
+
+			LapTimer json_write_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+			do {
+				std::string output;
+				ASSERT_TRUE(JSONWriter::Write(*value, &output));
+				json_write_timer.NextLap();
+			} while (!json_write_timer.HasTimeLimitExpired());
+
+			std::string written;
+			ASSERT_TRUE(JSONWriter::Write(*value, &written));
+			LapTimer json_read_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+			do {
+				ASSERT_TRUE(JSONReader::Read(written));
+				json_read_timer.NextLap();
+			} while (!json_read_timer.HasTimeLimitExpired());
+
+			LapTimer pickle_write_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+			do {
+				Pickle pickle;
+				ASSERT_TRUE(PickleValueSerializer(&pickle).Serialize(*value));
+				pickle_write_timer.NextLap();
+			} while (!pickle_write_timer.HasTimeLimitExpired());
+
+			Pickle pickle;
+			ASSERT_TRUE(PickleValueSerializer(&pickle).Serialize(*value));
+			LapTimer pickle_read_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+			do {
+				PickleIterator iter(pickle);
+				ASSERT_TRUE(PickleValueDeserializer(&iter).Deserialize(nullptr,
+					nullptr));
+				pickle_read_timer.NextLap();
+			} while (!pickle_read_timer.HasTimeLimitExpired());
+
+			perf_test::PrintResult("serialize", "_json", trace,
+				json_write_timer.TimePerLap().InMillisecondsF(), "ms", true);
+			perf_test::PrintResult("serialize", "_pickle", trace,
+				pickle_write_timer.TimePerLap().InMillisecondsF(), "ms", true);
+			perf_test::PrintResult("deserialize", "_json", trace,
+				json_read_timer.TimePerLap().InMillisecondsF(), "ms", true);
+			perf_test::PrintResult("deserialize", "_pickle", trace,
+				pickle_read_timer.TimePerLap().InMillisecondsF(), "ms", true);
+			perf_test::PrintResult("serialized_size", "_json", trace,
+				written.size(), "bytes", true);
+			perf_test::PrintResult("serialized_size", "_pickle", trace,
+				pickle.size(), "bytes", true);
+		}
+	}
+
+	// Compares parsing a whole document against indexing it lazily, to read
+	// two fields out of it.
+	TEST(JSONPerfTest, FindPathVersusReadLazy) {
+		for (int records : {100, 10000}) {
+			const std::string json = R"({"records":)" + GenerateDocument(records) +
+				R"(,"meta":{"count":)" + NumberToString(records) +
+				R"(,"source":"generated"}})";
+			const std::string trace = SizeTrace(json);
+
+			LapTimer value_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+			do {
+				std::optional<Value> value = JSONReader::Read(json);
+				ASSERT_TRUE(value);
+				ASSERT_TRUE(value->FindPath("meta.count"));
+				ASSERT_TRUE(value->FindPath("meta.source"));
+				value_timer.NextLap();
+			} while (!value_timer.HasTimeLimitExpired());
+
+			LapTimer lazy_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+			do {
+				std::optional<JSONLazyDocument> doc = JSONReader::ReadLazy(json);
+				ASSERT_TRUE(doc);
+				ASSERT_TRUE(doc->FindPath("meta.count"));
+				ASSERT_TRUE(doc->FindPath("meta.source"));
+				lazy_timer.NextLap();
+			} while (!lazy_timer.HasTimeLimitExpired());
+
+			perf_test::PrintResult("find_path", "_value", trace,
+				value_timer.TimePerLap().InMillisecondsF(), "ms", true);
+			perf_test::PrintResult("find_path", "_lazy", trace,
+				lazy_timer.TimePerLap().InMillisecondsF(), "ms", true);
+
+			std::optional<JSONLazyDocument> doc = JSONReader::ReadLazy(json);
+			doc->FindPath("meta.count");
+			doc->FindPath("meta.source");
+			perf_test::PrintResult("footprint", "_value", trace,
+				JSONReader::Read(json)->EstimateMemoryUsage(), "bytes", true);
+			perf_test::PrintResult("footprint", "_lazy", trace,
+				doc->EstimateMemoryUsage(), "bytes", true);
+		}
+	}
+
+	// Compares parsing records with and without JSON_INTERN_KEYS, and the
+	// memory the results hold on to.
+	TEST(JSONPerfTest, InternKeys) {
+		for (int records : {100, 10000}) {
+			const std::string json = GenerateDocument(records);
+			const std::string trace = SizeTrace(json);
+			for (int options : {JSON_PARSE_RFC, JSON_INTERN_KEYS}) {
+				const char* const variant =
+					options == JSON_INTERN_KEYS ? "_interned" : "";
+				LapTimer timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+				do {
+					ASSERT_TRUE(JSONReader::Read(json, options));
+					timer.NextLap();
+				} while (!timer.HasTimeLimitExpired());
+				perf_test::PrintResult("intern_keys_parse", variant, trace,
+					timer.TimePerLap().InMillisecondsF(), "ms", true);
+				perf_test::PrintResult("intern_keys_footprint", variant, trace,
+					JSONReader::Read(json, options)->EstimateMemoryUsage(), "bytes",
+					true);
+			}
+		}
+	}
+
+	// Compares parsing a document in one piece against feeding it to
+	// JSONIncrementalParser in the fragments it would be read in.
+	TEST(JSONPerfTest, ReadVersusIncremental) {
+		const std::string json = GenerateDocument(10000);
+		const std::string trace = SizeTrace(json);
+
+		LapTimer read_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			ASSERT_TRUE(JSONReader::Read(json));
+			read_timer.NextLap();
+		} while (!read_timer.HasTimeLimitExpired());
+		perf_test::PrintResult("incremental", "_read", trace,
+			read_timer.TimePerLap().InMillisecondsF(), "ms", true);
+
+		for (size_t fragment_size : {512, 4096, 65536}) {
+			JSONIncrementalParser parser;
+			LapTimer timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+			do {
+				for (size_t pos = 0; pos < json.size(); pos += fragment_size) {
+					ASSERT_TRUE(
+						parser.Feed(std::string_view(json).substr(pos, fragment_size)));
+				}
+				ASSERT_TRUE(parser.Finish().value);
+				timer.NextLap();
+			} while (!timer.HasTimeLimitExpired());
+			perf_test::PrintResult("incremental",
+				"_feed_" + NumberToString(fragment_size), trace,
+				timer.TimePerLap().InMillisecondsF(), "ms", true);
+		}
+	}
+
+	// Measures the memory taken by parsed documents whose lists hold records,
+	// numbers and short scalars.
+	TEST(JSONPerfTest, ValueFootprint) {
+		const struct {
+			const char* name;
+			std::string json;
+		} corpora[] = {
+			{"_records", GenerateDocument(10000)},
+			{"_numbers", GenerateNumbers(100000)},
+			{"_scalars", GenerateScalars(100000)},
+		};
+		perf_test::PrintResult("value_size", "", "", sizeof(Value), "bytes", true);
+		for (const auto& corpus : corpora) {
+			const std::optional<Value> value = JSONReader::Read(corpus.json);
+			ASSERT_TRUE(value);
+			perf_test::PrintResult("value_footprint", corpus.name,
+				SizeTrace(corpus.json),
+				sizeof(Value) + value->EstimateMemoryUsage(), "bytes", true);
+		}
+	}
+
+	TEST(JSONPerfTest, ReadNumbers) {
+		const std::string json = GenerateNumbers(100000);
+		LapTimer timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			ASSERT_TRUE(JSONReader::Read(json));
+			timer.NextLap();
+		} while (!timer.HasTimeLimitExpired());
+		perf_test::PrintResult("read_numbers", "", SizeTrace(json),
+			timer.TimePerLap().InMillisecondsF(), "ms", true);
+	}
+
+	TEST(JSONPerfTest, JSONValueConverter) {
+		ConvertMessage<Message5>();
+		ConvertMessage<Message50>();
+		ConvertMessage<Message500>();
+	}
+
+}  // namespace base
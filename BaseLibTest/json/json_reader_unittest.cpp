@@ -10,6 +10,7 @@
 
 #include "base_paths.h"
 #include "files/file_util.h"
+#include "json/json_event_handler.h"
 #include "logging.h"
 #include "path_service.h"
 #include "stl_util.h"
@@ -18,6 +19,53 @@
 
 namespace base {
 
+	namespace {
+
+		// Records the events of JSONReader::ReadEvents() as a compact string, and
+		// stops parsing once |max_events| events were seen.
+		class RecordingHandler : public JSONEventHandler {
+		public:
+			explicit RecordingHandler(size_t max_events = SIZE_MAX)
+				: max_events_(max_events) {}
+
+			bool OnDictBegin() override { return Record("{"); }
+			bool OnDictEnd() override { return Record("}"); }
+			bool OnListBegin() override { return Record("["); }
+			bool OnListEnd() override { return Record("]"); }
+			bool OnKey(std::string_view key) override {
+				return Record("k:" + std::string(key));
+			}
+			bool OnString(std::string_view value) override {
+				return Record("s:" + std::string(value));
+			}
+			bool OnInt(int value) override {
+				return Record("i:" + std::to_string(value));
+			}
+			bool OnDouble(double value) override {
+				return Record("d:" + std::to_string(value));
+			}
+			bool OnBool(bool value) override {
+				return Record(value ? "true" : "false");
+			}
+			bool OnNull() override { return Record("null"); }
+
+			const std::string& events() const { return events_; }
+
+		private:
+			bool Record(const std::string& event) {
+				if (!events_.empty())
+					events_ += ' ';
+				events_ += event;
+				return ++num_events_ < max_events_;
+			}
+
+			const size_t max_events_;
+			size_t num_events_ = 0;
+			std::string events_;
+		};
+
+	}  // namespace
+
 	TEST(JSONReaderTest, Whitespace) {
 		auto root = JSONReader::Read("   null   ");
 		ASSERT_TRUE(root);
@@ -666,4 +714,69 @@ namespace base {
 		EXPECT_TRUE(JSONReader::Read(json, JSON_PARSE_RFC, 4));
 	}
 
+	TEST(JSONReaderTest, ReadEvents) {
+		JSONReader reader;
+		RecordingHandler handler;
+		EXPECT_TRUE(reader.ReadEvents(
+			R"({"a": [1, 2.5, "x\ny"], "b": {"c": null, "d": true}, "e": false})",
+			&handler));
+		EXPECT_EQ(JSONReader::JSON_NO_ERROR, reader.error_code());
+		EXPECT_EQ("{ k:a [ i:1 d:2.500000 s:x\ny ] k:b { k:c null k:d true } "
+			"k:e false }",
+			handler.events());
+	}
+
+	TEST(JSONReaderTest, ReadEventsScalarRoot) {
+		JSONReader reader;
+		RecordingHandler handler;
+		EXPECT_TRUE(reader.ReadEvents("  \"\\u00e9t\\u00e9\"  ", &handler));
+		EXPECT_EQ("s:\xC3\xA9t\xC3\xA9", handler.events());
+	}
+
+	TEST(JSONReaderTest, ReadEventsReportsDuplicateKeys) {
+		JSONReader reader;
+		RecordingHandler handler;
+		EXPECT_TRUE(reader.ReadEvents(R"({"a": 1, "a": 2})", &handler));
+		EXPECT_EQ("{ k:a i:1 k:a i:2 }", handler.events());
+	}
+
+	TEST(JSONReaderTest, ReadEventsStopsEarly) {
+		JSONReader reader;
+		RecordingHandler handler(3);
+		// Everything after the third event is never looked at, even if invalid.
+		EXPECT_TRUE(reader.ReadEvents(R"({"a": [1, 2, 3], "b": })", &handler));
+		EXPECT_EQ(JSONReader::JSON_NO_ERROR, reader.error_code());
+		EXPECT_EQ("{ k:a [", handler.events());
+	}
+
+	TEST(JSONReaderTest, ReadEventsErrorsMatchReadToValue) {
+		const char* const kInvalidJson[] = {
+			"/* test *", "{\"foo\"", "{\"foo\":", "  [", "\"\\u123g\"",
+			"{\n\"eh:\n}", "[1,]", "{\"a\":1 \"b\":2}", "[1] 2", "{a: 1}", "1e999",
+		};
+
+		for (size_t i = 0; i < base::size(kInvalidJson); ++i) {
+			SCOPED_TRACE(kInvalidJson[i]);
+			JSONReader value_reader;
+			EXPECT_FALSE(value_reader.ReadToValue(kInvalidJson[i]));
+
+			JSONReader event_reader;
+			RecordingHandler handler;
+			EXPECT_FALSE(event_reader.ReadEvents(kInvalidJson[i], &handler));
+			EXPECT_NE(JSONReader::JSON_NO_ERROR, event_reader.error_code());
+			if (value_reader.error_code() != JSONReader::JSON_NO_ERROR) {
+				EXPECT_EQ(value_reader.error_code(), event_reader.error_code());
+				EXPECT_EQ(value_reader.GetErrorMessage(),
+					event_reader.GetErrorMessage());
+			}
+		}
+	}
+
+	TEST(JSONReaderTest, ReadEventsMaxNesting) {
+		std::string json(R"({"outer": { "inner": {"foo": true}}})");
+		RecordingHandler handler;
+		EXPECT_FALSE(JSONReader(JSON_PARSE_RFC, 3).ReadEvents(json, &handler));
+		EXPECT_TRUE(JSONReader(JSON_PARSE_RFC, 4).ReadEvents(json, &handler));
+	}
+
 }  // namespace base
@@ -2,16 +2,17 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
-#include "base/json/json_value_converter.h"
+#include "pch.h"
+#include "json/json_value_converter.h"
 
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
-#include "base/json/json_reader.h"
-#include "base/strings/string_piece.h"
-#include "base/values.h"
-#include "testing/gtest/include/gtest/gtest.h"
+#include "json/json_reader.h"
+#include "values.h"
 
 namespace base {
 namespace {
@@ -30,7 +31,7 @@ struct SimpleMessage {
   std::vector<std::unique_ptr<std::string>> string_values;
   SimpleMessage() : foo(0), baz(false), bstruct(false), simple_enum(FOO) {}
 
-  static bool ParseSimpleEnum(StringPiece value, SimpleEnum* field) {
+  static bool ParseSimpleEnum(std::string_view value, SimpleEnum* field) {
     if (value == "foo") {
       *field = FOO;
       return true;
@@ -90,6 +91,20 @@ struct NestedMessage {
   }
 };
 
+// Fields sharing a name, and a field at a path.
+struct AliasedMessage {
+  int first = 0;
+  int second = 0;
+  std::string nested;
+
+  static void RegisterJSONConverter(
+      base::JSONValueConverter<AliasedMessage>* converter) {
+    converter->RegisterIntField("value", &AliasedMessage::first);
+    converter->RegisterStringField("outer.inner", &AliasedMessage::nested);
+    converter->RegisterIntField("value", &AliasedMessage::second);
+  }
+};
+
 }  // namespace
 
 TEST(JSONValueConverterTest, ParseSimpleMessage) {
@@ -104,7 +119,7 @@ TEST(JSONValueConverterTest, ParseSimpleMessage) {
       "  \"ints\": [1, 2]"
       "}\n";
 
-  Optional<Value> value = base::JSONReader::Read(normal_data);
+  std::optional<Value> value = base::JSONReader::Read(normal_data);
   ASSERT_TRUE(value);
   SimpleMessage message;
   base::JSONValueConverter<SimpleMessage> converter;
@@ -147,7 +162,7 @@ TEST(JSONValueConverterTest, ParseNestedMessage) {
       "  }]\n"
       "}\n";
 
-  Optional<Value> value = base::JSONReader::Read(normal_data);
+  std::optional<Value> value = base::JSONReader::Read(normal_data);
   ASSERT_TRUE(value);
   NestedMessage message;
   base::JSONValueConverter<NestedMessage> converter;
@@ -190,7 +205,7 @@ TEST(JSONValueConverterTest, ParseFailures) {
       "  \"ints\": [1, 2]"
       "}\n";
 
-  Optional<Value> value = base::JSONReader::Read(normal_data);
+  std::optional<Value> value = base::JSONReader::Read(normal_data);
   ASSERT_TRUE(value);
   SimpleMessage message;
   base::JSONValueConverter<SimpleMessage> converter;
@@ -207,7 +222,7 @@ TEST(JSONValueConverterTest, ParseWithMissingFields) {
       "  \"ints\": [1, 2]"
       "}\n";
 
-  Optional<Value> value = base::JSONReader::Read(normal_data);
+  std::optional<Value> value = base::JSONReader::Read(normal_data);
   ASSERT_TRUE(value);
   SimpleMessage message;
   base::JSONValueConverter<SimpleMessage> converter;
@@ -231,7 +246,7 @@ TEST(JSONValueConverterTest, EnumParserFails) {
       "  \"ints\": [1, 2]"
       "}\n";
 
-  Optional<Value> value = base::JSONReader::Read(normal_data);
+  std::optional<Value> value = base::JSONReader::Read(normal_data);
   ASSERT_TRUE(value);
   SimpleMessage message;
   base::JSONValueConverter<SimpleMessage> converter;
@@ -249,7 +264,7 @@ TEST(JSONValueConverterTest, RepeatedValueErrorInTheMiddle) {
       "  \"ints\": [1, false]"
       "}\n";
 
-  Optional<Value> value = base::JSONReader::Read(normal_data);
+  std::optional<Value> value = base::JSONReader::Read(normal_data);
   ASSERT_TRUE(value);
   SimpleMessage message;
   base::JSONValueConverter<SimpleMessage> converter;
@@ -257,4 +272,35 @@ TEST(JSONValueConverterTest, RepeatedValueErrorInTheMiddle) {
   // No check the values as mentioned above.
 }
 
+TEST(JSONValueConverterTest, SharedNamesAndPaths) {
+  std::optional<Value> value = base::JSONReader::Read(
+      R"({"value": 7, "outer": {"inner": "x"}, "outer.inner": "y"})");
+  ASSERT_TRUE(value);
+  AliasedMessage message;
+  base::JSONValueConverter<AliasedMessage> converter;
+  EXPECT_TRUE(converter.Convert(*value, &message));
+  EXPECT_EQ(7, message.first);
+  EXPECT_EQ(7, message.second);
+  EXPECT_EQ("x", message.nested);
+}
+
+TEST(JSONValueConverterTest, RegisterAfterFinalize) {
+  std::optional<Value> value =
+      base::JSONReader::Read(R"({"foo": 1, "bar": "bar", "extra": 2})");
+  ASSERT_TRUE(value);
+  base::JSONValueConverter<SimpleMessage> converter;
+  converter.RegisterIntField("extra", &SimpleMessage::foo);
+
+  SimpleMessage message;
+  EXPECT_TRUE(converter.Convert(*value, &message));
+  EXPECT_EQ(2, message.foo);
+  EXPECT_EQ("bar", message.bar);
+
+  converter.Finalize();
+  SimpleMessage finalized_message;
+  EXPECT_TRUE(converter.Convert(*value, &finalized_message));
+  EXPECT_EQ(2, finalized_message.foo);
+  EXPECT_EQ("bar", finalized_message.bar);
+}
+
 }  // namespace base
@@ -7,6 +7,7 @@
 
 #include "stl_util.h"
 #include "strings/string_util.h"
+#include "strings/utf_string_conversions.h"
 
 namespace base {
 
@@ -69,6 +70,52 @@ namespace base {
 		EXPECT_TRUE(IsStringUTF8(out));
 	}
 
+	// Special characters must be found wherever they fall relative to the
+	// blocks the escaper scans at once.
+	TEST(JSONStringEscapeTest, EscapeUTF8AcrossScanBlocks) {
+		const struct {
+			const char* to_escape;
+			const char* escaped;
+		} cases[] = {
+			{ "\"", "\\\"" },
+			{ "\\", "\\\\" },
+			{ "<", "\\u003C" },
+			{ "\n", "\\n" },
+			{ "\x1f", "\\u001F" },
+			{ "\x7f", "\x7f" },
+			{ "\xC3\xA9", "\xC3\xA9" },
+			{ "\xF0\x9F\x98\x80", "\xF0\x9F\x98\x80" },
+			{ "\xe2\x80\xa8", "\\u2028" },
+			{ "\xff", "\xEF\xBF\xBD" },
+		};
+
+		for (const auto& i : cases) {
+			for (size_t pos = 0; pos <= 70; ++pos) {
+				const std::string prefix(pos, 'a');
+				const std::string suffix(70 - pos, 'z');
+				std::string out;
+				EscapeJSONString(prefix + i.to_escape + suffix, true, &out);
+				EXPECT_EQ("\"" + prefix + i.escaped + suffix + "\"", out)
+					<< "at " << pos;
+			}
+		}
+	}
+
+	TEST(JSONStringEscapeTest, EscapeUTF8MatchesUTF16) {
+		// Valid UTF-8 must come out the same as the equivalent UTF-16.
+		std::string in;
+		for (int i = 0; i < 200; ++i) {
+			in += "key";
+			in += static_cast<char>(i % 0x80);
+			in += "\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80 <\"\\>";
+		}
+		std::string from_utf8;
+		EXPECT_TRUE(EscapeJSONString(in, true, &from_utf8));
+		std::string from_utf16;
+		EXPECT_TRUE(EscapeJSONString(UTF8ToWide(in), true, &from_utf16));
+		EXPECT_EQ(from_utf16, from_utf8);
+	}
+
 	TEST(JSONStringEscapeTest, EscapeUTF16) {
 		const struct {
 			const wchar_t* to_escape;
@@ -0,0 +1,71 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "pch.h"
+#include "memory/monotonic_arena.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace base {
+
+	TEST(MonotonicArenaTest, Alignment) {
+		MonotonicArena arena(64);
+		for (size_t alignment = 1; alignment <= 64; alignment *= 2) {
+			arena.Allocate(1, 1);
+			void* p = arena.Allocate(3, alignment);
+			EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(p) % alignment);
+		}
+	}
+
+	TEST(MonotonicArenaTest, AllocationsDoNotOverlap) {
+		MonotonicArena arena(128);
+		std::vector<uint32_t*> arrays;
+		for (uint32_t i = 0; i < 1000; ++i) {
+			uint32_t* array = arena.AllocateArray<uint32_t>(i % 37 + 1);
+			for (uint32_t j = 0; j < i % 37 + 1; ++j)
+				array[j] = i;
+			arrays.push_back(array);
+		}
+		for (uint32_t i = 0; i < arrays.size(); ++i) {
+			for (uint32_t j = 0; j < i % 37 + 1; ++j)
+				ASSERT_EQ(i, arrays[i][j]);
+		}
+	}
+
+	TEST(MonotonicArenaTest, LargeAllocation) {
+		MonotonicArena arena(64);
+		const size_t size = MonotonicArena::kMaxBlockSize * 3;
+		auto* p = static_cast<char*>(arena.Allocate(size, 16));
+		memset(p, 0xAB, size);
+		EXPECT_GE(arena.bytes_reserved(), size);
+		// Small allocations still work afterwards.
+		EXPECT_NE(nullptr, arena.Allocate(8, 8));
+	}
+
+	TEST(MonotonicArenaTest, BlockGrowth) {
+		MonotonicArena arena(1024);
+		EXPECT_EQ(0u, arena.bytes_reserved());
+		arena.Allocate(16, 8);
+		EXPECT_EQ(1024u, arena.bytes_reserved());
+		// Filling many blocks reserves roughly geometrically more memory rather
+		// than one block per allocation.
+		for (int i = 0; i < 10000; ++i)
+			arena.Allocate(100, 8);
+		EXPECT_LT(arena.bytes_reserved(), 4 * 10000 * 100u);
+		EXPECT_GE(arena.bytes_reserved(), 10000 * 100u);
+	}
+
+	TEST(MonotonicArenaTest, CopyString) {
+		MonotonicArena arena;
+		std::string source = "hello arena";
+		std::string_view copy = arena.CopyString(source);
+		source.assign("overwritten");
+		EXPECT_EQ("hello arena", copy);
+		EXPECT_TRUE(arena.CopyString(std::string_view()).empty());
+	}
+
+}  // namespace base
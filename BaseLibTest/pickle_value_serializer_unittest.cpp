@@ -0,0 +1,184 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "pch.h"
+#include "pickle_value_serializer.h"
+
+#include <limits>
+#include <memory>
+#include <string>
+
+#include "json/json_reader.h"
+#include "pickle.h"
+#include "values.h"
+
+namespace base {
+
+	namespace {
+
+		std::unique_ptr<Value> RoundTrip(const Value& value) {
+			Pickle pickle;
+			EXPECT_TRUE(PickleValueSerializer(&pickle).Serialize(value));
+			PickleIterator iter(pickle);
+			int error_code = -1;
+			std::string error_message;
+			std::unique_ptr<Value> result =
+				PickleValueDeserializer(&iter).Deserialize(&error_code, &error_message);
+			EXPECT_EQ(-1, error_code) << error_message;
+			return result;
+		}
+
+		// Returns the error from deserializing a pickle that holds the version and
+		// |data|.
+		int DeserializeError(const std::string& data, int version = 1) {
+			Pickle pickle;
+			pickle.WriteInt(version);
+			pickle.WriteData(data.data(), static_cast<int>(data.size()));
+			PickleIterator iter(pickle);
+			int error_code = PickleValueDeserializer::kNoError;
+			std::string error_message;
+			EXPECT_FALSE(PickleValueDeserializer(&iter).Deserialize(&error_code,
+				&error_message));
+			EXPECT_FALSE(error_message.empty());
+			return error_code;
+		}
+
+	}  // namespace
+
+	TEST(PickleValueSerializerTest, RoundTrip) {
+		Value dict(Value::Type::DICTIONARY);
+		dict.SetKey("null", Value());
+		dict.SetKey("false", Value(false));
+		dict.SetKey("true", Value(true));
+		dict.SetKey("zero", Value(0));
+		dict.SetKey("min", Value(std::numeric_limits<int>::min()));
+		dict.SetKey("max", Value(std::numeric_limits<int>::max()));
+		dict.SetKey("negative", Value(-300));
+		dict.SetKey("double", Value(0.1));
+		dict.SetKey("tiny", Value(std::numeric_limits<double>::denorm_min()));
+		dict.SetKey("string", Value("caf\xC3\xA9"));
+		dict.SetKey("empty string", Value(""));
+		dict.SetKey("binary", Value(Value::BlobStorage{ 0, 1, 0xFF, '"' }));
+		dict.SetKey("empty list", Value(Value::Type::LIST));
+		dict.SetKey("empty dict", Value(Value::Type::DICTIONARY));
+		Value list(Value::Type::LIST);
+		list.Append(1);
+		list.Append("two");
+		list.Append(dict.Clone());
+		dict.SetKey("list", std::move(list));
+
+		std::unique_ptr<Value> result = RoundTrip(dict);
+		ASSERT_TRUE(result);
+		EXPECT_EQ(dict, *result);
+
+		for (const Value& scalar : { Value(), Value(42), Value("root"), Value(2.5) }) {
+			result = RoundTrip(scalar);
+			ASSERT_TRUE(result);
+			EXPECT_EQ(scalar, *result);
+		}
+	}
+
+	TEST(PickleValueSerializerTest, RoundTripJSON) {
+		const std::optional<Value> value = JSONReader::Read(R"({
+			"records": [{"id": 1, "tags": ["a", "b"], "score": 0.25},
+						{"id": 2, "tags": [], "score": -1e300}],
+			"meta": {"count": 2, "next": null}
+		})");
+		ASSERT_TRUE(value);
+		std::unique_ptr<Value> result = RoundTrip(*value);
+		ASSERT_TRUE(result);
+		EXPECT_EQ(*value, *result);
+	}
+
+	TEST(PickleValueSerializerTest, SeveralValuesInOnePickle) {
+		Pickle pickle;
+		pickle.WriteString("before");
+		ASSERT_TRUE(PickleValueSerializer(&pickle).Serialize(Value(1)));
+		ASSERT_TRUE(PickleValueSerializer(&pickle).Serialize(Value("second")));
+		pickle.WriteInt(7);
+
+		PickleIterator iter(pickle);
+		std::string before;
+		ASSERT_TRUE(iter.ReadString(&before));
+		PickleValueDeserializer deserializer(&iter);
+		EXPECT_EQ(Value(1), *deserializer.Deserialize(nullptr, nullptr));
+		EXPECT_EQ(Value("second"), *deserializer.Deserialize(nullptr, nullptr));
+		int after;
+		ASSERT_TRUE(iter.ReadInt(&after));
+		EXPECT_EQ(7, after);
+	}
+
+	TEST(PickleValueSerializerTest, TooDeep) {
+		Value value(Value::Type::LIST);
+		for (int i = 0; i < 250; ++i) {
+			Value outer(Value::Type::LIST);
+			outer.Append(std::move(value));
+			value = std::move(outer);
+		}
+		Pickle pickle;
+		EXPECT_FALSE(PickleValueSerializer(&pickle).Serialize(value));
+		EXPECT_EQ(0u, pickle.payload_size());
+
+		// Hand-encode the same nesting, which the deserializer must reject.
+		std::string data;
+		for (int i = 0; i < 250; ++i)
+			data += "\x07\x01";
+		data.back() = '\0';
+		EXPECT_EQ(PickleValueDeserializer::kTooMuchNesting, DeserializeError(data));
+	}
+
+	TEST(PickleValueSerializerTest, InvalidData) {
+		// An empty pickle, and an unsupported version.
+		{
+			Pickle pickle;
+			PickleIterator iter(pickle);
+			int error_code = PickleValueDeserializer::kNoError;
+			EXPECT_FALSE(PickleValueDeserializer(&iter).Deserialize(&error_code,
+				nullptr));
+			EXPECT_EQ(PickleValueDeserializer::kInvalidHeader, error_code);
+		}
+		EXPECT_EQ(PickleValueDeserializer::kInvalidHeader,
+			DeserializeError(std::string(1, '\0'), 2));
+
+		EXPECT_EQ(PickleValueDeserializer::kTruncated, DeserializeError(""));
+		// A string of five bytes holding two.
+		EXPECT_EQ(PickleValueDeserializer::kTruncated,
+			DeserializeError("\x05\x05" "ab"));
+		// A list claiming more elements than there are bytes left.
+		EXPECT_EQ(PickleValueDeserializer::kTruncated,
+			DeserializeError("\x07\xFF\xFF\xFF\xFF\x0F"));
+		EXPECT_EQ(PickleValueDeserializer::kTruncated,
+			DeserializeError(std::string("\x04\x00\x00\x00", 4)));
+
+		EXPECT_EQ(PickleValueDeserializer::kInvalidEncoding,
+			DeserializeError("\x09"));
+		// An integer out of range.
+		EXPECT_EQ(PickleValueDeserializer::kInvalidEncoding,
+			DeserializeError("\x03\xFF\xFF\xFF\xFF\x10"));
+
+		// {"b": null, "a": null}, and a duplicate key.
+		EXPECT_EQ(PickleValueDeserializer::kUnsortedKeys,
+			DeserializeError(std::string("\x08\x02\x01" "b\x00\x01" "a\x00", 8)));
+		EXPECT_EQ(PickleValueDeserializer::kUnsortedKeys,
+			DeserializeError(std::string("\x08\x02\x01" "a\x00\x01" "a\x00", 8)));
+
+		EXPECT_EQ(PickleValueDeserializer::kTrailingData,
+			DeserializeError(std::string("\x00\x00", 2)));
+	}
+
+	TEST(PickleValueSerializerTest, InvalidValues) {
+		// NaN and infinity, which Value cannot hold.
+		EXPECT_EQ(PickleValueDeserializer::kInvalidEncoding,
+			DeserializeError(std::string("\x04\x00\x00\x00\x00\x00\x00\xF8\x7F", 9)));
+		EXPECT_EQ(PickleValueDeserializer::kInvalidEncoding,
+			DeserializeError(std::string("\x04\x00\x00\x00\x00\x00\x00\xF0\xFF", 9)));
+
+		// A string and a dictionary key that are not UTF-8.
+		EXPECT_EQ(PickleValueDeserializer::kInvalidEncoding,
+			DeserializeError("\x05\x01\xFF"));
+		EXPECT_EQ(PickleValueDeserializer::kInvalidEncoding,
+			DeserializeError(std::string("\x08\x01\x01\xFF\x00", 5)));
+	}
+
+}  // namespace base
@@ -0,0 +1,169 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "pch.h"
+#include "strings/multi_string_matcher.h"
+
+#include <string>
+#include <vector>
+
+#include "rand_util.h"
+
+namespace base {
+
+	namespace {
+
+		// The leftmost-longest match at or after |pos|, the slow way.
+		std::optional<MultiStringMatcher::Match> NaiveFindFirst(
+			const std::vector<std::string_view>& patterns,
+			std::string_view text,
+			size_t pos) {
+			for (size_t offset = pos; offset < text.size(); ++offset) {
+				std::optional<MultiStringMatcher::Match> best;
+				for (size_t i = 0; i < patterns.size(); ++i) {
+					if (patterns[i].empty() ||
+						text.substr(offset, patterns[i].size()) != patterns[i]) {
+						continue;
+					}
+					if (!best || patterns[i].size() > best->length)
+						best = MultiStringMatcher::Match{ i, offset, patterns[i].size() };
+				}
+				if (best)
+					return best;
+			}
+			return std::nullopt;
+		}
+
+		std::string RandomString(size_t length, const char* alphabet) {
+			std::string result;
+			for (size_t i = 0; i < length; ++i)
+				result += alphabet[RandGenerator(strlen(alphabet))];
+			return result;
+		}
+
+	}  // namespace
+
+	TEST(MultiStringMatcherTest, FindSubstring) {
+		const std::string text = "abcabcabd" + std::string(100, 'a') + "abd";
+		EXPECT_EQ(0u, internal::FindSubstring(text, "", 0));
+		EXPECT_EQ(5u, internal::FindSubstring(text, "", 5));
+		EXPECT_EQ(std::string_view::npos,
+			internal::FindSubstring(text, "", text.size() + 1));
+		EXPECT_EQ(6u, internal::FindSubstring(text, "abd", 0));
+		EXPECT_EQ(text.size() - 3, internal::FindSubstring(text, "abd", 7));
+		EXPECT_EQ(std::string_view::npos, internal::FindSubstring(text, "abe", 0));
+		EXPECT_EQ(std::string_view::npos, internal::FindSubstring("ab", "abc", 0));
+
+		// Every pattern length and start position, across the vector widths.
+		const std::string haystack = RandomString(200, "ab");
+		for (size_t length = 1; length < 40; ++length) {
+			for (size_t start = 0; start + length <= haystack.size(); start += 7) {
+				const std::string pattern = haystack.substr(start, length);
+				for (size_t pos = 0; pos <= haystack.size(); pos += 13) {
+					EXPECT_EQ(haystack.find(pattern, pos),
+						internal::FindSubstring(haystack, pattern, pos))
+						<< pattern << " from " << pos;
+				}
+			}
+		}
+	}
+
+	TEST(MultiStringMatcherTest, LeftmostLongest) {
+		const MultiStringMatcher matcher({ "bc", "abcd", "ab", "c" });
+		auto match = matcher.FindFirst("xabcd");
+		ASSERT_TRUE(match);
+		EXPECT_EQ(1u, match->pattern);
+		EXPECT_EQ(1u, match->offset);
+		EXPECT_EQ(4u, match->length);
+
+		// "abcd" fails, so the earlier "ab" wins over the longer "bc".
+		match = matcher.FindFirst("xabce");
+		ASSERT_TRUE(match);
+		EXPECT_EQ(2u, match->pattern);
+		EXPECT_EQ(1u, match->offset);
+
+		match = matcher.FindFirst("xabce", 2);
+		ASSERT_TRUE(match);
+		EXPECT_EQ(0u, match->pattern);
+		EXPECT_EQ(2u, match->offset);
+
+		EXPECT_FALSE(matcher.FindFirst("xyz"));
+		EXPECT_FALSE(matcher.FindFirst("abc", 4));
+	}
+
+	TEST(MultiStringMatcherTest, EmptyAndDuplicatePatterns) {
+		EXPECT_FALSE(MultiStringMatcher({}).FindFirst("abc"));
+		EXPECT_FALSE(MultiStringMatcher({ "" }).FindFirst("abc"));
+
+		const MultiStringMatcher single({ "", "b", "b" });
+		auto match = single.FindFirst("abc");
+		ASSERT_TRUE(match);
+		EXPECT_EQ(1u, match->pattern);
+		EXPECT_EQ(1u, match->offset);
+
+		const MultiStringMatcher multiple({ "c", "", "b", "b" });
+		match = multiple.FindFirst("abc");
+		ASSERT_TRUE(match);
+		EXPECT_EQ(2u, match->pattern);
+		EXPECT_EQ(1u, match->offset);
+	}
+
+	TEST(MultiStringMatcherTest, FindAllMatchesNaive) {
+		for (int round = 0; round < 200; ++round) {
+			std::vector<std::string> storage;
+			const size_t pattern_count = 1 + RandGenerator(12);
+			for (size_t i = 0; i < pattern_count; ++i)
+				storage.push_back(RandomString(RandGenerator(5), "abcd"));
+			const std::vector<std::string_view> patterns(storage.begin(),
+				storage.end());
+			const std::string text = RandomString(RandGenerator(300), "abcde");
+
+			const MultiStringMatcher matcher(patterns);
+			std::vector<MultiStringMatcher::Match> expected;
+			size_t pos = 0;
+			while (auto match = NaiveFindFirst(patterns, text, pos)) {
+				expected.push_back(*match);
+				pos = match->offset + match->length;
+			}
+			const auto matches = matcher.FindAll(text);
+			ASSERT_EQ(expected.size(), matches.size()) << text;
+			for (size_t i = 0; i < matches.size(); ++i) {
+				EXPECT_EQ(storage[expected[i].pattern], storage[matches[i].pattern]);
+				EXPECT_EQ(expected[i].offset, matches[i].offset);
+				EXPECT_EQ(expected[i].length, matches[i].length);
+			}
+		}
+	}
+
+	TEST(MultiStringMatcherTest, ReplaceAll) {
+		const MultiStringMatcher matcher({ "{{name}}", "{{id}}", "{{" });
+		const std::string_view replacements[] = { "{{id}}", "42", "<" };
+
+		std::string text = "{{name}} is {{id}}, {{unknown}}";
+		EXPECT_EQ(3u, matcher.ReplaceAll(&text, replacements));
+		// The "{{id}}" that replaced "{{name}}" is not expanded again.
+		EXPECT_EQ("{{id}} is 42, <unknown}}", text);
+
+		text = "nothing to see";
+		EXPECT_EQ(0u, matcher.ReplaceAll(&text, replacements));
+		EXPECT_EQ("nothing to see", text);
+	}
+
+	TEST(MultiStringMatcherTest, ManyFirstBytes) {
+		// More distinct first bytes than FindFirstOf() takes at once.
+		std::vector<std::string> storage;
+		for (char c = 'a'; c <= 'z'; ++c)
+			storage.push_back(std::string(1, c) + "!");
+		const std::vector<std::string_view> patterns(storage.begin(),
+			storage.end());
+		const MultiStringMatcher matcher(patterns);
+		const auto matches = matcher.FindAll("a! b c! zz!");
+		ASSERT_EQ(3u, matches.size());
+		EXPECT_EQ(0u, matches[0].pattern);
+		EXPECT_EQ(2u, matches[1].pattern);
+		EXPECT_EQ(25u, matches[2].pattern);
+		EXPECT_EQ(9u, matches[2].offset);
+	}
+
+}  // namespace base
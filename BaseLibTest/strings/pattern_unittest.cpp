@@ -0,0 +1,175 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "pch.h"
+#include "strings/pattern.h"
+
+#include <string>
+
+#include "rand_util.h"
+
+namespace base {
+
+	namespace {
+
+		// Matches the bytes of |eval| against |pattern| by trying every split,
+		// with ? matching zero or one character and \ escaping, as in
+		// MatchPattern().
+		bool NaiveMatch(std::string_view eval, std::string_view pattern) {
+			if (pattern.empty())
+				return eval.empty();
+			if (pattern[0] == '\\' && pattern.size() > 1) {
+				return !eval.empty() && eval[0] == pattern[1] &&
+					NaiveMatch(eval.substr(1), pattern.substr(2));
+			}
+			if (pattern[0] == '\\')
+				return eval.empty();
+			if (pattern[0] == '*') {
+				for (size_t i = 0; i <= eval.size(); ++i) {
+					if (NaiveMatch(eval.substr(i), pattern.substr(1)))
+						return true;
+				}
+				return false;
+			}
+			if (pattern[0] == '?') {
+				return NaiveMatch(eval, pattern.substr(1)) ||
+					(!eval.empty() && NaiveMatch(eval.substr(1), pattern.substr(1)));
+			}
+			return !eval.empty() && eval[0] == pattern[0] &&
+				NaiveMatch(eval.substr(1), pattern.substr(1));
+		}
+
+		std::string RandomString(size_t length, const char* alphabet) {
+			std::string result;
+			for (size_t i = 0; i < length; ++i)
+				result += alphabet[RandGenerator(strlen(alphabet))];
+			return result;
+		}
+
+		bool CompiledMatch(std::string_view eval, std::string_view pattern) {
+			return CompiledPattern(pattern).Match(eval);
+		}
+
+	}  // namespace
+
+	TEST(StringUtilTest, MatchPatternTest) {
+		EXPECT_TRUE(MatchPattern("www.google.com", "*.com"));
+		EXPECT_TRUE(MatchPattern("www.google.com", "*"));
+		EXPECT_FALSE(MatchPattern("www.google.com", "www*.g*.org"));
+		EXPECT_TRUE(MatchPattern("Hello", "H?l?o"));
+		EXPECT_FALSE(MatchPattern("www.google.com", "http://*)"));
+		EXPECT_FALSE(MatchPattern("www.msn.com", "*.COM"));
+		EXPECT_TRUE(MatchPattern("Hello*1234", "He??o\\*1*"));
+		EXPECT_FALSE(MatchPattern("", "*.*"));
+		EXPECT_TRUE(MatchPattern("", "*"));
+		EXPECT_TRUE(MatchPattern("", "?"));
+		EXPECT_TRUE(MatchPattern("", ""));
+		EXPECT_FALSE(MatchPattern("Hello", ""));
+		EXPECT_TRUE(MatchPattern("Hello*", "Hello*"));
+		EXPECT_TRUE(MatchPattern("abcd", "*???"));
+		EXPECT_FALSE(MatchPattern("abcd", "???"));
+		EXPECT_TRUE(MatchPattern("abcb", "a*b"));
+		EXPECT_FALSE(MatchPattern("abcb", "a?b"));
+
+		// Test UTF8 matching.
+		EXPECT_TRUE(MatchPattern("heart: \xe2\x99\xa0", "*\xe2\x99\xa0"));
+		EXPECT_TRUE(MatchPattern("heart: \xe2\x99\xa0.", "heart: ?."));
+		EXPECT_TRUE(MatchPattern("hearts: \xe2\x99\xa0\xe2\x99\xa0", "*"));
+		// Invalid sequences should be handled as a single invalid character.
+		EXPECT_TRUE(MatchPattern("invalid: \xef\xbf\xbe", "invalid: ?"));
+		// If the pattern has invalid characters, it shouldn't match anything.
+		EXPECT_FALSE(MatchPattern("\xf4\x90\x80\x80", "\xf4\x90\x80\x80"));
+
+		// Test UTF16 character matching.
+		EXPECT_TRUE(MatchPattern(L"www.google.com", L"*.com"));
+		EXPECT_TRUE(MatchPattern(L"Hello*1234", L"He??o\\*1*"));
+
+		// Some test cases that might cause naive implementations to exhibit
+		// exponential run time or fail.
+		EXPECT_TRUE(MatchPattern("Hello", "He********************************o"));
+		EXPECT_TRUE(MatchPattern("123456789012345678", "?????????????????*"));
+		EXPECT_TRUE(MatchPattern("aaaaaaaaaaab", "a*a*a*a*a*a*a*a*a*a*a*b"));
+	}
+
+	TEST(CompiledPatternTest, MatchesLikeMatchPattern) {
+		const char* const kCases[][2] = {
+			{ "www.google.com", "*.com" },
+			{ "www.google.com", "www*.g*.org" },
+			{ "Hello", "H?l?o" },
+			{ "www.msn.com", "*.COM" },
+			{ "Hello*1234", "He??o\\*1*" },
+			{ "", "*.*" },
+			{ "", "?" },
+			{ "", "" },
+			{ "Hello", "" },
+			{ "abcd", "*???" },
+			{ "abcd", "???" },
+			{ "abcb", "a?b" },
+			{ "trailing", "trailing\\" },
+			{ "heart: \xe2\x99\xa0", "*\xe2\x99\xa0" },
+			{ "heart: \xe2\x99\xa0.", "heart: ?." },
+			{ "heart: \xe2\x99\xa0.", "heart: \xe2\x99\xa1." },
+			{ "invalid: \xef\xbf\xbe", "invalid: ?" },
+			{ "\xf4\x90\x80\x80", "\xf4\x90\x80\x80" },
+			{ "Hello", "He********************************o" },
+			{ "aaaaaaaaaaab", "a*a*a*a*a*a*a*a*a*a*a*b" },
+		};
+		for (const auto& test_case : kCases) {
+			EXPECT_EQ(MatchPattern(test_case[0], test_case[1]),
+				CompiledMatch(test_case[0], test_case[1]))
+				<< test_case[0] << " against " << test_case[1];
+		}
+	}
+
+	TEST(CompiledPatternTest, MatchesNaive) {
+		for (int round = 0; round < 5000; ++round) {
+			const std::string pattern = RandomString(RandGenerator(10), "ab*?\\");
+			const std::string eval = RandomString(RandGenerator(12), "ab*?\\");
+			EXPECT_EQ(NaiveMatch(eval, pattern), CompiledMatch(eval, pattern))
+				<< eval << " against " << pattern;
+		}
+	}
+
+	TEST(CompiledPatternTest, LongPatterns) {
+		// Patterns longer than one machine word of automaton positions.
+		const std::string eval = RandomString(500, "ab");
+		for (int round = 0; round < 200; ++round) {
+			const size_t start = RandGenerator(eval.size());
+			std::string pattern = "*" + eval.substr(start, 70 + RandGenerator(100));
+			for (int i = 0; i < 5; ++i)
+				pattern[1 + RandGenerator(pattern.size() - 1)] = '?';
+			pattern += "*";
+			EXPECT_TRUE(CompiledMatch(eval, pattern)) << pattern;
+			EXPECT_EQ(NaiveMatch(eval.substr(start), pattern),
+				CompiledMatch(eval.substr(start), pattern)) << pattern;
+			EXPECT_FALSE(CompiledMatch(eval, pattern + "c"));
+		}
+		EXPECT_TRUE(CompiledMatch(std::string(200, 'a'),
+			std::string(199, '?') + "a"));
+		EXPECT_FALSE(CompiledMatch(std::string(200, 'a'),
+			std::string(198, '?') + "a"));
+	}
+
+	TEST(CompiledPatternTest, FilePathSyntax) {
+		const auto match = [](std::string_view eval, std::string_view pattern) {
+			return CompiledPattern(pattern, CompiledPattern::Syntax::kFilePath)
+				.Match(eval);
+		};
+		// ? matches exactly one character.
+		EXPECT_TRUE(match("blah", "bl?h"));
+		EXPECT_FALSE(match("blh", "bl?h"));
+		EXPECT_TRUE(match("blah", "b*?h"));
+		EXPECT_FALSE(match("bh", "b*?h"));
+		// No escaping, and any slash matches any slash.
+		EXPECT_TRUE(match("bl\\ah", "bl\\?h"));
+		EXPECT_TRUE(match("bl/ah", "bl\\?h"));
+		EXPECT_FALSE(match("bl?h", "bl\\?h"));
+		EXPECT_TRUE(match("\\b/lah", "/b\\lah"));
+		EXPECT_TRUE(match("/foo\\bar/baz\\quux/grault.cc", "*quux/*"));
+		// Bytes, not UTF-8 characters.
+		EXPECT_FALSE(match("\xe2\x99\xa0", "?"));
+		EXPECT_TRUE(match("\xe2\x99\xa0", "???"));
+	}
+
+}  // namespace base
@@ -0,0 +1,74 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "pch.h"
+#include "strings/strcat.h"
+
+#include <string>
+
+#include "strings/string_number_conversions.h"
+#include "strings/stringprintf.h"
+#include "test/perf_test.h"
+#include "timer/lap_timer.h"
+
+namespace base {
+
+	namespace {
+
+		constexpr int kWarmupRuns = 2;
+		constexpr int kTimeCheckInterval = 4;
+		constexpr TimeDelta kTimeLimit = TimeDelta::FromMilliseconds(500);
+		constexpr int kRecords = 10000;
+
+	}  // namespace
+
+	// Builds the same "name#id: value (flags)" record three ways: StringPrintf,
+	// operator+ over NumberToString() temporaries, and StrCat.
+	TEST(StrCatPerfTest, MixedArguments) {
+		const std::string name = "connection";
+		size_t total_size = 0;
+
+		LapTimer printf_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			for (int i = 0; i < kRecords; ++i) {
+				const std::string record = StringPrintf("%s#%d: %g (%X)",
+					name.c_str(), i, i * 0.5, static_cast<unsigned>(i));
+				total_size += record.size();
+			}
+			printf_timer.NextLap();
+		} while (!printf_timer.HasTimeLimitExpired());
+		perf_test::PrintResult("format_record", "_string_printf", "",
+			printf_timer.TimePerLap().InMillisecondsF(), "ms", true);
+
+		LapTimer plus_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			for (int i = 0; i < kRecords; ++i) {
+				const std::string record = name + "#" + NumberToString(i) + ": " +
+					NumberToString(i * 0.5) + " (" +
+					HexEncode(&i, sizeof(i)) + ")";
+				total_size += record.size();
+			}
+			plus_timer.NextLap();
+		} while (!plus_timer.HasTimeLimitExpired());
+		perf_test::PrintResult("format_record", "_operator_plus", "",
+			plus_timer.TimePerLap().InMillisecondsF(), "ms", true);
+
+		LapTimer timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			for (int i = 0; i < kRecords; ++i) {
+				const std::string record =
+					StrCat({ name, "#", i, ": ", i * 0.5, " (", Hex(i), ")" });
+				total_size += record.size();
+			}
+			timer.NextLap();
+		} while (!timer.HasTimeLimitExpired());
+		perf_test::PrintResult("format_record", "_str_cat", "",
+			timer.TimePerLap().InMillisecondsF(), "ms", true);
+		EXPECT_GT(total_size, 0u);
+
+		EXPECT_EQ("connection#26: 13 (1A)",
+			StrCat({ name, "#", 26, ": ", 13.0, " (", Hex(26), ")" }));
+	}
+
+}  // namespace base
@@ -0,0 +1,66 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "pch.h"
+#include "strings/strcat.h"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace base {
+
+	TEST(StrCatTest, Strings) {
+		const std::string str = "string";
+		EXPECT_EQ("a string and a view",
+			StrCat({ "a ", str, " and ", std::string_view("a view") }));
+		EXPECT_EQ(L"wide string", StrCat({ L"wide ", std::wstring(L"string") }));
+	}
+
+	TEST(StrCatTest, Numbers) {
+		EXPECT_EQ("0 -1 42", StrCat({ 0, " ", -1, " ", 42u }));
+		EXPECT_EQ("-9223372036854775808",
+			StrCat({ std::numeric_limits<int64_t>::min() }));
+		EXPECT_EQ("18446744073709551615",
+			StrCat({ std::numeric_limits<uint64_t>::max() }));
+		EXPECT_EQ("size=5", StrCat({ "size=", sizeof(int) + 1 }));
+		EXPECT_EQ("0.5 1e+300 -0", StrCat({ 0.5, " ", 1e300, " ", -0.0 }));
+		EXPECT_EQ("1.5", StrCat({ 1.5f }));
+		// Numbers match NumberToString().
+		EXPECT_EQ(NumberToString(1.0 / 3), StrCat({ 1.0 / 3 }));
+	}
+
+	TEST(StrCatTest, Hex) {
+		EXPECT_EQ("0", StrCat({ Hex(0) }));
+		EXPECT_EQ("0xDEADBEEF", StrCat({ "0x", Hex(0xDEADBEEF) }));
+		EXPECT_EQ("000A", StrCat({ Hex(10, 4) }));
+		EXPECT_EQ("12345", StrCat({ Hex(0x12345, 2) }));
+		EXPECT_EQ("FFFFFFFFFFFFFFFF", StrCat({ Hex(-1) }));
+		EXPECT_EQ(std::string(32, '0'), StrCat({ Hex(0, 32) }));
+		int value;
+		EXPECT_EQ(StrCat({ Hex(reinterpret_cast<uintptr_t>(&value)) }),
+			StrCat({ Hex(&value) }));
+	}
+
+	TEST(StrCatTest, Append) {
+		std::string result = "x=";
+		StrAppend(&result, { 1, ", y=", 2.5, ", id=", Hex(255, 4) });
+		EXPECT_EQ("x=1, y=2.5, id=00FF", result);
+
+		std::wstring wide = L"a";
+		StrAppend(&wide, { L"b", std::wstring(L"c") });
+		EXPECT_EQ(L"abc", wide);
+	}
+
+	TEST(StrCatTest, ManyPieces) {
+		std::string expected;
+		for (int i = 0; i < 100; ++i)
+			expected += NumberToString(i) + ",";
+		std::vector<std::string> pieces;
+		for (int i = 0; i < 100; ++i)
+			pieces.push_back(NumberToString(i) + ",");
+		EXPECT_EQ(expected, StrCat(pieces));
+	}
+
+}  // namespace base
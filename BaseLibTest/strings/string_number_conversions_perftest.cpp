@@ -0,0 +1,190 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "pch.h"
+#include "strings/string_number_conversions.h"
+
+#include <string>
+#include <vector>
+
+#include "test/perf_test.h"
+#include "third_party/double_conversion/double-conversion.h"
+#include "timer/lap_timer.h"
+
+namespace base {
+
+	namespace {
+
+		constexpr int kWarmupRuns = 2;
+		constexpr int kTimeCheckInterval = 4;
+		constexpr TimeDelta kTimeLimit = TimeDelta::FromMilliseconds(500);
+
+		// The fields of a CSV file of measurements: prices, counts, ratios and
+		// the occasional number in scientific notation.
+		std::vector<std::string> GenerateFields() {
+			std::vector<std::string> fields;
+			for (int i = 0; i < 100000; ++i) {
+				switch (i % 4) {
+				case 0:
+					fields.push_back(NumberToString(i % 1000) + "." +
+						NumberToString(i % 90 + 10));
+					break;
+				case 1:
+					fields.push_back(NumberToString(i * 37));
+					break;
+				case 2:
+					fields.push_back(NumberToString(1.0 / (i + 1)));
+					break;
+				default:
+					fields.push_back(NumberToString(i) + "e-" + NumberToString(i % 40));
+					break;
+				}
+			}
+			return fields;
+		}
+
+	}  // namespace
+
+	// Compares StringToDouble() against double_conversion's exact converter,
+	// which it used to call for every input.
+	TEST(StringNumberConversionsPerfTest, StringToDouble) {
+		const std::vector<std::string> fields = GenerateFields();
+		const double_conversion::StringToDoubleConverter converter(
+			double_conversion::StringToDoubleConverter::NO_FLAGS, 0.0, 0, nullptr,
+			nullptr);
+
+		double sum = 0;
+		LapTimer exact_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			for (const std::string& field : fields) {
+				int processed;
+				sum += converter.StringToDouble(field.data(), field.size(),
+					&processed);
+			}
+			exact_timer.NextLap();
+		} while (!exact_timer.HasTimeLimitExpired());
+		perf_test::PrintResult("string_to_double", "_exact", "csv",
+			exact_timer.TimePerLap().InMillisecondsF(), "ms", true);
+
+		LapTimer timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			for (const std::string& field : fields) {
+				double value;
+				ASSERT_TRUE(StringToDouble(field, &value)) << field;
+				sum += value;
+			}
+			timer.NextLap();
+		} while (!timer.HasTimeLimitExpired());
+		perf_test::PrintResult("string_to_double", "", "csv",
+			timer.TimePerLap().InMillisecondsF(), "ms", true);
+		EXPECT_GT(sum, 0);
+	}
+
+	// Compares building a line of numbers from NumberToString() temporaries
+	// against appending them in place.
+	TEST(StringNumberConversionsPerfTest, AppendNumber) {
+		constexpr int kNumbers = 10000;
+		std::string line;
+
+		LapTimer temporary_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			line.clear();
+			for (int i = 0; i < kNumbers; ++i) {
+				line += NumberToString(i * 7919);
+				line += ' ';
+				line += NumberToString(i * 0.25);
+				line += ' ';
+			}
+			temporary_timer.NextLap();
+		} while (!temporary_timer.HasTimeLimitExpired());
+		const std::string expected = line;
+		perf_test::PrintResult("format_numbers", "_number_to_string", "",
+			temporary_timer.TimePerLap().InMillisecondsF(), "ms", true);
+
+		LapTimer timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			line.clear();
+			for (int i = 0; i < kNumbers; ++i) {
+				AppendNumber(&line, i * 7919);
+				line += ' ';
+				AppendNumber(&line, i * 0.25);
+				line += ' ';
+			}
+			timer.NextLap();
+		} while (!timer.HasTimeLimitExpired());
+		perf_test::PrintResult("format_numbers", "_append_number", "",
+			timer.TimePerLap().InMillisecondsF(), "ms", true);
+		EXPECT_EQ(expected, line);
+	}
+
+	// Hex-encodes 16-byte tokens, with and without an allocation per token,
+	// and a 1 MiB buffer, then decodes them back.
+	TEST(StringNumberConversionsPerfTest, Hex) {
+		constexpr int kTokens = 10000;
+		constexpr size_t kTokenSize = 16;
+		constexpr size_t kBufferSize = 1024 * 1024;
+		std::vector<uint8_t> buffer(kBufferSize);
+		for (size_t i = 0; i < buffer.size(); ++i)
+			buffer[i] = static_cast<uint8_t>(i * 7919 >> 3);
+		size_t total_size = 0;
+
+		LapTimer token_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			for (int i = 0; i < kTokens; ++i) {
+				total_size += HexEncode(make_span(buffer).subspan(
+					i * kTokenSize % kBufferSize, kTokenSize)).size();
+			}
+			token_timer.NextLap();
+		} while (!token_timer.HasTimeLimitExpired());
+		perf_test::PrintResult("hex_encode", "_token", "",
+			token_timer.TimePerLap().InMillisecondsF(), "ms", true);
+
+		char token[2 * kTokenSize];
+		LapTimer token_span_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			for (int i = 0; i < kTokens; ++i) {
+				HexEncode(make_span(buffer).subspan(i * kTokenSize % kBufferSize,
+					kTokenSize), token);
+				total_size += token[0];
+			}
+			token_span_timer.NextLap();
+		} while (!token_span_timer.HasTimeLimitExpired());
+		perf_test::PrintResult("hex_encode", "_token_span", "",
+			token_span_timer.TimePerLap().InMillisecondsF(), "ms", true);
+
+		std::string hex;
+		LapTimer buffer_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			hex = HexEncode(buffer);
+			buffer_timer.NextLap();
+		} while (!buffer_timer.HasTimeLimitExpired());
+		perf_test::PrintResult("hex_encode", "_1mib", "",
+			buffer_timer.TimePerLap().InMillisecondsF(), "ms", true);
+		EXPECT_GT(total_size, 0u);
+
+		uint8_t bytes[kTokenSize];
+		LapTimer decode_token_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			for (int i = 0; i < kTokens; ++i) {
+				ASSERT_TRUE(HexStringToSpan(std::string_view(hex).substr(
+					i * 2 * kTokenSize % hex.size(), 2 * kTokenSize), bytes));
+			}
+			decode_token_timer.NextLap();
+		} while (!decode_token_timer.HasTimeLimitExpired());
+		perf_test::PrintResult("hex_decode", "_token_span", "",
+			decode_token_timer.TimePerLap().InMillisecondsF(), "ms", true);
+
+		std::vector<uint8_t> decoded;
+		LapTimer decode_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			decoded.clear();
+			ASSERT_TRUE(HexStringToBytes(hex, &decoded));
+			decode_timer.NextLap();
+		} while (!decode_timer.HasTimeLimitExpired());
+		perf_test::PrintResult("hex_decode", "_1mib", "",
+			decode_timer.TimePerLap().InMillisecondsF(), "ms", true);
+		EXPECT_EQ(buffer, decoded);
+	}
+
+}  // namespace base
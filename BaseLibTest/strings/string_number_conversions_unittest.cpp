@@ -13,12 +13,16 @@
 
 #include <cmath>
 #include <limits>
+#include <string>
+#include <vector>
 
 #include "bit_cast.h"
 #include "format_macros.h"
 #include "stl_util.h"
+#include "strings/string_util.h"
 #include "strings/stringprintf.h"
 #include "strings/utf_string_conversions.h"
+#include "third_party/double_conversion/double-conversion.h"
 
 namespace base {
 
@@ -65,6 +69,43 @@ namespace base {
 		}
 	}
 
+	TEST(StringNumberConversionsTest, ToCharsAndAppendNumber) {
+		char buffer[kMaxNumberChars];
+		std::string appended = "x";
+		std::string expected = "x";
+		const auto check = [&](auto value) {
+			const std::string str = NumberToString(value);
+			EXPECT_EQ(str, std::string(buffer, ToChars(value, buffer)));
+			AppendNumber(&appended, value);
+			expected += str;
+		};
+
+		for (const int value :
+			{ 0, 7, 10, 99, 100, -1, -10, -100, INT_MAX, INT_MIN }) {
+			check(value);
+		}
+		check(std::numeric_limits<unsigned>::max());
+		check(std::numeric_limits<long>::min());
+		check(std::numeric_limits<unsigned long>::max());
+		check(std::numeric_limits<int64_t>::min());
+		check(std::numeric_limits<int64_t>::max());
+		check(std::numeric_limits<uint64_t>::max());
+		for (uint64_t value = 1; value < std::numeric_limits<uint64_t>::max() / 10;
+			 value *= 10) {
+			check(value - 1);
+			check(value);
+		}
+
+		// The longest shortest forms.
+		for (const double value :
+			{ 0.0, -0.0, 0.1, -1.5, 1e21, 1e-7, 123456789012.0,
+			 -2.2250738585072014e-308, -1.7976931348623157e308,
+			 -0.0000012345678901234567, 4.9e-324 }) {
+			check(value);
+		}
+		EXPECT_EQ(expected, appended);
+	}
+
 	TEST(StringNumberConversionsTest, Uint64ToString) {
 		static const struct {
 			uint64_t input;
@@ -807,6 +848,59 @@ namespace base {
 		EXPECT_DOUBLE_EQ(3.14, output);
 	}
 
+	// StringToDouble() converts most numbers without double_conversion, and
+	// must give the same results bit for bit.
+	TEST(StringNumberConversionsTest, StringToDoubleMatchesDoubleConversion) {
+		const double_conversion::StringToDoubleConverter converter(
+			double_conversion::StringToDoubleConverter::ALLOW_TRAILING_JUNK, 0.0,
+			0, nullptr, nullptr);
+		const auto expect_same = [&converter](const std::string& input) {
+			int processed = 0;
+			const double expected =
+				converter.StringToDouble(input.data(), input.size(), &processed);
+			double output = 0;
+			const bool success = StringToDouble(input, &output);
+			EXPECT_EQ(bit_cast<uint64_t>(expected), bit_cast<uint64_t>(output))
+				<< input;
+			EXPECT_EQ(static_cast<size_t>(processed) == input.size() &&
+				std::isfinite(expected), success) << input;
+		};
+
+		// Rounding boundaries, subnormals and the extremes of the exponent.
+		for (const char* input :
+			{ "9007199254740993", "9007199254740993.0", "9007199254740995",
+			 "4.9e-324", "2.4703282292062327e-324", "2.2250738585072011e-308",
+			 "2.2250738585072014e-308", "1.7976931348623157e308",
+			 "1.7976931348623158e308", "1e-342", "1e-343", "1e308", "1e309",
+			 "7.2057594037927933e16", "1e23", "8.98846567431158e307",
+			 "0.1", "0.3", "123456789012345678", "1234567890123456789",
+			 "12345678901234567890", "0.0000000000000000000000000001234",
+			 "1.e5", ".5e-3", "-.5", "+5e+5", "5e", "5e+", "1.5e3x",
+			 "00000000000000000000000000000000001e2" }) {
+			expect_same(input);
+		}
+
+		// Random mantissas of every length with random exponents, and the
+		// shortest and 17-digit forms of random doubles.
+		uint64_t state = 42;
+		const auto next = [&state] {
+			state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+			return state;
+		};
+		for (int i = 0; i < 100000; ++i) {
+			std::string input = NumberToString(next()).substr(0, next() % 20 + 1);
+			input.insert(next() % (input.size() + 1), ".");
+			input += "e" + NumberToString(static_cast<int>(next() % 700) - 360);
+			expect_same(input);
+
+			const double value = bit_cast<double>(next());
+			if (!std::isfinite(value))
+				continue;
+			expect_same(NumberToString(value));
+			expect_same(StringPrintf("%.17g", value));
+		}
+	}
+
 	TEST(StringNumberConversionsTest, DoubleToString) {
 		static const struct {
 			double input;
@@ -846,6 +940,67 @@ namespace base {
 		EXPECT_EQ(hex.compare("01FF02FE038081"), 0);
 	}
 
+	// Long enough for every vector width, with a tail of every length.
+	TEST(StringNumberConversionsTest, HexEncodeLongInputs) {
+		std::vector<uint8_t> bytes(200);
+		for (size_t i = 0; i < bytes.size(); ++i)
+			bytes[i] = static_cast<uint8_t>(i * 37 + 11);
+		for (size_t size = 0; size <= bytes.size(); ++size) {
+			std::string expected;
+			for (size_t i = 0; i < size; ++i)
+				expected += StringPrintf("%02X", bytes[i]);
+			const auto input = make_span(bytes.data(), size);
+			EXPECT_EQ(expected, HexEncode(input)) << size;
+
+			std::string output(2 * size + 1, '!');
+			HexEncode(input, make_span(&output[0], 2 * size));
+			EXPECT_EQ(expected + "!", output) << size;
+		}
+	}
+
+	TEST(StringNumberConversionsTest, HexStringToBytesLongInputs) {
+		std::vector<uint8_t> bytes(100);
+		for (size_t i = 0; i < bytes.size(); ++i)
+			bytes[i] = static_cast<uint8_t>(i * 53 + 7);
+		const std::string upper = HexEncode(bytes);
+		const std::string lower = ToLowerASCII(upper);
+		for (const std::string& hex : { upper, lower }) {
+			std::vector<uint8_t> output;
+			EXPECT_TRUE(HexStringToBytes(hex, &output));
+			EXPECT_EQ(bytes, output);
+
+			std::vector<uint8_t> span_output(bytes.size());
+			EXPECT_TRUE(HexStringToSpan(hex, span_output));
+			EXPECT_EQ(bytes, span_output);
+		}
+
+		// The bytes before an invalid character are still decoded.
+		for (size_t i = 0; i < upper.size(); ++i) {
+			for (const char c : { 'G', 'g', '/', ':', '@', '`', ' ', '\xff' }) {
+				std::string hex = upper;
+				hex[i] = c;
+				std::vector<uint8_t> output;
+				EXPECT_FALSE(HexStringToBytes(hex, &output)) << i;
+				EXPECT_EQ(std::vector<uint8_t>(bytes.begin(), bytes.begin() + i / 2),
+					output) << i;
+				std::vector<uint8_t> span_output(bytes.size());
+				EXPECT_FALSE(HexStringToSpan(hex, span_output)) << i;
+			}
+		}
+	}
+
+	TEST(StringNumberConversionsTest, HexStringToSpan) {
+		uint8_t output[4] = {};
+		EXPECT_TRUE(HexStringToSpan("deadBEEF", output));
+		EXPECT_EQ(0xde, output[0]);
+		EXPECT_EQ(0xef, output[3]);
+		// |output| must be exactly half the size of the input.
+		EXPECT_FALSE(HexStringToSpan("dead", output));
+		EXPECT_FALSE(HexStringToSpan("deadbeef00", output));
+		EXPECT_FALSE(HexStringToSpan("", span<uint8_t>()));
+		EXPECT_FALSE(HexStringToSpan("dea", make_span(output, 1)));
+	}
+
 	// Test cases of known-bad strtod conversions that motivated the use of dmg_fp.
 	// See https://bugs.chromium.org/p/chromium/issues/detail?id=593512.
 	TEST(StringNumberConversionsTest, StrtodFailures) {
@@ -0,0 +1,92 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "pch.h"
+#include "strings/string_split.h"
+
+#include <string>
+
+#include "strings/string_number_conversions.h"
+#include "strings/string_tokenizer.h"
+#include "test/perf_test.h"
+#include "timer/lap_timer.h"
+
+namespace base {
+
+	namespace {
+
+		constexpr int kWarmupRuns = 2;
+		constexpr int kTimeCheckInterval = 4;
+		constexpr TimeDelta kTimeLimit = TimeDelta::FromMilliseconds(500);
+
+		// A delimited log export: one record per line, fields separated by tabs,
+		// tags by semicolons.
+		std::string GenerateFile() {
+			std::string file;
+			for (int i = 0; i < 50000; ++i) {
+				file += "2020-06-01T12:00:00.";
+				AppendNumber(&file, i % 1000);
+				file += "Z\tnetwork.request\thttps://example.com/resources/item/";
+				AppendNumber(&file, i);
+				file += "\tstatus=200;cached=false;bytes=";
+				AppendNumber(&file, i * 31);
+				file += '\n';
+			}
+			return file;
+		}
+
+	}  // namespace
+
+	// Adds up the field sizes of every line, first collecting lines and fields
+	// in vectors, then with the lazy range, then with StringTokenizer.
+	TEST(StringSplitPerfTest, DelimitedFile) {
+		const std::string file = GenerateFile();
+		size_t expected_size = 0;
+
+		LapTimer vector_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			expected_size = 0;
+			for (const auto line : SplitStringPiece(file, "\n", KEEP_WHITESPACE,
+				SPLIT_WANT_NONEMPTY)) {
+				for (const auto field : SplitStringPiece(line, "\t;",
+					KEEP_WHITESPACE, SPLIT_WANT_ALL)) {
+					expected_size += field.size();
+				}
+			}
+			vector_timer.NextLap();
+		} while (!vector_timer.HasTimeLimitExpired());
+		perf_test::PrintResult("split_file", "_vector", "",
+			vector_timer.TimePerLap().InMillisecondsF(), "ms", true);
+
+		size_t size = 0;
+		LapTimer range_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			size = 0;
+			for (const auto line : SplitStringPieceRange(file, "\n",
+				KEEP_WHITESPACE, SPLIT_WANT_NONEMPTY)) {
+				for (const auto field : SplitStringPieceRange(line, "\t;",
+					KEEP_WHITESPACE, SPLIT_WANT_ALL)) {
+					size += field.size();
+				}
+			}
+			range_timer.NextLap();
+		} while (!range_timer.HasTimeLimitExpired());
+		perf_test::PrintResult("split_file", "_range", "",
+			range_timer.TimePerLap().InMillisecondsF(), "ms", true);
+		EXPECT_EQ(expected_size, size);
+
+		LapTimer tokenizer_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			size = 0;
+			StringTokenizer tokenizer(file, "\t;\n");
+			while (tokenizer.GetNext())
+				size += tokenizer.token_piece().size();
+			tokenizer_timer.NextLap();
+		} while (!tokenizer_timer.HasTimeLimitExpired());
+		perf_test::PrintResult("split_file", "_tokenizer", "",
+			tokenizer_timer.TimePerLap().InMillisecondsF(), "ms", true);
+		EXPECT_EQ(expected_size, size);
+	}
+
+}  // namespace base
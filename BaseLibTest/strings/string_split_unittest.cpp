@@ -11,8 +11,6 @@
 #include "strings/string_util.h"
 #include "strings/utf_string_conversions.h"
 
-//using ::testing::ElementsAre;
-
 namespace base {
 
 	class SplitStringIntoKeyValuePairsTest : public testing::Test {
@@ -213,7 +211,7 @@ namespace base {
 		std::vector<std::string> results = SplitStringUsingSubstr(
 			std::string(), "DELIMITER", TRIM_WHITESPACE, SPLIT_WANT_ALL);
 		ASSERT_EQ(1u, results.size());
-		EXPECT_THAT(results, ElementsAre(""));
+		EXPECT_EQ((std::vector<std::string>{ "" }), results);
 	}
 
 	TEST(StringUtilTest, SplitString_Basics) {
@@ -295,7 +293,7 @@ namespace base {
 			"alongwordwithnodelimiter", "DELIMITER", TRIM_WHITESPACE,
 			SPLIT_WANT_ALL);
 		ASSERT_EQ(1u, results.size());
-		EXPECT_THAT(results, ElementsAre("alongwordwithnodelimiter"));
+		EXPECT_EQ((std::vector<std::string>{ "alongwordwithnodelimiter" }), results);
 	}
 
 	TEST(SplitStringUsingSubstrTest, LeadingDelimitersSkipped) {
@@ -303,7 +301,7 @@ namespace base {
 			"DELIMITERDELIMITERDELIMITERoneDELIMITERtwoDELIMITERthree",
 			"DELIMITER", TRIM_WHITESPACE, SPLIT_WANT_ALL);
 		ASSERT_EQ(6u, results.size());
-		EXPECT_THAT(results, ElementsAre("", "", "", "one", "two", "three"));
+		EXPECT_EQ((std::vector<std::string>{ "", "", "", "one", "two", "three" }), results);
 	}
 
 	TEST(SplitStringUsingSubstrTest, ConsecutiveDelimitersSkipped) {
@@ -311,7 +309,9 @@ namespace base {
 			"unoDELIMITERDELIMITERDELIMITERdosDELIMITERtresDELIMITERDELIMITERcuatro",
 			"DELIMITER", TRIM_WHITESPACE, SPLIT_WANT_ALL);
 		ASSERT_EQ(7u, results.size());
-		EXPECT_THAT(results, ElementsAre("uno", "", "", "dos", "tres", "", "cuatro"));
+		EXPECT_EQ((std::vector<std::string>{
+			"uno", "", "", "dos", "tres", "", "cuatro" }),
+			results);
 	}
 
 	TEST(SplitStringUsingSubstrTest, TrailingDelimitersSkipped) {
@@ -319,8 +319,9 @@ namespace base {
 			"unDELIMITERdeuxDELIMITERtroisDELIMITERquatreDELIMITERDELIMITERDELIMITER",
 			"DELIMITER", TRIM_WHITESPACE, SPLIT_WANT_ALL);
 		ASSERT_EQ(7u, results.size());
-		EXPECT_THAT(
-			results, ElementsAre("un", "deux", "trois", "quatre", "", "", ""));
+		EXPECT_EQ((std::vector<std::string>{
+			"un", "deux", "trois", "quatre", "", "", "" }),
+			results);
 	}
 
 	TEST(SplitStringPieceUsingSubstrTest, StringWithNoDelimiter) {
@@ -328,7 +329,7 @@ namespace base {
 			SplitStringPieceUsingSubstr("alongwordwithnodelimiter", "DELIMITER",
 				base::TRIM_WHITESPACE, base::SPLIT_WANT_ALL);
 		ASSERT_EQ(1u, results.size());
-		EXPECT_THAT(results, ElementsAre("alongwordwithnodelimiter"));
+		EXPECT_EQ((std::vector<std::string_view>{ "alongwordwithnodelimiter" }), results);
 	}
 
 	TEST(SplitStringPieceUsingSubstrTest, LeadingDelimitersSkipped) {
@@ -336,7 +337,9 @@ namespace base {
 			"DELIMITERDELIMITERDELIMITERoneDELIMITERtwoDELIMITERthree", "DELIMITER",
 			base::TRIM_WHITESPACE, base::SPLIT_WANT_ALL);
 		ASSERT_EQ(6u, results.size());
-		EXPECT_THAT(results, ElementsAre("", "", "", "one", "two", "three"));
+		EXPECT_EQ((std::vector<std::string_view>{
+			"", "", "", "one", "two", "three" }),
+			results);
 	}
 
 	TEST(SplitStringPieceUsingSubstrTest, ConsecutiveDelimitersSkipped) {
@@ -344,7 +347,9 @@ namespace base {
 			"unoDELIMITERDELIMITERDELIMITERdosDELIMITERtresDELIMITERDELIMITERcuatro",
 			"DELIMITER", base::TRIM_WHITESPACE, base::SPLIT_WANT_ALL);
 		ASSERT_EQ(7u, results.size());
-		EXPECT_THAT(results, ElementsAre("uno", "", "", "dos", "tres", "", "cuatro"));
+		EXPECT_EQ((std::vector<std::string_view>{
+			"uno", "", "", "dos", "tres", "", "cuatro" }),
+			results);
 	}
 
 	TEST(SplitStringPieceUsingSubstrTest, TrailingDelimitersSkipped) {
@@ -352,8 +357,9 @@ namespace base {
 			"unDELIMITERdeuxDELIMITERtroisDELIMITERquatreDELIMITERDELIMITERDELIMITER",
 			"DELIMITER", base::TRIM_WHITESPACE, base::SPLIT_WANT_ALL);
 		ASSERT_EQ(7u, results.size());
-		EXPECT_THAT(results,
-			ElementsAre("un", "deux", "trois", "quatre", "", "", ""));
+		EXPECT_EQ((std::vector<std::string_view>{
+			"un", "deux", "trois", "quatre", "", "", "" }),
+			results);
 	}
 
 	TEST(SplitStringPieceUsingSubstrTest, KeepWhitespace) {
@@ -361,7 +367,9 @@ namespace base {
 			"un DELIMITERdeux\tDELIMITERtrois\nDELIMITERquatre", "DELIMITER",
 			base::KEEP_WHITESPACE, base::SPLIT_WANT_ALL);
 		ASSERT_EQ(4u, results.size());
-		EXPECT_THAT(results, ElementsAre("un ", "deux\t", "trois\n", "quatre"));
+		EXPECT_EQ((std::vector<std::string_view>{
+			"un ", "deux\t", "trois\n", "quatre" }),
+			results);
 	}
 
 	TEST(SplitStringPieceUsingSubstrTest, TrimWhitespace) {
@@ -369,7 +377,7 @@ namespace base {
 			"un DELIMITERdeux\tDELIMITERtrois\nDELIMITERquatre", "DELIMITER",
 			base::TRIM_WHITESPACE, base::SPLIT_WANT_ALL);
 		ASSERT_EQ(4u, results.size());
-		EXPECT_THAT(results, ElementsAre("un", "deux", "trois", "quatre"));
+		EXPECT_EQ((std::vector<std::string_view>{ "un", "deux", "trois", "quatre" }), results);
 	}
 
 	TEST(SplitStringPieceUsingSubstrTest, SplitWantAll) {
@@ -377,7 +385,7 @@ namespace base {
 			"unDELIMITERdeuxDELIMITERtroisDELIMITERDELIMITER", "DELIMITER",
 			base::TRIM_WHITESPACE, base::SPLIT_WANT_ALL);
 		ASSERT_EQ(5u, results.size());
-		EXPECT_THAT(results, ElementsAre("un", "deux", "trois", "", ""));
+		EXPECT_EQ((std::vector<std::string_view>{ "un", "deux", "trois", "", "" }), results);
 	}
 
 	TEST(SplitStringPieceUsingSubstrTest, SplitWantNonEmpty) {
@@ -385,7 +393,7 @@ namespace base {
 			"unDELIMITERdeuxDELIMITERtroisDELIMITERDELIMITER", "DELIMITER",
 			base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
 		ASSERT_EQ(3u, results.size());
-		EXPECT_THAT(results, ElementsAre("un", "deux", "trois"));
+		EXPECT_EQ((std::vector<std::string_view>{ "un", "deux", "trois" }), results);
 	}
 
 	TEST(StringSplitTest, StringSplitKeepWhitespace) {
@@ -443,4 +451,54 @@ namespace base {
 		}
 	}
 
+	TEST(StringSplitTest, SplitStringPieceRange) {
+		const std::string_view inputs[] = {
+			"", ",", "a", "a,b;c", ",a,,b,", " a ; b\t, ,c ", ";;;",
+		};
+		for (const auto input : inputs) {
+			for (const auto whitespace : { KEEP_WHITESPACE, TRIM_WHITESPACE }) {
+				for (const auto result_type : { SPLIT_WANT_ALL, SPLIT_WANT_NONEMPTY }) {
+					std::vector<std::string_view> pieces;
+					for (const auto piece :
+						SplitStringPieceRange(input, ",;", whitespace, result_type)) {
+						pieces.push_back(piece);
+					}
+					EXPECT_EQ(SplitStringPiece(input, ",;", whitespace, result_type),
+						pieces) << input;
+				}
+			}
+		}
+
+		std::vector<std::wstring_view> wide_pieces;
+		for (const auto piece : SplitStringPieceRange(
+			L" a\n\nb \n", L"\n", TRIM_WHITESPACE, SPLIT_WANT_NONEMPTY)) {
+			wide_pieces.push_back(piece);
+		}
+		EXPECT_EQ((std::vector<std::wstring_view>{ L"a", L"b" }), wide_pieces);
+	}
+
+	// The vectorized search steps over 16 or 32 bytes at a time; check every
+	// delimiter position against the scalar search, for sets of every size.
+	TEST(StringSplitTest, FindFirstOf) {
+		const std::string_view all_delimiters = ",;:|\t\n =/";
+		for (size_t set_size = 0; set_size <= all_delimiters.size(); ++set_size) {
+			const auto delimiters = all_delimiters.substr(0, set_size);
+			for (size_t length = 0; length < 70; ++length) {
+				std::string str(length, 'x');
+				EXPECT_EQ(std::string::npos, internal::FindFirstOf(str, delimiters, 0));
+				for (size_t pos = 0; pos < length; ++pos) {
+					for (const char delimiter : all_delimiters) {
+						str[pos] = delimiter;
+						for (const size_t start : { size_t{ 0 }, pos, pos + 1 }) {
+							EXPECT_EQ(str.find_first_of(delimiters, start),
+								internal::FindFirstOf(str, delimiters, start))
+								<< set_size << " " << length << " " << pos;
+						}
+						str[pos] = 'x';
+					}
+				}
+			}
+		}
+	}
+
 }  // namespace base
@@ -381,6 +381,20 @@ namespace base {
 			EXPECT_FALSE(t.GetNext());
 		}
 
+		TEST(StringTokenizerTest, LongTokens) {
+			const string word(100, 'w');
+			string input;
+			for (int i = 0; i < 10; ++i)
+				input += word.substr(0, i * 10) + (i % 2 ? " ," : "\t");
+			StringTokenizer t(input, ", \t");
+
+			for (int i = 1; i < 10; ++i) {
+				EXPECT_TRUE(t.GetNext());
+				EXPECT_EQ(word.substr(0, i * 10), t.token());
+			}
+			EXPECT_FALSE(t.GetNext());
+		}
+
 	}  // namespace
 
 }  // namespace base
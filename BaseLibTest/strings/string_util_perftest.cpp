@@ -0,0 +1,86 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "pch.h"
+#include "strings/string_util.h"
+
+#include <string>
+#include <vector>
+
+#include "strings/string_number_conversions.h"
+#include "strings/utf_string_conversions.h"
+#include "test/perf_test.h"
+#include "timer/lap_timer.h"
+
+namespace base {
+
+	namespace {
+
+		constexpr int kWarmupRuns = 2;
+		constexpr int kTimeCheckInterval = 4;
+		constexpr TimeDelta kTimeLimit = TimeDelta::FromMilliseconds(500);
+
+		// HTTP-style header names and values, as a header normalizer sees them.
+		std::vector<std::string> GenerateHeaders() {
+			const char* const kNames[] = {
+				"Content-Type", "Accept-Encoding", "X-Forwarded-For",
+				"Access-Control-Allow-Origin", "Strict-Transport-Security",
+				"Cache-Control", "User-Agent", "Content-Security-Policy-Report-Only",
+			};
+			std::vector<std::string> headers;
+			for (int i = 0; i < 10000; ++i) {
+				headers.push_back(std::string(kNames[i % size(kNames)]) +
+					": Mozilla/5.0 (Windows NT 10.0; Win64; x64) Session=" +
+					NumberToString(i));
+			}
+			return headers;
+		}
+
+	}  // namespace
+
+	TEST(StringUtilPerfTest, CaseFolding) {
+		const std::vector<std::string> headers = GenerateHeaders();
+		std::vector<std::wstring> wide_headers;
+		for (const auto& header : headers)
+			wide_headers.push_back(ASCIIToUTF16(header));
+
+		size_t size = 0;
+		LapTimer lower_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			for (const auto& header : headers)
+				size += ToLowerASCII(header).size();
+			lower_timer.NextLap();
+		} while (!lower_timer.HasTimeLimitExpired());
+		perf_test::PrintResult("to_lower_ascii", "", "headers",
+			lower_timer.TimePerLap().InMillisecondsF(), "ms", true);
+
+		LapTimer wide_lower_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			for (const auto& header : wide_headers)
+				size += ToLowerASCII(header).size();
+			wide_lower_timer.NextLap();
+		} while (!wide_lower_timer.HasTimeLimitExpired());
+		perf_test::PrintResult("to_lower_ascii", "_wide", "headers",
+			wide_lower_timer.TimePerLap().InMillisecondsF(), "ms", true);
+		EXPECT_GT(size, 0u);
+
+		// Every header against its uppercased copy, so that each comparison
+		// runs to the end.
+		std::vector<std::string> upper_headers;
+		for (const auto& header : headers)
+			upper_headers.push_back(ToUpperASCII(header));
+		int equal = 0;
+		LapTimer equals_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			equal = 0;
+			for (size_t i = 0; i < headers.size(); ++i)
+				equal += EqualsCaseInsensitiveASCII(headers[i], upper_headers[i]);
+			equals_timer.NextLap();
+		} while (!equals_timer.HasTimeLimitExpired());
+		perf_test::PrintResult("equals_case_insensitive_ascii", "", "headers",
+			equals_timer.TimePerLap().InMillisecondsF(), "ms", true);
+		EXPECT_EQ(static_cast<int>(headers.size()), equal);
+	}
+
+}  // namespace base
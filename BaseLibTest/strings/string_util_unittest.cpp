@@ -425,6 +425,24 @@ namespace base {
 		EXPECT_FALSE(IsStringUTF8("embedded\xc0\x80U+0000"));
 	}
 
+	// ASCII runs are skipped in vector-sized steps; make sure a multibyte
+	// sequence is validated wherever it falls relative to those steps.
+	TEST(StringUtilTest, IsStringUTF8AroundASCIIRuns) {
+		const std::string ascii(80, 'a');
+		for (size_t len = 0; len <= ascii.size(); ++len) {
+			EXPECT_TRUE(IsStringUTF8(std::string_view(ascii.data(), len)));
+			for (size_t pos = 0; pos <= len; ++pos) {
+				std::string str = ascii.substr(0, len);
+				str.insert(pos, "\xe4\xbd\xa0");  // U+4F60
+				EXPECT_TRUE(IsStringUTF8(str)) << len << " " << pos;
+				str[pos + 2] = 'a';  // Truncated sequence.
+				EXPECT_FALSE(IsStringUTF8(str)) << len << " " << pos;
+				str.replace(pos, 3, "\xef\xbf\xbe");  // U+FFFE, a non-character.
+				EXPECT_FALSE(IsStringUTF8(str)) << len << " " << pos;
+			}
+		}
+	}
+
 	TEST(StringUtilTest, IsStringASCII) {
 		static char char_ascii[] =
 			"0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF";
@@ -563,6 +581,80 @@ namespace base {
 		EXPECT_EQ(ASCIIToUTF16("CC2"), ToUpperASCII(ASCIIToUTF16("Cc2")));
 	}
 
+	TEST(StringUtilTest, ChangeCaseASCIILongStrings) {
+		// Letters, their neighbours, and non-ASCII values, at every length and
+		// alignment the vector code can see.
+		const char kNarrow[] = "@AZ[`az{0 \x80\xc1\xe1\xff";
+		const wchar_t kWide[] = L"@AZ[`az{0 \x80\xc1\xe1\xff\x141\x4141\xff41\xffff";
+		std::string narrow;
+		std::wstring wide;
+		for (size_t i = 0; i < 100; ++i) {
+			narrow += kNarrow[(i * 7) % (base::size(kNarrow) - 1)];
+			wide += kWide[(i * 7) % (base::size(kWide) - 1)];
+		}
+		for (size_t start = 0; start < 8; ++start) {
+			for (size_t length = 0; start + length <= narrow.size(); ++length) {
+				const std::string_view piece = std::string_view(narrow).substr(start, length);
+				const std::wstring_view wide_piece =
+					std::wstring_view(wide).substr(start, length);
+				std::string lower, upper;
+				std::wstring wide_lower, wide_upper;
+				for (size_t i = 0; i < length; ++i) {
+					lower += ToLowerASCII(piece[i]);
+					upper += ToUpperASCII(piece[i]);
+					wide_lower += ToLowerASCII(wide_piece[i]);
+					wide_upper += ToUpperASCII(wide_piece[i]);
+				}
+				EXPECT_EQ(lower, ToLowerASCII(piece));
+				EXPECT_EQ(upper, ToUpperASCII(piece));
+				EXPECT_EQ(wide_lower, ToLowerASCII(wide_piece));
+				EXPECT_EQ(wide_upper, ToUpperASCII(wide_piece));
+
+				std::string in_place(piece);
+				ToLowerASCIIInPlace(&in_place);
+				EXPECT_EQ(lower, in_place);
+				ToUpperASCIIInPlace(&in_place);
+				EXPECT_EQ(upper, in_place);
+				std::wstring wide_in_place(wide_piece);
+				ToUpperASCIIInPlace(&wide_in_place);
+				EXPECT_EQ(wide_upper, wide_in_place);
+				ToLowerASCIIInPlace(&wide_in_place);
+				EXPECT_EQ(wide_lower, wide_in_place);
+
+				EXPECT_TRUE(EqualsCaseInsensitiveASCII(upper, piece));
+				EXPECT_TRUE(EqualsCaseInsensitiveASCII(wide_lower, wide_piece));
+				EXPECT_EQ(0, CompareCaseInsensitiveASCII(lower, piece));
+				EXPECT_TRUE(LowerCaseEqualsASCII(upper, lower));
+				if (IsStringASCII(lower))
+					EXPECT_TRUE(LowerCaseEqualsASCII(UTF8ToWide(upper), lower));
+			}
+		}
+	}
+
+	TEST(StringUtilTest, CompareCaseInsensitiveASCIIFirstDifference) {
+		const std::string base(70, 'a');
+		for (size_t i = 0; i < base.size(); ++i) {
+			std::string upper = ToUpperASCII(base);
+			std::string other = base;
+			other[i] = 'b';
+			EXPECT_EQ(-1, CompareCaseInsensitiveASCII(upper, other));
+			EXPECT_EQ(1, CompareCaseInsensitiveASCII(other, upper));
+			EXPECT_FALSE(EqualsCaseInsensitiveASCII(upper, other));
+			EXPECT_FALSE(LowerCaseEqualsASCII(upper, other.c_str()));
+			// Characters compare as char, so non-ASCII sorts before ASCII.
+			other[i] = '\x80';
+			EXPECT_EQ(1, CompareCaseInsensitiveASCII(upper, other));
+			EXPECT_FALSE(LowerCaseEqualsASCII(ASCIIToUTF16(upper), other));
+
+			std::wstring wide_upper = ASCIIToUTF16(upper);
+			std::wstring wide_other = ASCIIToUTF16(base);
+			wide_other[i] = L'\x4100';
+			EXPECT_EQ(-1, CompareCaseInsensitiveASCII(wide_upper, wide_other));
+			EXPECT_FALSE(EqualsCaseInsensitiveASCII(wide_upper, wide_other));
+			EXPECT_FALSE(LowerCaseEqualsASCII(wide_other, base));
+		}
+	}
+
 	TEST(StringUtilTest, LowerCaseEqualsASCII) {
 		static const struct {
 			const char* src_a;
@@ -0,0 +1,72 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "pch.h"
+#include "strings/utf_string_conversions.h"
+
+#include <string>
+
+#include "strings/string_util.h"
+#include "test/perf_test.h"
+#include "timer/lap_timer.h"
+
+namespace base {
+
+	namespace {
+
+		constexpr int kWarmupRuns = 2;
+		constexpr int kTimeCheckInterval = 4;
+		constexpr TimeDelta kTimeLimit = TimeDelta::FromMilliseconds(500);
+
+		// File paths and log lines: long ASCII runs with a multibyte name every
+		// few lines.
+		std::string GenerateText() {
+			std::string text;
+			for (int i = 0; i < 20000; ++i) {
+				text += "C:\\Users\\build\\AppData\\Local\\Temp\\";
+				if (i % 8 == 0)
+					text += "\xe6\x8a\xa5\xe5\x91\x8a";  // U+62A5 U+544A
+				text += "session_" + std::to_string(i) + ".log: opened\n";
+			}
+			return text;
+		}
+
+	}  // namespace
+
+	TEST(UTFStringConversionsPerfTest, MostlyASCII) {
+		const std::string text = GenerateText();
+		const std::wstring wide = UTF8ToWide(text);
+
+		bool valid = true;
+		LapTimer validate_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			valid &= IsStringUTF8(text);
+			validate_timer.NextLap();
+		} while (!validate_timer.HasTimeLimitExpired());
+		perf_test::PrintResult("is_string_utf8", "", "mostly_ascii",
+			validate_timer.TimePerLap().InMillisecondsF(), "ms", true);
+		EXPECT_TRUE(valid);
+
+		std::wstring converted_wide;
+		LapTimer to_wide_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			UTF8ToWide(text.data(), text.size(), &converted_wide);
+			to_wide_timer.NextLap();
+		} while (!to_wide_timer.HasTimeLimitExpired());
+		perf_test::PrintResult("utf8_to_wide", "", "mostly_ascii",
+			to_wide_timer.TimePerLap().InMillisecondsF(), "ms", true);
+		EXPECT_EQ(wide, converted_wide);
+
+		std::string converted_utf8;
+		LapTimer to_utf8_timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+		do {
+			WideToUTF8(wide.data(), wide.size(), &converted_utf8);
+			to_utf8_timer.NextLap();
+		} while (!to_utf8_timer.HasTimeLimitExpired());
+		perf_test::PrintResult("wide_to_utf8", "", "mostly_ascii",
+			to_utf8_timer.TimePerLap().InMillisecondsF(), "ms", true);
+		EXPECT_EQ(text, converted_utf8);
+	}
+
+}  // namespace base
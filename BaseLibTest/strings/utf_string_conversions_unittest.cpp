@@ -177,6 +177,40 @@ namespace base {
 	}
 #endif  // defined(WCHAR_T_IS_UTF32)
 
+	// ASCII runs are converted in vector-sized steps; check that every split
+	// between a run and the multibyte sequences around it comes out right.
+	TEST(UTFStringConversionsTest, ConvertAroundASCIIRuns) {
+		const std::string ascii(80, 'a');
+		const std::wstring wide_ascii(80, L'a');
+		for (size_t len = 0; len <= ascii.size(); ++len) {
+			for (size_t pos = 0; pos <= len; ++pos) {
+				std::string utf8 = ascii.substr(0, len);
+				utf8.insert(pos, "\xe4\xbd\xa0");  // U+4F60
+				std::wstring wide = wide_ascii.substr(0, len);
+				wide.insert(pos, 1, L'\x4f60');
+
+				std::wstring converted_wide;
+				EXPECT_TRUE(UTF8ToWide(utf8.data(), utf8.size(), &converted_wide));
+				EXPECT_EQ(wide, converted_wide) << len << " " << pos;
+				std::string converted_utf8;
+				EXPECT_TRUE(WideToUTF8(wide.data(), wide.size(), &converted_utf8));
+				EXPECT_EQ(utf8, converted_utf8) << len << " " << pos;
+
+				// Invalid input in the middle of a run is replaced with U+FFFD.
+				utf8[pos] = '\xff';
+				wide[pos] = L'\xfffd';
+				wide.insert(pos + 1, L"\xfffd\xfffd");
+				EXPECT_FALSE(UTF8ToWide(utf8.data(), utf8.size(), &converted_wide));
+				EXPECT_EQ(wide, converted_wide) << len << " " << pos;
+				wide.erase(pos + 1, 2);
+				wide[pos] = L'\xdc00';  // Lone trail surrogate.
+				EXPECT_FALSE(WideToUTF8(wide.data(), wide.size(), &converted_utf8));
+				utf8.replace(pos, 3, "\xef\xbf\xbd");
+				EXPECT_EQ(utf8, converted_utf8) << len << " " << pos;
+			}
+		}
+	}
+
 	TEST(UTFStringConversionsTest, ConvertMultiString) {
 		static wchar_t multi16[] = {
 			'f', 'o', 'o', '\0',
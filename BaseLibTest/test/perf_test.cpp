@@ -0,0 +1,73 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "pch.h"
+
+#include "test/perf_test.h"
+
+#include <cstdio>
+
+#include "strings/string_number_conversions.h"
+#include "strings/stringprintf.h"
+
+namespace {
+
+	std::string ResultsToString(const std::string& measurement,
+								const std::string& modifier,
+								const std::string& trace,
+								const std::string& values,
+								const std::string& units,
+								bool important) {
+		return base::StringPrintf("%sRESULT %s%s: %s= %s %s\n",
+								  important ? "*" : "", measurement.c_str(),
+								  modifier.c_str(), trace.c_str(), values.c_str(),
+								  units.c_str());
+	}
+
+	void PrintResultsImpl(const std::string& measurement,
+						  const std::string& modifier,
+						  const std::string& trace,
+						  const std::string& values,
+						  const std::string& units,
+						  bool important) {
+		fflush(stdout);
+		printf("%s", ResultsToString(measurement, modifier, trace, values,
+									 units, important).c_str());
+		fflush(stdout);
+	}
+
+}  // namespace
+
+namespace perf_test {
+
+	void PrintResult(const std::string& measurement,
+					 const std::string& modifier,
+					 const std::string& trace,
+					 size_t value,
+					 const std::string& units,
+					 bool important) {
+		PrintResultsImpl(measurement, modifier, trace,
+						 base::NumberToString(value), units, important);
+	}
+
+	void PrintResult(const std::string& measurement,
+					 const std::string& modifier,
+					 const std::string& trace,
+					 double value,
+					 const std::string& units,
+					 bool important) {
+		PrintResultsImpl(measurement, modifier, trace,
+						 base::NumberToString(value), units, important);
+	}
+
+	void PrintResult(const std::string& measurement,
+					 const std::string& modifier,
+					 const std::string& trace,
+					 const std::string& value,
+					 const std::string& units,
+					 bool important) {
+		PrintResultsImpl(measurement, modifier, trace, value, units, important);
+	}
+
+}  // namespace perf_test
@@ -0,0 +1,43 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <string>
+
+// Helpers for reporting the results of perf tests in the "*RESULT" format
+// understood by Chromium's perf dashboards.
+namespace perf_test {
+
+	// Prints numerical information to stdout in a controlled format, for
+	// post-processing. |measurement| is a description of the quantity being
+	// measured, e.g. "parse"; |modifier| is provided as a convenience and will
+	// be appended directly to the name of the |measurement|, e.g. "_arena";
+	// |trace| is a description of the particular data point, e.g. "1MB";
+	// |value| is the measured value; and |units| is a description of the units
+	// of measure, e.g. "ms" or "bytes". If |important| is true, the output line
+	// will be specially marked, to notify the post-processor.
+	void PrintResult(const std::string& measurement,
+					 const std::string& modifier,
+					 const std::string& trace,
+					 size_t value,
+					 const std::string& units,
+					 bool important);
+	void PrintResult(const std::string& measurement,
+					 const std::string& modifier,
+					 const std::string& trace,
+					 double value,
+					 const std::string& units,
+					 bool important);
+
+	// Like the above version of PrintResult(), but takes a std::string value
+	// instead of a size_t.
+	void PrintResult(const std::string& measurement,
+					 const std::string& modifier,
+					 const std::string& trace,
+					 const std::string& value,
+					 const std::string& units,
+					 bool important);
+
+}  // namespace perf_test
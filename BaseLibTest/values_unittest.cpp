@@ -42,14 +42,14 @@ namespace base {
 	}
 
 	TEST(ValuesTest, SizeOfValue) {
-#define INNER_TYPES_LIST(X)              \
-  X(bool, bool_value_)                   \
-  X(int, int_value_)                     \
-  X(Value::DoubleStorage, double_value_) \
-  X(std::string, string_value_)          \
-  X(Value::BlobStorage, binary_value_)   \
-  X(Value::ListStorage, list_)           \
-  X(Value::DictStorage, dict_)
+#define INNER_TYPES_LIST(X)                  \
+  X(bool, bool_value_)                       \
+  X(int, int_value_)                         \
+  X(Value::DoubleStorage, double_value_)     \
+  X(Value::HeapStringStorage, string_value_) \
+  X(Value::HeapBlobStorage, binary_value_)   \
+  X(Value::HeapListStorage, list_)           \
+  X(Value::HeapDictStorage, dict_)
 
 #define INNER_FIELD_ALIGNMENT(type, value) alignof(type),
 
@@ -92,6 +92,8 @@ namespace base {
 			AlignSizeTo(max_inner_struct_end_offset, alignof(Value));
 
 		EXPECT_EQ(expected_value_size, sizeof(Value));
+		// Only the type precedes the payload, which is at most a double.
+		EXPECT_LE(sizeof(Value), sizeof(void*) + sizeof(double));
 		if (min_inner_value_offset != expected_min_offset ||
 			expected_value_size != sizeof(Value)) {
 			// The following are useful to understand what's wrong when the EXPECT_EQ()
@@ -346,6 +348,20 @@ namespace base {
 		EXPECT_EQ(value, blank);
 	}
 
+	TEST(ValuesTest, FindStringPathOnEmptyString) {
+		Value dict(Value::Type::DICTIONARY);
+		dict.SetStringKey("a", "");
+		std::string* a = dict.FindStringPath("a");
+		ASSERT_TRUE(a);
+		a->append("written");
+		EXPECT_EQ("written", *dict.FindStringKey("a"));
+
+		// Writing to |a| must not reach other empty strings.
+		Value empty_string(Value::Type::STRING);
+		EXPECT_EQ("", empty_string.GetString());
+		EXPECT_EQ("", Value("").GetString());
+	}
+
 	// Group of tests for the move constructors and move-assigmnent.
 	TEST(ValuesTest, MoveBool) {
 		Value true_value(true);
@@ -109,6 +109,24 @@ namespace logging {
 			EXPECT_EQ(4, vlog_info.GetVlogLevel("foo/bar/baz/blah-inl.h"));
 		}
 
+		TEST(VlogTest, StaticFileCache) {
+			const char kVModuleSwitch[] = "foo=2,*/bar/*=3";
+			const char kFoo[] = "/path/to/foo.cc";
+			const char kBar[] = "/path/bar/baz.cc";
+			const char kQux[] = "qux.cc";
+			int min_log_level = 0;
+			VlogInfo vlog_info("1", kVModuleSwitch, &min_log_level);
+			for (int i = 0; i < 2; ++i) {
+				EXPECT_EQ(2, vlog_info.GetVlogLevelForStaticFile(kFoo, strlen(kFoo)));
+				EXPECT_EQ(3, vlog_info.GetVlogLevelForStaticFile(kBar, strlen(kBar)));
+				EXPECT_EQ(1, vlog_info.GetVlogLevelForStaticFile(kQux, strlen(kQux)));
+			}
+			// Files matching no pattern follow the current default.
+			min_log_level = -4;
+			EXPECT_EQ(4, vlog_info.GetVlogLevelForStaticFile(kQux, strlen(kQux)));
+			EXPECT_EQ(2, vlog_info.GetVlogLevelForStaticFile(kFoo, strlen(kFoo)));
+		}
+
 	}  // namespace
 
 }  // namespace logging